@@ -5,6 +5,9 @@
 #include "CommonTypes.hh"
 #include "Config.hh"
 #include "CommonUtils.hh"
+#include "../../plugins/BranchGroups.hh"
+#include "../../plugins/HistRegistry.hh"
+#include "../../plugins/ColumnStats.hh"
 
 #include "TTree.h"
 #include "TBranch.h"
@@ -22,6 +25,7 @@ public:
   void InitAndReadConfigTree();
   void InitConfigStrings();
   void InitConfigBranches();
+  void SetupBranchGroups();
   void EventLoop();
   Bool_t IsGoodPho(const Pho & pho);
   Bool_t PassOOTID(const Pho & pho);
@@ -31,6 +35,8 @@ public:
   void SetupIsoNvtxPlots();
   void SetupIsoPtPlots();
   void SetupPhotonEffPlots();
+  void SetupFillHandles();
+  UInt_t GetPhoSlot(const Int_t ipho, const Pho & pho);
   void FillEventStandardPlots(const Float_t weight);
   void FillPhotonStandardPlots(const Int_t Nphotons, const Float_t weight);
   void FillIsoPlots(const Int_t Nphotons, const Float_t weight);
@@ -56,10 +62,9 @@ public:
   void MakeInclusiveSplitTEffs(TEffMap & teffmap, TStrMap & subdirmap);
   void Make1DFrom2DPlots(const TH2F * hist2d, const TString & subdir2d, const TString & name);
   void Project2Dto1D(const TH2F * hist2d, const TString & subdir2d, TH1Map & th1dmap, TStrMap & subdir1dmap, TStrIntMap & th1dbinmap);
-  void ProduceQuantile(const TH2F * hist2d, const TString & subdir2d, TH1Map & th1dmap, TStrIntMap & th1dbinmap);
-  void ProduceMeanHist(const TH2F * hist2d, const TString & subdir2d, TH1Map & th1dmap, TStrIntMap & th1dbinmap);
-  void GetQuantileX(const TH1F * hist, Float_t & x, Float_t & dx_dn, Float_t & dx_up);
-  Float_t FluctuateX(const FltVec & eff, const FltVec & eff_err, const Float_t qprob, const FltVec & centers, const Float_t x, const Bool_t isUp);
+  void ProduceQuantile(const TH2F * hist2d, const TString & subdir2d, const Float_t qprob, const std::vector<ColumnStats::Column> & columns);
+  void ProduceMeanHist(const TH2F * hist2d, const TString & subdir2d, const std::vector<ColumnStats::Column> & columns);
+  Float_t GetQuantProb(const TString & hname);
   TH1F * MakeTH1Plot(const TString & hname, const TString & htitle, const Int_t nbinsx, const Double_t xlow, const Double_t xhigh, 
 		     const TString & xtitle, const TString & ytitle, TStrMap& subdirmap, const TString & subdir);
   TH1F * MakeTH1PlotFromTH2(const TH2F * hist2d, const TString & name, const TString & ytitle);
@@ -88,6 +93,7 @@ private:
   Bool_t fIsHVDS;
   TFile * fInFile;
   TTree * fInTree; 
+  BranchGroups fBranches;
   TTree * fConfigTree;
   TH1F  * fCutFlow;
 
@@ -101,6 +107,10 @@ private:
   std::ofstream fTH1Dump; 
   std::ofstream fTH1PhoDump; 
   std::ofstream fTEffDump;
+  TString fTH1DumpName;
+  TString fTH1PhoDumpName;
+  TString fTEffDumpName;
+  TString fTmpExt;
   
   // Output colors
   Color_t fColor;
@@ -115,6 +125,16 @@ private:
   TH2Map isonvtxTH2Map; TStrMap isonvtxTH2SubMap;
   TH2Map isoptTH2Map; TStrMap isoptTH2SubMap;
   TEffMap phoTEffMap; TStrMap phoTEffSubMap;
+
+  ///////////////////////////////////////////////////
+  // fill handles: resolved once, after the setup //
+  ///////////////////////////////////////////////////
+  HistRegistry<TH1F> fTH1s;
+  HistRegistry<TH2F> fTH2s;
+  HistRegistry<TEfficiency> fTEffs;
+  UInt_t fNvtxHandle;
+  UInt_t fRhoNvtxHandle;
+  PhoHandlesVec fPhoHandles;
   
   ///////////////////////////////////////////
   // Declaration of leaf types for fInTree //
@@ -202,4 +202,18 @@ struct Pho
 };
 typedef std::vector<Pho> PhoVec;
 
+// fill handles of one photon slot: photon index, EB/EE, GED/OOT
+struct PhoHandles
+{
+  // TH1
+  UInt_t pt, phi, eta, hoe, r9, sieie, sieip, sipip, smaj, smin, seedtime;
+  UInt_t chgiso, neuiso, phoiso, ecaliso, hcaliso, trkiso;
+  // TH2
+  UInt_t ecaliso_v_nvtx, hcaliso_v_nvtx, trkiso_v_nvtx;
+  UInt_t chgiso_v_pt, neuiso_v_pt, phoiso_v_pt, ecaliso_v_pt, hcaliso_v_pt, trkiso_v_pt;
+  // TEfficiency
+  UInt_t effpt, effeta, effphi;
+};
+typedef std::vector<PhoHandles> PhoHandlesVec;
+
 #endif
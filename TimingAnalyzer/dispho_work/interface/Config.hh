@@ -112,6 +112,7 @@ namespace Config
   extern Bool_t      doPhoStacks;
   extern Bool_t      doEffStacks;
   extern Bool_t      doDemo;
+  extern Int_t       nJobs;
   extern Bool_t      useDEG;
   extern Bool_t      useSPH;
   extern Bool_t      useDYll;
@@ -0,0 +1,282 @@
+// Class include
+#include "BinnedTemplateFit.hh"
+
+BinnedTemplateFit::BinnedTemplateFit(const TH1 * bkgdhist, const TH1 * signhist)
+  : fHasSign(signhist != (TH1*) NULL)
+{
+  std::cout << "Initializing BinnedTemplateFit..." << std::endl;
+
+  fTemplateHist = (TH1*)bkgdhist->Clone(Form("%s_BinnedTemplateFit",bkgdhist->GetName()));
+  fTemplateHist->SetDirectory(0);
+  fTemplateHist->Reset();
+
+  BinnedTemplateFit::SetupBins(bkgdhist,signhist);
+  BinnedTemplateFit::FillTemplate(bkgdhist,fBkgdShape);
+  if (fHasSign) BinnedTemplateFit::FillTemplate(signhist,fSignShape);
+  else          fSignShape.assign(fBins.size(),0.0);
+
+  fData  .assign(fBins.size(),0.0);
+  fDataW2.assign(fBins.size(),0.0);
+}
+
+void BinnedTemplateFit::SetData(const TH1 * datahist)
+{
+  Double_t nlost = 0.0;
+  for (auto ibin = 0U; ibin < fBins.size(); ibin++)
+  {
+    const auto error = datahist->GetBinError(fBins[ibin]);
+    fData  [ibin] = datahist->GetBinContent(fBins[ibin]);
+    fDataW2[ibin] = error*error;
+    nlost -= fData[ibin];
+  }
+  nlost += datahist->Integral();
+
+  // data where neither template has anything cannot be described by the model
+  if (std::abs(nlost) > 0) std::cout << "Warning: " << nlost << " data events in bins empty in all templates are not fitted" << std::endl;
+}
+
+void BinnedTemplateFit::GenerateToy(const Double_t nbkgd, const Double_t nsign, const Long64_t nevents)
+{
+  const auto nsignused = (fHasSign ? nsign : 0.0);
+  const auto ntotal = nbkgd + nsignused;
+
+  // multinomial as a chain of binomials: bin i gets Binomial(events left, p_i / probability left)
+  Long64_t nleft = nevents;
+  Double_t pleft = 1.0;
+  for (auto ibin = 0U; ibin < fBins.size(); ibin++)
+  {
+    const auto prob = std::max(0.0,(nbkgd*fBkgdShape[ibin] + nsignused*fSignShape[ibin]) / ntotal);
+
+    Long64_t count = 0;
+    if (nleft > 0)
+    {
+      if (ibin == fBins.size()-1) count = nleft;
+      else if (pleft > 0)         count = gRandom->Binomial(Int_t(nleft),std::min(1.0,prob/pleft));
+    }
+
+    fData  [ibin] = count;
+    fDataW2[ibin] = count;
+
+    nleft -= count;
+    pleft -= prob;
+  }
+}
+
+BinnedFitResult BinnedTemplateFit::Fit(const Double_t nbkgd0, const Double_t nbkgdlow, const Double_t nbkgdhigh,
+				       const Double_t nsign0, const Double_t nsignlow, const Double_t nsignhigh,
+				       const Bool_t sumW2Error) const
+{
+  const Int_t maxiter = 100;
+  const Double_t edmtol = 1e-6;
+
+  const Int_t npar = (fHasSign ? 2 : 1);
+  const Double_t low [2] = {nbkgdlow ,nsignlow };
+  const Double_t high[2] = {nbkgdhigh,nsignhigh};
+
+  BinnedFitResult result;
+  Double_t par[2] = {std::min(std::max(nbkgd0,low[0]),high[0]), (fHasSign ? std::min(std::max(nsign0,low[1]),high[1]) : 0.0)};
+  Double_t nll = BinnedTemplateFit::EvalNLL(par[0],par[1]);
+
+  Double_t grad[2], hess[3], cov[3];
+  for (result.niter = 0; result.niter < maxiter; result.niter++)
+  {
+    BinnedTemplateFit::EvalDerivatives(par[0],par[1],grad,hess,NULL);
+
+    // Newton step if the Hessian is positive definite, else a scaled gradient step
+    Double_t step[2] = {0.0,0.0};
+    const Double_t det = (npar == 2 ? hess[0]*hess[2] - hess[1]*hess[1] : hess[0]);
+    if (hess[0] > 0 && det > 0)
+    {
+      if (npar == 2)
+      {
+	step[0] = -( hess[2]*grad[0] - hess[1]*grad[1]) / det;
+	step[1] = -(-hess[1]*grad[0] + hess[0]*grad[1]) / det;
+      }
+      else
+      {
+	step[0] = -grad[0] / hess[0];
+      }
+    }
+    else
+    {
+      step[0] = -grad[0] / std::max(std::abs(hess[0]),1.0);
+      if (npar == 2) step[1] = -grad[1] / std::max(std::abs(hess[2]),1.0);
+    }
+
+    // estimated distance to minimum
+    result.edm = -0.5 * (grad[0]*step[0] + grad[1]*step[1]);
+    if (result.edm < edmtol) {result.converged = true; break;}
+
+    // halve the step until it lowers the NLL, staying in range
+    Bool_t accepted = false;
+    for (auto t = 1.0; t > 1e-10; t *= 0.5)
+    {
+      Double_t trial[2] = {par[0],par[1]};
+      for (auto ipar = 0; ipar < npar; ipar++) trial[ipar] = std::min(std::max(par[ipar]+t*step[ipar],low[ipar]),high[ipar]);
+
+      const auto trialnll = BinnedTemplateFit::EvalNLL(trial[0],trial[1]);
+      if (trialnll <= nll)
+      {
+	accepted = (trial[0] != par[0] || trial[1] != par[1]);
+	par[0] = trial[0];
+	par[1] = trial[1];
+	nll = trialnll;
+	break;
+      }
+    }
+
+    // stuck, e.g. pinned at a range limit
+    if (!accepted) break;
+  }
+
+  // errors from the Hessian at the minimum
+  BinnedTemplateFit::EvalDerivatives(par[0],par[1],grad,hess,cov);
+
+  result.nbkgd = par[0];
+  result.nsign = par[1];
+  result.nll = nll;
+
+  Double_t inv[3] = {0.0,0.0,0.0};
+  if (npar == 2)
+  {
+    const auto det = hess[0]*hess[2] - hess[1]*hess[1];
+    if (det > 0)
+    {
+      inv[0] =  hess[2] / det;
+      inv[1] = -hess[1] / det;
+      inv[2] =  hess[0] / det;
+    }
+  }
+  else if (hess[0] > 0)
+  {
+    inv[0] = 1.0 / hess[0];
+  }
+
+  Double_t var[3] = {inv[0],inv[1],inv[2]};
+  if (sumW2Error)
+  {
+    // V = H^-1 C H^-1, symmetric 2x2
+    var[0] = inv[0]*(cov[0]*inv[0] + cov[1]*inv[1]) + inv[1]*(cov[1]*inv[0] + cov[2]*inv[1]);
+    var[1] = inv[0]*(cov[0]*inv[1] + cov[1]*inv[2]) + inv[1]*(cov[1]*inv[1] + cov[2]*inv[2]);
+    var[2] = inv[1]*(cov[0]*inv[1] + cov[1]*inv[2]) + inv[2]*(cov[1]*inv[1] + cov[2]*inv[2]);
+  }
+
+  result.nbkgdErr = std::sqrt(std::max(var[0],0.0));
+  result.nsignErr = std::sqrt(std::max(var[2],0.0));
+  result.corr = ((result.nbkgdErr > 0 && result.nsignErr > 0) ? var[1] / (result.nbkgdErr*result.nsignErr) : 0.0);
+
+  if (!result.converged) std::cout << "Warning: BinnedTemplateFit did not converge after " << result.niter << " iterations, edm: " << result.edm << std::endl;
+
+  return result;
+}
+
+TH1 * BinnedTemplateFit::MakeDataHist(const TString & name) const
+{
+  auto hist = (TH1*)fTemplateHist->Clone(name.Data());
+  hist->SetDirectory(0);
+  hist->Reset();
+
+  Double_t entries = 0.0;
+  for (auto ibin = 0U; ibin < fBins.size(); ibin++)
+  {
+    hist->SetBinContent(fBins[ibin],fData[ibin]);
+    hist->SetBinError  (fBins[ibin],std::sqrt(fDataW2[ibin]));
+    entries += fData[ibin];
+  }
+  hist->SetEntries(entries);
+
+  return hist;
+}
+
+void BinnedTemplateFit::SetupBins(const TH1 * bkgdhist, const TH1 * signhist)
+{
+  const Bool_t is2D = (bkgdhist->GetDimension() == 2);
+  const auto nbinsX = bkgdhist->GetXaxis()->GetNbins();
+  const auto nbinsY = (is2D ? bkgdhist->GetYaxis()->GetNbins() : 1);
+
+  // in-range bins where at least one template is non-zero
+  for (auto ibinY = 1; ibinY <= nbinsY; ibinY++)
+  {
+    for (auto ibinX = 1; ibinX <= nbinsX; ibinX++)
+    {
+      const auto bin = (is2D ? bkgdhist->GetBin(ibinX,ibinY) : bkgdhist->GetBin(ibinX));
+      if (bkgdhist->GetBinContent(bin) > 0 || (signhist && signhist->GetBinContent(bin) > 0)) fBins.emplace_back(bin);
+    }
+  }
+
+  std::cout << "Fitting " << fBins.size() << " of " << (nbinsX*nbinsY) << " bins" << std::endl;
+}
+
+void BinnedTemplateFit::FillTemplate(const TH1 * hist, std::vector<Double_t> & shape) const
+{
+  shape.assign(fBins.size(),0.0);
+
+  Double_t sum = 0.0;
+  for (auto ibin = 0U; ibin < fBins.size(); ibin++)
+  {
+    shape[ibin] = std::max(hist->GetBinContent(fBins[ibin]),0.0);
+    sum += shape[ibin];
+  }
+
+  if (sum <= 0)
+  {
+    std::cerr << "Template " << hist->GetName() << " is empty! Exiting..." << std::endl;
+    exit(1);
+  }
+  for (auto & value : shape) value /= sum;
+}
+
+Double_t BinnedTemplateFit::EvalNLL(const Double_t nbkgd, const Double_t nsign) const
+{
+  Double_t nll = 0.0;
+  for (auto ibin = 0U; ibin < fBins.size(); ibin++)
+  {
+    const auto nu = nbkgd*fBkgdShape[ibin] + nsign*fSignShape[ibin];
+    if (fData[ibin] > 0)
+    {
+      if (nu <= 0) return HUGE_VAL;
+      nll -= fData[ibin]*std::log(nu);
+    }
+    nll += nu;
+  }
+  return nll;
+}
+
+void BinnedTemplateFit::EvalDerivatives(const Double_t nbkgd, const Double_t nsign, Double_t * grad, Double_t * hess, Double_t * cov) const
+{
+  grad[0] = grad[1] = 0.0;
+  hess[0] = hess[1] = hess[2] = 0.0;
+  if (cov) cov[0] = cov[1] = cov[2] = 0.0;
+
+  // d nu / d nbkgd = bkgd shape, d nu / d nsign = sign shape
+  for (auto ibin = 0U; ibin < fBins.size(); ibin++)
+  {
+    const auto b  = fBkgdShape[ibin];
+    const auto s  = fSignShape[ibin];
+    const auto nu = nbkgd*b + nsign*s;
+
+    if (fData[ibin] <= 0 || nu <= 0)
+    {
+      grad[0] += b;
+      grad[1] += s;
+      continue;
+    }
+
+    const auto r = fData[ibin] / nu;
+    grad[0] += b * (1.0 - r);
+    grad[1] += s * (1.0 - r);
+
+    const auto h = r / nu;
+    hess[0] += h * b*b;
+    hess[1] += h * b*s;
+    hess[2] += h * s*s;
+
+    if (cov)
+    {
+      const auto c = fDataW2[ibin] / (nu*nu);
+      cov[0] += c * b*b;
+      cov[1] += c * b*s;
+      cov[2] += c * s*s;
+    }
+  }
+}
@@ -0,0 +1,76 @@
+#ifndef __BinnedTemplateFit__
+#define __BinnedTemplateFit__
+
+// ROOT includes
+#include "TH1.h"
+#include "TString.h"
+#include "TRandom.h"
+
+// STL includes
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+struct BinnedFitResult
+{
+  BinnedFitResult() : nbkgd(0), nbkgdErr(0), nsign(0), nsignErr(0), corr(0), nll(0), edm(0), niter(0), converged(false) {}
+
+  Double_t nbkgd;
+  Double_t nbkgdErr;
+  Double_t nsign;
+  Double_t nsignErr;
+  Double_t corr; // bkgd-sign correlation
+  Double_t nll;
+  Double_t edm;
+  Int_t niter;
+  Bool_t converged;
+};
+
+// Extended binned template fit of nbkgd * bkgd shape + nsign * sign shape, without RooFit.
+// Templates and data are flattened into contiguous arrays of the in-range bins the templates populate;
+// the Poisson NLL sum_i [nu_i - n_i ln(nu_i)] is minimized by Newton steps with the analytic gradient
+// and Hessian, clamped to the yield ranges. Errors are from the inverse Hessian at the minimum; with
+// sumW2Error, from the sandwich H^-1 C H^-1 (C uses the data sum of weights^2), as RooFit::SumW2Error.
+class BinnedTemplateFit
+{
+public:
+  // signhist == NULL: bkgd-only fit
+  BinnedTemplateFit(const TH1 * bkgdhist, const TH1 * signhist);
+  ~BinnedTemplateFit() {delete fTemplateHist;}
+
+  // data from a hist with the same binning as the templates
+  void SetData(const TH1 * datahist);
+
+  // toy data: nevents distributed multinomially over the model with the given yields
+  void GenerateToy(const Double_t nbkgd, const Double_t nsign, const Long64_t nevents);
+
+  // fit the current data
+  BinnedFitResult Fit(const Double_t nbkgd0, const Double_t nbkgdlow, const Double_t nbkgdhigh,
+		      const Double_t nsign0, const Double_t nsignlow, const Double_t nsignhigh,
+		      const Bool_t sumW2Error) const;
+
+  // current data as a hist with the template binning
+  TH1 * MakeDataHist(const TString & name) const;
+
+  UInt_t GetNBins() const {return fBins.size();}
+
+private:
+  void SetupBins(const TH1 * bkgdhist, const TH1 * signhist);
+  void FillTemplate(const TH1 * hist, std::vector<Double_t> & shape) const;
+  Double_t EvalNLL(const Double_t nbkgd, const Double_t nsign) const;
+  void EvalDerivatives(const Double_t nbkgd, const Double_t nsign, Double_t * grad, Double_t * hess, Double_t * cov) const;
+
+  TH1 * fTemplateHist; // empty copy of the binning
+  const Bool_t fHasSign;
+
+  // global bin numbers of the fitted bins, and the per-bin arrays
+  std::vector<Int_t> fBins;
+  std::vector<Double_t> fBkgdShape; // normalized to 1
+  std::vector<Double_t> fSignShape; // normalized to 1
+  std::vector<Double_t> fData;
+  std::vector<Double_t> fDataW2;
+};
+
+#endif
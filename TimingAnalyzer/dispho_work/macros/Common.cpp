@@ -679,6 +679,30 @@ namespace Common
     }  
   }
 
+  void SetupEraCuts(const std::vector<TString> & eras)
+  {
+    // run range spanning all eras: data are split by era afterwards
+    auto startRun = Common::EraMap[eras.front()].startRun;
+    auto endRun   = Common::EraMap[eras.front()].endRun;
+    for (const auto & era : eras)
+    {
+      const auto & erainfo = Common::EraMap[era];
+      startRun = std::min(startRun,erainfo.startRun);
+      endRun   = std::max(endRun  ,erainfo.endRun);
+    }
+
+    for (auto & CutWgtPair : Common::CutWgtMap)
+    {
+      const auto & sample = CutWgtPair.first;
+      auto & cutwgt = CutWgtPair.second;
+    
+      if (Common::GroupMap[sample] != SampleGroup::isData) continue;
+
+      // add era cut for data
+      cutwgt += Form("&&(run>=%i&&run<=%i)",startRun,endRun);
+    }
+  }
+
   void SetupVarWgts(const TString & varwgtmapconfig)
   {
     std::cout << "Reading varwgtmap config..." << std::endl;
@@ -726,8 +750,7 @@ namespace Common
   void SetupEraWeights(const TString & era)
   {
     // get era info
-    const auto & erainfo = Common::EraMap[era];
-    const auto frac = erainfo.lumi / Common::EraMap["Full"].lumi;
+    const auto frac = Common::GetEraWeight(era);
 
     // multiply cut string by fractional lumi
     for (auto & CutWgtPair : Common::CutWgtMap)
@@ -742,6 +765,14 @@ namespace Common
     } 
   }
 
+  Float_t GetEraWeight(const TString & era)
+  {
+    // fractional lumi, to the precision it is applied in the cut string
+    const auto & erainfo = Common::EraMap[era];
+    const auto frac = erainfo.lumi / Common::EraMap["Full"].lumi;
+    return std::atof(Form("%6.3f",frac));
+  }
+
   void SetupBins(std::string & str, std::vector<Double_t> & bins, Bool_t & var_bins)
   {
     if      (str.find("CONSTANT") != std::string::npos)
@@ -919,35 +950,23 @@ namespace Common
     }
   }
   
-  TH1F * SetupOutCutFlowHist(const TH1F * inhist, const TString & outname, std::map<TString,Int_t> & binlabels)
+  TH1F * SetupOutCutFlowHist(const TH1F * inhist, const TString & outname, CutFlow & cutflow)
   {
-    // get cut flow labels
-    const auto inNbinsX = inhist->GetNbinsX();
-    for (auto ibin = 1; ibin <= inNbinsX; ibin++) binlabels[inhist->GetXaxis()->GetBinLabel(ibin)] = ibin;
-    
-    Int_t inNbinsX_new = inNbinsX;
-    for (const auto & SignalCutFlowPair : Common::CutFlowPairVec) binlabels[SignalCutFlowPair.first] = ++inNbinsX_new;
-  
+    // get cut flow labels, then one slot per cut in the order they are applied
+    cutflow.Inherit(inhist);
+    for (const auto & CutFlowPair : Common::CutFlowPairVec) cutflow.Register(CutFlowPair.first.Data());
+
     // make new cut flow
-    auto outhist = new TH1F(outname.Data(),inhist->GetTitle(),binlabels.size(),0,binlabels.size());
-    outhist->Sumw2();
-    
-    for (const auto & binlabel : binlabels)
-    {
-      const auto & cut = binlabel.first;
-      const auto ibin = binlabel.second;
-      
-      outhist->GetXaxis()->SetBinLabel(ibin,cut.Data());
-      
-      if (ibin > inNbinsX) continue;
-      
-      outhist->SetBinContent(ibin,inhist->GetBinContent(ibin));
-      outhist->SetBinError(ibin,inhist->GetBinError(ibin));
-    }
-    
-    outhist->GetYaxis()->SetTitle(inhist->GetYaxis()->GetTitle());
-    
-    return outhist;
+    return cutflow.MakeHist(outname,inhist->GetTitle(),inhist);
+  }
+
+  TString GetSkimFileName(const TString & inskimdir, const TString & input)
+  {
+    if (inskimdir.BeginsWith("/")) return Form("%s/%s/%s",inskimdir.Data(),input.Data(),Common::tupleFileName.Data());
+
+    const auto localdir = std::getenv("DISPHO_EOS_DIR");
+    const TString eosdir = ((localdir != NULL && localdir[0] != '\0') ? localdir : Common::eosDir.Data());
+    return Form("%s/%s/%s/%s/%s",eosdir.Data(),Common::baseDir.Data(),inskimdir.Data(),input.Data(),Common::tupleFileName.Data());
   }
 
   void CheckValidFile(const TFile * file, const TString & filename)
@@ -1209,6 +1228,129 @@ namespace Common
     }
   }
 
+  void ScaleBoot(TH2F * boot, const TH1 * hist, const Bool_t isUp, const Bool_t varBinsX, const Bool_t varBinsY)
+  {
+    std::cout << "Scaling " << (isUp?"up":"down") << " bootstrap replicas: " << boot->GetName() << std::endl;
+
+    const Bool_t is2D  = (hist->GetDimension() == 2);
+    const auto nbinsY  = (is2D ? hist->GetYaxis()->GetNbins() : 1);
+    const auto nboot   = boot->GetYaxis()->GetNbins();
+
+    for (auto ibinX = 1; ibinX <= hist->GetXaxis()->GetNbins(); ibinX++)
+    {
+      for (auto ibinY = 1; ibinY <= nbinsY; ibinY++)
+      {
+	// same multiplier as the nominal gets
+	auto multiplier = 1.f;
+	if (varBinsX)         multiplier *= hist->GetXaxis()->GetBinWidth(ibinX);
+	if (varBinsY && is2D) multiplier *= hist->GetYaxis()->GetBinWidth(ibinY);
+
+	const auto cell = (is2D ? hist->GetBin(ibinX,ibinY) : hist->GetBin(ibinX));
+	for (auto iboot = 1; iboot <= nboot; iboot++)
+	{
+	  const auto content = boot->GetBinContent(cell+1,iboot);
+	  boot->SetBinContent(cell+1,iboot,(isUp ? content*multiplier : content/multiplier));
+	}
+      }
+    }
+  }
+
+  std::vector<Double_t> GetBootIntegrals(const TH1 * hist, const TH2F * boot, const Bool_t VarBins)
+  {
+    const Bool_t is2D = (hist->GetDimension() == 2);
+    const auto nbinsY = (is2D ? hist->GetYaxis()->GetNbins() : 1);
+    const auto nboot  = boot->GetYaxis()->GetNbins();
+
+    // mirrors hist->Integral(VarBins?"width":""): no under/overflow
+    std::vector<Double_t> integrals(nboot,0.0);
+    for (auto ibinX = 1; ibinX <= hist->GetXaxis()->GetNbins(); ibinX++)
+    {
+      for (auto ibinY = 1; ibinY <= nbinsY; ibinY++)
+      {
+	auto width = 1.0;
+	if (VarBins) width = hist->GetXaxis()->GetBinWidth(ibinX) * (is2D ? hist->GetYaxis()->GetBinWidth(ibinY) : 1.0);
+
+	const auto cell = (is2D ? hist->GetBin(ibinX,ibinY) : hist->GetBin(ibinX));
+	for (auto iboot = 0; iboot < nboot; iboot++)
+	{
+	  integrals[iboot] += boot->GetBinContent(cell+1,iboot+1) * width;
+	}
+      }
+    }
+
+    return integrals;
+  }
+
+  Float_t GetBootRMS(const std::vector<Float_t> & values)
+  {
+    if (values.size() < 2) return 0.f;
+
+    auto mean = 0.0;
+    for (const auto value : values) mean += value;
+    mean /= values.size();
+
+    auto var = 0.0;
+    for (const auto value : values) var += (value-mean)*(value-mean);
+    var /= (values.size()-1);
+
+    return std::sqrt(var);
+  }
+
+  Bool_t SetupCRBootHists(const TString & CR, TFile *& infile, std::map<TString,TH2F*> & BootMap, std::map<TString,TH2F*> & BootMapTmp)
+  {
+    std::cout << "Setting up CR bootstrap replicas for: " << CR.Data() << std::endl;
+
+    // replicas are optional: missing ones just mean no bootstrap spread
+    Bool_t found = true;
+
+    // Get Data
+    auto & boot = BootMap[CR];
+    boot = (TH2F*)infile->Get(Form("%s_boot",Common::HistNameMap["Data"].Data()));
+    if (boot) boot->SetName(Form("%s_CR_%s",CR.Data(),boot->GetName()));
+    else found = false;
+
+    // Get Bkgd MC Histograms
+    for (const auto & BkgdHistNamePair : Common::BkgdHistNameMap)
+    {
+      const auto & sample   = BkgdHistNamePair.first;
+      const auto & histname = BkgdHistNamePair.second;
+
+      auto & bootTmp = BootMapTmp[Form("%s_CR_%s",CR.Data(),sample.Data())];
+
+      bootTmp = (TH2F*)infile->Get(Form("%s_boot",histname.Data()));
+      if (bootTmp) bootTmp->SetName(Form("%s_CR_%s",CR.Data(),bootTmp->GetName()));
+      else found = false;
+    }
+
+    if (!found) std::cout << "No bootstrap replicas in: " << infile->GetName() << std::endl;
+    return found;
+  }
+
+  Bool_t SetupSRMCBootHists(TFile *& infile, std::map<TString,TH2F*> & BootMapTmp)
+  {
+    std::cout << "Setting up SR MC bootstrap replicas..." << std::endl;
+
+    Bool_t found = true;
+
+    // Get Bkgd MC Histograms
+    for (const auto & BkgdHistNamePair : Common::BkgdHistNameMap)
+    {
+      const auto & sample   = BkgdHistNamePair.first;
+      const auto & histname = BkgdHistNamePair.second;
+
+      if (!Common::IsCR(sample)) continue;
+
+      auto & bootTmp = BootMapTmp[Form("SR_%s",sample.Data())];
+
+      bootTmp = (TH2F*)infile->Get(Form("%s_boot",histname.Data()));
+      if (bootTmp) bootTmp->SetName(Form("SR_%s",bootTmp->GetName()));
+      else found = false;
+    }
+
+    if (!found) std::cout << "No bootstrap replicas in: " << infile->GetName() << std::endl;
+    return found;
+  }
+
   void SaveAs(TCanvas *& canv, const TString & label)
   {
     canv->cd();
@@ -27,8 +27,15 @@
 #include <cstdlib>
 #include <utility>
 #include <algorithm>
+#include <cmath>
 #include <sys/stat.h>
 
+// Cut flow accounting, shared with the ntuplizer
+#include "../../plugins/CutFlow.hh"
+
+// Scoped timers and counters, dumped at the end of each run
+#include "../../plugins/Profiler.hh"
+
 // ECAL Enums
 enum ECAL {EB, EM, EP, NONE};
 
@@ -145,11 +152,13 @@ namespace Common
   static const TString rootdir        = "tree";
   static const TString configtreename = "configtree";
   static const TString disphotreename = "disphotree";
+  static const TString manifestTreeName = "manifest";
   static const TString h_cutflowname  = "h_cutflow";
   static const TString pavename       = "Config";
 
   static const TString h_cutflow_wgtname    = Common::h_cutflowname+"_wgt";
   static const TString h_cutflow_scaledname = Common::h_cutflowname+"_scaled";
+  static const TString h_cutflow_timename   = Common::h_cutflowname+"_time";
 
   static const Int_t   nPUBins        = 150;
   static const TString dataPUFileName = "datapu";
@@ -212,9 +221,11 @@ namespace Common
   void SetupCuts(const TString & cutconfig);
   void SetupCutFlow(const TString & cutflowconfig);
   void SetupEraCuts(const TString & era);
+  void SetupEraCuts(const std::vector<TString> & eras);
   void SetupVarWgts(const TString & varwgtconfig);
   void SetupWeights();
   void SetupEraWeights(const TString & era);
+  Float_t GetEraWeight(const TString & era);
   void RemoveData();
   void KeepOnlySamples(const std::vector<TString> & samplevec);
   void KeepOnlySignals();
@@ -232,7 +243,11 @@ namespace Common
   void SetupWhichSignals(const std::string & str, std::vector<TString> & signalvec);
 
   // cutflow histograms
-  TH1F * SetupOutCutFlowHist(const TH1F * inhist, const TString & outname, std::map<TString,Int_t> & binlabels);
+  TH1F * SetupOutCutFlowHist(const TH1F * inhist, const TString & outname, CutFlow & cutflow);
+
+  // skim file of an input: eosDir/baseDir/<inskimdir>/<input>/tree.root, or <inskimdir>/<input>/tree.root for an absolute inskimdir;
+  // DISPHO_EOS_DIR set: a local mirror of eosDir (same layout) is read instead, e.g. to test offline
+  TString GetSkimFileName(const TString & inskimdir, const TString & input);
   
   // skim input
   constexpr UInt_t nEvCheck = 10000;
@@ -292,6 +307,13 @@ namespace Common
   void Scale(TH1F *& hist, const Bool_t isUp);
   void Scale(TGraphAsymmErrors *& graph, const std::vector<Double_t> & bins, const Bool_t isUp);
 
+  // Bootstrap replicas from SystFiller: <hist>_boot, with x = global cell of hist, y = replica
+  void ScaleBoot(TH2F * boot, const TH1 * hist, const Bool_t isUp, const Bool_t varBinsX, const Bool_t varBinsY);
+  std::vector<Double_t> GetBootIntegrals(const TH1 * hist, const TH2F * boot, const Bool_t VarBins);
+  Float_t GetBootRMS(const std::vector<Float_t> & values);
+  Bool_t SetupCRBootHists(const TString & CR, TFile *& infile, std::map<TString,TH2F*> & BootMap, std::map<TString,TH2F*> & BootMapTmp);
+  Bool_t SetupSRMCBootHists(TFile *& infile, std::map<TString,TH2F*> & BootMapTmp);
+
   // Check inputs
   void CheckValidFile(const TFile * file, const TString & filename);
   Bool_t isGoodFile(const TFile * file, const TString & filename);
@@ -487,6 +509,69 @@ namespace Common
     }
   }
 
+  // same k- and x-factors as above, once per bootstrap replica: returns their spread
+  template <typename T>
+  void GetBootFactorsFromCR(const TString & CR, const T & HistMap, const T & HistMapTmp,
+			    const std::map<TString,TH2F*> & BootMap, const std::map<TString,TH2F*> & BootMapTmp,
+			    const Bool_t VarBins, Float_t & kFactorErr, Float_t & xFactorErr)
+  {
+    std::cout << "Computing bootstrap spread of k- and x-factors for: " << CR.Data() << std::endl;
+
+    // data in CR
+    const auto numers = Common::GetBootIntegrals(HistMap.at(CR),BootMap.at(CR),VarBins);
+    const auto nboot  = numers.size();
+
+    // all bkgd MC in CR, and CR MC in CR
+    std::vector<Double_t> denoms(nboot,0.0);
+    std::vector<Double_t> cr_ints(nboot,0.0);
+    for (const auto & HistPair : HistMapTmp)
+    {
+      const auto & key  = HistPair.first;
+      const auto & hist = HistPair.second;
+      
+      if (key.Contains("SR",TString::kExact)) continue; // skip SR plots
+      if (!key.Contains(Form("%s_CR",CR.Data()),TString::kExact)) continue; // skip other CR
+
+      const auto ints = Common::GetBootIntegrals(hist,BootMapTmp.at(key),VarBins);
+      for (auto iboot = 0U; iboot < nboot; iboot++) denoms[iboot] += ints[iboot];
+
+      if (key.Contains(Form("%s_CR_%s",CR.Data(),CR.Data()),TString::kExact)) cr_ints = ints;
+    }
+
+    // CR MC in SR
+    const TString srkey = Form("SR_%s",CR.Data());
+    const auto sr_ints = Common::GetBootIntegrals(HistMapTmp.at(srkey),BootMapTmp.at(srkey),VarBins);
+
+    std::vector<Float_t> kFactors, xFactors;
+    for (auto iboot = 0U; iboot < nboot; iboot++)
+    {
+      const Float_t kFactor = numers[iboot] / denoms[iboot];
+      kFactors.emplace_back(kFactor);
+      xFactors.emplace_back(sr_ints[iboot] / (kFactor * cr_ints[iboot]));
+    }
+
+    kFactorErr = Common::GetBootRMS(kFactors);
+    xFactorErr = Common::GetBootRMS(xFactors);
+  }
+
+  template <typename T>
+  void GetBootFactorsFromCRs(const T & HistMap, const T & HistMapTmp,
+			     const std::map<TString,TH2F*> & BootMap, const std::map<TString,TH2F*> & BootMapTmp, const Bool_t VarBins,
+			     std::map<TString,Float_t> & KFErrMap, std::map<TString,Float_t> & XFErrMap)
+  {
+    std::cout << "Computing bootstrap spread of factors in each CR..." << std::endl;
+
+    for (const auto & BkgdGroupPair : Common::BkgdGroupMap)
+    {
+      const auto & sample = BkgdGroupPair.first;
+
+      if (!Common::IsCR(sample)) continue;
+
+      const auto & CR = sample;
+      GetBootFactorsFromCR(CR,HistMap,HistMapTmp,BootMap,BootMapTmp,VarBins,KFErrMap[CR],XFErrMap[CR]);
+    }
+  }
+
   // common function for deleting map pairs that are dynamically allocated
   template <typename T>
   void DeleteMap(T & Map)
@@ -0,0 +1,227 @@
+#include "DelayTemplates.hh"
+
+DelayTemplates::DelayTemplates(const TString & infilename, const TString & outfiletext,
+			       const Int_t nbins, const Float_t xlow, const Float_t xhigh, const UInt_t batchsize) :
+  fInFileName(infilename), fOutFileText(outfiletext),
+  fNBins(nbins), fXLow(xlow), fXHigh(xhigh), fBatchSize(batchsize)
+{
+  std::cout << "Initializing DelayTemplates..." << std::endl;
+
+  // get input (signal skim)
+  fInFile = TFile::Open(Form("%s",fInFileName.Data()));
+  Common::CheckValidFile(fInFile,fInFileName);
+
+  // setup output
+  fOutFile = TFile::Open(Form("%s.root",fOutFileText.Data()),"RECREATE");
+
+  // setup config
+  DelayTemplates::SetupCommon();
+
+  // batch buffers
+  fInputs.reserve(fBatchSize);
+}
+
+DelayTemplates::~DelayTemplates()
+{
+  std::cout << "Tidying up in destructor..." << std::endl;
+
+  for (auto & TemplatePair : fTemplates)
+  {
+    auto & dtemplate = TemplatePair.second;
+    delete dtemplate.hist_det;
+    delete dtemplate.hist_path;
+    delete dtemplate.hist_time_EE;
+    delete dtemplate.hist_time_EB;
+    delete dtemplate.hist_time;
+  }
+
+  delete fOutFile;
+  delete fInFile;
+}
+
+void DelayTemplates::SetupCommon()
+{
+  std::cout << "Setting up Common..." << std::endl;
+
+  Common::SetupSignalSamples();
+  Common::SetupGroups();
+  Common::SetupSignalGroups();
+  Common::SetupTreeNames();
+}
+
+void DelayTemplates::MakeDelayTemplates()
+{
+  std::cout << "Making delay templates for each (Lambda,ctau) point..." << std::endl;
+
+  for (const auto & SignalGroupPair : Common::SignalGroupMap)
+  {
+    const auto & sample = SignalGroupPair.first;
+    const auto & group  = SignalGroupPair.second;
+    if (group != "GMSB") continue;
+
+    DelayTemplates::MakeTemplate(sample);
+  }
+
+  DelayTemplates::DumpSummary();
+}
+
+void DelayTemplates::MakeTemplate(const TString & sample)
+{
+  const auto & treename = Common::TreeNameMap[sample];
+  std::cout << "Working on tree: " << treename.Data() << std::endl;
+
+  auto tree = (TTree*)fInFile->Get(Form("%s",treename.Data()));
+  if (Common::IsNullTree(tree))
+  {
+    std::cout << "Skipping null tree..." << std::endl;
+    delete tree;
+    return;
+  }
+
+  // gen branches only
+  Int_t nNeutoPhGr = 0;
+  std::vector<GenDelayInputs> gens(Common::nGMSBs);
+  DelayTemplates::SetupBranches(tree,nNeutoPhGr,gens);
+
+  auto & dtemplate = fTemplates[sample];
+  DelayTemplates::SetupTemplate(sample,dtemplate);
+
+  // fill the SoA inputs, and run the kernel once per batch
+  fInputs.clear();
+  const auto nEntries = tree->GetEntries();
+  for (Long64_t entry = 0; entry < nEntries; entry++)
+  {
+    if (entry%Common::nEvCheck == 0 || entry == 0) std::cout << "Processing Entry: " << entry << " out of " << nEntries << std::endl;
+    tree->GetEntry(entry);
+
+    const auto ngmsbs = std::min(nNeutoPhGr,Common::nGMSBs);
+    for (auto igmsb = 0; igmsb < ngmsbs; igmsb++)
+    {
+      const auto & gen = gens[igmsb];
+      if (gen.genNmass <= 0.f) continue;
+
+      // parent momentum from (pt,eta)
+      const auto genNp = gen.genNpt*std::cosh(gen.genNeta);
+      const auto t0    = ArrivalTime::DecayTime(gen.genNprodvx,gen.genNprodvy,gen.genNprodvz,
+					        gen.genNdecayvx,gen.genNdecayvy,gen.genNdecayvz,genNp,gen.genNE);
+
+      fInputs.emplace_back(gen.genNdecayvx,gen.genNdecayvy,gen.genNdecayvz,gen.genpheta,gen.genphphi,t0);
+    }
+    if (fInputs.size() >= fBatchSize) DelayTemplates::FillBatch(dtemplate);
+  }
+  DelayTemplates::FillBatch(dtemplate);
+
+  // templates are shapes
+  for (auto hist : {dtemplate.hist_time,dtemplate.hist_time_EB,dtemplate.hist_time_EE,dtemplate.hist_path})
+  {
+    if (hist->Integral() > 0.0) hist->Scale(1.0/hist->Integral());
+  }
+
+  fOutFile->cd();
+  dtemplate.hist_time   ->Write(dtemplate.hist_time   ->GetName(),TObject::kWriteDelete);
+  dtemplate.hist_time_EB->Write(dtemplate.hist_time_EB->GetName(),TObject::kWriteDelete);
+  dtemplate.hist_time_EE->Write(dtemplate.hist_time_EE->GetName(),TObject::kWriteDelete);
+  dtemplate.hist_path   ->Write(dtemplate.hist_path   ->GetName(),TObject::kWriteDelete);
+  dtemplate.hist_det    ->Write(dtemplate.hist_det    ->GetName(),TObject::kWriteDelete);
+
+  delete tree;
+}
+
+void DelayTemplates::SetupTemplate(const TString & sample, DelayTemplate & dtemplate)
+{
+  // GMSB_L<lambda>_CTau<ctau>
+  const TString s_lambda = "_L";
+  const TString s_ctau   = "_CTau";
+  const auto i_lambda = sample.Index(s_lambda);
+  const auto i_ctau   = sample.Index(s_ctau);
+  dtemplate.lambda = sample(i_lambda+s_lambda.Length(),i_ctau-i_lambda-s_lambda.Length());
+  dtemplate.ctau   = sample(i_ctau+s_ctau.Length(),sample.Length()-i_ctau-s_ctau.Length());
+
+  const TString title = "GMSB #Lambda:"+dtemplate.lambda+"TeV c#tau:"+dtemplate.ctau+"cm";
+
+  dtemplate.hist_time    = new TH1F(sample+"_arrival_time",title+";Photon Arrival Time [ns];Fraction of Photons",fNBins,fXLow,fXHigh);
+  dtemplate.hist_time_EB = new TH1F(sample+"_arrival_time_EB",title+" (EB);Photon Arrival Time [ns];Fraction of Photons",fNBins,fXLow,fXHigh);
+  dtemplate.hist_time_EE = new TH1F(sample+"_arrival_time_EE",title+" (EE);Photon Arrival Time [ns];Fraction of Photons",fNBins,fXLow,fXHigh);
+  dtemplate.hist_path    = new TH1F(sample+"_path",title+";Decay Vertex to ECAL [cm];Fraction of Photons",100,0.f,400.f);
+  dtemplate.hist_det     = new TH1F(sample+"_arrival_det",title+";;nPhotons",3,0,3);
+
+  const std::vector<TString> labels = {"EB","EE","Missed"};
+  for (auto ibin = 1; ibin <= dtemplate.hist_det->GetNbinsX(); ibin++) dtemplate.hist_det->GetXaxis()->SetBinLabel(ibin,labels[ibin-1]);
+
+  for (auto hist : {dtemplate.hist_time,dtemplate.hist_time_EB,dtemplate.hist_time_EE,dtemplate.hist_path,dtemplate.hist_det})
+  {
+    hist->Sumw2();
+    hist->SetDirectory(0);
+  }
+}
+
+void DelayTemplates::SetupBranches(TTree * tree, Int_t & nNeutoPhGr, std::vector<GenDelayInputs> & gens)
+{
+  // do not read anything else off disk
+  tree->SetBranchStatus("*",0);
+
+  auto activate = [&](const TString & name, void * address)
+  {
+    tree->SetBranchStatus(name.Data(),1);
+    tree->SetBranchAddress(name.Data(),address);
+  };
+
+  activate("nNeutoPhGr",&nNeutoPhGr);
+  for (auto igmsb = 0; igmsb < Common::nGMSBs; igmsb++)
+  {
+    auto & gen = gens[igmsb];
+    activate(Form("genNmass_%i",igmsb),&gen.genNmass);
+    activate(Form("genNE_%i",igmsb),&gen.genNE);
+    activate(Form("genNpt_%i",igmsb),&gen.genNpt);
+    activate(Form("genNeta_%i",igmsb),&gen.genNeta);
+    activate(Form("genNprodvx_%i",igmsb),&gen.genNprodvx);
+    activate(Form("genNprodvy_%i",igmsb),&gen.genNprodvy);
+    activate(Form("genNprodvz_%i",igmsb),&gen.genNprodvz);
+    activate(Form("genNdecayvx_%i",igmsb),&gen.genNdecayvx);
+    activate(Form("genNdecayvy_%i",igmsb),&gen.genNdecayvy);
+    activate(Form("genNdecayvz_%i",igmsb),&gen.genNdecayvz);
+    activate(Form("genpheta_%i",igmsb),&gen.genpheta);
+    activate(Form("genphphi_%i",igmsb),&gen.genphphi);
+  }
+}
+
+void DelayTemplates::FillBatch(DelayTemplate & dtemplate)
+{
+  if (fInputs.size() == 0) return;
+
+  ArrivalTime::Compute(fInputs,fOutputs);
+
+  for (auto i = 0U; i < fInputs.size(); i++)
+  {
+    const auto det = fOutputs.det[i];
+    dtemplate.hist_det->Fill(det);
+    if (det == ArrivalTime::Missed) continue;
+
+    const auto time = fOutputs.time[i];
+    dtemplate.hist_time->Fill(time);
+    (det == ArrivalTime::EB ? dtemplate.hist_time_EB : dtemplate.hist_time_EE)->Fill(time);
+    dtemplate.hist_path->Fill(fOutputs.path[i]);
+  }
+
+  fInputs.clear();
+}
+
+void DelayTemplates::DumpSummary()
+{
+  const TString filename = fOutFileText+"."+Common::outTextExt;
+  std::ofstream outfile(filename.Data(),std::ios_base::trunc);
+  std::cout << "Writing summary to: " << filename.Data() << std::endl;
+
+  outfile << "Lambda[TeV] ctau[cm] nPhotons fracEB fracEE fracMissed meanTime[ns] rmsTime[ns]" << std::endl;
+  for (const auto & TemplatePair : fTemplates)
+  {
+    const auto & dtemplate = TemplatePair.second;
+    const auto & hist_det  = dtemplate.hist_det;
+    const auto ntot = hist_det->Integral();
+    const auto frac = [&](const Int_t ibin){return (ntot > 0.0 ? hist_det->GetBinContent(ibin)/ntot : 0.0);};
+
+    outfile << dtemplate.lambda.Data() << " " << dtemplate.ctau.Data() << " " << ntot << " "
+	    << frac(1) << " " << frac(2) << " " << frac(3) << " "
+	    << dtemplate.hist_time->GetMean() << " " << dtemplate.hist_time->GetRMS() << std::endl;
+  }
+}
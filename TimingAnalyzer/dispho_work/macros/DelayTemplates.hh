@@ -0,0 +1,83 @@
+#ifndef __DelayTemplates__
+#define __DelayTemplates__
+
+// ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TH1F.h"
+#include "TString.h"
+
+// STL includes
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <map>
+
+// Common include
+#include "Common.hh"
+#include "../../plugins/ArrivalTime.hh"
+
+// gen-level inputs per neutralino, read with only these branches active
+struct GenDelayInputs
+{
+  Float_t genNmass, genNE, genNpt, genNeta;
+  Float_t genNprodvx, genNprodvy, genNprodvz;
+  Float_t genNdecayvx, genNdecayvy, genNdecayvz;
+  Float_t genpheta, genphphi;
+};
+
+struct DelayTemplate
+{
+  TString lambda;
+  TString ctau;
+
+  TH1F * hist_time;
+  TH1F * hist_time_EB;
+  TH1F * hist_time_EE;
+  TH1F * hist_path;
+  TH1F * hist_det;
+};
+
+class DelayTemplates
+{
+public:
+  DelayTemplates(const TString & infilename, const TString & outfiletext,
+		 const Int_t nbins = 120, const Float_t xlow = -2.f, const Float_t xhigh = 28.f, const UInt_t batchsize = 4096);
+  ~DelayTemplates();
+
+  // Setup
+  void SetupCommon();
+
+  // Main call
+  void MakeDelayTemplates();
+
+  // Subroutines
+  void MakeTemplate(const TString & sample);
+  void SetupTemplate(const TString & sample, DelayTemplate & dtemplate);
+  void SetupBranches(TTree * tree, Int_t & nNeutoPhGr, std::vector<GenDelayInputs> & gens);
+  void FillBatch(DelayTemplate & dtemplate);
+  void DumpSummary();
+
+private:
+  // Settings
+  const TString fInFileName;
+  const TString fOutFileText;
+  const Int_t   fNBins;
+  const Float_t fXLow;
+  const Float_t fXHigh;
+  const UInt_t  fBatchSize;
+
+  // Input
+  TFile * fInFile;
+
+  // Batch buffers: reused across samples
+  ArrivalTime::Inputs  fInputs;
+  ArrivalTime::Outputs fOutputs;
+
+  // Output
+  TFile * fOutFile;
+  std::map<TString,DelayTemplate> fTemplates;
+};
+
+#endif
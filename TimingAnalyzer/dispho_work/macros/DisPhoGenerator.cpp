@@ -0,0 +1,1334 @@
+// Class include
+#include "DisPhoGenerator.hh"
+
+DisPhoGenerator::DisPhoGenerator(const TString & genconfig, const TString & outfilename)
+  : fGenConfig(genconfig), fOutFileName(outfilename)
+{
+  std::cout << "Initializing DisPhoGenerator..." << std::endl;
+
+  ////////////////
+  //            //
+  // Initialize //
+  //            //
+  ////////////////
+
+  // init configuration
+  DisPhoGenerator::SetupDefaults();
+  DisPhoGenerator::SetupGenConfig();
+  DisPhoGenerator::SetupConfig();
+
+  // need run ranges
+  Common::SetupEras();
+  if (!Common::EraMap.count(fEra))
+  {
+    std::cerr << "Aye... your gen config is messed up, era: " << fEra.Data() << " is not known! Exiting..." << std::endl;
+    exit(1);
+  }
+
+  // random numbers: same seed, same file
+  fRand = new TRandom3(fSeed);
+
+  // output file: everything lives in the same dir as in the DisPho output
+  fOutFile = TFile::Open(Form("%s",fOutFileName.Data()),"RECREATE");
+  Common::CheckValidFile(fOutFile,fOutFileName);
+  fOutFile->mkdir(Common::rootdir.Data());
+  fOutFile->cd(Common::rootdir.Data());
+
+  DisPhoGenerator::InitOutHists();
+  DisPhoGenerator::InitOutConfigTree();
+  DisPhoGenerator::InitOutTree();
+}
+
+DisPhoGenerator::~DisPhoGenerator()
+{
+  std::cout << "Tidying up in the destructor..." << std::endl;
+
+  for (auto & pho : fPhos) delete pho.recHits;
+
+  delete fRecHits.X;
+  delete fRecHits.Y;
+  delete fRecHits.Z;
+  delete fRecHits.E;
+  delete fRecHits.time;
+  delete fRecHits.timeErr;
+  delete fRecHits.TOF;
+  delete fRecHits.ID;
+  delete fRecHits.isOOT;
+  delete fRecHits.isGS6;
+  delete fRecHits.isGS1;
+  delete fRecHits.adcToGeV;
+  delete fRecHits.ped12;
+  delete fRecHits.ped6;
+  delete fRecHits.ped1;
+  delete fRecHits.pedrms12;
+  delete fRecHits.pedrms6;
+  delete fRecHits.pedrms1;
+
+  delete fOutFile; // owns the trees and hists
+  delete fRand;
+}
+
+void DisPhoGenerator::Generate()
+{
+  std::cout << "Generating " << fNEvents << " events into: " << fOutFileName.Data() << std::endl;
+
+  for (auto ievent = 0ULL; ievent < fNEvents; ievent++)
+  {
+    // dump status check
+    if (ievent%Common::nEvCheck == 0 || ievent == 0) std::cout << "Processing Event: " << ievent << " out of " << fNEvents << std::endl;
+
+    // start the clock for the first cut
+    fCutFlow.StartEvent();
+
+    DisPhoGenerator::GenerateEvent(ievent);
+
+    // generated events pass the full DisPho selection
+    const auto wgt = (fIsMC ? fEvent.genwgt : 1.f);
+    for (const auto slot : fCutSlots) fCutFlow.Pass(slot,wgt);
+
+    // PU hists are filled before any selection in DisPho, which is the same thing here
+    if (fIsMC)
+    {
+      fGenPUObsHist    ->Fill(fEvent.genpuobs);
+      fGenPUObsWgtHist ->Fill(fEvent.genpuobs,wgt);
+      fGenPUTrueHist   ->Fill(fEvent.genputrue);
+      fGenPUTrueWgtHist->Fill(fEvent.genputrue,wgt);
+    }
+
+    fOutTree->Fill();
+  }
+
+  // export the cut flow
+  fOutFile->cd(Common::rootdir.Data());
+  fCutFlow.Export(fCutFlowHist,fCutFlowWgtHist,NULL);
+  auto cutflowtime = fCutFlow.MakeTimeHist(Common::h_cutflow_timename);
+  fCutFlow.Dump();
+
+  // write it all out
+  fCutFlowHist->Write(fCutFlowHist->GetName(),TObject::kWriteDelete);
+  fCutFlowWgtHist->Write(fCutFlowWgtHist->GetName(),TObject::kWriteDelete);
+  cutflowtime->Write(cutflowtime->GetName(),TObject::kWriteDelete);
+  if (fIsMC)
+  {
+    fGenPUObsHist->Write(fGenPUObsHist->GetName(),TObject::kWriteDelete);
+    fGenPUObsWgtHist->Write(fGenPUObsWgtHist->GetName(),TObject::kWriteDelete);
+    fGenPUTrueHist->Write(fGenPUTrueHist->GetName(),TObject::kWriteDelete);
+    fGenPUTrueWgtHist->Write(fGenPUTrueWgtHist->GetName(),TObject::kWriteDelete);
+  }
+  fOutConfigTree->Write(fOutConfigTree->GetName(),TObject::kWriteDelete);
+  fOutTree->Write(fOutTree->GetName(),TObject::kWriteDelete);
+
+  // sum of weights is the input for the skimmer
+  std::cout << "Finished generating, sum of weights: " << fCutFlowWgtHist->GetBinContent(1) << std::endl;
+}
+
+void DisPhoGenerator::GenerateEvent(const ULong64_t ievent)
+{
+  // clear out the vectors
+  fJets.E_f.clear();
+  fJets.pt_f.clear();
+  fJets.phi_f.clear();
+  fJets.eta_f.clear();
+  fJets.ID_i.clear();
+  fJets.NHF_f.clear();
+  fJets.NEMF_f.clear();
+  fJets.CHF_f.clear();
+  fJets.CEMF_f.clear();
+  fJets.MUF_f.clear();
+  fJets.NHM_f.clear();
+  fJets.CHM_f.clear();
+  fExtras.jetscaleRel.clear();
+  fExtras.jetsmearSF.clear();
+  fExtras.jetsmearDownSF.clear();
+  fExtras.jetsmearUpSF.clear();
+  fExtras.jetisGen.clear();
+
+  fRecHits.X->clear();
+  fRecHits.Y->clear();
+  fRecHits.Z->clear();
+  fRecHits.E->clear();
+  fRecHits.time->clear();
+  fRecHits.timeErr->clear();
+  fRecHits.TOF->clear();
+  fRecHits.ID->clear();
+  fRecHits.isOOT->clear();
+  fRecHits.isGS6->clear();
+  fRecHits.isGS1->clear();
+  fRecHits.adcToGeV->clear();
+  fRecHits.ped12->clear();
+  fRecHits.ped6->clear();
+  fRecHits.ped1->clear();
+  fRecHits.pedrms12->clear();
+  fRecHits.pedrms6->clear();
+  fRecHits.pedrms1->clear();
+
+  // event level info first: photons need the vertex
+  DisPhoGenerator::GenerateEventInfo(ievent);
+  DisPhoGenerator::GenerateJets();
+
+  // photons: from LLPs, then prompt ones
+  std::vector<GenPhoton> genphos;
+  if (fIsGMSB || fIsHVDS) DisPhoGenerator::GenerateLLPs(genphos);
+  DisPhoGenerator::GeneratePhotons(genphos);
+  if (fIsToy) DisPhoGenerator::GenerateToys();
+
+  // rest of the occupancy
+  DisPhoGenerator::GenerateNoiseRecHits();
+
+  // triggers: single photon paths from the leading photon, the rest at random
+  const Float_t leadpt = (fEvent.nphotons > 0 ? fPhos[0].pt : 0.f);
+  fEvent.hltSignal = (leadpt > 60.f);
+  fEvent.hltRefPhoID = (fRand->Rndm() < 0.1);
+  fEvent.hltRefDispID = (fRand->Rndm() < 0.1);
+  fEvent.hltRefHT = (fRand->Rndm() < 0.1);
+  fEvent.hltPho50 = (leadpt > 50.f);
+  fEvent.hltPho200 = (leadpt > 200.f);
+  fEvent.hltDiPho70 = (fEvent.nphotons > 1 && fPhos[1].pt > 70.f);
+  fEvent.hltDiPho3022M90 = (fRand->Rndm() < 0.1);
+  fEvent.hltDiPho30PV18PV = (fRand->Rndm() < 0.1);
+  fEvent.hltEle32WPT = (fRand->Rndm() < 0.1);
+  fEvent.hltDiEle33MW = (fRand->Rndm() < 0.1);
+  fEvent.hltJet500 = (fRand->Rndm() < 0.1);
+}
+
+void DisPhoGenerator::GenerateEventInfo(const ULong64_t ievent)
+{
+  // run, lumi, event: data walks through the runs of the era
+  const ULong64_t ilumi = ievent / fEventsPerLumi;
+  const auto & era = Common::EraMap[fEra];
+  if (fIsMC)
+  {
+    fEvent.run  = 1;
+    fEvent.lumi = ilumi + 1;
+  }
+  else
+  {
+    const auto nruns = era.endRun - era.startRun + 1;
+    fEvent.run  = era.startRun + (ilumi / Common::genLumisPerRun) % nruns;
+    fEvent.lumi = (ilumi % Common::genLumisPerRun) + 1;
+  }
+  fEvent.event = ievent + 1;
+
+  // vertices and pileup
+  fEvent.nvtx = std::max(1,fRand->Poisson(fMeanNVtx));
+  fEvent.vtxX = fRand->Gaus(0.f,0.001f);
+  fEvent.vtxY = fRand->Gaus(0.f,0.001f);
+  fEvent.vtxZ = fRand->Gaus(0.f,3.5f);
+  fEvent.rho  = std::max(0.f,Float_t(0.55f*fEvent.nvtx + fRand->Gaus(0.f,2.f)));
+
+  // MET
+  fEvent.t1pfMETpt    = fRand->Exp(fMeanMET);
+  fEvent.t1pfMETphi   = fRand->Uniform(-Common::PI,Common::PI);
+  fEvent.t1pfMETsumEt = fEvent.t1pfMETpt + fRand->Exp(20.f*fMeanMET);
+
+  // MET flags all good, as after the standard filters
+  fEvent.metPV = true;
+  fEvent.metBeamHalo = true;
+  fEvent.metHBHENoise = true;
+  fEvent.metHBHEisoNoise = true;
+  fEvent.metECALTP = true;
+  fEvent.metPFMuon = true;
+  fEvent.metPFChgHad = true;
+  fEvent.metEESC = true;
+  fEvent.metECALCalib = true;
+
+  // gen info
+  if (fIsMC)
+  {
+    fEvent.genwgt = 1.f;
+    fEvent.genx0 = fEvent.vtxX;
+    fEvent.geny0 = fEvent.vtxY;
+    fEvent.genz0 = fEvent.vtxZ;
+    fEvent.gent0 = fRand->Gaus(0.f,0.2f);
+    fEvent.genputrue = std::min(fRand->Poisson(fMeanNVtx),Common::nPUBins-1);
+    fEvent.genpuobs  = std::min(fRand->Poisson(fEvent.genputrue),Common::nPUBins-1);
+  }
+}
+
+void DisPhoGenerator::GenerateJets()
+{
+  fEvent.njets = fRand->Poisson(fMeanNJets);
+  for (auto ijet = 0; ijet < fEvent.njets; ijet++)
+  {
+    const Float_t pt  = fConfig.jetpTmin + fRand->Exp(50.f);
+    const Float_t eta = fRand->Uniform(-fConfig.jetEtamax,fConfig.jetEtamax);
+
+    fJets.pt_f .emplace_back(pt);
+    fJets.eta_f.emplace_back(eta);
+    fJets.phi_f.emplace_back(fRand->Uniform(-Common::PI,Common::PI));
+    fJets.E_f  .emplace_back(pt*std::cosh(eta));
+    fJets.ID_i .emplace_back(fRand->Rndm() < 0.95 ? 3 : 1);
+
+    // energy fractions summing to one
+    const Float_t nh = fRand->Rndm(), nem = fRand->Rndm(), ch = fRand->Rndm(), cem = fRand->Rndm(), mu = 0.05f*fRand->Rndm();
+    const Float_t sum = nh + nem + ch + cem + mu;
+    fJets.NHF_f .emplace_back(nh /sum);
+    fJets.NEMF_f.emplace_back(nem/sum);
+    fJets.CHF_f .emplace_back(ch /sum);
+    fJets.CEMF_f.emplace_back(cem/sum);
+    fJets.MUF_f .emplace_back(mu /sum);
+    fJets.NHM_f .emplace_back(fRand->Poisson(5.0));
+    fJets.CHM_f .emplace_back(fRand->Poisson(10.0));
+
+    if (fIsMC)
+    {
+      const Float_t smearSF = fRand->Gaus(1.f,0.05f);
+      fExtras.jetscaleRel   .emplace_back(std::abs(fRand->Gaus(0.f,0.02f)));
+      fExtras.jetsmearSF    .emplace_back(smearSF);
+      fExtras.jetsmearDownSF.emplace_back(smearSF-0.05f);
+      fExtras.jetsmearUpSF  .emplace_back(smearSF+0.05f);
+      fExtras.jetisGen      .emplace_back(fRand->Rndm() < 0.9 ? 1 : 0);
+    }
+  }
+}
+
+void DisPhoGenerator::GenerateLLPs(std::vector<GenPhoton> & genphos)
+{
+  // GMSB: neutralino -> photon + gravitino; HVDS: vPion -> two photons
+  const auto nllps = (fIsGMSB ? Common::nGMSBs : Common::nHVDSs);
+  const Float_t ctau = fLLPCTau;
+  if (fIsGMSB) fEvent.nNeutoPhGr = nllps;
+  if (fIsHVDS) fEvent.nvPions = nllps;
+
+  for (auto illp = 0; illp < nllps; illp++)
+  {
+    // LLP kinematics
+    const Float_t mass = fLLPMass;
+    const Float_t pt   = fRand->Exp(0.5f*mass);
+    const Float_t eta  = fRand->Gaus(0.f,1.2f);
+    const Float_t phi  = fRand->Uniform(-Common::PI,Common::PI);
+    const Float_t px = pt*std::cos(phi), py = pt*std::sin(phi), pz = pt*std::sinh(eta);
+    const Float_t p  = Common::hypot(px,py,pz);
+    const Float_t E  = std::sqrt(p*p + mass*mass);
+    const Float_t beta = p/E, gamma = E/mass;
+    const Float_t nx = px/p, ny = py/p, nz = pz/p;
+
+    // decay vertex
+    const Float_t length = fRand->Exp(beta*gamma*ctau);
+    const Float_t dx = fEvent.vtxX + length*nx, dy = fEvent.vtxY + length*ny, dz = fEvent.vtxZ + length*nz;
+    const Float_t tdecay = length / (beta*Common::sol);
+
+    // daughters: isotropic two body decay to massless photon(s) in the rest frame, boosted along n
+    const auto ndaughters = (fIsGMSB ? 1 : 2);
+    Float_t dauE[2], dauPx[2], dauPy[2], dauPz[2];
+    const Float_t costh = fRand->Uniform(-1.f,1.f), sinth = std::sqrt(1.f-costh*costh), rphi = fRand->Uniform(-Common::PI,Common::PI);
+    for (auto idau = 0; idau < ndaughters; idau++)
+    {
+      const Float_t sign = (idau == 0 ? 1.f : -1.f);
+      const Float_t Estar = 0.5f*mass;
+      const Float_t sx = sign*Estar*sinth*std::cos(rphi), sy = sign*Estar*sinth*std::sin(rphi), sz = sign*Estar*costh;
+      const Float_t pn = sx*nx + sy*ny + sz*nz;
+      const Float_t boost = (gamma-1.f)*pn + gamma*beta*Estar;
+      dauE [idau] = gamma*(Estar + beta*pn);
+      dauPx[idau] = sx + boost*nx;
+      dauPy[idau] = sy + boost*ny;
+      dauPz[idau] = sz + boost*nz;
+    }
+
+    // photons that make it to ECAL, with the delay from the detour
+    for (auto idau = 0; idau < ndaughters; idau++)
+    {
+      Float_t x, y, z;
+      if (!DisPhoGenerator::PropagateToECAL(dx,dy,dz,dauPx[idau],dauPy[idau],dauPz[idau],x,y,z)) continue;
+
+      const Float_t arrival = tdecay + Common::hypot(x-dx,y-dy,z-dz) / Common::sol;
+      const Float_t prompt  = Common::hypot(x-fEvent.vtxX,y-fEvent.vtxY,z-fEvent.vtxZ) / Common::sol;
+      genphos.emplace_back(dauE[idau],x,y,z,arrival-prompt,illp,idau);
+    }
+
+    // gen branches: matches are set once the photons are sorted
+    const Float_t dauPt0 = std::sqrt(dauPx[0]*dauPx[0]+dauPy[0]*dauPy[0]);
+    const Float_t dauEta0 = std::asinh(dauPz[0]/dauPt0), dauPhi0 = std::atan2(dauPy[0],dauPx[0]);
+    if (fIsGMSB)
+    {
+      auto & gmsb = fGMSBs[illp];
+      gmsb.genNmass = mass;
+      gmsb.genNE = E;
+      gmsb.genNpt = pt;
+      gmsb.genNphi = phi;
+      gmsb.genNeta = eta;
+      gmsb.genNprodvx = fEvent.vtxX;
+      gmsb.genNprodvy = fEvent.vtxY;
+      gmsb.genNprodvz = fEvent.vtxZ;
+      gmsb.genNdecayvx = dx;
+      gmsb.genNdecayvy = dy;
+      gmsb.genNdecayvz = dz;
+      gmsb.genphE = dauE[0];
+      gmsb.genphpt = dauPt0;
+      gmsb.genphphi = dauPhi0;
+      gmsb.genpheta = dauEta0;
+      gmsb.genphmatch = -1;
+
+      // gravitino takes the rest
+      const Float_t grpx = px-dauPx[0], grpy = py-dauPy[0], grpz = pz-dauPz[0];
+      const Float_t grpt = std::sqrt(grpx*grpx+grpy*grpy);
+      gmsb.gengrmass = 0.f;
+      gmsb.gengrE = E-dauE[0];
+      gmsb.gengrpt = grpt;
+      gmsb.gengrphi = std::atan2(grpy,grpx);
+      gmsb.gengreta = std::asinh(grpz/grpt);
+    }
+    else
+    {
+      const Float_t dauPt1 = std::sqrt(dauPx[1]*dauPx[1]+dauPy[1]*dauPy[1]);
+      auto & hvds = fHVDSs[illp];
+      hvds.genvPionmass = mass;
+      hvds.genvPionE = E;
+      hvds.genvPionpt = pt;
+      hvds.genvPionphi = phi;
+      hvds.genvPioneta = eta;
+      hvds.genvPionprodvx = fEvent.vtxX;
+      hvds.genvPionprodvy = fEvent.vtxY;
+      hvds.genvPionprodvz = fEvent.vtxZ;
+      hvds.genvPiondecayvx = dx;
+      hvds.genvPiondecayvy = dy;
+      hvds.genvPiondecayvz = dz;
+      hvds.genHVph0E = dauE[0];
+      hvds.genHVph0pt = dauPt0;
+      hvds.genHVph0phi = dauPhi0;
+      hvds.genHVph0eta = dauEta0;
+      hvds.genHVph0match = -1;
+      hvds.genHVph1E = dauE[1];
+      hvds.genHVph1pt = dauPt1;
+      hvds.genHVph1phi = std::atan2(dauPy[1],dauPx[1]);
+      hvds.genHVph1eta = std::asinh(dauPz[1]/dauPt1);
+      hvds.genHVph1match = -1;
+    }
+  }
+}
+
+void DisPhoGenerator::GenerateToys()
+{
+  // gen photons are the reco ones, matched one to one
+  fEvent.nToyPhs = std::min(fEvent.nphotons,Common::nToys);
+  for (auto itoy = 0; itoy < Common::nToys; itoy++)
+  {
+    auto & toy = fToys[itoy];
+    const auto isToy = (itoy < fEvent.nToyPhs);
+    const auto & pho = fPhos[itoy];
+
+    toy.genphE = (isToy ? pho.E : -9999.f);
+    toy.genphpt = (isToy ? pho.pt : -9999.f);
+    toy.genphphi = (isToy ? pho.phi : -9999.f);
+    toy.genpheta = (isToy ? pho.eta : -9999.f);
+    toy.genphmatch = (isToy ? itoy : -1);
+    toy.genphmatch_ptres = (isToy ? itoy : -1);
+    toy.genphmatch_status = (isToy ? itoy : -1);
+  }
+}
+
+void DisPhoGenerator::GeneratePhotons(std::vector<GenPhoton> & genphos)
+{
+  // prompt photons fill up the multiplicity
+  const auto nprompt = std::max(0,fRand->Poisson(fMeanNPhotons)-Int_t(genphos.size()));
+  for (auto iprompt = 0; iprompt < nprompt; iprompt++)
+  {
+    const Float_t pt  = fConfig.phpTmin + fRand->Exp(fMeanPhoPt);
+    const Float_t eta = fRand->Uniform(-Common::etaEEmax,Common::etaEEmax);
+    const Float_t phi = fRand->Uniform(-Common::PI,Common::PI);
+
+    Float_t x, y, z;
+    if (!DisPhoGenerator::PropagateToECAL(fEvent.vtxX,fEvent.vtxY,fEvent.vtxZ,pt*std::cos(phi),pt*std::sin(phi),pt*std::sinh(eta),x,y,z)) continue;
+    genphos.emplace_back(pt*std::cosh(eta),x,y,z,0.f,-1,-1);
+  }
+
+  // stored in order of pt, as seen from the origin
+  std::sort(genphos.begin(),genphos.end(),
+	    [](const GenPhoton & pho1, const GenPhoton & pho2)
+	    {return (pho1.E / std::cosh(std::asinh(pho1.z/std::hypot(pho1.x,pho1.y)))) > (pho2.E / std::cosh(std::asinh(pho2.z/std::hypot(pho2.x,pho2.y))));});
+
+  fEvent.nphotons = genphos.size();
+  for (auto ipho = 0; ipho < Common::nPhotons; ipho++)
+  {
+    if (ipho < fEvent.nphotons) DisPhoGenerator::FillPhoton(ipho,genphos[ipho]);
+    else                        DisPhoGenerator::ResetPhoton(ipho);
+  }
+
+  // gen matches now that the order is known: -1 if not stored
+  for (auto ipho = 0; ipho < std::min(fEvent.nphotons,Common::nPhotons); ipho++)
+  {
+    const auto & genpho = genphos[ipho];
+    if (genpho.mother < 0) continue;
+
+    if (fIsGMSB)
+    {
+      fGMSBs[genpho.mother].genphmatch = ipho;
+    }
+    else if (fIsHVDS)
+    {
+      auto & hvds = fHVDSs[genpho.mother];
+      if (genpho.daughter == 0) hvds.genHVph0match = ipho;
+      else                      hvds.genHVph1match = ipho;
+    }
+  }
+  // signal flags as in DisPho: GMSB 1/2/3 for leading/subleading/both neutralinos, HVDS one digit per vPion
+  if (fIsGMSB || fIsHVDS)
+  {
+    for (auto ipho = 0; ipho < std::min(fEvent.nphotons,Common::nPhotons); ipho++)
+    {
+      auto & pho = fPhos[ipho];
+      pho.isSignal = 0;
+      if (fIsGMSB)
+      {
+	if (fGMSBs[0].genphmatch == ipho) pho.isSignal += 1;
+	if (fGMSBs[1].genphmatch == ipho) pho.isSignal += 2;
+      }
+      else
+      {
+	for (auto ihvds = 0; ihvds < Common::nHVDSs; ihvds++)
+	{
+	  const auto & hvds = fHVDSs[ihvds];
+	  const Int_t match = (hvds.genHVph0match == ipho ? 1 : 0) + (hvds.genHVph1match == ipho ? 2 : 0);
+	  pho.isSignal += match * Int_t(std::pow(10,ihvds));
+	}
+      }
+    }
+  }
+}
+
+void DisPhoGenerator::FillPhoton(const Int_t ipho, const GenPhoton & genpho)
+{
+  auto & pho = fPhos[ipho];
+
+  // kinematics from the ECAL position
+  const Float_t r   = std::hypot(genpho.x,genpho.y);
+  const Float_t eta = std::asinh(genpho.z/r);
+  const Float_t phi = std::atan2(genpho.y,genpho.x);
+  const auto seedID = DisPhoGenerator::GetDetID(genpho.x,genpho.y,genpho.z);
+  const auto isEB   = DisPhoGenerator::IsEB(seedID);
+
+  pho.E = genpho.E;
+  pho.pt = genpho.E / std::cosh(eta);
+  pho.eta = eta;
+  pho.phi = phi;
+  pho.scE = genpho.E * fRand->Gaus(1.f,0.01f);
+  pho.sceta = eta;
+  pho.scphi = phi;
+  pho.HoE = fRand->Exp(0.02f);
+  pho.r9 = fRand->Uniform(0.5f,1.f);
+  pho.ChgHadIso = fRand->Exp(1.f);
+  pho.NeuHadIso = fRand->Exp(1.f);
+  pho.PhoIso = fRand->Exp(1.f);
+  pho.EcalPFClIso = fRand->Exp(2.f);
+  pho.HcalPFClIso = fRand->Exp(2.f);
+  pho.TrkIso = fRand->Exp(1.f);
+  pho.ChgHadIsoC = pho.ChgHadIso;
+  pho.NeuHadIsoC = pho.NeuHadIso;
+  pho.PhoIsoC = pho.PhoIso;
+  pho.EcalPFClIsoC = pho.EcalPFClIso;
+  pho.HcalPFClIsoC = pho.HcalPFClIso;
+  pho.TrkIsoC = pho.TrkIso;
+  pho.sieie = std::abs(fRand->Gaus((isEB ? 0.0095f : 0.027f),0.001f));
+  pho.sipip = std::abs(fRand->Gaus((isEB ? 0.0095f : 0.027f),0.002f));
+  pho.sieip = fRand->Gaus(0.f,0.0001f);
+  pho.e2x2 = 0.80f*pho.scE;
+  pho.e3x3 = pho.r9*pho.scE;
+  pho.e5x5 = 0.97f*pho.scE;
+  pho.smaj = fRand->Uniform(0.2f,1.f);
+  pho.smin = fRand->Uniform(0.1f,pho.smaj);
+  pho.alpha = fRand->Uniform(-Common::PI,Common::PI);
+  pho.suisseX = fRand->Uniform(0.f,0.9f);
+  pho.isOOT = (fRand->Rndm() < 0.05);
+  pho.isEB = isEB;
+  pho.isHLT = (fRand->Rndm() < 0.8);
+  pho.isTrk = (fRand->Rndm() < 0.1);
+  pho.passEleVeto = (fRand->Rndm() < 0.9);
+  pho.hasPixSeed = !pho.passEleVeto;
+  pho.gedID = (fRand->Rndm() < 0.7 ? 3 : fRand->Integer(3));
+  pho.ootID = (pho.isOOT ? pho.gedID : 0);
+  if (fIsMC)
+  {
+    pho.isGen = (genpho.mother >= 0 || fRand->Rndm() < 0.8);
+    fExtras.scaleAbs[ipho] = 0.003f*genpho.E;
+    fExtras.smearAbs[ipho] = 0.010f*genpho.E;
+  }
+
+  // seed: a fraction of the energy in the crystal hit, the rest spread around it
+  const Float_t seedE = genpho.E * fRand->Uniform(0.3f,0.9f);
+  if (fStoreRecHits)
+  {
+    pho.recHits->clear();
+    pho.seed = DisPhoGenerator::AddRecHit(seedID,seedE,genpho.delay);
+    pho.recHits->emplace_back(pho.seed);
+
+    const auto nrechits = 1 + fRand->Poisson(std::max(fRecHitsPerPho-1.f,0.f));
+    for (auto irh = 1; irh < nrechits; irh++)
+    {
+      const auto rhID = DisPhoGenerator::GetNeighborDetID(seedID,Int_t(fRand->Integer(5))-2,Int_t(fRand->Integer(5))-2);
+      const Float_t rhE = std::max(fConfig.rhEmin,Float_t(seedE*fRand->Uniform(0.005f,0.3f)));
+      pho.recHits->emplace_back(DisPhoGenerator::AddRecHit(rhID,rhE,genpho.delay));
+    }
+  }
+  else
+  {
+    DisPhoGenerator::GetDetIDPosition(seedID,pho.seedX,pho.seedY,pho.seedZ);
+    pho.seedE = seedE;
+    pho.seedtimeErr = DisPhoGenerator::GetTimeSigma(seedE);
+    pho.seedtime = fTimeMu + genpho.delay + fRand->Gaus(0.f,pho.seedtimeErr);
+    pho.seedTOF = DisPhoGenerator::GetTOF(pho.seedX,pho.seedY,pho.seedZ);
+    pho.seedID = seedID;
+    pho.seedisGS6 = (seedE > 150.f);
+    pho.seedisGS1 = (seedE > 1500.f);
+    pho.seedadcToGeV = fRand->Gaus((isEB ? 0.039f : 0.063f),0.002f);
+    pho.seedped12 = fRand->Gaus(200.f,3.f);
+    pho.seedped6 = fRand->Gaus(200.f,3.f);
+    pho.seedped1 = fRand->Gaus(200.f,3.f);
+    pho.seedpedrms12 = fRand->Gaus(1.1f,0.05f);
+    pho.seedpedrms6 = fRand->Gaus(0.9f,0.05f);
+    pho.seedpedrms1 = fRand->Gaus(0.8f,0.05f);
+    fExtras.seedisOOT[ipho] = (std::abs(pho.seedtime) > 3.f);
+  }
+}
+
+void DisPhoGenerator::ResetPhoton(const Int_t ipho)
+{
+  // empty slots keep the DisPho defaults
+  auto & pho = fPhos[ipho];
+
+  pho.E = pho.pt = pho.eta = pho.phi = -9999.f;
+  pho.scE = pho.sceta = pho.scphi = -9999.f;
+  pho.HoE = pho.r9 = -9999.f;
+  pho.ChgHadIso = pho.NeuHadIso = pho.PhoIso = pho.EcalPFClIso = pho.HcalPFClIso = pho.TrkIso = -9999.f;
+  pho.ChgHadIsoC = pho.NeuHadIsoC = pho.PhoIsoC = pho.EcalPFClIsoC = pho.HcalPFClIsoC = pho.TrkIsoC = -9999.f;
+  pho.sieie = pho.sipip = pho.sieip = -9999.f;
+  pho.e2x2 = pho.e3x3 = pho.e5x5 = -9999.f;
+  pho.smaj = pho.smin = pho.alpha = -9999.f;
+  pho.suisseX = -9999.f;
+  pho.isOOT = pho.isEB = pho.isHLT = pho.isTrk = pho.passEleVeto = pho.hasPixSeed = false;
+  pho.gedID = pho.ootID = -1;
+
+  pho.seed = -1;
+  pho.recHits->clear();
+  pho.seedX = pho.seedY = pho.seedZ = pho.seedE = -9999.f;
+  pho.seedtime = pho.seedtimeErr = pho.seedTOF = -9999.f;
+  pho.seedID = 0;
+  pho.seedisGS6 = pho.seedisGS1 = -1;
+  pho.seedadcToGeV = -9999.f;
+  pho.seedped12 = pho.seedped6 = pho.seedped1 = -9999.f;
+  pho.seedpedrms12 = pho.seedpedrms6 = pho.seedpedrms1 = -9999.f;
+  fExtras.seedisOOT[ipho] = -1;
+
+  pho.isGen = false;
+  pho.isSignal = -9999;
+  fExtras.scaleAbs[ipho] = fExtras.smearAbs[ipho] = -9999.f;
+}
+
+void DisPhoGenerator::GenerateNoiseRecHits()
+{
+  // occupancy above rhEmin: photon clusters plus noise and pileup hits everywhere else
+  const auto nrechits = fRand->Poisson(fMeanNRecHits);
+  if (!fStoreRecHits)
+  {
+    fEvent.nrechits = std::max(nrechits,Int_t(fRecHitsPerPho*std::min(fEvent.nphotons,Common::nPhotons)));
+    return;
+  }
+
+  for (auto irh = Int_t(fRecHits.E->size()); irh < nrechits; irh++)
+  {
+    const Float_t eta = fRand->Uniform(-Common::etaEEmax,Common::etaEEmax);
+    const Float_t phi = fRand->Uniform(-Common::PI,Common::PI);
+
+    Float_t x, y, z;
+    if (!DisPhoGenerator::PropagateToECAL(0.f,0.f,0.f,std::cos(phi),std::sin(phi),std::sinh(eta),x,y,z)) continue;
+    DisPhoGenerator::AddRecHit(DisPhoGenerator::GetDetID(x,y,z),fConfig.rhEmin+fRand->Exp(2.f),0.f);
+  }
+  fEvent.nrechits = fRecHits.E->size();
+}
+
+Int_t DisPhoGenerator::AddRecHit(const UInt_t detid, const Float_t E, const Float_t delay)
+{
+  const auto isEB = DisPhoGenerator::IsEB(detid);
+  const auto timeErr = DisPhoGenerator::GetTimeSigma(E);
+  const Float_t time = fTimeMu + delay + fRand->Gaus(0.f,timeErr);
+
+  Float_t x, y, z;
+  DisPhoGenerator::GetDetIDPosition(detid,x,y,z);
+
+  fRecHits.X->emplace_back(x);
+  fRecHits.Y->emplace_back(y);
+  fRecHits.Z->emplace_back(z);
+  fRecHits.E->emplace_back(E);
+  fRecHits.time->emplace_back(time);
+  fRecHits.timeErr->emplace_back(timeErr);
+  fRecHits.TOF->emplace_back(DisPhoGenerator::GetTOF(x,y,z));
+  fRecHits.ID->emplace_back(detid);
+  fRecHits.isOOT->emplace_back(std::abs(time) > 3.f);
+  fRecHits.isGS6->emplace_back(E > 150.f);
+  fRecHits.isGS1->emplace_back(E > 1500.f);
+  fRecHits.adcToGeV->emplace_back(fRand->Gaus((isEB ? 0.039f : 0.063f),0.002f));
+  fRecHits.ped12->emplace_back(fRand->Gaus(200.f,3.f));
+  fRecHits.ped6->emplace_back(fRand->Gaus(200.f,3.f));
+  fRecHits.ped1->emplace_back(fRand->Gaus(200.f,3.f));
+  fRecHits.pedrms12->emplace_back(fRand->Gaus(1.1f,0.05f));
+  fRecHits.pedrms6->emplace_back(fRand->Gaus(0.9f,0.05f));
+  fRecHits.pedrms1->emplace_back(fRand->Gaus(0.8f,0.05f));
+
+  return fRecHits.E->size()-1;
+}
+
+Bool_t DisPhoGenerator::PropagateToECAL(const Float_t x0, const Float_t y0, const Float_t z0, const Float_t px, const Float_t py, const Float_t pz,
+					Float_t & x, Float_t & y, Float_t & z) const
+{
+  // barrel: solve |(x0,y0) + s*(px,py)| = radEB for s > 0
+  const Float_t a = px*px + py*py;
+  const Float_t b = 2.f*(x0*px + y0*py);
+  const Float_t c = x0*x0 + y0*y0 - Common::radEB*Common::radEB;
+  const Float_t disc = b*b - 4.f*a*c;
+  const Float_t zEBmax = Common::radEB*std::sinh(Common::etaEBcutoff);
+
+  if (a > 0.f && disc >= 0.f && c < 0.f)
+  {
+    const Float_t s = (-b + std::sqrt(disc)) / (2.f*a);
+    x = x0 + s*px; y = y0 + s*py; z = z0 + s*pz;
+    if (std::abs(z) <= zEBmax) return true;
+  }
+
+  // endcaps: plane in the direction of flight, inside the EE rings
+  if (pz == 0.f || std::abs(z0) >= Common::zEE) return false;
+  const Float_t s = ((pz > 0.f ? Common::zEE : -Common::zEE) - z0) / pz;
+  x = x0 + s*px; y = y0 + s*py; z = z0 + s*pz;
+
+  const Float_t r = std::hypot(x,y);
+  return (r <= Common::radEB && std::abs(std::asinh(z/r)) <= Common::etaEEmax);
+}
+
+UInt_t DisPhoGenerator::GetDetID(const Float_t x, const Float_t y, const Float_t z) const
+{
+  // EB: ieta, iphi; EE: ix, iy, side (as CMSSW EBDetId/EEDetId)
+  if (std::abs(z) < Common::zEE - 1.f)
+  {
+    const Float_t eta = std::asinh(z/std::hypot(x,y));
+    const Int_t absieta = std::min(Int_t(std::abs(eta)/Common::genEBCrystalDEta)+1,Common::genEBiEtaMax);
+    const Int_t iphi = Int_t((std::atan2(y,x)+Common::PI)/Common::DegToRad)%360 + 1;
+    return (0x32000000 | (eta > 0.f ? 0x10000 : 0) | (absieta << 9) | iphi);
+  }
+  else
+  {
+    const Int_t ix = std::min(std::max(Int_t(x/Common::genEECrystalSize + 0.5f*Common::genEEiXYMax)+1,1),Common::genEEiXYMax);
+    const Int_t iy = std::min(std::max(Int_t(y/Common::genEECrystalSize + 0.5f*Common::genEEiXYMax)+1,1),Common::genEEiXYMax);
+    return (0x34000000 | (z > 0.f ? 0x4000 : 0) | (ix << 7) | iy);
+  }
+}
+
+UInt_t DisPhoGenerator::GetNeighborDetID(const UInt_t detid, const Int_t di1, const Int_t di2) const
+{
+  if (DisPhoGenerator::IsEB(detid))
+  {
+    const Int_t sign = ((detid & 0x10000) ? 1 : -1);
+    const Int_t ieta = sign*((detid >> 9) & 0x7F);
+    const Int_t iphi = detid & 0x1FF;
+
+    // no ieta = 0, iphi wraps
+    auto nieta = ieta + di2;
+    if (nieta == 0 || (nieta > 0) != (ieta > 0)) nieta += (di2 > 0 ? 1 : -1);
+    nieta = std::min(std::max(nieta,-Common::genEBiEtaMax),Common::genEBiEtaMax);
+    const Int_t niphi = ((iphi - 1 + di1) % 360 + 360) % 360 + 1;
+
+    return (0x32000000 | (nieta > 0 ? 0x10000 : 0) | (std::abs(nieta) << 9) | niphi);
+  }
+  else
+  {
+    const Int_t ix = std::min(std::max(Int_t((detid >> 7) & 0x7F) + di1,1),Common::genEEiXYMax);
+    const Int_t iy = std::min(std::max(Int_t(detid & 0x7F) + di2,1),Common::genEEiXYMax);
+    return ((detid & ~0x3FFF) | (ix << 7) | iy);
+  }
+}
+
+void DisPhoGenerator::GetDetIDPosition(const UInt_t detid, Float_t & x, Float_t & y, Float_t & z) const
+{
+  // crystal centers
+  if (DisPhoGenerator::IsEB(detid))
+  {
+    const Float_t sign = ((detid & 0x10000) ? 1.f : -1.f);
+    const Float_t eta = sign*(((detid >> 9) & 0x7F) - 0.5f)*Common::genEBCrystalDEta;
+    const Float_t phi = ((detid & 0x1FF) - 0.5f)*Common::DegToRad - Common::PI;
+    x = Common::radEB*std::cos(phi);
+    y = Common::radEB*std::sin(phi);
+    z = Common::radEB*std::sinh(eta);
+  }
+  else
+  {
+    x = (Int_t((detid >> 7) & 0x7F) - 0.5f - 0.5f*Common::genEEiXYMax)*Common::genEECrystalSize;
+    y = (Int_t(detid & 0x7F) - 0.5f - 0.5f*Common::genEEiXYMax)*Common::genEECrystalSize;
+    z = ((detid & 0x4000) ? Common::zEE : -Common::zEE);
+  }
+}
+
+void DisPhoGenerator::InitOutHists()
+{
+  std::cout << "Initializing output hists..." << std::endl;
+
+  // same cuts as DisPho, all passed
+  for (const std::string label : {"All","nEvBlinding","METBlinding","Trigger","H_{T}","Good Photon"})
+  {
+    fCutSlots.emplace_back(fCutFlow.Register(label));
+  }
+
+  fCutFlowHist    = fCutFlow.MakeHist(Common::h_cutflowname,"Cut Flow");
+  fCutFlowWgtHist = fCutFlow.MakeHist(Common::h_cutflow_wgtname,"Cut Flow (Weighted)");
+  fCutFlowHist   ->GetYaxis()->SetTitle("nEntries");
+  fCutFlowWgtHist->GetYaxis()->SetTitle("nEntries with gen weights");
+
+  if (fIsMC)
+  {
+    fGenPUObsHist     = new TH1F(Common::puObsHistName.Data(),"Gen PU Observed",Common::nPUBins,0,Common::nPUBins);
+    fGenPUObsWgtHist  = new TH1F(Form("%s_wgt",Common::puObsHistName.Data()),"Gen PU Observed (Weighted)",Common::nPUBins,0,Common::nPUBins);
+    fGenPUTrueHist    = new TH1F(Common::puTrueHistName.Data(),"Gen PU True",Common::nPUBins,0,Common::nPUBins);
+    fGenPUTrueWgtHist = new TH1F(Form("%s_wgt",Common::puTrueHistName.Data()),"Gen PU True (Weighted)",Common::nPUBins,0,Common::nPUBins);
+
+    fGenPUObsHist    ->GetXaxis()->SetTitle("nPU observed");
+    fGenPUObsHist    ->GetYaxis()->SetTitle("nEntries");
+    fGenPUObsWgtHist ->GetXaxis()->SetTitle("nPU observed");
+    fGenPUObsWgtHist ->GetYaxis()->SetTitle("nEvents with weights");
+    fGenPUTrueHist   ->GetXaxis()->SetTitle("nPU True");
+    fGenPUTrueHist   ->GetYaxis()->SetTitle("nEntries");
+    fGenPUTrueWgtHist->GetXaxis()->SetTitle("nPU True");
+    fGenPUTrueWgtHist->GetYaxis()->SetTitle("nEvents with weights");
+  }
+}
+
+void DisPhoGenerator::InitOutConfigTree()
+{
+  std::cout << "Initializing output config tree..." << std::endl;
+
+  fOutConfigTree = new TTree(Common::configtreename.Data(),Common::configtreename.Data());
+
+  fOutConfigTree->Branch(fConfig.s_blindSF.c_str(), &fConfig.blindSF);
+  fOutConfigTree->Branch(fConfig.s_applyBlindSF.c_str(), &fConfig.applyBlindSF);
+  fOutConfigTree->Branch(fConfig.s_blindMET.c_str(), &fConfig.blindMET);
+  fOutConfigTree->Branch(fConfig.s_applyBlindMET.c_str(), &fConfig.applyBlindMET);
+  fOutConfigTree->Branch(fConfig.s_jetpTmin.c_str(), &fConfig.jetpTmin);
+  fOutConfigTree->Branch(fConfig.s_jetEtamax.c_str(), &fConfig.jetEtamax);
+  fOutConfigTree->Branch(fConfig.s_jetIDmin.c_str(), &fConfig.jetIDmin);
+  fOutConfigTree->Branch(fConfig.s_rhEmin.c_str(), &fConfig.rhEmin);
+  fOutConfigTree->Branch(fConfig.s_phpTmin.c_str(), &fConfig.phpTmin);
+  fOutConfigTree->Branch(fConfig.s_phIDmin.c_str(), &fConfig.phIDmin_s);
+  fOutConfigTree->Branch(fConfig.s_seedTimemin.c_str(), &fConfig.seedTimemin);
+  fOutConfigTree->Branch(fConfig.s_splitPho.c_str(), &fConfig.splitPho);
+  fOutConfigTree->Branch(fConfig.s_onlyGED.c_str(), &fConfig.onlyGED);
+  fOutConfigTree->Branch(fConfig.s_onlyOOT.c_str(), &fConfig.onlyOOT);
+  fOutConfigTree->Branch(fConfig.s_storeRecHits.c_str(), &fConfig.storeRecHits);
+  fOutConfigTree->Branch(fConfig.s_applyTrigger.c_str(), &fConfig.applyTrigger);
+  fOutConfigTree->Branch(fConfig.s_minHT.c_str(), &fConfig.minHT);
+  fOutConfigTree->Branch(fConfig.s_applyHT.c_str(), &fConfig.applyHT);
+  fOutConfigTree->Branch(fConfig.s_phgoodpTmin.c_str(), &fConfig.phgoodpTmin);
+  fOutConfigTree->Branch(fConfig.s_phgoodIDmin.c_str(), &fConfig.phgoodIDmin_s);
+  fOutConfigTree->Branch(fConfig.s_applyPhGood.c_str(), &fConfig.applyPhGood);
+  fOutConfigTree->Branch(fConfig.s_dRmin.c_str(), &fConfig.dRmin);
+  fOutConfigTree->Branch(fConfig.s_pTres.c_str(), &fConfig.pTres);
+  fOutConfigTree->Branch("gendRmin", &fExtras.gendRmin);
+  fOutConfigTree->Branch(fConfig.s_genpTres.c_str(), &fConfig.genpTres);
+  fOutConfigTree->Branch(fConfig.s_trackdRmin.c_str(), &fConfig.trackdRmin);
+  fOutConfigTree->Branch(fConfig.s_trackpTmin.c_str(), &fConfig.trackpTmin);
+  fOutConfigTree->Branch(fConfig.s_genjetdRmin.c_str(), &fConfig.genjetdRmin);
+  fOutConfigTree->Branch(fConfig.s_genjetpTfactor.c_str(), &fConfig.genjetpTfactor);
+  fOutConfigTree->Branch(fConfig.s_smearjetEmin.c_str(), &fConfig.smearjetEmin);
+  fOutConfigTree->Branch(fConfig.s_inputPaths.c_str(), &fConfig.inputPaths_s);
+  fOutConfigTree->Branch(fConfig.s_inputFilters.c_str(), &fConfig.inputFilters_s);
+  fOutConfigTree->Branch(fConfig.s_inputFlags.c_str(), &fConfig.inputFlags_s);
+  fOutConfigTree->Branch(fConfig.s_isGMSB.c_str(), &fConfig.isGMSB);
+  fOutConfigTree->Branch(fConfig.s_isHVDS.c_str(), &fConfig.isHVDS);
+  fOutConfigTree->Branch(fConfig.s_isBkgd.c_str(), &fConfig.isBkgd);
+  fOutConfigTree->Branch(fConfig.s_isToy.c_str(), &fConfig.isToy);
+  fOutConfigTree->Branch(fConfig.s_isADD.c_str(), &fConfig.isADD);
+  fOutConfigTree->Branch(fConfig.s_xsec.c_str(), &fConfig.xsec);
+  fOutConfigTree->Branch(fConfig.s_filterEff.c_str(), &fConfig.filterEff);
+  fOutConfigTree->Branch(fConfig.s_BR.c_str(), &fConfig.BR);
+
+  // and fill it once
+  fOutConfigTree->Fill();
+}
+
+void DisPhoGenerator::InitOutTree()
+{
+  std::cout << "Initializing output tree..." << std::endl;
+
+  fOutTree = new TTree(Common::disphotreename.Data(),Common::disphotreename.Data());
+
+  // fixed size structs: branches point into them
+  fPhos.resize(Common::nPhotons);
+  if (fIsGMSB) fGMSBs.resize(Common::nGMSBs);
+  if (fIsHVDS) fHVDSs.resize(Common::nHVDSs);
+  if (fIsToy)  fToys .resize(Common::nToys);
+  fExtras.seedisOOT.resize(Common::nPhotons);
+  fExtras.scaleAbs .resize(Common::nPhotons);
+  fExtras.smearAbs .resize(Common::nPhotons);
+
+  // vectors are written through pointers
+  fRecHits.X = new std::vector<Float_t>();
+  fRecHits.Y = new std::vector<Float_t>();
+  fRecHits.Z = new std::vector<Float_t>();
+  fRecHits.E = new std::vector<Float_t>();
+  fRecHits.time = new std::vector<Float_t>();
+  fRecHits.timeErr = new std::vector<Float_t>();
+  fRecHits.TOF = new std::vector<Float_t>();
+  fRecHits.ID = new std::vector<UInt_t>();
+  fRecHits.isOOT = new std::vector<Int_t>();
+  fRecHits.isGS6 = new std::vector<Int_t>();
+  fRecHits.isGS1 = new std::vector<Int_t>();
+  fRecHits.adcToGeV = new std::vector<Float_t>();
+  fRecHits.ped12 = new std::vector<Float_t>();
+  fRecHits.ped6 = new std::vector<Float_t>();
+  fRecHits.ped1 = new std::vector<Float_t>();
+  fRecHits.pedrms12 = new std::vector<Float_t>();
+  fRecHits.pedrms6 = new std::vector<Float_t>();
+  fRecHits.pedrms1 = new std::vector<Float_t>();
+  for (auto & pho : fPhos) pho.recHits = new std::vector<Int_t>();
+
+  DisPhoGenerator::InitOutBranches();
+}
+
+void DisPhoGenerator::InitOutBranches()
+{
+  // same order as DisPho::MakeEventTree
+  fOutTree->Branch(fEvent.s_rho.c_str(), &fEvent.rho);
+
+  if (fIsMC)
+  {
+    fOutTree->Branch(fEvent.s_genwgt.c_str(), &fEvent.genwgt);
+    fOutTree->Branch(fEvent.s_genx0.c_str(), &fEvent.genx0);
+    fOutTree->Branch(fEvent.s_geny0.c_str(), &fEvent.geny0);
+    fOutTree->Branch(fEvent.s_genz0.c_str(), &fEvent.genz0);
+    fOutTree->Branch(fEvent.s_gent0.c_str(), &fEvent.gent0);
+    fOutTree->Branch(fEvent.s_genpuobs.c_str(), &fEvent.genpuobs);
+    fOutTree->Branch(fEvent.s_genputrue.c_str(), &fEvent.genputrue);
+  }
+
+  if (fIsGMSB)
+  {
+    fOutTree->Branch(fEvent.s_nNeutoPhGr.c_str(), &fEvent.nNeutoPhGr);
+    for (auto igmsb = 0; igmsb < Common::nGMSBs; igmsb++)
+    {
+      auto & gmsb = fGMSBs[igmsb];
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNmass.c_str(),igmsb), &gmsb.genNmass);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNE.c_str(),igmsb), &gmsb.genNE);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNpt.c_str(),igmsb), &gmsb.genNpt);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNphi.c_str(),igmsb), &gmsb.genNphi);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNeta.c_str(),igmsb), &gmsb.genNeta);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNprodvx.c_str(),igmsb), &gmsb.genNprodvx);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNprodvy.c_str(),igmsb), &gmsb.genNprodvy);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNprodvz.c_str(),igmsb), &gmsb.genNprodvz);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNdecayvx.c_str(),igmsb), &gmsb.genNdecayvx);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNdecayvy.c_str(),igmsb), &gmsb.genNdecayvy);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genNdecayvz.c_str(),igmsb), &gmsb.genNdecayvz);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genphE.c_str(),igmsb), &gmsb.genphE);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genphpt.c_str(),igmsb), &gmsb.genphpt);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genphphi.c_str(),igmsb), &gmsb.genphphi);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genpheta.c_str(),igmsb), &gmsb.genpheta);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_genphmatch.c_str(),igmsb), &gmsb.genphmatch);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_gengrmass.c_str(),igmsb), &gmsb.gengrmass);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_gengrE.c_str(),igmsb), &gmsb.gengrE);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_gengrpt.c_str(),igmsb), &gmsb.gengrpt);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_gengrphi.c_str(),igmsb), &gmsb.gengrphi);
+      fOutTree->Branch(Form("%s_%i",gmsb.s_gengreta.c_str(),igmsb), &gmsb.gengreta);
+    }
+  }
+
+  if (fIsHVDS)
+  {
+    fOutTree->Branch(fEvent.s_nvPions.c_str(), &fEvent.nvPions);
+    for (auto ihvds = 0; ihvds < Common::nHVDSs; ihvds++)
+    {
+      auto & hvds = fHVDSs[ihvds];
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPionmass.c_str(),ihvds), &hvds.genvPionmass);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPionE.c_str(),ihvds), &hvds.genvPionE);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPionpt.c_str(),ihvds), &hvds.genvPionpt);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPionphi.c_str(),ihvds), &hvds.genvPionphi);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPioneta.c_str(),ihvds), &hvds.genvPioneta);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPionprodvx.c_str(),ihvds), &hvds.genvPionprodvx);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPionprodvy.c_str(),ihvds), &hvds.genvPionprodvy);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPionprodvz.c_str(),ihvds), &hvds.genvPionprodvz);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPiondecayvx.c_str(),ihvds), &hvds.genvPiondecayvx);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPiondecayvy.c_str(),ihvds), &hvds.genvPiondecayvy);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genvPiondecayvz.c_str(),ihvds), &hvds.genvPiondecayvz);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph0E.c_str(),ihvds), &hvds.genHVph0E);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph0pt.c_str(),ihvds), &hvds.genHVph0pt);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph0phi.c_str(),ihvds), &hvds.genHVph0phi);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph0eta.c_str(),ihvds), &hvds.genHVph0eta);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph0match.c_str(),ihvds), &hvds.genHVph0match);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph1E.c_str(),ihvds), &hvds.genHVph1E);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph1pt.c_str(),ihvds), &hvds.genHVph1pt);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph1phi.c_str(),ihvds), &hvds.genHVph1phi);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph1eta.c_str(),ihvds), &hvds.genHVph1eta);
+      fOutTree->Branch(Form("%s_%i",hvds.s_genHVph1match.c_str(),ihvds), &hvds.genHVph1match);
+    }
+  }
+
+  if (fIsToy)
+  {
+    fOutTree->Branch(fEvent.s_nToyPhs.c_str(), &fEvent.nToyPhs);
+    for (auto itoy = 0; itoy < Common::nToys; itoy++)
+    {
+      auto & toy = fToys[itoy];
+      fOutTree->Branch(Form("%s_%i",toy.s_genphE.c_str(),itoy), &toy.genphE);
+      fOutTree->Branch(Form("%s_%i",toy.s_genphpt.c_str(),itoy), &toy.genphpt);
+      fOutTree->Branch(Form("%s_%i",toy.s_genphphi.c_str(),itoy), &toy.genphphi);
+      fOutTree->Branch(Form("%s_%i",toy.s_genpheta.c_str(),itoy), &toy.genpheta);
+      fOutTree->Branch(Form("%s_%i",toy.s_genphmatch.c_str(),itoy), &toy.genphmatch);
+      fOutTree->Branch(Form("%s_%i",toy.s_genphmatch_ptres.c_str(),itoy), &toy.genphmatch_ptres);
+      fOutTree->Branch(Form("%s_%i",toy.s_genphmatch_status.c_str(),itoy), &toy.genphmatch_status);
+    }
+  }
+
+  fOutTree->Branch(fEvent.s_run.c_str(), &fEvent.run);
+  fOutTree->Branch(fEvent.s_lumi.c_str(), &fEvent.lumi);
+  fOutTree->Branch(fEvent.s_event.c_str(), &fEvent.event);
+
+  fOutTree->Branch(fEvent.s_hltSignal.c_str(), &fEvent.hltSignal);
+  fOutTree->Branch(fEvent.s_hltRefPhoID.c_str(), &fEvent.hltRefPhoID);
+  fOutTree->Branch(fEvent.s_hltRefDispID.c_str(), &fEvent.hltRefDispID);
+  fOutTree->Branch(fEvent.s_hltRefHT.c_str(), &fEvent.hltRefHT);
+  fOutTree->Branch(fEvent.s_hltPho50.c_str(), &fEvent.hltPho50);
+  fOutTree->Branch(fEvent.s_hltPho200.c_str(), &fEvent.hltPho200);
+  fOutTree->Branch(fEvent.s_hltDiPho70.c_str(), &fEvent.hltDiPho70);
+  fOutTree->Branch(fEvent.s_hltDiPho3022M90.c_str(), &fEvent.hltDiPho3022M90);
+  fOutTree->Branch(fEvent.s_hltDiPho30PV18PV.c_str(), &fEvent.hltDiPho30PV18PV);
+  fOutTree->Branch(fEvent.s_hltEle32WPT.c_str(), &fEvent.hltEle32WPT);
+  fOutTree->Branch(fEvent.s_hltDiEle33MW.c_str(), &fEvent.hltDiEle33MW);
+  fOutTree->Branch(fEvent.s_hltJet500.c_str(), &fEvent.hltJet500);
+
+  fOutTree->Branch(fEvent.s_metPV.c_str(), &fEvent.metPV);
+  fOutTree->Branch(fEvent.s_metBeamHalo.c_str(), &fEvent.metBeamHalo);
+  fOutTree->Branch(fEvent.s_metHBHENoise.c_str(), &fEvent.metHBHENoise);
+  fOutTree->Branch(fEvent.s_metHBHEisoNoise.c_str(), &fEvent.metHBHEisoNoise);
+  fOutTree->Branch(fEvent.s_metECALTP.c_str(), &fEvent.metECALTP);
+  fOutTree->Branch(fEvent.s_metPFMuon.c_str(), &fEvent.metPFMuon);
+  fOutTree->Branch(fEvent.s_metPFChgHad.c_str(), &fEvent.metPFChgHad);
+  fOutTree->Branch(fEvent.s_metEESC.c_str(), &fEvent.metEESC);
+  fOutTree->Branch(fEvent.s_metECALCalib.c_str(), &fEvent.metECALCalib);
+
+  fOutTree->Branch(fEvent.s_nvtx.c_str(), &fEvent.nvtx);
+  fOutTree->Branch(fEvent.s_vtxX.c_str(), &fEvent.vtxX);
+  fOutTree->Branch(fEvent.s_vtxY.c_str(), &fEvent.vtxY);
+  fOutTree->Branch(fEvent.s_vtxZ.c_str(), &fEvent.vtxZ);
+
+  fOutTree->Branch(fEvent.s_t1pfMETpt.c_str(), &fEvent.t1pfMETpt);
+  fOutTree->Branch(fEvent.s_t1pfMETphi.c_str(), &fEvent.t1pfMETphi);
+  fOutTree->Branch(fEvent.s_t1pfMETsumEt.c_str(), &fEvent.t1pfMETsumEt);
+
+  fOutTree->Branch(fEvent.s_njets.c_str(), &fEvent.njets);
+  fOutTree->Branch(fJets.s_E.c_str(), &fJets.E_f);
+  fOutTree->Branch(fJets.s_pt.c_str(), &fJets.pt_f);
+  fOutTree->Branch(fJets.s_eta.c_str(), &fJets.eta_f);
+  fOutTree->Branch(fJets.s_phi.c_str(), &fJets.phi_f);
+  fOutTree->Branch(fJets.s_ID.c_str(), &fJets.ID_i);
+  fOutTree->Branch(fJets.s_NHF.c_str(), &fJets.NHF_f);
+  fOutTree->Branch(fJets.s_NEMF.c_str(), &fJets.NEMF_f);
+  fOutTree->Branch(fJets.s_CHF.c_str(), &fJets.CHF_f);
+  fOutTree->Branch(fJets.s_CEMF.c_str(), &fJets.CEMF_f);
+  fOutTree->Branch(fJets.s_MUF.c_str(), &fJets.MUF_f);
+  fOutTree->Branch(fJets.s_NHM.c_str(), &fJets.NHM_f);
+  fOutTree->Branch(fJets.s_CHM.c_str(), &fJets.CHM_f);
+
+  if (fIsMC)
+  {
+    fOutTree->Branch("jetscaleRel", &fExtras.jetscaleRel);
+    fOutTree->Branch("jetsmearSF", &fExtras.jetsmearSF);
+    fOutTree->Branch("jetsmearDownSF", &fExtras.jetsmearDownSF);
+    fOutTree->Branch("jetsmearUpSF", &fExtras.jetsmearUpSF);
+    fOutTree->Branch("jetisGen", &fExtras.jetisGen);
+  }
+
+  fOutTree->Branch(fEvent.s_nrechits.c_str(), &fEvent.nrechits);
+  if (fStoreRecHits)
+  {
+    fOutTree->Branch(fRecHits.s_X.c_str(), &fRecHits.X);
+    fOutTree->Branch(fRecHits.s_Y.c_str(), &fRecHits.Y);
+    fOutTree->Branch(fRecHits.s_Z.c_str(), &fRecHits.Z);
+    fOutTree->Branch(fRecHits.s_E.c_str(), &fRecHits.E);
+    fOutTree->Branch(fRecHits.s_time.c_str(), &fRecHits.time);
+    fOutTree->Branch(fRecHits.s_timeErr.c_str(), &fRecHits.timeErr);
+    fOutTree->Branch(fRecHits.s_TOF.c_str(), &fRecHits.TOF);
+    fOutTree->Branch(fRecHits.s_ID.c_str(), &fRecHits.ID);
+    fOutTree->Branch(fRecHits.s_isOOT.c_str(), &fRecHits.isOOT);
+    fOutTree->Branch(fRecHits.s_isGS6.c_str(), &fRecHits.isGS6);
+    fOutTree->Branch(fRecHits.s_isGS1.c_str(), &fRecHits.isGS1);
+    fOutTree->Branch(fRecHits.s_adcToGeV.c_str(), &fRecHits.adcToGeV);
+    fOutTree->Branch(fRecHits.s_ped12.c_str(), &fRecHits.ped12);
+    fOutTree->Branch(fRecHits.s_ped6.c_str(), &fRecHits.ped6);
+    fOutTree->Branch(fRecHits.s_ped1.c_str(), &fRecHits.ped1);
+    fOutTree->Branch(fRecHits.s_pedrms12.c_str(), &fRecHits.pedrms12);
+    fOutTree->Branch(fRecHits.s_pedrms6.c_str(), &fRecHits.pedrms6);
+    fOutTree->Branch(fRecHits.s_pedrms1.c_str(), &fRecHits.pedrms1);
+  }
+
+  fOutTree->Branch(fEvent.s_nphotons.c_str(), &fEvent.nphotons);
+  for (auto ipho = 0; ipho < Common::nPhotons; ipho++)
+  {
+    auto & pho = fPhos[ipho];
+    fOutTree->Branch(Form("%s_%i",pho.s_E.c_str(),ipho), &pho.E);
+    fOutTree->Branch(Form("%s_%i",pho.s_pt.c_str(),ipho), &pho.pt);
+    fOutTree->Branch(Form("%s_%i",pho.s_eta.c_str(),ipho), &pho.eta);
+    fOutTree->Branch(Form("%s_%i",pho.s_phi.c_str(),ipho), &pho.phi);
+    fOutTree->Branch(Form("%s_%i",pho.s_scE.c_str(),ipho), &pho.scE);
+    fOutTree->Branch(Form("%s_%i",pho.s_sceta.c_str(),ipho), &pho.sceta);
+    fOutTree->Branch(Form("%s_%i",pho.s_scphi.c_str(),ipho), &pho.scphi);
+    fOutTree->Branch(Form("%s_%i",pho.s_HoE.c_str(),ipho), &pho.HoE);
+    fOutTree->Branch(Form("%s_%i",pho.s_r9.c_str(),ipho), &pho.r9);
+    fOutTree->Branch(Form("%s_%i",pho.s_ChgHadIso.c_str(),ipho), &pho.ChgHadIso);
+    fOutTree->Branch(Form("%s_%i",pho.s_NeuHadIso.c_str(),ipho), &pho.NeuHadIso);
+    fOutTree->Branch(Form("%s_%i",pho.s_PhoIso.c_str(),ipho), &pho.PhoIso);
+    fOutTree->Branch(Form("%s_%i",pho.s_EcalPFClIso.c_str(),ipho), &pho.EcalPFClIso);
+    fOutTree->Branch(Form("%s_%i",pho.s_HcalPFClIso.c_str(),ipho), &pho.HcalPFClIso);
+    fOutTree->Branch(Form("%s_%i",pho.s_TrkIso.c_str(),ipho), &pho.TrkIso);
+    fOutTree->Branch(Form("%s_%i",pho.s_ChgHadIsoC.c_str(),ipho), &pho.ChgHadIsoC);
+    fOutTree->Branch(Form("%s_%i",pho.s_NeuHadIsoC.c_str(),ipho), &pho.NeuHadIsoC);
+    fOutTree->Branch(Form("%s_%i",pho.s_PhoIsoC.c_str(),ipho), &pho.PhoIsoC);
+    fOutTree->Branch(Form("%s_%i",pho.s_EcalPFClIsoC.c_str(),ipho), &pho.EcalPFClIsoC);
+    fOutTree->Branch(Form("%s_%i",pho.s_HcalPFClIsoC.c_str(),ipho), &pho.HcalPFClIsoC);
+    fOutTree->Branch(Form("%s_%i",pho.s_TrkIsoC.c_str(),ipho), &pho.TrkIsoC);
+    fOutTree->Branch(Form("%s_%i",pho.s_sieie.c_str(),ipho), &pho.sieie);
+    fOutTree->Branch(Form("%s_%i",pho.s_sipip.c_str(),ipho), &pho.sipip);
+    fOutTree->Branch(Form("%s_%i",pho.s_sieip.c_str(),ipho), &pho.sieip);
+    fOutTree->Branch(Form("%s_%i",pho.s_e2x2.c_str(),ipho), &pho.e2x2);
+    fOutTree->Branch(Form("%s_%i",pho.s_e3x3.c_str(),ipho), &pho.e3x3);
+    fOutTree->Branch(Form("%s_%i",pho.s_e5x5.c_str(),ipho), &pho.e5x5);
+    fOutTree->Branch(Form("%s_%i",pho.s_smaj.c_str(),ipho), &pho.smaj);
+    fOutTree->Branch(Form("%s_%i",pho.s_smin.c_str(),ipho), &pho.smin);
+    fOutTree->Branch(Form("%s_%i",pho.s_alpha.c_str(),ipho), &pho.alpha);
+    if (fStoreRecHits)
+    {
+      fOutTree->Branch(Form("%s_%i",pho.s_seed.c_str(),ipho), &pho.seed);
+      fOutTree->Branch(Form("%s_%i",pho.s_recHits.c_str(),ipho), &pho.recHits);
+    }
+    else
+    {
+      fOutTree->Branch(Form("%s_%i",pho.s_seedX.c_str(),ipho), &pho.seedX);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedY.c_str(),ipho), &pho.seedY);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedZ.c_str(),ipho), &pho.seedZ);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedE.c_str(),ipho), &pho.seedE);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedtime.c_str(),ipho), &pho.seedtime);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedtimeErr.c_str(),ipho), &pho.seedtimeErr);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedTOF.c_str(),ipho), &pho.seedTOF);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedID.c_str(),ipho), &pho.seedID);
+      fOutTree->Branch(Form("phoseedisOOT_%i",ipho), &fExtras.seedisOOT[ipho]);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedisGS6.c_str(),ipho), &pho.seedisGS6);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedisGS1.c_str(),ipho), &pho.seedisGS1);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedadcToGeV.c_str(),ipho), &pho.seedadcToGeV);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedped12.c_str(),ipho), &pho.seedped12);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedped6.c_str(),ipho), &pho.seedped6);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedped1.c_str(),ipho), &pho.seedped1);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedpedrms12.c_str(),ipho), &pho.seedpedrms12);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedpedrms6.c_str(),ipho), &pho.seedpedrms6);
+      fOutTree->Branch(Form("%s_%i",pho.s_seedpedrms1.c_str(),ipho), &pho.seedpedrms1);
+    }
+    fOutTree->Branch(Form("%s_%i",pho.s_suisseX.c_str(),ipho), &pho.suisseX);
+    fOutTree->Branch(Form("%s_%i",pho.s_isOOT.c_str(),ipho), &pho.isOOT);
+    fOutTree->Branch(Form("%s_%i",pho.s_isEB.c_str(),ipho), &pho.isEB);
+    fOutTree->Branch(Form("%s_%i",pho.s_isHLT.c_str(),ipho), &pho.isHLT);
+    fOutTree->Branch(Form("%s_%i",pho.s_isTrk.c_str(),ipho), &pho.isTrk);
+    fOutTree->Branch(Form("%s_%i",pho.s_passEleVeto.c_str(),ipho), &pho.passEleVeto);
+    fOutTree->Branch(Form("%s_%i",pho.s_hasPixSeed.c_str(),ipho), &pho.hasPixSeed);
+    fOutTree->Branch(Form("%s_%i",pho.s_gedID.c_str(),ipho), &pho.gedID);
+    fOutTree->Branch(Form("%s_%i",pho.s_ootID.c_str(),ipho), &pho.ootID);
+
+    if (fIsMC)
+    {
+      if (fIsGMSB || fIsHVDS) fOutTree->Branch(Form("%s_%i",pho.s_isSignal.c_str(),ipho), &pho.isSignal);
+      fOutTree->Branch(Form("%s_%i",pho.s_isGen.c_str(),ipho), &pho.isGen);
+      fOutTree->Branch(Form("phoscaleAbs_%i",ipho), &fExtras.scaleAbs[ipho]);
+      fOutTree->Branch(Form("phosmearAbs_%i",ipho), &fExtras.smearAbs[ipho]);
+    }
+  }
+}
+
+void DisPhoGenerator::SetupDefaults()
+{
+  fNEvents = 10000;
+  fIsMC = false;
+  fIsGMSB = false;
+  fIsHVDS = false;
+  fIsToy = false;
+  fStoreRecHits = false;
+  fSeed = 4357;
+  fEra = "Full";
+  fEventsPerLumi = 1000;
+  fMeanNPhotons = 2.f;
+  fMeanPhoPt = 50.f;
+  fMeanNJets = 4.f;
+  fMeanNRecHits = 150.f;
+  fRecHitsPerPho = 9.f;
+  fMeanNVtx = 32.f;
+  fMeanMET = 40.f;
+  fLLPMass = 300.f;
+  fLLPCTau = 10.f;
+  fXsec = 1.f;
+  fFilterEff = 1.f;
+  fBR = 1.f;
+  fTimeMu = -9999.f; // set from data/MC unless given
+  fTimeC = -9999.f;
+}
+
+void DisPhoGenerator::SetupGenConfig()
+{
+  std::cout << "Reading gen config..." << std::endl;
+
+  std::ifstream infile(Form("%s",fGenConfig.Data()),std::ios::in);
+  std::string str;
+  while (std::getline(infile,str))
+  {
+    if (str == "") continue;
+    else if (str.find("n_events=") != std::string::npos)
+    {
+      fNEvents = std::stoull(Common::RemoveDelim(str,"n_events="));
+    }
+    else if (str.find("is_mc=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"is_mc=");
+      Common::SetupBool(str,fIsMC);
+    }
+    else if (str.find("is_gmsb=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"is_gmsb=");
+      Common::SetupBool(str,fIsGMSB);
+    }
+    else if (str.find("is_hvds=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"is_hvds=");
+      Common::SetupBool(str,fIsHVDS);
+    }
+    else if (str.find("is_toy=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"is_toy=");
+      Common::SetupBool(str,fIsToy);
+    }
+    else if (str.find("store_rechits=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"store_rechits=");
+      Common::SetupBool(str,fStoreRecHits);
+    }
+    else if (str.find("seed=") != std::string::npos)
+    {
+      fSeed = std::atoi(Common::RemoveDelim(str,"seed=").c_str());
+    }
+    else if (str.find("era=") != std::string::npos)
+    {
+      fEra = Common::RemoveDelim(str,"era=");
+    }
+    else if (str.find("events_per_lumi=") != std::string::npos)
+    {
+      fEventsPerLumi = std::max(1,std::atoi(Common::RemoveDelim(str,"events_per_lumi=").c_str()));
+    }
+    else if (str.find("mean_n_photons=") != std::string::npos)
+    {
+      fMeanNPhotons = Common::Atof(Common::RemoveDelim(str,"mean_n_photons="));
+    }
+    else if (str.find("mean_pho_pt=") != std::string::npos)
+    {
+      fMeanPhoPt = Common::Atof(Common::RemoveDelim(str,"mean_pho_pt="));
+    }
+    else if (str.find("mean_n_jets=") != std::string::npos)
+    {
+      fMeanNJets = Common::Atof(Common::RemoveDelim(str,"mean_n_jets="));
+    }
+    else if (str.find("mean_n_rechits=") != std::string::npos)
+    {
+      fMeanNRecHits = Common::Atof(Common::RemoveDelim(str,"mean_n_rechits="));
+    }
+    else if (str.find("rechits_per_pho=") != std::string::npos)
+    {
+      fRecHitsPerPho = Common::Atof(Common::RemoveDelim(str,"rechits_per_pho="));
+    }
+    else if (str.find("mean_n_vtx=") != std::string::npos)
+    {
+      fMeanNVtx = Common::Atof(Common::RemoveDelim(str,"mean_n_vtx="));
+    }
+    else if (str.find("mean_met=") != std::string::npos)
+    {
+      fMeanMET = Common::Atof(Common::RemoveDelim(str,"mean_met="));
+    }
+    else if (str.find("llp_mass=") != std::string::npos)
+    {
+      fLLPMass = Common::Atof(Common::RemoveDelim(str,"llp_mass="));
+    }
+    else if (str.find("llp_ctau=") != std::string::npos)
+    {
+      fLLPCTau = Common::Atof(Common::RemoveDelim(str,"llp_ctau="));
+    }
+    else if (str.find("xsec=") != std::string::npos)
+    {
+      fXsec = Common::Atof(Common::RemoveDelim(str,"xsec="));
+    }
+    else if (str.find("filter_eff=") != std::string::npos)
+    {
+      fFilterEff = Common::Atof(Common::RemoveDelim(str,"filter_eff="));
+    }
+    else if (str.find("BR=") != std::string::npos)
+    {
+      fBR = Common::Atof(Common::RemoveDelim(str,"BR="));
+    }
+    else if (str.find("time_mu=") != std::string::npos)
+    {
+      fTimeMu = Common::Atof(Common::RemoveDelim(str,"time_mu="));
+    }
+    else if (str.find("time_C=") != std::string::npos)
+    {
+      fTimeC = Common::Atof(Common::RemoveDelim(str,"time_C="));
+    }
+    else
+    {
+      std::cerr << "Aye... your gen config is messed up, try again!" << std::endl;
+      std::cerr << "Offending line: " << str.c_str() << std::endl;
+      exit(1);
+    }
+  }
+
+  // signal and toys are MC, and only one kind of signal per file
+  fIsMC = (fIsMC || fIsGMSB || fIsHVDS || fIsToy);
+  fIsBkgd = (fIsMC && !fIsGMSB && !fIsHVDS && !fIsToy);
+  if (fIsGMSB && fIsHVDS)
+  {
+    std::cerr << "Aye... your gen config is messed up, is_gmsb and is_hvds are exclusive! Exiting..." << std::endl;
+    exit(1);
+  }
+
+  // time model
+  if (fTimeMu == -9999.f) fTimeMu = (fIsMC ? Common::genTimeMuMC : Common::genTimeMuData);
+  if (fTimeC  == -9999.f) fTimeC  = (fIsMC ? Common::genTimeCMC  : Common::genTimeCData);
+}
+
+void DisPhoGenerator::SetupConfig()
+{
+  // DisPho defaults, with the sample info from the gen config
+  fConfig.blindSF = 1000;
+  fConfig.applyBlindSF = false;
+  fConfig.blindMET = 100.f;
+  fConfig.applyBlindMET = false;
+  fConfig.jetpTmin = 15.f;
+  fConfig.jetEtamax = 3.f;
+  fConfig.jetIDmin = 1;
+  fConfig.rhEmin = 1.f;
+  fConfig.phpTmin = 20.f;
+  fConfig.phIDmin_s = "none";
+  fConfig.seedTimemin = -25.f;
+  fConfig.splitPho = false;
+  fConfig.onlyGED = false;
+  fConfig.onlyOOT = false;
+  fConfig.storeRecHits = fStoreRecHits;
+  fConfig.applyTrigger = false;
+  fConfig.minHT = 400.f;
+  fConfig.applyHT = false;
+  fConfig.phgoodpTmin = 70.f;
+  fConfig.phgoodIDmin_s = "loose";
+  fConfig.applyPhGood = false;
+  fConfig.dRmin = 0.3f;
+  fConfig.pTres = 100.f;
+  fExtras.gendRmin = 0.1f;
+  fConfig.genpTres = 0.5f;
+  fConfig.trackdRmin = 0.2f;
+  fConfig.trackpTmin = 5.f;
+  fConfig.genjetdRmin = 0.2f;
+  fConfig.genjetpTfactor = 3.f;
+  fConfig.smearjetEmin = 0.01f;
+  fConfig.inputPaths_s = fGenConfig.Data();
+  fConfig.inputFilters_s = fGenConfig.Data();
+  fConfig.inputFlags_s = fGenConfig.Data();
+  fConfig.isGMSB = fIsGMSB;
+  fConfig.isHVDS = fIsHVDS;
+  fConfig.isBkgd = fIsBkgd;
+  fConfig.isToy = fIsToy;
+  fConfig.isADD = false;
+  fConfig.xsec = fXsec;
+  fConfig.filterEff = fFilterEff;
+  fConfig.BR = fBR;
+}
@@ -0,0 +1,183 @@
+#ifndef __DisPhoGenerator__
+#define __DisPhoGenerator__
+
+// ROOT includes
+#include "TFile.h"
+#include "TDirectory.h"
+#include "TTree.h"
+#include "TH1F.h"
+#include "TRandom3.h"
+#include "TString.h"
+
+// STL includes
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+// Common include
+#include "Common.hh"
+#include "SkimmerTypes.hh"
+
+namespace Common
+{
+  // seed time model: t = mu + delay + gaus(0,sigma), sigma(E) = sqrt((N/E)^2 + 2C^2), as weighted in the Skimmer
+  constexpr Float_t genTimeMuData = 0.15f;  // ns
+  constexpr Float_t genTimeMuMC   = -0.05f; // ns
+  constexpr Float_t genTimeCData  = Common::timefitC;
+  constexpr Float_t genTimeCMC    = 0.5f * Common::timefitC;
+
+  // ECAL geometry of the generated hits
+  constexpr Float_t genEBCrystalDEta = 0.0174f;
+  constexpr Float_t genEECrystalSize = 2.862f; // cm
+  constexpr Int_t   genEBiEtaMax     = 85;
+  constexpr Int_t   genEEiXYMax      = 100;
+
+  // run numbering: new run every so many lumis
+  constexpr UInt_t  genLumisPerRun   = 100;
+};
+
+// DisPho branches the Skimmer never reads, so SkimmerTypes does not carry them
+struct GenExtras
+{
+  // config
+  Float_t gendRmin;
+
+  // MC jets
+  std::vector<Float_t> jetscaleRel;
+  std::vector<Float_t> jetsmearSF;
+  std::vector<Float_t> jetsmearDownSF;
+  std::vector<Float_t> jetsmearUpSF;
+  std::vector<Int_t>   jetisGen;
+
+  // per photon
+  std::vector<Int_t>   seedisOOT;
+  std::vector<Float_t> scaleAbs;
+  std::vector<Float_t> smearAbs;
+};
+
+// a photon before it is sorted into the pho_i branches
+struct GenPhoton
+{
+  GenPhoton() {}
+  GenPhoton(const Float_t E, const Float_t x, const Float_t y, const Float_t z, const Float_t delay, const Int_t mother, const Int_t daughter)
+    : E(E), x(x), y(y), z(z), delay(delay), mother(mother), daughter(daughter) {}
+
+  Float_t E;
+  Float_t x, y, z; // ECAL hit position
+  Float_t delay;   // arrival time minus that of a prompt photon to the same crystal
+  Int_t   mother;  // index of the LLP (GMSB neutralino or HVDS vPion) it came from, -1 if none
+  Int_t   daughter;
+};
+
+// Writes ntuples with the layout DisPho produces: tree/configtree (one entry), tree/disphotree, and the
+// cut flow and gen PU histograms, so the macro chain can be run on local, reproducible inputs.
+// Physics is a toy: exponential spectra, an ECAL made of crystal centers, and a seed time model
+// whose mean and resolution are the Common::genTime constants above (or the gen config overrides).
+// Every event passes the DisPho cut flow, as in the real ntuples after selection.
+class DisPhoGenerator
+{
+public:
+  DisPhoGenerator(const TString & genconfig, const TString & outfilename);
+  ~DisPhoGenerator();
+
+  // Config
+  void SetupDefaults();
+  void SetupGenConfig();
+  void SetupConfig();
+
+  // Main call
+  void Generate();
+
+  // Init outputs
+  void InitOutConfigTree();
+  void InitOutTree();
+  void InitOutBranches();
+  void InitOutHists();
+
+  // Event generation
+  void GenerateEvent(const ULong64_t ievent);
+  void GenerateEventInfo(const ULong64_t ievent);
+  void GenerateJets();
+  void GenerateLLPs(std::vector<GenPhoton> & genphos);
+  void GenerateToys();
+  void GeneratePhotons(std::vector<GenPhoton> & genphos);
+  void FillPhoton(const Int_t ipho, const GenPhoton & genpho);
+  void ResetPhoton(const Int_t ipho);
+  void GenerateNoiseRecHits();
+  Int_t AddRecHit(const UInt_t detid, const Float_t E, const Float_t delay);
+
+  // Helpers
+  Bool_t PropagateToECAL(const Float_t x0, const Float_t y0, const Float_t z0, const Float_t px, const Float_t py, const Float_t pz,
+			 Float_t & x, Float_t & y, Float_t & z) const;
+  UInt_t GetDetID(const Float_t x, const Float_t y, const Float_t z) const;
+  UInt_t GetNeighborDetID(const UInt_t detid, const Int_t di1, const Int_t di2) const;
+  void GetDetIDPosition(const UInt_t detid, Float_t & x, Float_t & y, Float_t & z) const;
+  Bool_t IsEB(const UInt_t detid) const {return (((detid >> 25) & 0x7) == 1);}
+  Float_t GetTimeSigma(const Float_t E) const {return std::sqrt(std::pow(Common::timefitN/E,2)+2.f*std::pow(fTimeC,2));}
+  Float_t GetTOF(const Float_t x, const Float_t y, const Float_t z) const
+  {return Common::hypot(x-fEvent.vtxX,y-fEvent.vtxY,z-fEvent.vtxZ) / Common::sol;}
+
+private:
+  // settings
+  const TString fGenConfig;
+  const TString fOutFileName;
+
+  // gen config
+  ULong64_t fNEvents;
+  Bool_t  fIsMC;
+  Bool_t  fIsGMSB;
+  Bool_t  fIsHVDS;
+  Bool_t  fIsToy;
+  Bool_t  fIsBkgd;
+  Bool_t  fStoreRecHits;
+  UInt_t  fSeed;
+  TString fEra;
+  UInt_t  fEventsPerLumi;
+  Float_t fMeanNPhotons;
+  Float_t fMeanPhoPt;
+  Float_t fMeanNJets;
+  Float_t fMeanNRecHits;
+  Float_t fRecHitsPerPho;
+  Float_t fMeanNVtx;
+  Float_t fMeanMET;
+  Float_t fLLPMass;
+  Float_t fLLPCTau;
+  Float_t fXsec;
+  Float_t fFilterEff;
+  Float_t fBR;
+  Float_t fTimeMu;
+  Float_t fTimeC;
+
+  // random numbers
+  TRandom3 * fRand;
+
+  // output
+  TFile * fOutFile;
+  TTree * fOutConfigTree;
+  TTree * fOutTree;
+
+  Configuration fConfig;
+  Event fEvent;
+  Jet fJets;
+  RecHits fRecHits;
+  PhoVec fPhos;
+  GmsbVec fGMSBs;
+  HvdsVec fHVDSs;
+  ToyVec fToys;
+  GenExtras fExtras;
+
+  // cut flow and gen PU hists
+  CutFlow fCutFlow;
+  std::vector<Int_t> fCutSlots;
+  TH1F * fCutFlowHist;
+  TH1F * fCutFlowWgtHist;
+  TH1F * fGenPUObsHist;
+  TH1F * fGenPUObsWgtHist;
+  TH1F * fGenPUTrueHist;
+  TH1F * fGenPUTrueWgtHist;
+};
+
+#endif
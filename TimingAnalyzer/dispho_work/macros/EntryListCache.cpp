@@ -0,0 +1,174 @@
+// Class include
+#include "EntryListCache.hh"
+
+EntryListCache::EntryListCache(const TString & cachename)
+  : fCacheName(cachename), fCacheFile(NULL), fNHits(0), fNIntersected(0), fNComputed(0)
+{
+  if (fCacheName == "") return;
+
+  std::cout << "Initializing EntryListCache: " << fCacheName.Data() << std::endl;
+
+  // created if not there yet
+  auto olddir = gDirectory;
+  fCacheFile = TFile::Open(Form("%s",fCacheName.Data()),"UPDATE");
+  Common::CheckValidFile(fCacheFile,fCacheName);
+  olddir->cd();
+}
+
+EntryListCache::~EntryListCache()
+{
+  if (fCacheFile == (TFile*) NULL) return;
+
+  std::cout << "EntryListCache: " << fNHits << " lists reused, " << fNIntersected << " intersected from cached cuts, "
+	    << fNComputed << " computed" << std::endl;
+
+  delete fCacheFile;
+}
+
+TString EntryListCache::GetTreeKey(TFile * file, const TString & treename) const
+{
+  if (fCacheFile == (TFile*) NULL || file == (TFile*) NULL) return "";
+
+  // a rewritten tree gets a new cycle or date, even in a file opened in UPDATE
+  const auto key = file->GetKey(Form("%s",treename.Data()));
+  if (key == (TKey*) NULL) return "";
+
+  return Form("%s|%s|%s;%i|%s",file->GetName(),file->GetUUID().AsString(),treename.Data(),
+	      key->GetCycle(),key->GetDatime().AsSQLString());
+}
+
+void EntryListCache::MakeList(TTree * tree, const TString & treekey, const TString & cut, TEntryList * list, TString & chain,
+			      std::ostream & log)
+{
+  const auto normcut = EntryListCache::NormalizeCut(cut);
+  const auto parent  = chain;
+  chain = (parent == "" ? normcut : parent+"&&"+normcut);
+
+  // nothing to key on: plain TTree::Draw()
+  if (fCacheFile == (TFile*) NULL || treekey == "")
+  {
+    tree->Draw(Form(">>%s",list->GetName()),Form("%s",cut.Data()),"entrylist");
+    return;
+  }
+
+  const TString basekey = Form("%s|%lld|",treekey.Data(),tree->GetEntries());
+
+  // same chain of cuts on the same tree
+  if (auto cached = EntryListCache::Get(basekey+chain))
+  {
+    log << "  reusing cached list" << std::endl;
+    EntryListCache::FillList(tree,list,cached);
+    delete cached;
+    fNHits++;
+    return;
+  }
+
+  // parent chain and this cut on its own both cached: their intersection, no pass over the tree
+  if (parent != "")
+  {
+    auto cachedParent = EntryListCache::Get(basekey+parent);
+    auto cachedCut    = (cachedParent ? EntryListCache::Get(basekey+normcut) : (TEntryList*) NULL);
+
+    const Bool_t isIntersected = (cachedParent && cachedCut);
+    if (isIntersected)
+    {
+      log << "  intersecting cached lists" << std::endl;
+      if (cachedParent->GetN() <= cachedCut->GetN()) EntryListCache::FillList(tree,list,cachedParent,cachedCut);
+      else                                           EntryListCache::FillList(tree,list,cachedCut,cachedParent);
+      EntryListCache::Put(basekey+chain,list);
+      fNIntersected++;
+    }
+
+    delete cachedCut;
+    delete cachedParent;
+    if (isIntersected) return;
+  }
+
+  // use ttree::draw() to generate entry list, and keep it
+  tree->Draw(Form(">>%s",list->GetName()),Form("%s",cut.Data()),"entrylist");
+  EntryListCache::Put(basekey+chain,list);
+  fNComputed++;
+}
+
+TEntryList * EntryListCache::Get(const TString & key) const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  auto cached = (TEntryList*)fCacheFile->Get(EntryListCache::GetListName(key).Data());
+  if (cached == (TEntryList*) NULL) return NULL;
+
+  // hash collision: treat as missing
+  if (key != cached->GetTitle())
+  {
+    delete cached;
+    return NULL;
+  }
+
+  cached->SetDirectory(0);
+  return cached;
+}
+
+void EntryListCache::Put(const TString & key, const TEntryList * list)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  auto olddir = gDirectory;
+
+  // copy, so the caller's list keeps its name and directory
+  fCacheFile->cd();
+  TEntryList copy(*list);
+  copy.SetDirectory(0);
+  copy.SetName(EntryListCache::GetListName(key).Data());
+  copy.SetTitle(key.Data());
+  copy.Write(copy.GetName(),TObject::kWriteDelete);
+
+  olddir->cd();
+}
+
+TString EntryListCache::GetListName(const TString & key)
+{
+  return Form("elist_%08x",key.Hash());
+}
+
+TString EntryListCache::NormalizeCut(const TString & cut)
+{
+  // whitespace never matters in a cut string
+  TString normcut = "";
+  for (auto i = 0; i < cut.Length(); i++)
+  {
+    if (!std::isspace(cut[i])) normcut += cut[i];
+  }
+
+  // nor do parentheses around the whole of it
+  while (normcut.Length() > 1 && normcut[0] == '(' && normcut[normcut.Length()-1] == ')')
+  {
+    auto depth = 0;
+    auto enclosing = true;
+    for (auto i = 0; i < normcut.Length()-1; i++)
+    {
+      if      (normcut[i] == '(') depth++;
+      else if (normcut[i] == ')') depth--;
+      if (depth == 0) {enclosing = false; break;}
+    }
+    if (!enclosing) break;
+    normcut = normcut(1,normcut.Length()-2);
+  }
+
+  return normcut;
+}
+
+void EntryListCache::FillList(TTree * tree, TEntryList * list, TEntryList * cached, TEntryList * mask)
+{
+  list->Reset();
+  list->SetTree(tree);
+
+  const auto nEntries = cached->GetN();
+  for (auto ientry = 0LL; ientry < nEntries; ientry++)
+  {
+    const auto entry = cached->GetEntry(ientry);
+    if (entry < 0) break;
+    if (mask && !mask->Contains(entry)) continue;
+
+    list->Enter(entry);
+  }
+}
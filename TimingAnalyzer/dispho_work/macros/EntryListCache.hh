@@ -0,0 +1,57 @@
+#ifndef __EntryListCache__
+#define __EntryListCache__
+
+// ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TKey.h"
+#include "TEntryList.h"
+#include "TString.h"
+
+// STL includes
+#include <iostream>
+#include <cctype>
+#include <mutex>
+#include <atomic>
+
+// Common include
+#include "Common.hh"
+
+// Selections already computed for a given tree: TEntryLists (themselves blocks of bits, or of
+// entry numbers when sparse) in a compressed ROOT file, keyed by the tree they came from and
+// the normalized chain of cuts applied to it, in order.
+// MakeList() may be called from several threads at once (ROOT::EnableThreadSafety()), each on its own tree.
+class EntryListCache
+{
+public:
+  EntryListCache(const TString & cachename); // "": no cache, every list is computed
+  ~EntryListCache();
+
+  // identity of a tree in a file: name, file UUID, and the cycle and date of its key; "" if not cacheable
+  TString GetTreeKey(TFile * file, const TString & treename) const;
+
+  // fill list with the entries of tree passing cut, on top of the tree's current entry list (the cuts in chain);
+  // chain is then extended with cut, for the next call on the same tree; messages go to log
+  void MakeList(TTree * tree, const TString & treekey, const TString & cut, TEntryList * list, TString & chain,
+		std::ostream & log = std::cout);
+
+  // helpers
+  static TString NormalizeCut(const TString & cut);
+  static void FillList(TTree * tree, TEntryList * list, TEntryList * cached, TEntryList * mask = NULL);
+
+private:
+  TEntryList * Get(const TString & key) const;
+  void Put(const TString & key, const TEntryList * list);
+  static TString GetListName(const TString & key);
+
+  const TString fCacheName;
+  TFile * fCacheFile;
+  mutable std::mutex fMutex; // guards fCacheFile
+
+  // bookkeeping
+  std::atomic<UInt_t> fNHits;
+  std::atomic<UInt_t> fNIntersected;
+  std::atomic<UInt_t> fNComputed;
+};
+
+#endif
@@ -0,0 +1,383 @@
+#include "EraTreePlotter.hh"
+
+EraTreePlotter::EraTreePlotter(const TString & infilename, const TString & insignalfilename, const TString & cutconfig,
+			       const TString & varwgtmapconfig, const TString & plotconfig, const TString & miscconfig,
+			       const TString & eraplotconfig)
+  : fInFileName(infilename), fInSignalFileName(insignalfilename), fCutConfig(cutconfig),
+    fVarWgtMapConfig(varwgtmapconfig), fPlotConfig(plotconfig), fMiscConfig(miscconfig),
+    fEraPlotConfig(eraplotconfig)
+{
+  std::cout << "Initializing EraTreePlotter..." << std::endl;
+
+  ////////////////
+  //            //
+  // Initialize //
+  //            //
+  ////////////////
+
+  // Get input file
+  fInFile = TFile::Open(Form("%s",fInFileName.Data()));
+  Common::CheckValidFile(fInFile,fInFileName);
+
+  // Get signal input file
+  fInSignalFile = TFile::Open(Form("%s",fInSignalFileName.Data()));
+  Common::CheckValidFile(fInSignalFile,fInSignalFileName);
+
+  // setup config
+  TreePlotter::SetupDefaults();
+  EraTreePlotter::SetupEraPlotConfig();
+  EraTreePlotter::SetupCommon();
+  TreePlotter::SetupMiscConfig(fMiscConfig);
+  if (TreePlotter::fSkipData) Common::RemoveData();
+  if (TreePlotter::fSignalsOnly) Common::KeepOnlySignals();
+  TreePlotter::SetupPlotConfig(fPlotConfig);
+
+  // setup run -> era lookup
+  EraTreePlotter::SetupRunLookup();
+}
+
+EraTreePlotter::~EraTreePlotter()
+{
+  // anything not handed over to an era plot
+  for (auto & EraHistMap : EraHistMaps)
+  {
+    for (auto & HistPair : EraHistMap) delete HistPair.second;
+  }
+
+  delete fInSignalFile;
+  delete fInFile;
+}
+
+void EraTreePlotter::MakeEraTreePlots()
+{
+  // Fill hists of every era in one pass over the trees
+  EraTreePlotter::MakeHistsFromTrees();
+
+  // Then make the usual plot for each era
+  for (const auto & era : fEras)
+  {
+    EraTreePlotter::MakeEraPlot(era);
+  }
+}
+
+void EraTreePlotter::MakeHistsFromTrees()
+{
+  std::cout << "Making hists for all eras from input trees..." << std::endl;
+
+  EraHistMaps.resize(fEras.size());
+
+  // loop over sample groups for each tree
+  for (const auto & TreeNamePair : Common::TreeNameMap)
+  {
+    // Init
+    const auto & sample   = TreeNamePair.first;
+    const auto & treename = TreeNamePair.second;
+    const auto & histname = Common::HistNameMap[sample];
+    std::cout << "Working on tree: " << treename.Data() << std::endl;
+
+    // Get infile
+    auto & infile = ((Common::GroupMap[sample] != SampleGroup::isSignal) ? fInFile : fInSignalFile);
+    infile->cd();
+
+    // Get TTree
+    auto intree = (TTree*)infile->Get(Form("%s",treename.Data()));
+    const auto isnull = Common::IsNullTree(intree);
+    if (isnull) std::cout << "Skipping null tree..." << std::endl;
+
+    if (Common::GroupMap[sample] == SampleGroup::isData)
+    {
+      // one hist per era, split by run in a single pass
+      for (auto iera = 0U; iera < fEras.size(); iera++)
+      {
+	auto & hist = EraHistMaps[iera][sample];
+	hist = TreePlotter::SetupHist(histname);
+	hist->SetDirectory(0);
+      }
+
+      if (!isnull) EraTreePlotter::FillDataHists(intree,sample);
+    }
+    else
+    {
+      // MC does not depend on the run: fill once, then scale by lumi fraction per era
+      auto hist = TreePlotter::SetupHist(histname);
+      hist->SetDirectory(infile);
+
+      if (!isnull)
+      {
+	std::cout << "Filling hist from tree..." << std::endl;
+	intree->Draw(Form("%s>>%s",Common::XVarMap[sample].Data(),hist->GetName()),Form("%s",Common::CutWgtMap[sample].Data()),"goff");
+      }
+      hist->SetDirectory(0);
+
+      for (auto iera = 0U; iera < fEras.size(); iera++)
+      {
+	auto erahist = (TH1F*)hist->Clone(histname.Data());
+	erahist->SetDirectory(0);
+	erahist->Scale(Common::GetEraWeight(fEras[iera]));
+	EraHistMaps[iera][sample] = erahist;
+      }
+
+      delete hist;
+    }
+
+    // delete tree;
+    delete intree;
+  }
+
+  // rescale bins by widths if variable size
+  if (fXVarBins)
+  {
+    const Bool_t isUp = false;
+    for (auto & EraHistMap : EraHistMaps)
+    {
+      for (auto & HistPair : EraHistMap)
+      {
+	auto & hist = HistPair.second;
+	Common::Scale(hist,isUp);
+      }
+    }
+  }
+}
+
+void EraTreePlotter::FillDataHists(TTree * tree, const TString & sample)
+{
+  std::cout << "Filling era hists from tree..." << std::endl;
+
+  const auto & xvar   = Common::XVarMap[sample];
+  const auto & cutwgt = Common::CutWgtMap[sample];
+  const auto nEntries = tree->GetEntries();
+
+  // in chunks: TTree::Draw keeps every selected row in memory
+  for (auto start = 0LL; start < nEntries; start += Common::eraFillChunk)
+  {
+    const auto nchunk = std::min(Common::eraFillChunk,nEntries-start);
+    tree->SetEstimate(nchunk+1);
+
+    auto nselected = tree->Draw(Form("%s:run",xvar.Data()),Form("%s",cutwgt.Data()),"goff",nchunk,start);
+
+    // array variables give more rows than entries
+    if (nselected > tree->GetEstimate())
+    {
+      tree->SetEstimate(nselected+1);
+      nselected = tree->Draw(Form("%s:run",xvar.Data()),Form("%s",cutwgt.Data()),"goff",nchunk,start);
+    }
+
+    const auto xs   = tree->GetV1();
+    const auto runs = tree->GetV2();
+    const auto ws   = tree->GetW();
+
+    for (auto i = 0LL; i < nselected; i++)
+    {
+      for (const auto iera : EraTreePlotter::GetEras(std::llround(runs[i])))
+      {
+	EraHistMaps[iera][sample]->Fill(xs[i],ws[i]);
+      }
+    }
+  }
+}
+
+void EraTreePlotter::MakeEraPlot(const TString & era)
+{
+  std::cout << "Making plot for era: " << era.Data() << std::endl;
+
+  const auto iera = std::find(fEras.begin(),fEras.end(),era) - fEras.begin();
+  const TString outfiletext = fInFileText+"_"+era;
+
+  // set style
+  TreePlotter::fTDRStyle = new TStyle("TDRStyle","Style for P-TDR");
+  Common::SetTDRStyle(TreePlotter::fTDRStyle);
+
+  // output root file for quick inspection
+  TreePlotter::fOutFile = TFile::Open(Form("%s.root",outfiletext.Data()),"UPDATE");
+
+  // hand over this era's hists: deleted with the rest of the plot
+  TreePlotter::HistMap.swap(EraHistMaps[iera]);
+  TreePlotter::SetupHistsStyle();
+
+  // save totals to output file
+  TreePlotter::fOutFile->cd();
+  for (const auto & HistPair : TreePlotter::HistMap)
+  {
+    const auto & hist = HistPair.second;
+    hist->Write(hist->GetName(),TObject::kWriteDelete);
+  }
+
+  // Make Data Output
+  TreePlotter::MakeDataOutput();
+
+  // Make Bkgd Output
+  TreePlotter::MakeBkgdOutput();
+
+  // Make Signal Output
+  TreePlotter::MakeSignalOutput();
+
+  // Make Ratio Output
+  TreePlotter::MakeRatioOutput();
+
+  // Make Legend
+  TreePlotter::MakeLegend();
+
+  // Init Output Canv+Pads
+  TreePlotter::InitOutputCanvPads();
+
+  // Draw Upper Pad
+  TreePlotter::DrawUpperPad();
+
+  // Draw Lower Pad
+  TreePlotter::DrawLowerPad();
+
+  // Save Output
+  TreePlotter::SaveOutput(outfiletext,era);
+
+  // Write Out Config
+  EraTreePlotter::MakeConfigPave(era);
+
+  // Dump integrals into text file
+  TreePlotter::DumpIntegrals(outfiletext);
+
+  // Delete allocated memory, except the inputs
+  TreePlotter::DeleteMemory(false);
+}
+
+void EraTreePlotter::MakeConfigPave(const TString & era)
+{
+  std::cout << "Dumping config to a pave..." << std::endl;
+
+  // create the pave, copying in old info
+  TreePlotter::fOutFile->cd();
+  TreePlotter::fConfigPave = new TPaveText();
+  TreePlotter::fConfigPave->SetName(Form("%s",Common::pavename.Data()));
+
+  // give grand title
+  TreePlotter::fConfigPave->AddText("***** EraTreePlotter Config *****");
+
+  // Add era info
+  Common::AddEraInfoToPave(TreePlotter::fConfigPave,era);
+
+  // dump era config
+  Common::AddTextFromInputConfig(TreePlotter::fConfigPave,"Era Plot Config",fEraPlotConfig);
+
+  // dump plot cut config first
+  Common::AddTextFromInputConfig(TreePlotter::fConfigPave,"TreePlotter Cut Config",fCutConfig);
+
+  // dump extra weights
+  Common::AddTextFromInputConfig(TreePlotter::fConfigPave,"VarWgtMap Config",fVarWgtMapConfig);
+
+  // dump plot config
+  Common::AddTextFromInputConfig(TreePlotter::fConfigPave,"Plot Config",fPlotConfig);
+
+  // store last bits of info from misc
+  Common::AddTextFromInputConfig(TreePlotter::fConfigPave,"Miscellaneous Config",fMiscConfig);
+
+  // padding
+  Common::AddPaddingToPave(TreePlotter::fConfigPave,3);
+
+  // save name of infile, redundant
+  TreePlotter::fConfigPave->AddText(Form("InFile name: %s",fInFileName.Data()));
+
+  // dump in old config
+  Common::AddTextFromInputPave(TreePlotter::fConfigPave,fInFile);
+
+  // save name of insignalfile, redundant
+  TreePlotter::fConfigPave->AddText(Form("InSignalFile name: %s",fInSignalFileName.Data()));
+
+  // dump in old signal config
+  Common::AddTextFromInputPave(TreePlotter::fConfigPave,fInSignalFile);
+
+  // save to output file
+  TreePlotter::fOutFile->cd();
+  TreePlotter::fConfigPave->Write(TreePlotter::fConfigPave->GetName(),TObject::kWriteDelete);
+}
+
+const std::vector<UInt_t> & EraTreePlotter::GetEras(const Long64_t run) const
+{
+  static const std::vector<UInt_t> noEras;
+
+  // interval [edge i, edge i+1) holding the run
+  const Long64_t iedge = std::upper_bound(fRunEdges.begin(),fRunEdges.end(),run) - fRunEdges.begin() - 1;
+  if (iedge < 0 || iedge >= Long64_t(fRunEras.size())) return noEras;
+
+  return fRunEras[iedge];
+}
+
+void EraTreePlotter::SetupRunLookup()
+{
+  std::cout << "Setting up run lookup for eras..." << std::endl;
+
+  // every era start, and one past every era end
+  for (const auto & era : fEras)
+  {
+    const auto & erainfo = Common::EraMap[era];
+    fRunEdges.emplace_back(erainfo.startRun);
+    fRunEdges.emplace_back(Long64_t(erainfo.endRun)+1);
+  }
+  std::sort(fRunEdges.begin(),fRunEdges.end());
+  fRunEdges.erase(std::unique(fRunEdges.begin(),fRunEdges.end()),fRunEdges.end());
+
+  // eras may overlap (e.g. Full): each interval keeps all of the eras it is in
+  fRunEras.resize(fRunEdges.size()-1);
+  for (auto iedge = 0U; iedge < fRunEras.size(); iedge++)
+  {
+    for (auto iera = 0U; iera < fEras.size(); iera++)
+    {
+      const auto & erainfo = Common::EraMap[fEras[iera]];
+      if (erainfo.startRun <= fRunEdges[iedge] && fRunEdges[iedge] <= erainfo.endRun) fRunEras[iedge].emplace_back(iera);
+    }
+  }
+}
+
+void EraTreePlotter::SetupCommon()
+{
+  std::cout << "Setting up Common..." << std::endl;
+
+  Common::SetupEras();
+  Common::SetupSamples();
+  Common::SetupSignalSamples();
+  Common::SetupGroups();
+  Common::SetupSignalGroups();
+  Common::SetupSignalSubGroups();
+  Common::SetupTreeNames();
+  Common::SetupHistNames();
+  Common::SetupSignalSubGroupColors();
+  Common::SetupColors();
+  Common::SetupLabels();
+  Common::SetupCuts(fCutConfig);
+  Common::SetupEraCuts(fEras);
+  Common::SetupVarWgts(fVarWgtMapConfig);
+  Common::SetupWeights();
+}
+
+void EraTreePlotter::SetupEraPlotConfig()
+{
+  std::cout << "Reading era plot config..." << std::endl;
+
+  std::ifstream infile(Form("%s",fEraPlotConfig.Data()),std::ios::in);
+  std::string str;
+  while (std::getline(infile,str))
+  {
+    if (str == "") continue;
+    else if (str.find("in_file_text=") != std::string::npos)
+    {
+      fInFileText = Common::RemoveDelim(str,"in_file_text=");
+    }
+    else if (str.find("eras=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"eras=");
+      std::stringstream ss(str);
+      std::string era;
+      while (ss >> era) fEras.push_back(era);
+    }
+    else
+    {
+      std::cerr << "Aye... your era plot config is messed up, try again!" << std::endl;
+      std::cerr << "Offending line: " << str.c_str() << std::endl;
+      exit(1);
+    }
+  }
+
+  if (fEras.empty())
+  {
+    std::cerr << "No eras in era plot config: " << fEraPlotConfig.Data() << " ...exiting..." << std::endl;
+    exit(1);
+  }
+}
@@ -0,0 +1,63 @@
+#ifndef __EraTreePlotter__
+#define __EraTreePlotter__
+
+#include "Common.hh"
+#include "TreePlotter.hh"
+
+namespace Common
+{
+  static const Long64_t eraFillChunk = 1000000;
+};
+
+// TreePlotter for several eras at once: each tree is read once, data are split by run into the
+// eras, and MC is filled once and scaled by each era's lumi fraction. Writes the same
+// <in_file_text>_<era> outputs as one TreePlotter per era, as read by EraPlotter.
+class EraTreePlotter : TreePlotter
+{
+public:
+  EraTreePlotter(const TString & infilename, const TString & insignalfilename, const TString & cutconfig,
+		 const TString & varwgtmapconfig, const TString & plotconfig, const TString & miscconfig,
+		 const TString & eraplotconfig);
+  ~EraTreePlotter();
+
+  // setup functions
+  void SetupCommon();
+  void SetupEraPlotConfig();
+  void SetupRunLookup();
+
+  // main calls!
+  void MakeEraTreePlots();
+  void MakeHistsFromTrees();
+  void FillDataHists(TTree * tree, const TString & sample);
+  void MakeEraPlot(const TString & era);
+  void MakeConfigPave(const TString & era);
+
+  // helper functions
+  const std::vector<UInt_t> & GetEras(const Long64_t run) const;
+
+private:
+  const TString fInFileName;
+  const TString fInSignalFileName;
+  const TString fCutConfig;
+  const TString fVarWgtMapConfig;
+  const TString fPlotConfig;
+  const TString fMiscConfig;
+  const TString fEraPlotConfig;
+
+  // era config
+  TString fInFileText;
+  std::vector<TString> fEras;
+
+  // sorted run edges of the eras, and the eras each interval between edges belongs to
+  std::vector<Long64_t> fRunEdges;
+  std::vector<std::vector<UInt_t> > fRunEras;
+
+  // input
+  TFile * fInFile;
+  TFile * fInSignalFile;
+
+  // hists for each era, handed to TreePlotter one era at a time
+  std::vector<std::map<TString,TH1F*> > EraHistMaps;
+};
+
+#endif
@@ -1,9 +1,11 @@
 #include "FastSkimmer.hh"
 
 FastSkimmer::FastSkimmer(const TString & cutflowconfig, const TString & pdname, const TString & inskimdir,
-			 const TString & outtext, const Bool_t doskim, const TString & sampleconfig)
+			 const TString & outtext, const Bool_t doskim, const TString & sampleconfig,
+			 const TString & listcachename, const TString & layoutconfig, const Int_t njobs)
   : fCutFlowConfig(cutflowconfig), fPDName(pdname), fInSkimDir(inskimdir),
-    fOutFileText(outtext), fDoSkim(doskim), fSampleConfig(sampleconfig)
+    fOutFileText(outtext), fDoSkim(doskim), fSampleConfig(sampleconfig),
+    fListCacheName(listcachename), fLayoutConfig(layoutconfig), fNJobs(njobs), fListCache(listcachename), fLayout(layoutconfig)
 {
   std::cout << "Initializing FastSkimmer..." << std::endl;
 
@@ -33,10 +35,15 @@ FastSkimmer::~FastSkimmer()
   }
   delete fConfigPave;
   delete fOutFile;
+
+  // where the time went
+  Profiler::Dump(fOutFileText);
 }
 
 void FastSkimmer::MakeSkim()
 {
+  PROFILE_SCOPE("FastSkimmer::MakeSkim");
+
   // Make TEntryLists for each Subsample
   FastSkimmer::MakeListFromTrees();
 
@@ -49,93 +56,263 @@ void FastSkimmer::MakeSkim()
 
 void FastSkimmer::MakeListFromTrees()
 {
+  PROFILE_READ_SCOPE("FastSkimmer::MakeListFromTrees");
+
   std::cout << "Making TEntryLists from trees..." << std::endl;
 
+  // subsamples, in the order they are written out
+  std::vector<SampleLists> samples(Common::SampleMap.size());
+  auto ifill = 0U;
   for (const auto & SamplePair : Common::SampleMap)
   {
-    // Init
-    const auto & input    = SamplePair.first;
-    const auto samplename = Common::ReplaceSlashWithUnderscore(input);
-    
-    std::cout << "Working on sample name: " << samplename.Data() << std::endl;
+    auto & sample = samples[ifill++];
+    sample.input      = SamplePair.first;
+    sample.samplename = Common::ReplaceSlashWithUnderscore(sample.input);
+    sample.histname   = Common::SampleCutFlowHistNameMap[sample.input];
 
-    // Get File
-    const TString filename = Form("%s/%s/%s/%s/%s",Common::eosDir.Data(),Common::baseDir.Data(),fInSkimDir.Data(),input.Data(),Common::tupleFileName.Data());
-    auto file = TFile::Open(Form("%s",filename.Data()));
-    Common::CheckValidFile(file,filename);
-    file->cd();
-	
-    // Get TTree
-    auto tree = (TTree*)file->Get(Form("%s",Common::disphotreename.Data()));
-    Common::CheckValidTree(tree,Common::disphotreename,filename);
+    // lists are attached to the input file while made, then to the output file when written out
+    for (const auto & CutFlowPair : Common::CutFlowPairVec)
+    {
+      auto list = ListMapMap[sample.samplename][CutFlowPair.first];
+      list->SetDirectory(0);
+      sample.lists.emplace_back(list);
+    }
+  }
 
-    // Get Input Cut Flow Histogram 
-    auto inhist = (TH1F*)file->Get(Form("%s",Common::h_cutflow_scaledname.Data()));
-    Common::CheckValidHist(inhist,Common::h_cutflow_scaledname,filename);
+  // one at a time
+  const UInt_t njobs = std::min<UInt_t>(std::max(fNJobs,1),samples.size());
+  if (njobs <= 1)
+  {
+    for (auto & sample : samples)
+    {
+      FastSkimmer::OpenSample(sample,false);
+      FastSkimmer::MakeListFromTree(sample);
+      FastSkimmer::WriteLists(sample);
+    }
+    return;
+  }
 
-    // Init Output Cut Flow Histogram 
-    std::map<TString,Int_t> binlabels;
-    auto outhist = Common::SetupOutCutFlowHist(inhist,Common::SampleCutFlowHistNameMap[input],binlabels);
+  // else njobs at a time, each in its own thread with its own file: reads are mostly waiting on EOS, not on the cpu
+  std::cout << "Making lists of " << samples.size() << " subsamples with " << njobs << " workers..." << std::endl;
+  ROOT::EnableThreadSafety();
 
-    // Set tmp evtwgt variables for filling cutflow histogram
-    Float_t evtwgt = 0;
-    TBranch * b_evtwgt = 0;
-    tree->SetBranchAddress("evtwgt",&evtwgt,&b_evtwgt);
+  std::mutex mutex;
+  std::condition_variable condition;
+  UInt_t nopened = 0, nclaimed = 0; // guarded by mutex, as is isDone of each sample
 
-    // Loop over cuts, and make entry list for each cut
-    for (const auto & CutFlowPair : Common::CutFlowPairVec)
+  // prefetcher: opens files in order, and reads the first baskets the cuts need, up to njobs files ahead of the workers
+  std::thread prefetcher([&]()
+  {
+    for (auto isample = 0U; isample < samples.size(); isample++)
     {
-      const auto & label = CutFlowPair.first;
-      const auto & cutstring = CutFlowPair.second;
+      {
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock,[&]{return (isample < nclaimed+njobs);});
+      }
 
-      std::cout << "Computing entries for cut: " << label.Data() << std::endl;
-      
-      // Get entry list	
-      file->cd();
-      auto & list = ListMapMap[samplename][label];
-      list->SetDirectory(file);
+      FastSkimmer::OpenSample(samples[isample],true);
 
-      // use ttree::draw() to generate entry list
-      tree->Draw(Form(">>%s",list->GetName()),Form("%s",cutstring.Data()),"entrylist");
+      {
+	std::lock_guard<std::mutex> lock(mutex);
+	nopened = isample+1;
+      }
+      condition.notify_all();
+    }
+  });
 
-      // recursively set entry list for input tree
-      tree->SetEntryList(list);
-      
-      // store result of number of entries into cutflow th1
-      for (auto ientry = 0U; ientry < tree->GetEntries(); ientry++)
+  // workers: next subsample in order, once opened
+  auto work = [&]()
+  {
+    while (true)
+    {
+      UInt_t isample = 0;
       {
-	// from the wise words of philippe: https://root-forum.cern.ch/t/tentrylist-and-setentrylist-on-chain-not-registering/28286/6
-	// and also: https://root-forum.cern.ch/t/ttree-loadtree/14566/6
-	auto filteredEntry = tree->GetEntryNumber(ientry);
-	if (filteredEntry < 0) break;
-	auto localEntry = tree->LoadTree(filteredEntry);
-	if (localEntry < 0) break;
-
-	b_evtwgt->GetEntry(localEntry);
-	outhist->Fill((binlabels[label]*1.f)-0.5f,evtwgt);
+	std::unique_lock<std::mutex> lock(mutex);
+	if (nclaimed >= samples.size()) break;
+	isample = nclaimed++;
       }
+      condition.notify_all();
 
-      // Write out list
-      fOutFile->cd();
-      list->SetDirectory(fOutFile);
-      list->SetTitle("EntryList");
-      list->Write(list->GetName(),TObject::kWriteDelete);
+      {
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock,[&]{return (isample < nopened);});
+      }
+
+      auto & sample = samples[isample];
+      sample.log = &sample.buffer;
+      FastSkimmer::MakeListFromTree(sample);
+
+      {
+	std::lock_guard<std::mutex> lock(mutex);
+	sample.isDone = true;
+      }
+      condition.notify_all();
     }
+  };
 
-    // Write out hist
-    fOutFile->cd();
-    outhist->Write(outhist->GetName(),TObject::kWriteDelete);
-    
-    // delete everything
-    delete outhist;
-    delete inhist;
-    delete tree;
-    delete file;
+  std::vector<std::thread> workers;
+  for (auto iworker = 0U; iworker < njobs; iworker++) workers.emplace_back(work);
+
+  // write out in order as they finish: same output file as one at a time
+  for (auto & sample : samples)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock,[&]{return sample.isDone;});
+    }
+    FastSkimmer::WriteLists(sample);
   }
+
+  for (auto & worker : workers) worker.join();
+  prefetcher.join();
+}
+
+void FastSkimmer::OpenSample(SampleLists & sample, const Bool_t prefetch) const
+{
+  PROFILE_SCOPE("FastSkimmer::OpenSample");
+
+  // Get File
+  const TString filename = Common::GetSkimFileName(fInSkimDir,sample.input);
+  sample.file = TFile::Open(Form("%s",filename.Data()));
+  Common::CheckValidFile(sample.file,filename);
+  sample.file->cd();
+
+  // Get TTree
+  sample.tree = (TTree*)sample.file->Get(Form("%s",Common::disphotreename.Data()));
+  Common::CheckValidTree(sample.tree,Common::disphotreename,filename);
+
+  if (!prefetch || sample.tree->GetEntries() == 0) return;
+
+  // cache only the branches the cuts and cut flow read, so a cluster of them comes in one vectored read
+  sample.tree->SetCacheSize(FastSkimmer::PrefetchCacheMB*1024LL*1024LL);
+  sample.tree->AddBranchToCache("evtwgt",kTRUE);
+  for (const auto & CutFlowPair : Common::CutFlowPairVec)
+  {
+    TTreeFormula formula("prefetch",CutFlowPair.second.Data(),sample.tree);
+    for (auto icode = 0; icode < formula.GetNcodes(); icode++)
+    {
+      if (auto leaf = formula.GetLeaf(icode)) sample.tree->AddBranchToCache(leaf->GetBranch(),kTRUE);
+    }
+  }
+  sample.tree->StopCacheLearningPhase();
+
+  // first cluster now, while the workers are busy with the files before this one
+  sample.tree->LoadTree(0);
+  if (auto branch = sample.tree->GetBranch("evtwgt")) branch->GetEntry(0);
+}
+
+void FastSkimmer::MakeListFromTree(SampleLists & sample)
+{
+  PROFILE_SCOPE("FastSkimmer::MakeListFromTree");
+
+  auto & log = *sample.log;
+  auto file = sample.file;
+  auto tree = sample.tree;
+
+  log << "Working on sample name: " << sample.samplename.Data() << std::endl;
+  file->cd();
+  Profiler::Count("entries",tree->GetEntries());
+
+  // Get Input Cut Flow Histogram 
+  auto inhist = (TH1F*)file->Get(Form("%s",Common::h_cutflow_scaledname.Data()));
+  Common::CheckValidHist(inhist,Common::h_cutflow_scaledname,file->GetName());
+
+  // Init Output Cut Flow Histogram 
+  auto & cutflow = sample.cutflow;
+  sample.outhist = Common::SetupOutCutFlowHist(inhist,sample.histname,cutflow);
+
+  // Set tmp evtwgt variables for filling cutflow histogram
+  Float_t evtwgt = 0;
+  TBranch * b_evtwgt = 0;
+  tree->SetBranchAddress("evtwgt",&evtwgt,&b_evtwgt);
+
+  // key for cached lists, and the cuts applied so far
+  const auto treekey = fListCache.GetTreeKey(file,Common::disphotreename);
+  TString chain = "";
+
+  // Loop over cuts, and make entry list for each cut
+  for (auto icut = 0U; icut < Common::CutFlowPairVec.size(); icut++)
+  {
+    const auto & label = Common::CutFlowPairVec[icut].first;
+    const auto slot = cutflow.GetSlot(label.Data());
+    const auto & cutstring = Common::CutFlowPairVec[icut].second;
+
+    log << "Computing entries for cut: " << label.Data() << std::endl;
+    TStopwatch timer; // cost of this cut: entry list plus cut flow fill
+      
+    // Get entry list	
+    file->cd();
+    auto list = sample.lists[icut];
+    list->SetDirectory(file);
+
+    // use ttree::draw() to generate entry list, unless cached
+    {
+      PROFILE_SCOPE("FastSkimmer::MakeList");
+      fListCache.MakeList(tree,treekey,cutstring,list,chain,log);
+    }
+
+    // recursively set entry list for input tree
+    tree->SetEntryList(list);
+      
+    // store result of number of entries into cutflow th1
+    for (auto ientry = 0U; ientry < tree->GetEntries(); ientry++)
+    {
+      // from the wise words of philippe: https://root-forum.cern.ch/t/tentrylist-and-setentrylist-on-chain-not-registering/28286/6
+      // and also: https://root-forum.cern.ch/t/ttree-loadtree/14566/6
+      auto filteredEntry = tree->GetEntryNumber(ientry);
+      if (filteredEntry < 0) break;
+      auto localEntry = tree->LoadTree(filteredEntry);
+      if (localEntry < 0) break;
+
+      b_evtwgt->GetEntry(localEntry);
+      cutflow.Fill(slot,evtwgt);
+    }
+    cutflow.AddTime(slot,timer.RealTime());
+
+    // keep list past the input file
+    list->SetDirectory(0);
+  }
+
+  // Export cuts to hist
+  cutflow.Export(NULL,sample.outhist,NULL);
+  sample.outhist->SetDirectory(0);
+  Profiler::Bytes("read",file->GetBytesRead());
+
+  // delete everything
+  delete inhist;
+  delete tree;
+  delete file;
+  sample.tree = NULL;
+  sample.file = NULL;
+}
+
+void FastSkimmer::WriteLists(SampleLists & sample)
+{
+  PROFILE_SCOPE("FastSkimmer::WriteLists");
+
+  // what a worker had to say, then efficiency and cost per cut
+  std::cout << sample.buffer.str();
+  sample.cutflow.Dump();
+
+  // Write out lists
+  fOutFile->cd();
+  for (auto list : sample.lists)
+  {
+    list->SetDirectory(fOutFile);
+    list->SetTitle("EntryList");
+    list->Write(list->GetName(),TObject::kWriteDelete);
+  }
+
+  // Write out hist
+  sample.outhist->Write(sample.outhist->GetName(),TObject::kWriteDelete);
+  delete sample.outhist;
+  sample.outhist = NULL;
 }
 
 void FastSkimmer::MakeMergedSkims()
 {
+  PROFILE_SCOPE("FastSkimmer::MakeMergedSkims");
+
   std::cout << "Make skims and merge for each sample..." << std::endl;
 
   // loop over all samples, merging subsamples and saving
@@ -155,6 +332,7 @@ void FastSkimmer::MakeMergedSkims()
     // https://root-forum.cern.ch/t/merging-trees-with-ttree-mergetrees/24301
     const TString TreeFileName = Form("tmpfile_%s.root",fOutFileText.Data());
     auto TreeFile = TFile::Open(Form("%s",TreeFileName.Data()),"RECREATE");
+    if (fLayout.IsActive()) TreeFile->SetCompressionSettings(SkimLayout::ScratchCompression); // read back once, below
 
     // output cutflow histogram
     auto OutHist = FastSkimmer::SetupTotalCutFlowHist(sample);
@@ -166,14 +344,16 @@ void FastSkimmer::MakeMergedSkims()
     if (fDoSkim && TreeList->GetEntries() != 0)
     {
       std::cout << "Merging skimmed trees..." << std::endl;
+      PROFILE_SCOPE("FastSkimmer::MergeTrees");
       
       // Now want to merge the list!
       fOutFile->cd();
-      auto OutTree = TTree::MergeTrees(TreeList);
+      auto OutTree = fLayout.MergeTrees(TreeList);
       
       // write out merged tree
       fOutFile->cd();
       OutTree->Write(OutTree->GetName(),TObject::kWriteDelete);
+      fLayout.Dump(OutTree);
 
       // delete to reduce memory footprint
       delete OutTree;
@@ -200,6 +380,8 @@ void FastSkimmer::MakeMergedSkims()
 void FastSkimmer::MakeSkimsFromEntryLists(TFile *& TreeFile, std::map<TString,TTree*> & TreeMap, TList *& TreeList,
 					  TH1F *& OutHist, const TString & sample, const TString & treename)
 {
+  PROFILE_READ_SCOPE("FastSkimmer::MakeSkimsFromEntryLists");
+
   // loop over all subsamples to avoid too many maps, simple control statement to control subsample grouping
   for (const auto & SamplePair : Common::SampleMap)
   {
@@ -210,7 +392,7 @@ void FastSkimmer::MakeSkimsFromEntryLists(TFile *& TreeFile, std::map<TString,TT
     std::cout << "Working on sample name: " << samplename.Data() << std::endl;
     
     // Get File
-    const TString infilename = Form("%s/%s/%s/%s/%s",Common::eosDir.Data(),Common::baseDir.Data(),fInSkimDir.Data(),input.Data(),Common::tupleFileName.Data());
+    const TString infilename = Common::GetSkimFileName(fInSkimDir,input);
     auto infile = TFile::Open(Form("%s",infilename.Data()));
     Common::CheckValidFile(infile,infilename);
     
@@ -248,6 +430,7 @@ void FastSkimmer::MakeSkimsFromEntryLists(TFile *& TreeFile, std::map<TString,TT
 	// Fill from tree into smaller tree
 	TreeFile->cd();
 	TreeMap[input] = intree->CopyTree("");
+	Profiler::Count("selected",nentries);
 	
 	// Add tree to list
 	TreeList->Add(TreeMap[input]);
@@ -267,6 +450,8 @@ void FastSkimmer::MakeSkimsFromEntryLists(TFile *& TreeFile, std::map<TString,TT
 
 void FastSkimmer::MakeConfigPave()
 {
+  PROFILE_SCOPE("FastSkimmer::MakeConfigPave");
+
   std::cout << "Dumping config to a pave..." << std::endl;
 
   // create the pave
@@ -288,6 +473,15 @@ void FastSkimmer::MakeConfigPave()
   // dump with option to save skim (a bit redundant as it will be obvious with .ls once the file is attached
   fConfigPave->AddText(Form("Do skim bool: %s",Common::PrintBool(fDoSkim).Data()));
 
+  // dump with entry list cache used
+  fConfigPave->AddText(Form("Entry list cache: %s",fListCacheName.Data()));
+
+  // dump with number of subsamples processed at once
+  fConfigPave->AddText(Form("Parallel jobs: %i",fNJobs));
+
+  // dump with layout of the merged skims
+  if (fLayout.IsActive()) Common::AddTextFromInputConfig(fConfigPave,"Skim Layout Config",fLayoutConfig);
+
   // save to output file
   fOutFile->cd();
   fConfigPave->Write(fConfigPave->GetName(),TObject::kWriteDelete);
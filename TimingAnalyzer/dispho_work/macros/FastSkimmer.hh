@@ -7,23 +7,55 @@
 #include "TBranch.h"
 #include "TString.h"
 #include "TEntryList.h"
+#include "TStopwatch.h"
 #include "TList.h"
 #include "TSystem.h"
 #include "TPaveText.h"
+#include "TTreeFormula.h"
+#include "TLeaf.h"
+#include "TROOT.h"
 
 // STL includes
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 // Common include
 #include "Common.hh"
+#include "EntryListCache.hh"
+#include "SkimLayout.hh"
+
+// a subsample in MakeListFromTrees(): opened, then its lists made, then written out
+struct SampleLists
+{
+  SampleLists() : file(NULL), tree(NULL), outhist(NULL), log(&std::cout), isDone(false) {}
+
+  TString input;
+  TString samplename;
+  TString histname;
+  std::vector<TEntryList*> lists; // one per cut, in order
+
+  TFile * file;
+  TTree * tree;
+  CutFlow cutflow;
+  TH1F * outhist;
+
+  std::ostream * log; // std::cout, or buffer when made in a worker: printed when written out
+  std::ostringstream buffer;
+  Bool_t isDone;
+};
 
 class FastSkimmer
 {
 public:
   FastSkimmer(const TString & cutflowconfig, const TString & pdname, const TString & inskimdir,
-	      const TString & outfiletext, const Bool_t doskim = true, const TString & sampleconfig = "");
+	      const TString & outfiletext, const Bool_t doskim = true, const TString & sampleconfig = "",
+	      const TString & listcachename = "", const TString & layoutconfig = "", const Int_t njobs = 1);
   ~FastSkimmer();
 
   // Initialize
@@ -35,6 +67,9 @@ public:
 
   // Subroutines for skimming
   void MakeListFromTrees();
+  void OpenSample(SampleLists & sample, const Bool_t prefetch) const;
+  void MakeListFromTree(SampleLists & sample);
+  void WriteLists(SampleLists & sample);
   void MakeMergedSkims();
   void MakeSkimsFromEntryLists(TFile *& TreeFile, std::map<TString,TTree*> & TreeMap, TList *& TreeList, 
 			       TH1F *& OutHist, const TString & sample, const TString & treename);
@@ -44,6 +79,9 @@ public:
 
   // Meta data and extra info
   void MakeConfigPave();
+
+  // TTreeCache of each input tree when prefetching, for the branches the cuts read
+  static const Long64_t PrefetchCacheMB = 30;
   
 private:
   // Settings
@@ -53,10 +91,19 @@ private:
   const TString fOutFileText;
   const Bool_t  fDoSkim;
   const TString fSampleConfig;
+  const TString fListCacheName;
+  const TString fLayoutConfig;
+  const Int_t   fNJobs;
 
   // tmp variables
   std::vector<TString> fSampleVec;
 
+  // selections computed in previous runs
+  EntryListCache fListCache;
+
+  // compression, baskets and clusters of the merged skims
+  SkimLayout fLayout;
+
   // Output
   TFile * fOutFile;
   std::map<TString,std::map<TString,TEntryList*> > ListMapMap;
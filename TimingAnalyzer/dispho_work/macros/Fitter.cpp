@@ -54,8 +54,11 @@ Fitter::~Fitter()
   Common::DeleteMap(fHistMapY);
   Common::DeleteMap(fHistMapX);
   Common::DeleteMap(fHistMap2D);
+  Common::DeleteMap(fSystHistMap2D);
 
+  Common::DeleteMap(fBootHistMap2D);
   Common::DeleteMap(fHistMap2DTmp);
+  Common::DeleteMap(fBootHistMap2DTmp);
   
   delete fSRFile;
   delete fQCDFile;
@@ -64,10 +67,15 @@ Fitter::~Fitter()
   if (fDoFits) delete fOutTree;
   delete fOutFile;
   delete fTDRStyle;
+
+  // where the time went
+  Profiler::Dump(fOutFileText);
 }
 
 void Fitter::DoMain()
 {
+  PROFILE_SCOPE("Fitter::DoMain");
+
   std::cout << "In main call..." << std::endl;
 
   // Get all the variables in place
@@ -103,6 +111,8 @@ void Fitter::DoMain()
 
 void Fitter::PrepareCommon()
 {
+  PROFILE_SCOPE("Fitter::PrepareCommon");
+
   std::cout << "Preparing common variables and datasets..." << std::endl;
 
   // Get the input 2D histograms
@@ -111,8 +121,21 @@ void Fitter::PrepareCommon()
   // Scale data CR to SR via MC SFs
   Common::GetSRPredFromCRs(fHistMap2D,fHistMap2DTmp,(fXVarBins||fYVarBins),fCRKFMap,fCRXFMap);
 
+  // Stat uncertainty on the factors, if the inputs were filled with bootstrap replicas
+  if (fHasBoot) 
+  {
+    Common::GetBootFactorsFromCRs(fHistMap2D,fHistMap2DTmp,fBootHistMap2D,fBootHistMap2DTmp,(fXVarBins||fYVarBins),fCRKFErrMap,fCRXFErrMap);
+    for (const auto & KFPair : fCRKFMap)
+    {
+      const auto & CR = KFPair.first;
+      std::cout << Form("%s k-Factor: %f +/- %f, x-Factor: %f +/- %f (bootstrap)",CR.Data(),
+			fCRKFMap[CR],fCRKFErrMap[CR],fCRXFMap[CR],fCRXFErrMap[CR]) << std::endl;
+    }
+  }
+
   // Check for any negative bins and set them to zero!
   Common::CheckNegativeBins(fHistMap2D);
+  Common::CheckNegativeBins(fSystHistMap2D);
 
   // Make plots from input hists and dump pre-fit integrals
   Fitter::DumpInputInfo();
@@ -129,6 +152,8 @@ void Fitter::PrepareCommon()
 
 void Fitter::GetInputHists()
 {
+  PROFILE_READ_SCOPE("Fitter::GetInputHists");
+
   std::cout << "Getting input histograms..." << std::endl;
 
   // scale up
@@ -143,6 +168,7 @@ void Fitter::GetInputHists()
   fGJetsFile->cd();
 
   Common::SetupCRHists("GJets",fGJetsFile,fHistMap2D,fHistMap2DTmp);
+  fHasBoot = Common::SetupCRBootHists("GJets",fGJetsFile,fBootHistMap2D,fBootHistMap2DTmp);
 
   ////////////
   // QCD CR //
@@ -153,6 +179,7 @@ void Fitter::GetInputHists()
   fQCDFile->cd();
 
   Common::SetupCRHists("QCD",fQCDFile,fHistMap2D,fHistMap2DTmp);
+  fHasBoot = (Common::SetupCRBootHists("QCD",fQCDFile,fBootHistMap2D,fBootHistMap2DTmp) && fHasBoot);
 
   //////////////
   // SR Hists //
@@ -164,6 +191,7 @@ void Fitter::GetInputHists()
 
   // MC bkgds excluding EWK
   Common::SetupSRMCHists(fSRFile,fHistMap2DTmp);
+  fHasBoot = (Common::SetupSRMCBootHists(fSRFile,fBootHistMap2DTmp) && fHasBoot);
 
   // EWK MC
   fHistMap2D["EWK"] = (TH2F*)fSRFile->Get(Form("%s",Common::EWKHistName.Data())); // MC prediction of all other MC backgrounds aside from GJets and QCD
@@ -190,6 +218,16 @@ void Fitter::GetInputHists()
       // load signals
       fHistMap2D[sample] = (TH2F*)fSRFile->Get(Form("%s",Common::HistNameMap[sample].Data()));
       Common::CheckValidHist(fHistMap2D[sample],Common::HistNameMap[sample],fSRFileName);
+
+      // and their variations, as named by SystFiller
+      for (const auto & syst : fSysts)
+      {
+	const TString histname = Form("%s_%s",Common::HistNameMap[sample].Data(),syst.Data());
+	auto & hist = fSystHistMap2D[Form("%s_%s",sample.Data(),syst.Data())];
+
+	hist = (TH2F*)fSRFile->Get(Form("%s",histname.Data()));
+	Common::CheckValidHist(hist,histname,fSRFileName);
+      }
     }
   }
 
@@ -212,6 +250,30 @@ void Fitter::GetInputHists()
       auto & hist = HistPair.second;
       Common::Scale(hist,isUp,fXVarBins,fYVarBins);
     }
+
+    // for variations
+    for (auto & HistPair : fSystHistMap2D)
+    {
+      auto & hist = HistPair.second;
+      Common::Scale(hist,isUp,fXVarBins,fYVarBins);
+    }
+
+    // for bootstrap replicas, with the binning of the hists they replicate
+    if (fHasBoot)
+    {
+      for (auto & HistPair : fBootHistMap2D)
+      {
+	const auto & key = HistPair.first;
+	auto & boot = HistPair.second;
+	Common::ScaleBoot(boot,fHistMap2D[key],isUp,fXVarBins,fYVarBins);
+      }
+      for (auto & HistPair : fBootHistMap2DTmp)
+      {
+	const auto & key = HistPair.first;
+	auto & boot = HistPair.second;
+	Common::ScaleBoot(boot,fHistMap2DTmp[key],isUp,fXVarBins,fYVarBins);
+      }
+    }
   }
 }  
 
@@ -680,6 +742,8 @@ void Fitter::DeclareXYVars()
 template <typename T>
 void Fitter::PreparePdfs(const T & HistMap, FitInfo & fitInfo)
 {
+  PROFILE_SCOPE("Fitter::PreparePdfs");
+
   std::cout << "Preparing common pdfs for: " << fitInfo.Text.Data() << std::endl;
 
   // Declare datasets with input histograms (when using real data as input)
@@ -687,6 +751,9 @@ void Fitter::PreparePdfs(const T & HistMap, FitInfo & fitInfo)
 
   // Make pdfs from histograms
   Fitter::DeclareSamplePdfs(fitInfo);
+
+  // Same templates for the native fit
+  if (fDoFits && fFitEngine != RooFitOnly) Fitter::DeclareNativeFit(HistMap,fitInfo);
 }
 
 template <typename T>
@@ -736,23 +803,59 @@ void Fitter::DeclareSamplePdfs(FitInfo & fitInfo)
   fitInfo.BkgdPdf = new RooAddPdf(Form("%s",bkgdname.Data()),Form("%s",bkgdname.Data()),BkgdPdfList,BkgdFracList);
 }
 
+template <typename T>
+void Fitter::DeclareNativeFit(const T & HistMap, FitInfo & fitInfo)
+{
+  std::cout << "Setting native template fit for: " << fitInfo.Text.Data() << std::endl;
+
+  // bkgd template: sum of bkgds, i.e. the same shape as the frac-weighted Bkgd_PDF
+  TH1 * bkgdHist = NULL;
+  for (const auto & BkgdGroupPair : Common::BkgdGroupMap)
+  {
+    const auto & sample = BkgdGroupPair.first;
+    const auto & hist = HistMap.at(sample);
+
+    if (bkgdHist == (TH1*) NULL)
+    {
+      bkgdHist = (TH1*)hist->Clone(Form("Bkgd_Template_%s",fitInfo.Text.Data()));
+      bkgdHist->SetDirectory(0);
+    }
+    else
+    {
+      bkgdHist->Add(hist);
+    }
+  }
+
+  fitInfo.NativeFit = new BinnedTemplateFit(bkgdHist,(fBkgdOnly ? (TH1*) NULL : HistMap.at(fSignalSample)));
+  delete bkgdHist;
+
+  // real data is fixed for all fits
+  if (!fGenData) fitInfo.NativeFit->SetData(HistMap.at("Data"));
+}
+
 void Fitter::MakeFit(FitInfo & fitInfo)
 {
+  PROFILE_SCOPE("Fitter::MakeFit");
+
   std::cout << "Doing full chain of fit for: " << fitInfo.Text.Data() << std::endl;
 
   // run n fits
   for (auto ifit = 0; ifit < fNFits; ifit++)
   {
     std::cout << "Working on ifit " << ifit << " of " << fNFits << " for: " << fitInfo.Text.Data() << std::endl;
+    Profiler::Count("fits");
 
     // Throw random numbers for new nEvents
     if (fGenData) Fitter::ThrowPoisson(fitInfo);
 
+    // Draw this one?
+    const Bool_t isDraw = (ifit % (fNFits/fNDraw) == 0);
+
     // Build Model
     Fitter::BuildModel(fitInfo);
 
-    // Construct dataset from model
-    if (fGenData) Fitter::GenerateData(fitInfo);
+    // Construct dataset from model: RooFit only needs it as a RooDataHist if fitting, drawing, or keeping it
+    if (fGenData) Fitter::GenerateData(fitInfo,(fFitEngine != NativeOnly || isDraw || ifit == (fNFits - 1)));
     
     // Fit Model to Data
     Fitter::FitModel(fitInfo);
@@ -761,7 +864,7 @@ void Fitter::MakeFit(FitInfo & fitInfo)
     Fitter::GetPredicted(fitInfo);
 
     // Draw for ntimes
-    if (ifit % (fNFits/fNDraw) == 0)
+    if (isDraw)
     {
       // Draw fit(s) in 1D
       if (fitInfo.Fit == TwoD)
@@ -807,6 +910,8 @@ void Fitter::ThrowPoisson(const FitInfo & fitInfo)
 
 void Fitter::BuildModel(FitInfo & fitInfo)
 {
+  PROFILE_SCOPE("Fitter::BuildModel");
+
   std::cout << "Build model for: " << fitInfo.Text.Data() << std::endl;
 
   // Declare strings for naming pdfs
@@ -829,20 +934,40 @@ void Fitter::BuildModel(FitInfo & fitInfo)
   }
 }
 
-void Fitter::GenerateData(FitInfo & fitInfo)
+void Fitter::GenerateData(FitInfo & fitInfo, const Bool_t makeDataHist)
 {
-  std::cout << "Generating toy data for: " << fitInfo.Text.Data() << std::endl;
+  PROFILE_SCOPE("Fitter::GenerateData");
 
-  // generate the data and save to "Data" slot in RooDataHist Map
-  fitInfo.DataHistMap["Data"] = fitInfo.ModelPdf->generateBinned(fitInfo.ArgList,(fNGenBkgd+fNGenSign));
+  std::cout << "Generating toy data for: " << fitInfo.Text.Data() << std::endl;
 
-  // Rename to follow conventions so far
   const TString name = Form("%s_RooDataHist_%s",Common::HistNameMap["Data"].Data(),fitInfo.Text.Data());
-  fitInfo.DataHistMap["Data"]->SetName(Form("%s",name.Data()));
+
+  if (fFitEngine == RooFitOnly)
+  {
+    // generate the data and save to "Data" slot in RooDataHist Map
+    fitInfo.DataHistMap["Data"] = fitInfo.ModelPdf->generateBinned(fitInfo.ArgList,(fNGenBkgd+fNGenSign));
+
+    // Rename to follow conventions so far
+    fitInfo.DataHistMap["Data"]->SetName(Form("%s",name.Data()));
+  }
+  else
+  {
+    // multinomial over the model bins, given the poisson-thrown total
+    fitInfo.NativeFit->GenerateToy(fNGenBkgd,fNGenSign,Long64_t(fNGenBkgd+fNGenSign));
+
+    if (makeDataHist)
+    {
+      auto hist = fitInfo.NativeFit->MakeDataHist(Form("%s_toy",name.Data()));
+      fitInfo.DataHistMap["Data"] = new RooDataHist(Form("%s",name.Data()),Form("%s",name.Data()),fitInfo.ArgList,hist);
+      delete hist;
+    }
+  }
 }
 
 void Fitter::FitModel(FitInfo & fitInfo)
 {
+  PROFILE_SCOPE("Fitter::FitModel");
+
   std::cout << "Fit model for: " << fitInfo.Text.Data() << std::endl;
 
   // initialize norms before each fit, i.e. don't cheat!
@@ -850,7 +975,54 @@ void Fitter::FitModel(FitInfo & fitInfo)
   fNPredSignMap[fSignalSample]->setVal(((fScaleRangeLow*fNTotalSignMap[fSignalSample])+(fScaleRangeHigh*fNTotalSignMap[fSignalSample]))/2.f);
 
   // perform the fit!
-  fitInfo.ModelPdf->fitTo(*fitInfo.DataHistMap.at("Data"),RooFit::SumW2Error(true));
+  if (fFitEngine != NativeOnly)
+  {
+    fitInfo.ModelPdf->fitTo(*fitInfo.DataHistMap.at("Data"),RooFit::SumW2Error(true));
+  }
+
+  // keep RooFit's answer for the cross check, then refit natively from the same starting point
+  if (fFitEngine == NativeAndRooFit)
+  {
+    fNFitBkgdRooFit = fNPredBkgd->getVal();
+    fNFitBkgdErrRooFit = fNPredBkgd->getError();
+    fNFitSignRooFit = fNPredSignMap[fSignalSample]->getVal();
+    fNFitSignErrRooFit = fNPredSignMap[fSignalSample]->getError();
+  }
+
+  if (fFitEngine != RooFitOnly)
+  {
+    Fitter::FitModelNative(fitInfo);
+  }
+}
+
+void Fitter::FitModelNative(FitInfo & fitInfo)
+{
+  PROFILE_SCOPE("Fitter::FitModelNative");
+
+  std::cout << "Fit model natively for: " << fitInfo.Text.Data() << std::endl;
+
+  auto & nPredSign = fNPredSignMap[fSignalSample];
+
+  // same starting point and ranges as RooFit
+  const auto result = fitInfo.NativeFit->Fit(((fScaleRangeLow*fNTotalBkgd)+(fScaleRangeHigh*fNTotalBkgd))/2.f,
+					     fNPredBkgd->getMin(),fNPredBkgd->getMax(),
+					     ((fScaleRangeLow*fNTotalSignMap[fSignalSample])+(fScaleRangeHigh*fNTotalSignMap[fSignalSample]))/2.f,
+					     nPredSign->getMin(),nPredSign->getMax(),true);
+
+  // write back into the model, so drawing and fOutTree see the native result
+  fNPredBkgd->setVal(result.nbkgd);
+  fNPredBkgd->setError(result.nbkgdErr);
+  if (!fBkgdOnly)
+  {
+    nPredSign->setVal(result.nsign);
+    nPredSign->setError(result.nsignErr);
+  }
+
+  if (fFitEngine == NativeAndRooFit)
+  {
+    std::cout << Form("Native vs RooFit, nbkgd: %f +/- %f vs %f +/- %f",result.nbkgd,result.nbkgdErr,fNFitBkgdRooFit,fNFitBkgdErrRooFit) << std::endl;
+    if (!fBkgdOnly) std::cout << Form("Native vs RooFit, nsign: %f +/- %f vs %f +/- %f",result.nsign,result.nsignErr,fNFitSignRooFit,fNFitSignErrRooFit) << std::endl;
+  }
 }
 
 void Fitter::GetPredicted(FitInfo & fitInfo)
@@ -865,6 +1037,8 @@ void Fitter::GetPredicted(FitInfo & fitInfo)
 
 void Fitter::DrawFit(RooRealVar *& var, const TString & title, const FitInfo & fitInfo)
 {
+  PROFILE_SCOPE("Fitter::DrawFit");
+
   std::cout << "Draw fits projected into 1D for: " << fitInfo.Text.Data() << std::endl;
   
   // which variable?
@@ -1031,11 +1205,17 @@ void Fitter::DeleteModel(FitInfo & fitInfo, const Int_t ifit)
   if (!fBkgdOnly) delete fitInfo.SignExtPdf;
   delete fitInfo.ModelPdf;
 
-  if (fGenData && (ifit != (fNFits - 1))) delete fitInfo.DataHistMap["Data"];
+  if (fGenData && (ifit != (fNFits - 1)))
+  {
+    delete fitInfo.DataHistMap["Data"];
+    fitInfo.DataHistMap.erase("Data"); // native toys do not always make a new one
+  }
 }
 
 void Fitter::ImportToWS(FitInfo & fitInfo)
 {
+  PROFILE_SCOPE("Fitter::ImportToWS");
+
   std::cout << "Make workspace for " << fitInfo.Text.Data() << std::endl;
 
   // make new workspace
@@ -1097,6 +1277,23 @@ void Fitter::ImportToWS(FitInfo & fitInfo)
   
     workspace->import(*fitInfo.HistPdfMap[sample]);
     workspace->import(*fNPredSignMap[sample]);
+
+    // shape variations: <signal pdf>_<syst>, as $SYSTEMATIC in the datacard
+    for (const auto & syst : fSysts)
+    {
+      const auto & hist2D = fSystHistMap2D[Form("%s_%s",sample.Data(),syst.Data())];
+
+      TH1 * hist1D = NULL;
+      if      (fitInfo.Fit == X) hist1D = hist2D->ProjectionX(Form("%s_%s_projX",sample.Data(),syst.Data()));
+      else if (fitInfo.Fit == Y) hist1D = hist2D->ProjectionY(Form("%s_%s_projY",sample.Data(),syst.Data()));
+
+      const TString name = Form("%s_%s",fitInfo.HistPdfMap[sample]->GetName(),syst.Data());
+      RooDataHist datahist(Form("%s_RooDataHist",name.Data()),Form("%s_RooDataHist",name.Data()),fitInfo.ArgList,(hist1D ? hist1D : hist2D));
+      RooHistPdf  histpdf (Form("%s",name.Data()),Form("%s",name.Data()),fitInfo.ArgList,datahist);
+      workspace->import(histpdf);
+
+      delete hist1D;
+    }
   }
 
   // make sanity plots
@@ -1197,6 +1394,8 @@ void Fitter::DumpWS(const FitInfo & fitInfo, const TString & label)
 
 void Fitter::SaveOutTree()
 {
+  PROFILE_SCOPE("Fitter::SaveOutTree");
+
   std::cout << "Writing fOutTree..." << std::endl;
 
   fOutFile->cd();
@@ -1205,6 +1404,8 @@ void Fitter::SaveOutTree()
 
 void Fitter::MakeConfigPave()
 {
+  PROFILE_SCOPE("Fitter::MakeConfigPave");
+
   std::cout << "Dumping config to a pave..." << std::endl;
 
   // create the pave, copying in old info
@@ -1227,6 +1428,19 @@ void Fitter::MakeConfigPave()
   // store last bits of misc info
   Common::AddTextFromInputConfig(fConfigPave,"Miscellaneous Config",fMiscConfig);
 
+  // bootstrap spread of the CR factors
+  if (fHasBoot)
+  {
+    Common::AddPaddingToPave(fConfigPave,1);
+    fConfigPave->AddText("CR factors with bootstrap spread");
+    for (const auto & KFPair : fCRKFMap)
+    {
+      const auto & CR = KFPair.first;
+      fConfigPave->AddText(Form("%s k-Factor: %f +/- %f",CR.Data(),fCRKFMap[CR],fCRKFErrMap[CR]));
+      fConfigPave->AddText(Form("%s x-Factor: %f +/- %f",CR.Data(),fCRXFMap[CR],fCRXFErrMap[CR]));
+    }
+  }
+
   // padding
   Common::AddPaddingToPave(fConfigPave,3);
 
@@ -1254,9 +1468,11 @@ void Fitter::SetupDefaults()
   fDoFits   = false;
   fMakeWS   = false;
   fDumpWS   = false;
+  fHasBoot  = false;
 
   fNFits = 1;
   fNDraw = 100;
+  fFitEngine = RooFitOnly;
   fScaleTotalBkgd = 1;
   fScaleTotalSign = 1;
   fScaleRangeLow = -100;
@@ -1374,6 +1590,25 @@ void Fitter::SetupFitConfig()
       str = Common::RemoveDelim(str,"n_draw=");
       fNDraw = std::atoi(str.c_str());
     }
+    else if (str.find("fit_engine=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"fit_engine=");
+      if      (str == "roofit") fFitEngine = RooFitOnly;
+      else if (str == "native") fFitEngine = NativeOnly;
+      else if (str == "both")   fFitEngine = NativeAndRooFit;
+      else
+      {
+	std::cerr << "Aye... your fit config is messed up, fit_engine is one of: roofit, native, both! Offending line: " << str.c_str() << std::endl;
+	exit(1);
+      }
+    }
+    else if (str.find("systs=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"systs=");
+      std::stringstream ss(str);
+      TString syst;
+      while (ss >> syst) fSysts.emplace_back(syst);
+    }
     else if (str.find("x_cut=") != std::string::npos)
     {
       fXCut = Common::RemoveDelim(str,"x_cut=");
@@ -1513,6 +1748,14 @@ void Fitter::SetupOutTree()
   fOutTree->Branch("nFitSign",&fNFitSign);
   fOutTree->Branch("nFitSignErr",&fNFitSignErr);
   fOutTree->Branch("fitID",&fFitID);
+
+  if (fFitEngine == NativeAndRooFit)
+  {
+    fOutTree->Branch("nFitBkgdRooFit",&fNFitBkgdRooFit);
+    fOutTree->Branch("nFitBkgdErrRooFit",&fNFitBkgdErrRooFit);
+    fOutTree->Branch("nFitSignRooFit",&fNFitSignRooFit);
+    fOutTree->Branch("nFitSignErrRooFit",&fNFitSignErrRooFit);
+  }
 }
 
 Bool_t Fitter::IsData(const TString & sample)
@@ -1585,4 +1828,5 @@ void Fitter::DeleteFitInfo(FitInfo & fitInfo)
   Common::DeleteMap(fitInfo.HistPdfMap);
 
   delete fitInfo.BkgdPdf;
+  delete fitInfo.NativeFit;
 }
@@ -29,6 +29,7 @@
 // STL includes
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <cmath>
 #include <cstdlib>
 #include <map>
@@ -38,15 +39,19 @@
 
 // Common include
 #include "Common.hh"
+#include "BinnedTemplateFit.hh"
 
 // Special enum for type of fit
 enum FitType {TwoD, X, Y};
 
+// Which minimizer fits the experiments: RooFit fitTo, BinnedTemplateFit, or both (native results kept, RooFit's as a cross check)
+enum FitEngine {RooFitOnly, NativeOnly, NativeAndRooFit};
+
 // Special struct for each fit
 struct FitInfo
 {
   FitInfo(const RooArgList & arglist, const TString & text, const FitType & fit)
-    : ArgList(arglist), Text(text), Fit(fit) {}
+    : ArgList(arglist), Text(text), Fit(fit), NativeFit(NULL) {}
 
   // input params
   const RooArgList ArgList;
@@ -62,6 +67,9 @@ struct FitInfo
   RooExtendPdf * BkgdExtPdf;
   RooExtendPdf * SignExtPdf;
   RooAddPdf    * ModelPdf;
+
+  // same model on flat bin arrays
+  BinnedTemplateFit * NativeFit;
 };
 
 class Fitter
@@ -117,13 +125,16 @@ public:
   template <typename T>
   void DeclareDatasets(const T & HistMap, FitInfo & fitInfo);
   void DeclareSamplePdfs(FitInfo & fitInfo);
+  template <typename T>
+  void DeclareNativeFit(const T & HistMap, FitInfo & fitInfo);
 
   // Subroutines for fitting
   void MakeFit(FitInfo & fitInfo);
   void ThrowPoisson(const FitInfo & fitInfo);
   void BuildModel(FitInfo & fitInfo);
-  void GenerateData(FitInfo & fitInfo);
+  void GenerateData(FitInfo & fitInfo, const Bool_t makeDataHist);
   void FitModel(FitInfo & fitInfo);
+  void FitModelNative(FitInfo & fitInfo);
   void GetPredicted(FitInfo & fitInfo);
   void DrawFit(RooRealVar *& var, const TString & title, const FitInfo & fitInfo);
   void FillOutTree(const FitInfo & fitInfo);
@@ -154,6 +165,7 @@ private:
   Bool_t fDumpWS;
   Int_t  fNFits;
   Int_t  fNDraw;
+  FitEngine fFitEngine;
 
   // scale factors of initial guess for fit range * fNTotal{Bkgd/Sign}
   Float_t fScaleRangeLow;
@@ -183,6 +195,15 @@ private:
   std::map<TString,TH1F*> fHistMapX;
   std::map<TString,TH1F*> fHistMapY;
 
+  // Signal shape variations from SystFiller, keyed as <sample>_<syst>
+  std::vector<TString> fSysts;
+  std::map<TString,TH2F*> fSystHistMap2D;
+
+  // Bootstrap replicas from SystFiller, keyed as the hists above
+  std::map<TString,TH2F*> fBootHistMap2D;
+  std::map<TString,TH2F*> fBootHistMap2DTmp;
+  Bool_t fHasBoot;
+
   // misc plot info + model info
   std::vector<TString> fPlotSignalVec;
   TString fSignalSample;
@@ -190,6 +211,8 @@ private:
   // scale factors
   std::map<TString,Float_t> fCRKFMap;
   std::map<TString,Float_t> fCRXFMap;
+  std::map<TString,Float_t> fCRKFErrMap;
+  std::map<TString,Float_t> fCRXFErrMap;
 
   // Counts + scaling norm from the start
   Float_t fScaleTotalBkgd;
@@ -237,6 +260,12 @@ private:
   Float_t fNFitSign;
   Float_t fNFitSignErr;
   std::string fFitID;
+
+  // RooFit results, when cross checking the native fit
+  Float_t fNFitBkgdRooFit;
+  Float_t fNFitBkgdErrRooFit;
+  Float_t fNFitSignRooFit;
+  Float_t fNFitSignErrRooFit;
 };
 
 #endif
@@ -0,0 +1,143 @@
+#ifndef __HistLookup__
+#define __HistLookup__
+
+// ROOT includes
+#include "TH1.h"
+#include "TH2.h"
+#include "TAxis.h"
+#include "TArrayD.h"
+
+// STL includes
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+///////////////////////////////////////////////////////////////////////
+//                                                                   //
+// Immutable bin lookup built once from a TH1/TH2: contents (incl.   //
+// under/overflow) are copied into a flat array, and bins resolved   //
+// either arithmetically (uniform) or by binary search (var bins).   //
+// Bin numbering follows ROOT: 0 = underflow, nbins+1 = overflow.    //
+//                                                                   //
+///////////////////////////////////////////////////////////////////////
+
+struct AxisLookup
+{
+  AxisLookup() : nbins(0), xmin(0), xmax(0), isVarBins(false) {}
+  AxisLookup(const TAxis * axis)
+    : nbins(axis->GetNbins()), xmin(axis->GetXmin()), xmax(axis->GetXmax()),
+      isVarBins(axis->IsVariableBinSize())
+  {
+    if (isVarBins)
+    {
+      const auto bins = axis->GetXbins();
+      edges.assign(bins->GetArray(),bins->GetArray()+bins->GetSize());
+    }
+  }
+
+  // same convention and arithmetic as TAxis::FindFixBin (so values on bin edges agree), NaN explicitly sent to overflow
+  inline Int_t FindBin(const Double_t x) const
+  {
+    if (x < xmin) return 0;
+    if (!(x < xmax)) return nbins+1;
+
+    if (isVarBins) return (std::upper_bound(edges.begin(),edges.end(),x) - edges.begin());
+    else           return 1 + Int_t(nbins * (x - xmin) / (xmax - xmin));
+  }
+
+  inline Bool_t IsFlow(const Int_t bin) const {return ((bin <= 0) || (bin > nbins));}
+
+  Int_t nbins;
+  Double_t xmin;
+  Double_t xmax;
+  Bool_t isVarBins;
+  std::vector<Double_t> edges;
+};
+
+class HistLookup
+{
+public:
+  HistLookup() : fIs2D(false), fStride(0) {}
+  HistLookup(const TH1 * hist) {HistLookup::Init(hist);}
+
+  void Init(const TH1 * hist)
+  {
+    if (hist == (TH1*) NULL)
+    {
+      std::cerr << "Cannot build lookup from a bad hist pointer! Exiting..." << std::endl;
+      exit(1);
+    }
+
+    fIs2D = (hist->GetDimension() == 2);
+    fXAxis = AxisLookup(hist->GetXaxis());
+    if (fIs2D) fYAxis = AxisLookup(hist->GetYaxis());
+
+    const auto nx = fXAxis.nbins + 2;
+    const auto ny = (fIs2D ? fYAxis.nbins + 2 : 1);
+    fStride = nx;
+
+    fContents.resize(nx*ny);
+    for (auto iy = 0; iy < ny; iy++)
+    {
+      for (auto ix = 0; ix < nx; ix++)
+      {
+	fContents[ix + iy*fStride] = hist->GetBinContent(fIs2D ? hist->GetBin(ix,iy) : ix);
+      }
+    }
+  }
+
+  // bin finding
+  inline Int_t FindBin(const Double_t x) const {return fXAxis.FindBin(x);}
+  inline Int_t FindBin(const Double_t x, const Double_t y) const {return fXAxis.FindBin(x) + fYAxis.FindBin(y)*fStride;}
+  inline Bool_t IsFlow(const Int_t bin) const {return fXAxis.IsFlow(bin);}
+
+  // equivalent of hist->GetBinContent(hist->FindBin(x)), i.e. flow bins return their own content
+  inline Float_t Get(const Double_t x) const {return fContents[fXAxis.FindBin(x)];}
+  inline Float_t Get(const Double_t x, const Double_t y) const {return fContents[HistLookup::FindBin(x,y)];}
+
+  // explicit flow handling: return fallback if outside axis range
+  inline Float_t GetInRange(const Double_t x, const Float_t fallback) const
+  {
+    const auto bin = fXAxis.FindBin(x);
+    return (fXAxis.IsFlow(bin) ? fallback : fContents[bin]);
+  }
+  inline Float_t GetInRange(const Double_t x, const Double_t y, const Float_t fallback) const
+  {
+    const auto binx = fXAxis.FindBin(x);
+    const auto biny = fYAxis.FindBin(y);
+    return ((fXAxis.IsFlow(binx) || fYAxis.IsFlow(biny)) ? fallback : fContents[binx + biny*fStride]);
+  }
+
+  // batch lookups over arrays
+  template <typename T>
+  void Get(const T * xs, Float_t * out, const size_t n) const
+  {
+    for (size_t i = 0; i < n; i++) out[i] = HistLookup::Get(xs[i]);
+  }
+  template <typename T>
+  void GetInRange(const T * xs, Float_t * out, const size_t n, const Float_t fallback) const
+  {
+    for (size_t i = 0; i < n; i++) out[i] = HistLookup::GetInRange(xs[i],fallback);
+  }
+
+  // accessors
+  inline Int_t GetNbinsX() const {return fXAxis.nbins;}
+  inline Int_t GetNbinsY() const {return (fIs2D ? fYAxis.nbins : 0);}
+  inline Bool_t Is2D() const {return fIs2D;}
+  inline Float_t GetBinContent(const Int_t bin) const {return fContents[bin];}
+  std::vector<Float_t> GetInRangeContents() const
+  {
+    if (fXAxis.nbins == 0) return std::vector<Float_t>();
+    return std::vector<Float_t>(fContents.begin()+1,fContents.begin()+1+fXAxis.nbins);
+  }
+
+private:
+  Bool_t fIs2D;
+  Int_t fStride;
+  AxisLookup fXAxis;
+  AxisLookup fYAxis;
+  std::vector<Float_t> fContents;
+};
+
+#endif
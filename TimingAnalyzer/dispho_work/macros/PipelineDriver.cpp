@@ -0,0 +1,562 @@
+// Class include
+#include "PipelineDriver.hh"
+
+PipelineDriver::PipelineDriver(const TString & pipelineconfig, const TString & cachedir, const Int_t njobs)
+  : fPipelineConfig(pipelineconfig), fCacheDir(cachedir), fNJobs(std::max(njobs,1))
+{
+  std::cout << "Initializing PipelineDriver..." << std::endl;
+
+  ////////////////
+  //            //
+  // Initialize //
+  //            //
+  ////////////////
+
+  fJournalName = Form("%s/pipeline_journal.%s",fCacheDir.Data(),Common::outTextExt.Data());
+  fNInFlight = 0;
+  fWallTime = 0;
+
+  // build the DAG, then see what is already up to date
+  PipelineDriver::SetupConfig();
+  PipelineDriver::SetupGraph();
+  PipelineDriver::ReadJournal();
+}
+
+void PipelineDriver::SetupConfig()
+{
+  std::cout << "Reading pipeline config: " << fPipelineConfig.Data() << std::endl;
+
+  // one block per stage, each starting with stage=
+  std::ifstream infile(Form("%s",fPipelineConfig.Data()),std::ios::in);
+  std::string str;
+  while (std::getline(infile,str))
+  {
+    if (str == "") continue;
+    else if (str.find("stage=") == 0)
+    {
+      fStages.emplace_back();
+      fStages.back().name = Common::RemoveDelim(str,"stage=");
+    }
+    else if (fStages.empty())
+    {
+      std::cerr << "Aye... your pipeline config needs a stage= before anything else!" << std::endl;
+      std::cerr << "Offending line: " << str.c_str() << std::endl;
+      exit(1);
+    }
+    else if (str.find("after=") == 0)
+    {
+      fStages.back().after = PipelineDriver::SplitList(Common::RemoveDelim(str,"after="));
+    }
+    else if (str.find("inputs=") == 0)
+    {
+      fStages.back().inputs = PipelineDriver::SplitList(Common::RemoveDelim(str,"inputs="));
+    }
+    else if (str.find("outputs=") == 0)
+    {
+      fStages.back().outputs = PipelineDriver::SplitList(Common::RemoveDelim(str,"outputs="));
+    }
+    else if (str.find("inplace=") == 0)
+    {
+      fStages.back().inplace = PipelineDriver::SplitList(Common::RemoveDelim(str,"inplace="));
+    }
+    else if (str.find("cache=") == 0)
+    {
+      str = Common::RemoveDelim(str,"cache=");
+      Common::SetupBool(str,fStages.back().cache);
+    }
+    else if (str.find("command=") == 0)
+    {
+      fStages.back().command = Common::RemoveDelim(str,"command=");
+    }
+    else
+    {
+      std::cerr << "Aye... your pipeline config is messed up, try again!" << std::endl;
+      std::cerr << "Offending line: " << str.c_str() << std::endl;
+      exit(1);
+    }
+  }
+
+  if (fStages.empty())
+  {
+    std::cerr << "No stages in pipeline config: " << fPipelineConfig.Data() << " ...exiting..." << std::endl;
+    exit(1);
+  }
+}
+
+void PipelineDriver::SetupGraph()
+{
+  std::cout << "Setting up graph of " << fStages.size() << " stages..." << std::endl;
+
+  for (auto istage = 0U; istage < fStages.size(); istage++)
+  {
+    const auto & stage = fStages[istage];
+    if (stage.command == "")
+    {
+      std::cerr << "Stage " << stage.name.c_str() << " has no command! ...exiting..." << std::endl;
+      exit(1);
+    }
+    if (!fStageIndices.emplace(stage.name,istage).second)
+    {
+      std::cerr << "Stage " << stage.name.c_str() << " defined twice! ...exiting..." << std::endl;
+      exit(1);
+    }
+  }
+
+  // edges
+  for (auto istage = 0U; istage < fStages.size(); istage++)
+  {
+    auto & stage = fStages[istage];
+    for (const auto & after : stage.after)
+    {
+      const auto & index = fStageIndices.find(after);
+      if (index == fStageIndices.end())
+      {
+	std::cerr << "Stage " << stage.name.c_str() << " runs after unknown stage: " << after.c_str() << " ...exiting..." << std::endl;
+	exit(1);
+      }
+      fStages[index->second].dependents.emplace_back(istage);
+      stage.nDepsLeft++;
+    }
+  }
+
+  // topological order, which also catches cycles
+  std::vector<UInt_t> nDepsLeft;
+  std::deque<UInt_t> ready;
+  for (auto istage = 0U; istage < fStages.size(); istage++)
+  {
+    nDepsLeft.emplace_back(fStages[istage].nDepsLeft);
+    if (nDepsLeft.back() == 0) ready.emplace_back(istage);
+  }
+  while (!ready.empty())
+  {
+    const auto istage = ready.front();
+    ready.pop_front();
+    fTopoOrder.emplace_back(istage);
+
+    for (const auto dependent : fStages[istage].dependents)
+    {
+      if (--nDepsLeft[dependent] == 0) ready.emplace_back(dependent);
+    }
+  }
+
+  if (fTopoOrder.size() != fStages.size())
+  {
+    std::cerr << "Pipeline config has a cycle among its stages! ...exiting..." << std::endl;
+    exit(1);
+  }
+}
+
+void PipelineDriver::ReadJournal()
+{
+  std::cout << "Reading journal: " << fJournalName.Data() << std::endl;
+
+  if (Common::IsNullFile(fJournalName))
+  {
+    std::cout << "No journal found, starting from scratch" << std::endl;
+    return;
+  }
+
+  // DONE <stage> <key>
+  // INPLACE <path> <hash after> <hash before>
+  std::ifstream journal(fJournalName.Data(),std::ios::in);
+  std::string str;
+  while (std::getline(journal,str))
+  {
+    if (str == "") continue;
+
+    std::stringstream ss(str);
+    std::string type;
+    ss >> type;
+
+    if (type == "DONE")
+    {
+      std::string name, key;
+      ss >> name >> key;
+      fDoneKeys[name] = key;
+    }
+    else if (type == "INPLACE")
+    {
+      std::string path, post, pre;
+      ss >> path >> post >> pre;
+      fInPlaceHashes[path][post] = pre;
+    }
+    else
+    {
+      std::cerr << "Aye... your journal is messed up, skipping line: " << str.c_str() << std::endl;
+    }
+  }
+
+  std::cout << "Journal has " << fDoneKeys.size() << " finished stages" << std::endl;
+}
+
+void PipelineDriver::Run()
+{
+  std::cout << "Running " << fStages.size() << " stages with " << fNJobs << " jobs..." << std::endl;
+
+  gSystem->mkdir(Form("%s/logs",fCacheDir.Data()),true);
+  fStart = std::chrono::steady_clock::now();
+
+  // roots of the DAG first
+  for (const auto istage : fTopoOrder)
+  {
+    if (fStages[istage].nDepsLeft == 0) fReady.emplace_back(istage);
+  }
+
+  // spin up the pool
+  std::vector<std::thread> workers;
+  for (auto iworker = 0; iworker < fNJobs; iworker++)
+  {
+    workers.emplace_back(&PipelineDriver::WorkerLoop,this,iworker);
+  }
+  for (auto & worker : workers) worker.join();
+
+  fWallTime = std::chrono::duration<Double_t>(std::chrono::steady_clock::now()-fStart).count();
+
+  PipelineDriver::DumpTimingReport();
+
+  // rerun picks up from the journal
+  std::vector<std::string> unfinished;
+  for (const auto & stage : fStages)
+  {
+    if (stage.status == Failed || stage.status == Skipped) unfinished.emplace_back(stage.name);
+  }
+  if (!unfinished.empty())
+  {
+    std::cerr << "Failed or skipped stages (rerun to retry only these):" << std::endl;
+    for (const auto & name : unfinished) std::cerr << "  " << name.c_str() << std::endl;
+    exit(1);
+  }
+}
+
+void PipelineDriver::WorkerLoop(const Int_t iworker)
+{
+  while (true)
+  {
+    UInt_t istage = 0;
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fCondition.wait(lock,[&]{return (!fReady.empty() || fNInFlight == 0);});
+
+      // nothing ready and nothing running that could make more ready
+      if (fReady.empty()) break;
+
+      istage = fReady.front();
+      fReady.pop_front();
+      fNInFlight++;
+    }
+
+    PipelineDriver::RunStage(istage,iworker);
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      PipelineDriver::FinishStage(istage);
+      fNInFlight--;
+    }
+    fCondition.notify_all();
+  }
+}
+
+void PipelineDriver::RunStage(const UInt_t istage, const Int_t iworker)
+{
+  auto & stage = fStages[istage];
+  stage.start = std::chrono::duration<Double_t>(std::chrono::steady_clock::now()-fStart).count();
+
+  // upstream stages are done, so their keys and outputs are final
+  {
+    std::lock_guard<std::mutex> lock(fHashMutex);
+    stage.key = PipelineDriver::ComputeKey(stage);
+  }
+
+  Bool_t isFresh = false;
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    const auto & done = fDoneKeys.find(stage.name);
+    isFresh = (done != fDoneKeys.end() && done->second == stage.key);
+  }
+
+  if (isFresh && PipelineDriver::HasOutputs(stage))
+  {
+    stage.status = Fresh;
+  }
+  else if (stage.cache && PipelineDriver::RestoreFromCache(stage))
+  {
+    stage.status = Restored;
+    PipelineDriver::AppendToJournal("DONE "+stage.name+" "+stage.key);
+  }
+  else
+  {
+    // hashes as seen by every other stage, before this one rewrites them
+    std::vector<std::string> preHashes;
+    {
+      std::lock_guard<std::mutex> lock(fHashMutex);
+      for (const auto & path : stage.inplace) preHashes.emplace_back(PipelineDriver::HashPath(path));
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      std::cout << "[job " << iworker << "] Running: " << stage.name.c_str() << std::endl;
+    }
+
+    const std::string logname = std::string(fCacheDir.Data())+"/logs/"+stage.name+"."+Common::outTextExt.Data();
+    const std::string command = "("+stage.command+") > "+logname+" 2>&1";
+    const auto status = std::system(command.c_str());
+
+    if (status == 0 && PipelineDriver::HasOutputs(stage))
+    {
+      // rewritten inputs keep their old hash, so this stage (and stages reading them before it) stay fresh
+      for (auto ipath = 0U; ipath < stage.inplace.size(); ipath++)
+      {
+	const auto & path = stage.inplace[ipath];
+	std::string postHash;
+	{
+	  std::lock_guard<std::mutex> lock(fHashMutex);
+	  postHash = PipelineDriver::HashPath(path,false);
+	  fInPlaceHashes[path][postHash] = preHashes[ipath];
+	}
+	PipelineDriver::AppendToJournal("INPLACE "+path+" "+postHash+" "+preHashes[ipath]);
+      }
+
+      PipelineDriver::AppendToJournal("DONE "+stage.name+" "+stage.key);
+      if (stage.cache && !PipelineDriver::StoreInCache(stage))
+      {
+	std::lock_guard<std::mutex> lock(fMutex);
+	std::cerr << "[job " << iworker << "] Could not cache outputs of: " << stage.name.c_str() << std::endl;
+      }
+      stage.status = Ran;
+    }
+    else
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      std::cerr << "[job " << iworker << "] Failed: " << stage.name.c_str() << " see: " << logname.c_str() << std::endl;
+      stage.status = Failed;
+    }
+  }
+
+  stage.end = std::chrono::duration<Double_t>(std::chrono::steady_clock::now()-fStart).count();
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  std::cout << "[job " << iworker << "] " << PipelineDriver::GetStatusName(stage.status).Data() << ": " << stage.name.c_str()
+	    << " in " << stage.end-stage.start << " s" << std::endl;
+}
+
+void PipelineDriver::FinishStage(const UInt_t istage)
+{
+  // caller holds the lock
+  const auto & stage = fStages[istage];
+  for (const auto idependent : stage.dependents)
+  {
+    auto & dependent = fStages[idependent];
+    if (--dependent.nDepsLeft > 0) continue;
+
+    // all upstream done: run it, unless one of them did not make its outputs
+    Bool_t isBlocked = false;
+    for (const auto & after : dependent.after)
+    {
+      const auto status = fStages[fStageIndices[after]].status;
+      if (status == Failed || status == Skipped) isBlocked = true;
+    }
+
+    if (isBlocked)
+    {
+      dependent.status = Skipped;
+      dependent.start  = stage.end;
+      dependent.end    = stage.end;
+      PipelineDriver::FinishStage(idependent);
+    }
+    else
+    {
+      fReady.emplace_back(idependent);
+    }
+  }
+}
+
+Bool_t PipelineDriver::StoreInCache(const PipelineStage & stage)
+{
+  // content addressed: one dir per key, only valid once complete
+  const std::string keydir = std::string(fCacheDir.Data())+"/"+stage.key;
+  if (std::system(("rm -rf '"+keydir+"' && mkdir -p '"+keydir+"'").c_str()) != 0) return false;
+
+  for (auto ioutput = 0U; ioutput < stage.outputs.size(); ioutput++)
+  {
+    const auto command = "cp -a '"+stage.outputs[ioutput]+"' '"+keydir+"/out_"+std::to_string(ioutput)+"'";
+    if (std::system(command.c_str()) != 0) return false;
+  }
+
+  std::ofstream complete(keydir+"/complete");
+  complete << stage.name.c_str() << std::endl;
+
+  return true;
+}
+
+Bool_t PipelineDriver::RestoreFromCache(const PipelineStage & stage)
+{
+  const std::string keydir = std::string(fCacheDir.Data())+"/"+stage.key;
+  if (gSystem->AccessPathName((keydir+"/complete").c_str())) return false;
+
+  for (auto ioutput = 0U; ioutput < stage.outputs.size(); ioutput++)
+  {
+    const auto & output = stage.outputs[ioutput];
+    const auto command = "rm -rf '"+output+"' && mkdir -p '"+gSystem->GetDirName(output.c_str()).Data()+"' && cp -a '"+keydir+"/out_"+std::to_string(ioutput)+"' '"+output+"'";
+    if (std::system(command.c_str()) != 0) return false;
+  }
+
+  return true;
+}
+
+std::string PipelineDriver::ComputeKey(const PipelineStage & stage)
+{
+  // caller holds the hash lock
+  std::string text = "command="+stage.command+"\n";
+  for (const auto & output : stage.outputs) text += "output="+output+"\n";
+  for (const auto & input  : stage.inputs)  text += "input="+input+" "+PipelineDriver::HashPath(input)+"\n";
+
+  // any change upstream changes the key of everything downstream
+  for (const auto & after : stage.after) text += "after="+after+" "+fStages[fStageIndices[after]].key+"\n";
+
+  TMD5 md5;
+  md5.Update((const UChar_t*)text.c_str(),text.size());
+  md5.Final();
+
+  return md5.AsString();
+}
+
+std::string PipelineDriver::HashPath(const std::string & path, const Bool_t substitute)
+{
+  // caller holds the hash lock
+  FileStat_t info;
+  if (gSystem->GetPathInfo(path.c_str(),info) != 0) return "missing";
+
+  std::string hash;
+  if (R_ISDIR(info.fMode))
+  {
+    // sorted, so the key does not depend on the order of the listing
+    std::vector<std::string> entries;
+    auto dir = gSystem->OpenDirectory(path.c_str());
+    while (const auto entry = gSystem->GetDirEntry(dir))
+    {
+      const std::string name = entry;
+      if (name != "." && name != "..") entries.emplace_back(name);
+    }
+    gSystem->FreeDirectory(dir);
+    std::sort(entries.begin(),entries.end());
+
+    std::string text = "";
+    for (const auto & entry : entries) text += entry+" "+PipelineDriver::HashPath(path+"/"+entry,substitute)+"\n";
+
+    TMD5 md5;
+    md5.Update((const UChar_t*)text.c_str(),text.size());
+    md5.Final();
+    hash = md5.AsString();
+  }
+  else if (info.fSize <= Common::pipelineHashMaxBytes)
+  {
+    auto md5 = TMD5::FileChecksum(path.c_str());
+    hash = (md5 ? md5->AsString() : "unreadable");
+    delete md5;
+  }
+  else
+  {
+    hash = std::to_string(info.fSize)+":"+std::to_string(info.fMtime);
+  }
+
+  if (substitute)
+  {
+    const auto & inplace = fInPlaceHashes.find(path);
+    if (inplace != fInPlaceHashes.end())
+    {
+      const auto & pre = inplace->second.find(hash);
+      if (pre != inplace->second.end()) return pre->second;
+    }
+  }
+
+  return hash;
+}
+
+Bool_t PipelineDriver::HasOutputs(const PipelineStage & stage) const
+{
+  for (const auto & output : stage.outputs)
+  {
+    if (gSystem->AccessPathName(output.c_str())) return false;
+  }
+  return true;
+}
+
+void PipelineDriver::AppendToJournal(const std::string & line)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  // reopen + close each time so a crash leaves a complete journal
+  std::ofstream journal(fJournalName.Data(),std::ios_base::app);
+  journal << line.c_str() << std::endl;
+}
+
+void PipelineDriver::DumpTimingReport() const
+{
+  std::cout << "Timing per stage:" << std::endl;
+  std::cout << Form("%-24s %10s %10s %10s %10s","stage","status","start [s]","end [s]","time [s]") << std::endl;
+
+  Double_t totalTime = 0;
+  for (const auto & stage : fStages)
+  {
+    std::cout << Form("%-24s %10s %10.1f %10.1f %10.1f",stage.name.c_str(),PipelineDriver::GetStatusName(stage.status).Data(),
+		      stage.start,stage.end,stage.end-stage.start) << std::endl;
+    totalTime += stage.end-stage.start;
+  }
+
+  // longest chain of stage times through the DAG
+  std::map<UInt_t,Double_t> finish;
+  std::map<UInt_t,Int_t> previous;
+  for (const auto istage : fTopoOrder)
+  {
+    const auto & stage = fStages[istage];
+
+    Double_t upstream = 0;
+    previous[istage] = -1;
+    for (const auto & after : stage.after)
+    {
+      const auto iafter = fStageIndices.at(after);
+      if (finish[iafter] > upstream || previous[istage] < 0)
+      {
+	upstream = finish[iafter];
+	previous[istage] = iafter;
+      }
+    }
+    finish[istage] = upstream + (stage.end-stage.start);
+  }
+
+  Int_t ilast = fTopoOrder.front();
+  for (const auto & finishPair : finish)
+  {
+    if (finishPair.second > finish[ilast]) ilast = finishPair.first;
+  }
+
+  std::vector<std::string> path;
+  for (auto istage = ilast; istage >= 0; istage = previous[istage]) path.emplace_back(fStages[istage].name);
+  std::reverse(path.begin(),path.end());
+
+  std::string chain = "";
+  for (const auto & name : path) chain += (chain == "" ? "" : " -> ")+name;
+
+  std::cout << "Critical path: " << chain.c_str() << " (" << finish[ilast] << " s)" << std::endl;
+  std::cout << "Sum of stage times: " << totalTime << " s" << std::endl;
+  std::cout << "Wall time: " << fWallTime << " s" << std::endl;
+}
+
+std::vector<std::string> PipelineDriver::SplitList(const std::string & str)
+{
+  std::vector<std::string> list;
+  std::stringstream ss(str);
+  std::string item;
+  while (ss >> item) list.emplace_back(item);
+  return list;
+}
+
+TString PipelineDriver::GetStatusName(const StageStatus status)
+{
+  if      (status == Fresh)    return "fresh";
+  else if (status == Restored) return "restored";
+  else if (status == Ran)      return "ran";
+  else if (status == Failed)   return "failed";
+  else if (status == Skipped)  return "skipped";
+  else                         return "pending";
+}
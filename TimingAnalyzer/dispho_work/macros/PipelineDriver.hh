@@ -0,0 +1,114 @@
+#ifndef __PipelineDriver__
+#define __PipelineDriver__
+
+// ROOT includes
+#include "TString.h"
+#include "TSystem.h"
+#include "TMD5.h"
+
+// STL includes
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+// Common include
+#include "Common.hh"
+
+namespace Common
+{
+  // inputs larger than this (i.e. skims) are keyed by size and mtime instead of their content
+  static const Long64_t pipelineHashMaxBytes = 64 * 1024 * 1024;
+};
+
+enum StageStatus {Pending, Fresh, Restored, Ran, Failed, Skipped};
+
+// one node of the DAG: a shell command, with the files it reads and writes
+struct PipelineStage
+{
+  PipelineStage() : cache(true), status(Pending), nDepsLeft(0), start(0), end(0) {}
+
+  // from config
+  std::string name;
+  std::string command;
+  std::vector<std::string> after;   // stages that must finish first
+  std::vector<std::string> inputs;  // files or dirs read
+  std::vector<std::string> outputs; // files or dirs written
+  std::vector<std::string> inplace; // inputs rewritten by the stage itself (e.g. weights added to skims)
+  Bool_t cache;                     // keep copies of outputs in the artifact cache
+
+  // run state
+  std::string key;
+  StageStatus status;
+  std::vector<UInt_t> dependents;
+  UInt_t nDepsLeft;
+  Double_t start; // seconds since pipeline start
+  Double_t end;
+};
+
+class PipelineDriver
+{
+public:
+  PipelineDriver(const TString & pipelineconfig, const TString & cachedir, const Int_t njobs);
+  ~PipelineDriver() {}
+
+  // Initialize
+  void SetupConfig();
+  void SetupGraph();
+  void ReadJournal();
+
+  // Main call
+  void Run();
+
+  // Subroutines for running
+  void WorkerLoop(const Int_t iworker);
+  void RunStage(const UInt_t istage, const Int_t iworker);
+  void FinishStage(const UInt_t istage);
+  Bool_t StoreInCache(const PipelineStage & stage);
+  Bool_t RestoreFromCache(const PipelineStage & stage);
+
+  // Helper functions
+  std::string ComputeKey(const PipelineStage & stage);
+  std::string HashPath(const std::string & path, const Bool_t substitute = true);
+  Bool_t HasOutputs(const PipelineStage & stage) const;
+  void AppendToJournal(const std::string & line);
+  void DumpTimingReport() const;
+  static std::vector<std::string> SplitList(const std::string & str);
+  static TString GetStatusName(const StageStatus status);
+
+private:
+  // Settings
+  const TString fPipelineConfig;
+  const TString fCacheDir;
+  const Int_t   fNJobs;
+
+  // DAG, in config order, and one topological order of it
+  std::vector<PipelineStage> fStages;
+  std::map<std::string,UInt_t> fStageIndices;
+  std::vector<UInt_t> fTopoOrder;
+
+  // journal: last key each stage succeeded with, and path hashes before/after in place rewrites
+  TString fJournalName;
+  std::map<std::string,std::string> fDoneKeys;
+  std::map<std::string,std::map<std::string,std::string> > fInPlaceHashes;
+
+  // shared state for the pool
+  std::deque<UInt_t> fReady;
+  UInt_t fNInFlight;
+  std::mutex fMutex;
+  std::mutex fHashMutex;
+  std::condition_variable fCondition;
+  std::chrono::steady_clock::time_point fStart;
+  Double_t fWallTime;
+};
+
+#endif
@@ -0,0 +1,765 @@
+#include "RunTimeMonitor.hh"
+#include "TVirtualFitter.h"
+
+RunTimeMonitor::RunTimeMonitor(const TString & infilename, const TString & cutconfig, const TString & plotconfig,
+			       const TString & timefitconfig, const TString & era, const TString & storename,
+			       const TString & outfiletext) :
+  fInFileName(infilename), fCutConfig(cutconfig), fPlotConfig(plotconfig),
+  fTimeFitConfig(timefitconfig), fEra(era), fStoreName(storename), fOutFileText(outfiletext)
+{
+  std::cout << "Initializing RunTimeMonitor..." << std::endl;
+
+  ////////////////
+  //            //
+  // Initialize //
+  //            //
+  ////////////////
+
+  // defaults
+  fXVarBins = false;
+  fYVarBins = false;
+
+  // Get input file + data tree
+  fInFile = TFile::Open(Form("%s",fInFileName.Data()));
+  Common::CheckValidFile(fInFile,fInFileName);
+
+  // set style
+  fTDRStyle = new TStyle("TDRStyle","Style for P-TDR");
+  Common::SetTDRStyle(fTDRStyle);
+
+  // output root file for quick inspection
+  fOutFile = TFile::Open(Form("%s.root",fOutFileText.Data()),"UPDATE");
+
+  // setup config
+  RunTimeMonitor::SetupCommon();
+  RunTimeMonitor::SetupPlotConfig();
+  RunTimeMonitor::SetupTimeFitConfig();
+  RunTimeMonitor::SetupStoreKeys();
+
+  // get the data tree, once the names are known
+  const auto & treename = Common::TreeNameMap["Data"];
+  fInTree = (TTree*)fInFile->Get(Form("%s",treename.Data()));
+  Common::CheckValidTree(fInTree,treename,fInFileName);
+
+  // set fitter
+  TVirtualFitter::SetDefaultFitter("Minuit2");
+}
+
+RunTimeMonitor::~RunTimeMonitor()
+{
+  std::cout << "Tidying up in destructor..." << std::endl;
+
+  delete fConfigPave;
+
+  Common::DeleteMap(ResultsMap);
+
+  delete fOutFile;
+  delete fTDRStyle;
+  delete fInTree;
+  delete fInFile;
+}
+
+void RunTimeMonitor::MakeTimeVsRunMonitor()
+{
+  std::cout << "Making time vs run monitor..." << std::endl;
+
+  // Get previous per-run sums, if any
+  RunTimeMonitor::ReadStore();
+
+  // Add only the skim entries not seen before
+  RunTimeMonitor::UpdateStore();
+
+  // Refit only runs with new entries
+  RunTimeMonitor::FitChangedRuns();
+
+  // Save sums + fits for next time
+  RunTimeMonitor::WriteStore();
+
+  // Extract mu and sigma into maps
+  RunTimeMonitor::ExtractFitResults();
+
+  // Make Plots
+  RunTimeMonitor::MakePlots();
+
+  // MakeConfigPave
+  RunTimeMonitor::MakeConfigPave();
+
+  // Dump mu's and sigma's into text file
+  RunTimeMonitor::DumpFitInfo();
+}
+
+void RunTimeMonitor::ReadStore()
+{
+  // start from scratch unless the store matches the current config
+  RunTimeMonitor::ResetStore();
+
+  if (Common::IsNullFile(fStoreName))
+  {
+    std::cout << "No run store: " << fStoreName.Data() << " ...building from scratch" << std::endl;
+    return;
+  }
+
+  std::cout << "Reading run store: " << fStoreName.Data() << std::endl;
+
+  auto file = TFile::Open(fStoreName.Data());
+  Common::CheckValidFile(file,fStoreName);
+
+  // config: sums are only reusable for the same cuts, vars, and y bins
+  auto configtree = (TTree*)file->Get(Common::runStoreConfigTreeName.Data());
+  Common::CheckValidTree(configtree,Common::runStoreConfigTreeName,fStoreName);
+
+  std::string * fillkey = 0, * fitkey = 0;
+  configtree->SetBranchAddress("fillkey",&fillkey);
+  configtree->SetBranchAddress("fitkey",&fitkey);
+  configtree->GetEntry(0);
+
+  const Bool_t sameFill = (*fillkey == fFillKey);
+  const Bool_t sameFit  = (*fitkey  == fFitKey);
+  delete configtree;
+
+  // inputs: the skim the sums came from, and how far into it
+  auto inputstree = (TTree*)file->Get(Common::runStoreInputsTreeName.Data());
+  Common::CheckValidTree(inputstree,Common::runStoreInputsTreeName,fStoreName);
+
+  std::string * filename = 0;
+  Long64_t nProcessed = 0, lastRun = 0, lastEvent = 0;
+  inputstree->SetBranchAddress("filename",&filename);
+  inputstree->SetBranchAddress("nProcessed",&nProcessed);
+  inputstree->SetBranchAddress("lastRun",&lastRun);
+  inputstree->SetBranchAddress("lastEvent",&lastEvent);
+  inputstree->GetEntry(0);
+
+  const Bool_t sameFile = (*filename == fInFileName.Data());
+  delete inputstree;
+
+  if (!sameFill || !sameFile)
+  {
+    std::cout << (!sameFill ? "Cuts, variables, or bins changed" : "Different input skim") << " ...rebuilding run store" << std::endl;
+    delete file;
+    return;
+  }
+
+  fNProcessed = nProcessed;
+  fLastRun    = lastRun;
+  fLastEvent  = lastEvent;
+
+  // runs: one entry per run
+  auto runstree = (TTree*)file->Get(Common::runStoreRunsTreeName.Data());
+  Common::CheckValidTree(runstree,Common::runStoreRunsTreeName,fStoreName);
+
+  Int_t run = 0;
+  RunStats stats;
+  std::vector<Double_t> * contents = 0, * sumw2 = 0;
+
+  runstree->SetBranchAddress("run",&run);
+  runstree->SetBranchAddress("nEntries",&stats.nEntries);
+  runstree->SetBranchAddress("sumw",&stats.sumw);
+  runstree->SetBranchAddress("sumwy",&stats.sumwy);
+  runstree->SetBranchAddress("sumwy2",&stats.sumwy2);
+  runstree->SetBranchAddress("contents",&contents);
+  runstree->SetBranchAddress("sumw2",&sumw2);
+  runstree->SetBranchAddress("fitted",&stats.fitted);
+  runstree->SetBranchAddress("chi2ndf",&stats.result.chi2ndf);
+  runstree->SetBranchAddress("chi2prob",&stats.result.chi2prob);
+  runstree->SetBranchAddress("mu",&stats.result.mu);
+  runstree->SetBranchAddress("emu",&stats.result.emu);
+  runstree->SetBranchAddress("sigma",&stats.result.sigma);
+  runstree->SetBranchAddress("esigma",&stats.result.esigma);
+
+  const auto nEntries = runstree->GetEntries();
+  for (auto entry = 0U; entry < nEntries; entry++)
+  {
+    runstree->GetEntry(entry);
+
+    auto & outstats = fRunStatsMap[run];
+    outstats = stats;
+    outstats.contents = *contents;
+    outstats.sumw2    = *sumw2;
+
+    // a new fit config invalidates every fit, not the sums
+    outstats.changed = !sameFit;
+  }
+
+  std::cout << "Read sums for " << fRunStatsMap.size() << " runs from " << fNProcessed << " entries"
+	    << (!sameFit ? " (fit config changed: refitting all runs)" : "") << std::endl;
+
+  delete runstree;
+  delete file;
+}
+
+void RunTimeMonitor::UpdateStore()
+{
+  std::cout << "Updating run store..." << std::endl;
+
+  const auto nEntries = fInTree->GetEntries();
+
+  // skims are expected to grow by appending: the last entry seen must still be where it was
+  if (fNProcessed > 0)
+  {
+    Long64_t run = 0, event = 0;
+    const Bool_t isAppended = ((nEntries >= fNProcessed) && RunTimeMonitor::GetLastRunEvent(fInTree,fNProcessed-1,run,event)
+			       && (run == fLastRun) && (event == fLastEvent));
+    if (!isAppended)
+    {
+      std::cout << "Input skim was rewritten, not appended to ...rebuilding run store" << std::endl;
+      RunTimeMonitor::ResetStore();
+    }
+  }
+
+  const auto nNew = nEntries - fNProcessed;
+  std::cout << "Processing " << nNew << " new entries (of " << nEntries << ")" << std::endl;
+  if (nNew <= 0) return;
+
+  RunTimeMonitor::FillEntries(fInTree,fNProcessed,nNew);
+
+  fNProcessed = nEntries;
+  RunTimeMonitor::GetLastRunEvent(fInTree,fNProcessed-1,fLastRun,fLastEvent);
+}
+
+void RunTimeMonitor::FillEntries(TTree * tree, const Long64_t first, const Long64_t nentries)
+{
+  const auto & xvar   = Common::XVarMap  ["Data"];
+  const auto & yvar   = Common::YVarMap  ["Data"];
+  const auto & cutwgt = Common::CutWgtMap["Data"];
+
+  // in chunks: TTree::Draw keeps every selected row in memory
+  for (auto start = first; start < first+nentries; start += Common::runStoreChunk)
+  {
+    const auto nchunk = std::min(Common::runStoreChunk,first+nentries-start);
+    tree->SetEstimate(nchunk+1);
+
+    const auto nselected = tree->Draw(Form("%s:%s",xvar.Data(),yvar.Data()),Form("%s",cutwgt.Data()),"goff",nchunk,start);
+    const auto xs = tree->GetV1();
+    const auto ys = tree->GetV2();
+    const auto ws = tree->GetW();
+
+    for (auto i = 0; i < nselected; i++)
+    {
+      const Int_t run = std::lround(xs[i]);
+      const auto y = ys[i];
+      const auto w = ws[i];
+
+      auto & stats = fRunStatsMap[run];
+      if (stats.contents.empty())
+      {
+	stats.contents.assign(fNBinsY+2,0.0);
+	stats.sumw2   .assign(fNBinsY+2,0.0);
+      }
+
+      // same bin convention as TH1: 0 is underflow, fNBinsY+1 overflow
+      const auto ibinY = std::upper_bound(fYBins.begin(),fYBins.end(),y) - fYBins.begin();
+
+      stats.nEntries++;
+      stats.sumw   += w;
+      stats.sumwy  += w*y;
+      stats.sumwy2 += w*y*y;
+      stats.contents[ibinY] += w;
+      stats.sumw2   [ibinY] += w*w;
+      stats.changed = true;
+    }
+
+    std::cout << "  processed entries: " << start+nchunk << " (runs so far: " << fRunStatsMap.size() << ")" << std::endl;
+  }
+}
+
+void RunTimeMonitor::FitChangedRuns()
+{
+  std::cout << "Fitting changed runs..." << std::endl;
+
+  auto nFit = 0U;
+  for (auto & RunStatsPair : fRunStatsMap)
+  {
+    const auto run = RunStatsPair.first;
+    auto & stats = RunStatsPair.second;
+    if (!stats.changed) continue;
+
+    auto TimeFit = new TimeFitStruct(fTimeFitType,fRangeLow,fRangeUp);
+    TimeFit->hist = RunTimeMonitor::MakeRunHist(run,stats);
+    TimeFit->varBinsX = fYVarBins;
+
+    stats.fitted = false;
+    if (!TimeFit->isEmpty())
+    {
+      TimeFit->PrepFit();
+      TimeFit->DoFit();
+      TimeFit->GetFitResult();
+
+      stats.result = TimeFit->result;
+      stats.fitted = true;
+
+      // save output: only what was refit
+      fOutFile->cd();
+      TimeFit->hist->Write(TimeFit->hist->GetName(),TObject::kWriteDelete);
+      TimeFit->fit->Write(TimeFit->fit->GetName(),TObject::kWriteDelete);
+    }
+
+    // delete internal members, then the object itself
+    TimeFit->DeleteInternal();
+    delete TimeFit;
+
+    stats.changed = false;
+    nFit++;
+  }
+
+  std::cout << "Refit " << nFit << " of " << fRunStatsMap.size() << " runs" << std::endl;
+}
+
+void RunTimeMonitor::WriteStore()
+{
+  std::cout << "Writing run store: " << fStoreName.Data() << std::endl;
+
+  auto file = TFile::Open(fStoreName.Data(),"RECREATE");
+  Common::CheckValidFile(file,fStoreName);
+  file->cd();
+
+  // config
+  auto configtree = new TTree(Common::runStoreConfigTreeName.Data(),Common::runStoreConfigTreeName.Data());
+  configtree->Branch("fillkey",&fFillKey);
+  configtree->Branch("fitkey",&fFitKey);
+  configtree->Fill();
+
+  // inputs
+  auto inputstree = new TTree(Common::runStoreInputsTreeName.Data(),Common::runStoreInputsTreeName.Data());
+  std::string filename = fInFileName.Data();
+  inputstree->Branch("filename",&filename);
+  inputstree->Branch("nProcessed",&fNProcessed);
+  inputstree->Branch("lastRun",&fLastRun);
+  inputstree->Branch("lastEvent",&fLastEvent);
+  inputstree->Fill();
+
+  // runs
+  auto runstree = new TTree(Common::runStoreRunsTreeName.Data(),Common::runStoreRunsTreeName.Data());
+
+  Int_t run = 0;
+  RunStats stats;
+
+  runstree->Branch("run",&run);
+  runstree->Branch("nEntries",&stats.nEntries);
+  runstree->Branch("sumw",&stats.sumw);
+  runstree->Branch("sumwy",&stats.sumwy);
+  runstree->Branch("sumwy2",&stats.sumwy2);
+  runstree->Branch("contents",&stats.contents);
+  runstree->Branch("sumw2",&stats.sumw2);
+  runstree->Branch("fitted",&stats.fitted);
+  runstree->Branch("chi2ndf",&stats.result.chi2ndf);
+  runstree->Branch("chi2prob",&stats.result.chi2prob);
+  runstree->Branch("mu",&stats.result.mu);
+  runstree->Branch("emu",&stats.result.emu);
+  runstree->Branch("sigma",&stats.result.sigma);
+  runstree->Branch("esigma",&stats.result.esigma);
+
+  for (const auto & RunStatsPair : fRunStatsMap)
+  {
+    run   = RunStatsPair.first;
+    stats = RunStatsPair.second;
+    runstree->Fill();
+  }
+
+  file->cd();
+  configtree->Write(configtree->GetName(),TObject::kWriteDelete);
+  inputstree->Write(inputstree->GetName(),TObject::kWriteDelete);
+  runstree->Write(runstree->GetName(),TObject::kWriteDelete);
+
+  delete runstree;
+  delete inputstree;
+  delete configtree;
+  delete file;
+}
+
+void RunTimeMonitor::ExtractFitResults()
+{
+  std::cout << "Extracting results..." << std::endl;
+
+  // setup hists
+  ResultsMap["chi2ndf"]  = RunTimeMonitor::SetupHist("#chi^{2}/NDF","chi2ndf");
+  ResultsMap["chi2prob"] = RunTimeMonitor::SetupHist("#chi^{2} Prob.","chi2prob");
+  ResultsMap["mu"]       = RunTimeMonitor::SetupHist(Form("#mu_{%s} [ns]",fTimeText.Data()),"mu");
+  ResultsMap["sigma"]    = RunTimeMonitor::SetupHist(Form("#sigma_{%s} [ns]",fTimeText.Data()),"sigma");
+
+  // set bin content straight from the store: x bins are expected to hold one run each
+  for (const auto & RunStatsPair : fRunStatsMap)
+  {
+    const auto & stats = RunStatsPair.second;
+    if (!stats.fitted) continue;
+
+    const auto ibinX = ResultsMap["mu"]->FindBin(RunStatsPair.first);
+    if (ibinX < 1 || ibinX > fNBinsX) continue;
+
+    const auto & result = stats.result;
+
+    // set bin content
+    ResultsMap["chi2ndf"] ->SetBinContent(ibinX,result.chi2ndf);
+    ResultsMap["chi2prob"]->SetBinContent(ibinX,result.chi2prob);
+    ResultsMap["mu"]      ->SetBinContent(ibinX,result.mu);
+    ResultsMap["mu"]      ->SetBinError  (ibinX,result.emu);
+    ResultsMap["sigma"]   ->SetBinContent(ibinX,result.sigma);
+    ResultsMap["sigma"]   ->SetBinError  (ibinX,result.esigma);
+  }
+
+  // save output
+  fOutFile->cd();
+  for (const auto & ResultsPair : ResultsMap) ResultsPair.second->Write(ResultsPair.second->GetName(),TObject::kWriteDelete);
+}
+
+void RunTimeMonitor::MakePlots()
+{
+  std::cout << "Make overlay plots..." << std::endl;
+
+  // make temp vector of hist key names
+  std::vector<TString> keys = {"mu","sigma"}; // can add chi2prob and chi2ndf
+
+  // loop over keys
+  for (const auto & key : keys)
+  {
+    // get hist
+    auto & DataHist = ResultsMap[key];
+
+    // tmp max, min
+    Float_t min =  1e9;
+    Float_t max = -1e9;
+    RunTimeMonitor::GetMinMax(DataHist,min,max,key);
+
+    // lin first, then log if applicable
+    RunTimeMonitor::PrintCanvas(min,max,key,false);
+    if (key.EqualTo("sigma",TString::kExact)) RunTimeMonitor::PrintCanvas(min,max,key,true);
+  }
+}
+
+void RunTimeMonitor::PrintCanvas(Float_t min, Float_t max, const TString & key, const Bool_t isLogy)
+{
+  std::cout << "Printing canvas for: " << key.Data() << " isLogy: " << Common::PrintBool(isLogy).Data() << std::endl;
+
+  // get hists
+  auto & DataHist = ResultsMap[key];
+
+  // make canvas first
+  auto Canvas = new TCanvas("Canvas_"+key,"");
+  Canvas->cd();
+  Canvas->SetGridx();
+  Canvas->SetGridy();
+  Canvas->SetLogy(isLogy);
+
+  // set min, max
+  if (key.EqualTo("sigma",TString::kExact))
+  {
+    min = (isLogy ? 0.1f : 0.f);
+    max = 1.f;
+  }
+  else
+  {
+    const Float_t factor = (isLogy ? 3.f : 1.5f);
+    min = (min > 0.f ? (min / factor) : (min * factor));
+    max = (max > 0.f ? (max * factor) : (max / factor));
+
+    if (key.EqualTo("mu",TString::kExact))
+    {
+      if (min < -10.f)
+      {
+	min = -1.f;
+	if (max < min) max = 0.f;
+      }
+      if (max > 10.f)
+      {
+	max = 1.f;
+	if (max < min) min = 0.f;
+      }
+    }
+  }
+
+  // set min, max
+  DataHist->SetMinimum(min);
+  DataHist->SetMaximum(max);
+
+  // draw!
+  DataHist->Draw("ep");
+
+  // pretty up
+  Common::CMSLumi(Canvas,0,fEra);
+
+  // make images
+  Common::SaveAs(Canvas,Form("%s_%s_%s",key.Data(),fOutFileText.Data(),(isLogy?"log":"lin")));
+
+  // save output if lin
+  if (!isLogy)
+  {
+    fOutFile->cd();
+    Canvas->Write(Canvas->GetName(),TObject::kWriteDelete);
+  }
+
+  // delete all
+  delete Canvas;
+}
+
+void RunTimeMonitor::GetMinMax(const TH1F * hist, Float_t & min, Float_t & max, const TString & key)
+{
+  for (auto ibinX = 1; ibinX <= fNBinsX; ibinX++)
+  {
+    // skip runs without a fit
+    if (hist->GetBinContent(ibinX) == 0.f && hist->GetBinError(ibinX) == 0.f) continue;
+
+    const auto content = hist->GetBinContent(ibinX);
+
+    // bool to allow negative values
+    const Bool_t canBeNeg = (key.EqualTo("mu",TString::kExact));
+
+    if ( ((!canBeNeg && min > 0.f) || (canBeNeg)) && content < min) min = content;
+    if ( ((!canBeNeg && max > 0.f) || (canBeNeg)) && content > max) max = content;
+  }
+}
+
+void RunTimeMonitor::MakeConfigPave()
+{
+  std::cout << "Dumping config to a pave..." << std::endl;
+
+  // create the pave
+  fOutFile->cd();
+  fConfigPave = new TPaveText();
+  fConfigPave->SetName(Form("%s",Common::pavename.Data()));
+
+  // give grand title
+  fConfigPave->AddText("***** RunTimeMonitor Config *****");
+
+  // add era info
+  Common::AddEraInfoToPave(fConfigPave,fEra);
+
+  // dump cut config
+  Common::AddTextFromInputConfig(fConfigPave,"Cut Config",fCutConfig);
+
+  // dump time fit config
+  Common::AddTextFromInputConfig(fConfigPave,"TimeFit Config",fTimeFitConfig);
+
+  // dump plot config
+  Common::AddTextFromInputConfig(fConfigPave,"Plot Config",fPlotConfig);
+
+  // padding
+  Common::AddPaddingToPave(fConfigPave,3);
+
+  // save name of infile + store, redundant
+  fConfigPave->AddText(Form("InFile name: %s",fInFileName.Data()));
+  fConfigPave->AddText(Form("Run store name: %s (entries: %lld, runs: %lu)",fStoreName.Data(),fNProcessed,fRunStatsMap.size()));
+
+  // save to output file
+  fOutFile->cd();
+  fConfigPave->Write(fConfigPave->GetName(),TObject::kWriteDelete);
+}
+
+void RunTimeMonitor::DumpFitInfo()
+{
+  std::cout << "Dumping fit info into text file..." << std::endl;
+
+  // make dumpfile object
+  const TString filename = fOutFileText+Common::outFitText+"."+Common::outTextExt;
+  std::ofstream dumpfile(Form("%s",filename.Data()),std::ios_base::out);
+
+  dumpfile << std::setw(9)  << "   Run  |"
+	   << std::setw(11) << " Entries  |"
+	   << std::setw(19) << "      Data mu     |"
+	   << std::setw(18) << "    Data sigma    "
+	   << std::endl;
+
+  std::string space = "";
+  const auto nw = 9+11+19+18;
+  for (auto i = 0; i < nw; i++) space += "-";
+
+  dumpfile << space.c_str() << std::endl;
+
+  auto irun = 0U;
+  for (const auto & RunStatsPair : fRunStatsMap)
+  {
+    const auto & stats  = RunStatsPair.second;
+    const auto & result = stats.result;
+
+    dumpfile << std::setw(9)  << Form(" %6i |",RunStatsPair.first)
+	     << std::setw(11) << Form(" %8lld |",stats.nEntries);
+    if (stats.fitted)
+    {
+      dumpfile << std::setw(19) << Form(" %6.3f +/- %5.3f |",result.mu,result.emu)
+	       << std::setw(19) << Form(" %6.3f +/- %5.3f |",result.sigma,result.esigma);
+    }
+    else
+    {
+      dumpfile << std::setw(19) << "       no fit      |";
+    }
+    dumpfile << std::endl;
+
+    if (++irun % 20 == 0) dumpfile << space.c_str() << std::endl;
+  }
+}
+
+void RunTimeMonitor::ResetStore()
+{
+  fNProcessed = 0;
+  fLastRun    = 0;
+  fLastEvent  = 0;
+  fRunStatsMap.clear();
+}
+
+Bool_t RunTimeMonitor::GetLastRunEvent(TTree * tree, const Long64_t entry, Long64_t & run, Long64_t & event)
+{
+  // reads two branches of a single entry
+  tree->SetEstimate(2);
+  if (tree->Draw("run:event","","goff",1,entry) != 1) return false;
+
+  run   = std::llround(tree->GetV1()[0]);
+  event = std::llround(tree->GetV2()[0]);
+  return true;
+}
+
+TH1F * RunTimeMonitor::MakeRunHist(const Int_t run, const RunStats & stats)
+{
+  const auto ybins = &fYBins[0];
+
+  auto hist = new TH1F(Form("%s_run%i",Common::HistNameMap["Data"].Data(),run),fYTitle+Form(" (Run %i);",run)+fYTitle+";Events",fNBinsY,ybins);
+  hist->Sumw2();
+
+  // same content as a ProjectionY of the run's x bin, rescaled if variable bins as in TreePlotter2D
+  auto sumw2 = hist->GetSumw2();
+  for (auto ibinY = 0; ibinY <= fNBinsY+1; ibinY++)
+  {
+    const auto inrange = (ibinY >= 1 && ibinY <= fNBinsY);
+    const Double_t width = ((fYVarBins && inrange) ? hist->GetXaxis()->GetBinWidth(ibinY) : 1.0);
+
+    hist->SetBinContent(ibinY,stats.contents[ibinY]/width);
+    sumw2->SetAt(stats.sumw2[ibinY]/(width*width),ibinY);
+  }
+  hist->SetEntries(stats.nEntries);
+
+  return hist;
+}
+
+void RunTimeMonitor::SetupCommon()
+{
+  std::cout << "Setting up Common..." << std::endl;
+
+  Common::SetupEras();
+  Common::SetupSamples();
+  Common::SetupSignalSamples();
+  Common::SetupGroups();
+  Common::SetupTreeNames();
+  Common::SetupHistNames();
+  Common::SetupCuts(fCutConfig);
+  Common::SetupEraCuts(fEra);
+  Common::SetupWeights();
+}
+
+void RunTimeMonitor::SetupPlotConfig()
+{
+  std::cout << "Reading plot config..." << std::endl;
+
+  std::ifstream infile(Form("%s",fPlotConfig.Data()),std::ios::in);
+  std::string str;
+  while (std::getline(infile,str))
+  {
+    if (str == "") continue;
+    else if (str.find("plot_title=") != std::string::npos)
+    {
+      fTitle = Common::RemoveDelim(str,"plot_title=");
+    }
+    else if (str.find("x_title=") != std::string::npos)
+    {
+      fXTitle = Common::RemoveDelim(str,"x_title=");
+    }
+    else if (str.find("x_var=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"x_var=");
+      Common::SetVar(str,Variable::X);
+    }
+    else if (str.find("x_var_data=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"x_var_data=");
+      Common::SetVarMod(str,Variable::X,SampleGroup::isData);
+    }
+    else if (str.find("x_bins=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"x_bins=");
+      Common::SetupBins(str,fXBins,fXVarBins);
+      fNBinsX = fXBins.size()-1;
+    }
+    else if (str.find("y_title=") != std::string::npos)
+    {
+      fYTitle = Common::RemoveDelim(str,"y_title=");
+    }
+    else if (str.find("y_var=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"y_var=");
+      Common::SetVar(str,Variable::Y);
+    }
+    else if (str.find("y_var_data=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"y_var_data=");
+      Common::SetVarMod(str,Variable::Y,SampleGroup::isData);
+    }
+    else if (str.find("y_bins=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"y_bins=");
+      Common::SetupBins(str,fYBins,fYVarBins);
+      fNBinsY = fYBins.size()-1;
+    }
+  }
+}
+
+void RunTimeMonitor::SetupTimeFitConfig()
+{
+  std::cout << "Reading time fit config..." << std::endl;
+
+  std::ifstream infile(Form("%s",fTimeFitConfig.Data()),std::ios::in);
+  std::string str;
+  while (std::getline(infile,str))
+  {
+    if (str == "") continue;
+    else if (str.find("fit_type=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"fit_type=");
+      Common::SetupTimeFitType(str,fTimeFitType);
+    }
+    else if (str.find("range_low=") != std::string::npos) // if "core" = how many sigma from mean down, else absolute low edge of fit
+    {
+      str = Common::RemoveDelim(str,"range_low=");
+      fRangeLow = std::atof(str.c_str());
+    }
+    else if (str.find("range_up=") != std::string::npos) // if "core" = how many sigma from mean up, else absolute up edge of fit
+    {
+      str = Common::RemoveDelim(str,"range_up=");
+      fRangeUp = std::atof(str.c_str());
+    }
+    else if (str.find("time_text=") != std::string::npos)
+    {
+      fTimeText = Common::RemoveDelim(str,"time_text=");
+    }
+    else
+    {
+      std::cerr << "Aye... your fit config is messed up, try again! Offending line: " << str.c_str() << std::endl;
+      std::cerr << "Offending line: " << str.c_str() << std::endl;
+      exit(1);
+    }
+  }
+}
+
+void RunTimeMonitor::SetupStoreKeys()
+{
+  // anything changing what is summed per run invalidates the sums
+  std::stringstream fillkey;
+  fillkey << "cut=" << Common::CutWgtMap["Data"].Data()
+	  << ";x=" << Common::XVarMap["Data"].Data()
+	  << ";y=" << Common::YVarMap["Data"].Data()
+	  << ";ybins=";
+  for (const auto ybin : fYBins) fillkey << std::setprecision(9) << ybin << ",";
+  fFillKey = fillkey.str();
+
+  // anything changing the fit only invalidates the fits
+  std::stringstream fitkey;
+  fitkey << "type=" << fTimeFitType << ";low=" << fRangeLow << ";up=" << fRangeUp;
+  fFitKey = fitkey.str();
+}
+
+TH1F * RunTimeMonitor::SetupHist(const TString & ytitle, const TString & yextra)
+{
+  // get bins
+  const auto xbins = &fXBins[0];
+
+  // make new hist
+  auto hist = new TH1F("Data_"+yextra,fTitle+" "+ytitle+";"+fXTitle+";"+ytitle,fNBinsX,xbins);
+  hist->Sumw2();
+
+  return hist;
+}
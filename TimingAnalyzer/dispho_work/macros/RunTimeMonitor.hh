@@ -0,0 +1,141 @@
+#ifndef __RunTimeMonitor__
+#define __RunTimeMonitor__
+
+// ROOT inludes
+#include "TStyle.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TH1F.h"
+#include "TString.h"
+#include "TCanvas.h"
+#include "TPaveText.h"
+
+// STL includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <map>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+// Common include(s)
+#include "Common.hh"
+#include "CommonTimeFit.hh"
+
+// sufficient statistics of the time distribution of a single run: enough to refit it without the skim
+struct RunStats
+{
+  RunStats() : nEntries(0), sumw(0.0), sumwy(0.0), sumwy2(0.0), changed(true), fitted(false) {}
+
+  Long64_t nEntries;
+  Double_t sumw;
+  Double_t sumwy;
+  Double_t sumwy2;
+  std::vector<Double_t> contents; // fixed y bins, under/overflow included
+  std::vector<Double_t> sumw2;
+
+  Bool_t changed; // new entries (or new fit config) since the last fit
+  Bool_t fitted;
+  TimeFitResult result;
+};
+
+namespace Common
+{
+  static const TString runStoreConfigTreeName = "runstore_config";
+  static const TString runStoreInputsTreeName = "runstore_inputs";
+  static const TString runStoreRunsTreeName   = "runstore_runs";
+  static const Long64_t runStoreChunk         = 1000000;
+};
+
+class RunTimeMonitor
+{
+public:
+  RunTimeMonitor(const TString & infilename, const TString & cutconfig, const TString & plotconfig,
+		 const TString & timefitconfig, const TString & era, const TString & storename,
+		 const TString & outfiletext);
+  ~RunTimeMonitor();
+
+  // config
+  void SetupCommon();
+  void SetupPlotConfig();
+  void SetupTimeFitConfig();
+  void SetupStoreKeys();
+
+  // main calls
+  void MakeTimeVsRunMonitor();
+  void ReadStore();
+  void UpdateStore();
+  void FitChangedRuns();
+  void WriteStore();
+  void ExtractFitResults();
+  void MakePlots();
+
+  // subroutines for the store
+  void ResetStore();
+  void FillEntries(TTree * tree, const Long64_t first, const Long64_t nentries);
+  Bool_t GetLastRunEvent(TTree * tree, const Long64_t entry, Long64_t & run, Long64_t & event);
+  TH1F * MakeRunHist(const Int_t run, const RunStats & stats);
+
+  // subroutines for plotting
+  void PrintCanvas(Float_t min, Float_t max, const TString & key, const Bool_t isLogy);
+
+  // save meta data and extra info
+  void MakeConfigPave();
+  void DumpFitInfo();
+
+  // additional helper functions
+  void GetMinMax(const TH1F * hist, Float_t & min, Float_t & max, const TString & key);
+  TH1F * SetupHist(const TString & ytitle, const TString & yextra);
+
+private:
+  // settings
+  const TString fInFileName;
+  const TString fCutConfig;
+  const TString fPlotConfig;
+  const TString fTimeFitConfig;
+  const TString fEra;
+  const TString fStoreName;
+  const TString fOutFileText;
+
+  // style
+  TStyle * fTDRStyle;
+  TString fTitle;
+  TString fXTitle;
+  TString fYTitle;
+  std::vector<Double_t> fXBins;
+  Int_t fNBinsX;
+  Bool_t fXVarBins;
+  std::vector<Double_t> fYBins;
+  Int_t fNBinsY;
+  Bool_t fYVarBins;
+
+  // var fit config
+  TimeFitType fTimeFitType;
+  Float_t fRangeLow;
+  Float_t fRangeUp;
+  TString fTimeText;
+
+  // store: what went into the sums, and what went into the fits
+  std::string fFillKey;
+  std::string fFitKey;
+  Long64_t fNProcessed;
+  Long64_t fLastRun;
+  Long64_t fLastEvent;
+  std::map<Int_t,RunStats> fRunStatsMap;
+
+  // input
+  TFile * fInFile;
+  TTree * fInTree;
+
+  // tmp I/O
+  std::map<TString,TH1F*> ResultsMap;
+
+  // output
+  TFile * fOutFile;
+  TPaveText * fConfigPave;
+};
+
+#endif
@@ -13,6 +13,7 @@ SRPlotter::SRPlotter(const TString & srplotconfig, const TString & miscconfig, c
 
   // setup config
   TreePlotter::SetupDefaults();
+  fHasBoot = false;
   SRPlotter::SetupCommon();
   TreePlotter::SetupMiscConfig(fMiscConfig);
   SRPlotter::SetupSRPlotConfig();
@@ -48,6 +49,10 @@ void SRPlotter::MakeSRPlot()
   // Scale data CR hists via MC predictions
   Common::GetSRPredFromCRs(TreePlotter::HistMap,SRPlotter::HistMap,fXVarBins,fCRKFMap,fCRXFMap);
 
+  // Stat uncertainty on the factors, if the inputs were filled with bootstrap replicas
+  if (fHasBoot) Common::GetBootFactorsFromCRs(TreePlotter::HistMap,SRPlotter::HistMap,TreePlotter::BootHistMap,SRPlotter::BootHistMap,
+					      fXVarBins,fCRKFErrMap,fCRXFErrMap);
+
   // Bulk hist plotter
   SRPlotter::CommonPlotter(fOutFileText);
 
@@ -248,6 +253,13 @@ void SRPlotter::DumpIntegrals(const TString & CR, TFile *& infile, std::ofstream
   // dump factors
   dumpfile << Form("%s k-Factor: ",CR.Data()) << fCRKFMap[CR] << std::endl;
   dumpfile << Form("%s x-Factor: ",CR.Data()) << fCRXFMap[CR] << std::endl;
+
+  // bootstrap spread
+  if (fHasBoot)
+  {
+    dumpfile << Form("%s k-Factor bootstrap spread: ",CR.Data()) << fCRKFErrMap[CR] << std::endl;
+    dumpfile << Form("%s x-Factor bootstrap spread: ",CR.Data()) << fCRXFErrMap[CR] << std::endl;
+  }
 }
 
 void SRPlotter::DeleteMemory(const Bool_t deleteSRHists)
@@ -260,6 +272,9 @@ void SRPlotter::DeleteMemory(const Bool_t deleteSRHists)
   {
     for (auto & HistPair : SRPlotter::HistMap) delete HistPair.second;
     SRPlotter::HistMap.clear();
+
+    for (auto & HistPair : SRPlotter::BootHistMap) delete HistPair.second;
+    SRPlotter::BootHistMap.clear();
   }
 }
 
@@ -337,6 +352,7 @@ void SRPlotter::SetupHists()
   fGJetsFile->cd();
 
   Common::SetupCRHists("GJets",fGJetsFile,TreePlotter::HistMap,SRPlotter::HistMap);
+  fHasBoot = Common::SetupCRBootHists("GJets",fGJetsFile,TreePlotter::BootHistMap,SRPlotter::BootHistMap);
 
   ////////////
   // QCD CR //
@@ -347,6 +363,7 @@ void SRPlotter::SetupHists()
   fQCDFile->cd();
 
   Common::SetupCRHists("QCD",fQCDFile,TreePlotter::HistMap,SRPlotter::HistMap);
+  fHasBoot = (Common::SetupCRBootHists("QCD",fQCDFile,TreePlotter::BootHistMap,SRPlotter::BootHistMap) && fHasBoot);
 
   //////////////
   // SR Hists //
@@ -357,6 +374,7 @@ void SRPlotter::SetupHists()
   fSRFile->cd();
 
   Common::SetupSRMCHists(fSRFile,SRPlotter::HistMap);
+  fHasBoot = (Common::SetupSRMCBootHists(fSRFile,SRPlotter::BootHistMap) && fHasBoot);
 
   /////////////////////////////////////////////////////////////
   // Read in the remaining SR histograms (for plotting only) //
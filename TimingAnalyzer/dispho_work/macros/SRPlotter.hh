@@ -55,10 +55,16 @@ private:
 
   // input extra hists
   std::map<TString,TH1F*> HistMap;
+  std::map<TString,TH2F*> BootHistMap;
+  Bool_t fHasBoot;
 
   // factor maps
   std::map<TString,Float_t> fCRKFMap;
   std::map<TString,Float_t> fCRXFMap;
+
+  // bootstrap spread of the factors
+  std::map<TString,Float_t> fCRKFErrMap;
+  std::map<TString,Float_t> fCRXFErrMap;
 };
 
 #endif
@@ -0,0 +1,387 @@
+// Class include
+#include "SampleManifest.hh"
+
+SampleManifest::SampleManifest(const TString & manifestname)
+  : fManifestName(manifestname)
+{
+  std::cout << "Initializing SampleManifest..." << std::endl;
+
+  // read in previous harvest if it exists
+  if (!Common::IsNullFile(fManifestName)) SampleManifest::Read();
+}
+
+void SampleManifest::Read()
+{
+  std::cout << "Reading manifest: " << fManifestName.Data() << std::endl;
+
+  auto file = TFile::Open(fManifestName.Data());
+  Common::CheckValidFile(file,fManifestName);
+
+  auto tree = (TTree*)file->Get(Common::manifestTreeName.Data());
+  Common::CheckValidTree(tree,Common::manifestTreeName,fManifestName);
+
+  // set branches
+  std::string * filename = 0;
+  FileMetadata metadata;
+  std::vector<Float_t> * puObs = 0, * puObsWgt = 0, * puTrue = 0, * puTrueWgt = 0;
+
+  tree->SetBranchAddress("filename",&filename);
+  tree->SetBranchAddress("size",&metadata.size);
+  tree->SetBranchAddress("mtime",&metadata.mtime);
+  tree->SetBranchAddress("nEntries",&metadata.nEntries);
+  tree->SetBranchAddress("sumWgts",&metadata.sumWgts);
+  tree->SetBranchAddress("sumWgtsWgt",&metadata.sumWgtsWgt);
+  tree->SetBranchAddress("puObs",&puObs);
+  tree->SetBranchAddress("puObsWgt",&puObsWgt);
+  tree->SetBranchAddress("puTrue",&puTrue);
+  tree->SetBranchAddress("puTrueWgt",&puTrueWgt);
+
+  // not in manifests from before the PU errors were kept: those files are harvested again
+  const Bool_t hasPUErrors = (tree->GetBranch("puObsErr2") != (TBranch*) NULL);
+  std::vector<Float_t> * puObsErr2 = 0, * puObsWgtErr2 = 0, * puTrueErr2 = 0, * puTrueWgtErr2 = 0;
+  if (hasPUErrors)
+  {
+    tree->SetBranchAddress("puObsErr2",&puObsErr2);
+    tree->SetBranchAddress("puObsWgtErr2",&puObsWgtErr2);
+    tree->SetBranchAddress("puTrueErr2",&puTrueErr2);
+    tree->SetBranchAddress("puTrueWgtErr2",&puTrueWgtErr2);
+  }
+
+  // one entry per file
+  fMetadataMap.clear();
+  const auto nEntries = tree->GetEntries();
+  for (auto entry = 0U; entry < nEntries; entry++)
+  {
+    tree->GetEntry(entry);
+
+    auto & outmetadata = fMetadataMap[*filename];
+    outmetadata = metadata;
+    outmetadata.puObs     = *puObs;
+    outmetadata.puObsWgt  = *puObsWgt;
+    outmetadata.puTrue    = *puTrue;
+    outmetadata.puTrueWgt = *puTrueWgt;
+    if (hasPUErrors)
+    {
+      outmetadata.puObsErr2     = *puObsErr2;
+      outmetadata.puObsWgtErr2  = *puObsWgtErr2;
+      outmetadata.puTrueErr2    = *puTrueErr2;
+      outmetadata.puTrueWgtErr2 = *puTrueWgtErr2;
+    }
+  }
+
+  std::cout << "Read metadata for " << fMetadataMap.size() << " files" << std::endl;
+
+  delete tree;
+  delete file;
+}
+
+void SampleManifest::Write()
+{
+  std::cout << "Writing manifest: " << fManifestName.Data() << std::endl;
+
+  auto file = TFile::Open(fManifestName.Data(),"RECREATE");
+  Common::CheckValidFile(file,fManifestName);
+  file->cd();
+
+  auto tree = new TTree(Common::manifestTreeName.Data(),Common::manifestTreeName.Data());
+
+  std::string filename;
+  FileMetadata metadata;
+
+  tree->Branch("filename",&filename);
+  tree->Branch("size",&metadata.size);
+  tree->Branch("mtime",&metadata.mtime);
+  tree->Branch("nEntries",&metadata.nEntries);
+  tree->Branch("sumWgts",&metadata.sumWgts);
+  tree->Branch("sumWgtsWgt",&metadata.sumWgtsWgt);
+  tree->Branch("puObs",&metadata.puObs);
+  tree->Branch("puObsWgt",&metadata.puObsWgt);
+  tree->Branch("puTrue",&metadata.puTrue);
+  tree->Branch("puTrueWgt",&metadata.puTrueWgt);
+  tree->Branch("puObsErr2",&metadata.puObsErr2);
+  tree->Branch("puObsWgtErr2",&metadata.puObsWgtErr2);
+  tree->Branch("puTrueErr2",&metadata.puTrueErr2);
+  tree->Branch("puTrueWgtErr2",&metadata.puTrueWgtErr2);
+
+  for (const auto & MetadataPair : fMetadataMap)
+  {
+    filename = MetadataPair.first;
+    metadata = MetadataPair.second;
+    tree->Fill();
+  }
+
+  file->cd();
+  tree->Write(tree->GetName(),TObject::kWriteDelete);
+
+  delete tree;
+  delete file;
+}
+
+void SampleManifest::Harvest(const TString & indir, const TString & filesconfig)
+{
+  std::cout << "Harvesting metadata for files in: " << filesconfig.Data() << std::endl;
+
+  // new map, reusing old entries where possible
+  std::map<std::string,FileMetadata> newMetadataMap;
+  auto nReused = 0U, nHarvested = 0U;
+
+  std::ifstream infiles(filesconfig.Data(),std::ios::in);
+  TString infile = "";
+  while (infiles >> infile)
+  {
+    const TString infilename = Form("%s/%s",indir.Data(),infile.Data());
+    const std::string key = infilename.Data();
+
+    // file identity
+    Long64_t size = 0, mtime = 0;
+    if (!SampleManifest::GetFileIdentity(infilename,size,mtime))
+    {
+      std::cerr << "Cannot stat input file: " << infilename.Data() << " ...exiting..." << std::endl;
+      exit(1);
+    }
+
+    // reuse if unchanged
+    const auto & oldMetadata = fMetadataMap.find(key);
+    if ((oldMetadata != fMetadataMap.end()) && (oldMetadata->second.size == size) && (oldMetadata->second.mtime == mtime)
+	&& oldMetadata->second.HasPUErrors())
+    {
+      newMetadataMap[key] = oldMetadata->second;
+      nReused++;
+      continue;
+    }
+
+    // otherwise, open once and take it all
+    auto & metadata = newMetadataMap[key];
+    metadata.size  = size;
+    metadata.mtime = mtime;
+    SampleManifest::HarvestFile(infilename,metadata);
+    nHarvested++;
+  }
+
+  // files no longer listed are dropped
+  auto nStale = 0U;
+  for (const auto & MetadataPair : fMetadataMap)
+  {
+    if (!newMetadataMap.count(MetadataPair.first)) nStale++;
+  }
+  std::cout << "Reused: " << nReused << " Harvested: " << nHarvested << " Stale: " << nStale << std::endl;
+
+  fMetadataMap.swap(newMetadataMap);
+}
+
+void SampleManifest::HarvestFile(const TString & filename, FileMetadata & metadata)
+{
+  auto file = TFile::Open(filename.Data());
+  Common::CheckValidFile(file,filename);
+  file->cd();
+
+  // cut flows
+  const TString inh_cutflowname = Form("%s/%s",Common::rootdir.Data(),Common::h_cutflowname.Data());
+  auto cutflow = (TH1F*)file->Get(inh_cutflowname.Data());
+  Common::CheckValidHist(cutflow,inh_cutflowname,filename);
+  metadata.sumWgts = cutflow->GetBinContent(1);
+  delete cutflow;
+
+  const TString inh_cutflow_wgtname = Form("%s/%s",Common::rootdir.Data(),Common::h_cutflow_wgtname.Data());
+  auto cutflow_wgt = (TH1F*)file->Get(inh_cutflow_wgtname.Data());
+  Common::CheckValidHist(cutflow_wgt,inh_cutflow_wgtname,filename);
+  metadata.sumWgtsWgt = cutflow_wgt->GetBinContent(1);
+  delete cutflow_wgt;
+
+  // entries: header only, no baskets read
+  const TString intreename = Form("%s/%s",Common::rootdir.Data(),Common::disphotreename.Data());
+  auto tree = (TTree*)file->Get(intreename.Data());
+  Common::CheckValidTree(tree,intreename,filename);
+  metadata.nEntries = tree->GetEntries();
+  delete tree;
+
+  // pileup: only in MC, so ok to be missing
+  const std::vector<std::tuple<TString,std::vector<Float_t>*,std::vector<Float_t>*> > puhists =
+    {std::make_tuple(Common::puObsHistName,&metadata.puObs,&metadata.puObsErr2),
+     std::make_tuple(Common::puObsHistName+"_wgt",&metadata.puObsWgt,&metadata.puObsWgtErr2),
+     std::make_tuple(Common::puTrueHistName,&metadata.puTrue,&metadata.puTrueErr2),
+     std::make_tuple(Common::puTrueHistName+"_wgt",&metadata.puTrueWgt,&metadata.puTrueWgtErr2)};
+
+  for (const auto & puhist : puhists)
+  {
+    auto & contents = *std::get<1>(puhist);
+    auto & errors2  = *std::get<2>(puhist);
+    contents.clear();
+    errors2 .clear();
+
+    const TString inhistname = Form("%s/%s",Common::rootdir.Data(),std::get<0>(puhist).Data());
+    auto inhist = (TH1F*)file->Get(inhistname.Data());
+    if (inhist == (TH1F*) NULL) continue;
+
+    // keep under/overflow; errors as TH1::Add() sums them: sumw2 if stored, else the content
+    for (auto ibin = 0; ibin <= inhist->GetNbinsX()+1; ibin++)
+    {
+      contents.emplace_back(inhist->GetBinContent(ibin));
+      errors2 .emplace_back(std::pow(inhist->GetBinError(ibin),2));
+    }
+    delete inhist;
+  }
+
+  delete file;
+}
+
+Float_t SampleManifest::GetSumWgts() const
+{
+  Float_t sumwgts = 0.f;
+  for (const auto & MetadataPair : fMetadataMap) sumwgts += MetadataPair.second.sumWgts;
+  return sumwgts;
+}
+
+Long64_t SampleManifest::GetNEntries() const
+{
+  Long64_t nentries = 0;
+  for (const auto & MetadataPair : fMetadataMap) nentries += MetadataPair.second.nEntries;
+  return nentries;
+}
+
+const FileMetadata * SampleManifest::GetMetadata(const TString & filename) const
+{
+  const auto & metadata = fMetadataMap.find(filename.Data());
+  return ((metadata != fMetadataMap.end()) ? &metadata->second : (FileMetadata*) NULL);
+}
+
+void SampleManifest::DumpSumWeights(const TString & wgtfile) const
+{
+  // same format as computeSumWeights.C
+  std::ofstream outfile(wgtfile.Data(),std::ios_base::trunc);
+  outfile << "Sum_of_weights: " << SampleManifest::GetSumWgts() << std::endl;
+}
+
+void SampleManifest::FillPUHist(TH1F *& hist, const TString & histname) const
+{
+  // same contents and errors as TH1::Add() of the input hists in computePUWeights.C
+  hist->Sumw2();
+  for (const auto & MetadataPair : fMetadataMap)
+  {
+    const auto & metadata = MetadataPair.second;
+    const auto & contents = metadata.GetPUContents(histname);
+    const auto & errors2  = metadata.GetPUErrors2 (histname);
+
+    if (contents.size() == 0)
+    {
+      std::cerr << "No " << histname.Data() << " stored for: " << MetadataPair.first.c_str() << " ...exiting..." << std::endl;
+      exit(1);
+    }
+    if (Int_t(contents.size()) != hist->GetNbinsX()+2 || errors2.size() != contents.size())
+    {
+      std::cerr << "Binning mismatch for " << histname.Data() << " in: " << MetadataPair.first.c_str() << " ...exiting..." << std::endl;
+      exit(1);
+    }
+
+    for (auto ibin = 0U; ibin < contents.size(); ibin++)
+    {
+      hist->SetBinContent(ibin,hist->GetBinContent(ibin)+contents[ibin]);
+      hist->SetBinError  (ibin,std::sqrt(std::pow(hist->GetBinError(ibin),2)+errors2[ibin]));
+    }
+  }
+}
+
+void SampleManifest::MakePUWeights(const TString & puwgtfile) const
+{
+  std::cout << "Making PU weights from manifest: " << puwgtfile.Data() << std::endl;
+
+  // make out file
+  auto outfile = TFile::Open(Form("%s",puwgtfile.Data()),"UPDATE");
+  outfile->cd();
+
+  // get mc sum hists: same as computePUWeights.C, but from cached contents
+  std::map<TString,TH1F*> mchistmap;
+  for (const auto & name : {Common::puObsHistName,Common::puObsHistName+"_wgt",Common::puTrueHistName,Common::puTrueHistName+"_wgt"})
+  {
+    auto & hist = mchistmap[name];
+    hist = new TH1F(Form("%s_sum",name.Data()),Form("%s_sum",name.Data()),Common::nPUBins,0,Common::nPUBins);
+    SampleManifest::FillPUHist(hist,name);
+  }
+
+  // save tmp output
+  outfile->cd();
+  for (const auto & mchistpair : mchistmap)
+  {
+    const auto & hist = mchistpair.second;
+    hist->Write(hist->GetName(),TObject::kWriteDelete);
+  }
+
+  // input data file
+  const TString indatafilename = Form("%s/%s.root",Common::eosDir.Data(),Common::dataPUFileName.Data());
+  auto indatafile = TFile::Open(indatafilename.Data());
+  Common::CheckValidFile(indatafile,indatafilename);
+  indatafile->cd();
+
+  // Get data hist
+  const TString indatahistname = Form("%s",Common::dataPUHistName.Data());
+  auto indatahist = (TH1D*)indatafile->Get(indatahistname.Data());
+  Common::CheckValidHist(indatahist,indatahistname,indatafilename);
+
+  // Make data hist resized
+  auto datahist = new TH1F("h_pudata","h_pudata",Common::nPUBins,0,Common::nPUBins);
+  datahist->Sumw2();
+  for (auto ibin = 1; ibin <= datahist->GetXaxis()->GetNbins(); ibin++)
+  {
+    datahist->SetBinContent(ibin,indatahist->GetBinContent(ibin));
+    datahist->SetBinError  (ibin,indatahist->GetBinError  (ibin));
+  }
+
+  // save data
+  outfile->cd();
+  datahist->Write(datahist->GetName(),TObject::kWriteDelete);
+
+  // make weights: normalized data / normalized MC
+  for (auto & mchistpair : mchistmap)
+  {
+    const auto & name = mchistpair.first;
+    auto & mchist = mchistpair.second;
+
+    auto wgthist = (TH1F*)datahist->Clone(Form("%s_%s",name.Data(),Common::puwgtHistName.Data()));
+    wgthist->Scale(1.f/wgthist->Integral());
+    mchist ->Scale(1.f/mchist ->Integral());
+    wgthist->Divide(mchist);
+
+    outfile->cd();
+    wgthist->Write(wgthist->GetName(),TObject::kWriteDelete);
+    delete wgthist;
+  }
+
+  // delete the rest
+  delete datahist;
+  delete indatahist;
+  delete indatafile;
+  Common::DeleteMap(mchistmap);
+  delete outfile;
+}
+
+Bool_t SampleManifest::GetFileIdentity(const TString & filename, Long64_t & size, Long64_t & mtime)
+{
+  struct stat buffer;
+  if (stat(filename.Data(),&buffer) != 0) return false;
+
+  size  = buffer.st_size;
+  mtime = buffer.st_mtime;
+  return true;
+}
+
+Bool_t FileMetadata::HasPUErrors() const
+{
+  return (puObsErr2.size() == puObs.size() && puObsWgtErr2.size() == puObsWgt.size() &&
+	  puTrueErr2.size() == puTrue.size() && puTrueWgtErr2.size() == puTrueWgt.size());
+}
+
+const std::vector<Float_t> & FileMetadata::GetPUContents(const TString & histname) const
+{
+  return (histname == Common::puObsHistName        ? puObs    :
+	  histname == Common::puObsHistName+"_wgt" ? puObsWgt :
+	  histname == Common::puTrueHistName       ? puTrue   :
+	                                             puTrueWgt);
+}
+
+const std::vector<Float_t> & FileMetadata::GetPUErrors2(const TString & histname) const
+{
+  return (histname == Common::puObsHistName        ? puObsErr2    :
+	  histname == Common::puObsHistName+"_wgt" ? puObsWgtErr2 :
+	  histname == Common::puTrueHistName       ? puTrueErr2   :
+	                                             puTrueWgtErr2);
+}
@@ -0,0 +1,82 @@
+#ifndef __SampleManifest__
+#define __SampleManifest__
+
+// ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TH1F.h"
+#include "TH1D.h"
+#include "TString.h"
+
+// STL includes
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <cmath>
+#include <sys/stat.h>
+
+// Common include
+#include "Common.hh"
+
+// everything needed from a single unskimmed ntuple, harvested in one open
+struct FileMetadata
+{
+  FileMetadata() : size(0), mtime(0), nEntries(0), sumWgts(0.f), sumWgtsWgt(0.f) {}
+
+  // contents and errors squared (incl. under/overflow) of a PU hist, by name
+  Bool_t HasPUErrors() const;
+  const std::vector<Float_t> & GetPUContents(const TString & histname) const;
+  const std::vector<Float_t> & GetPUErrors2 (const TString & histname) const;
+
+  // file identity
+  Long64_t size;
+  Long64_t mtime;
+
+  // payload
+  Long64_t nEntries;
+  Float_t  sumWgts;    // h_cutflow, bin 1
+  Float_t  sumWgtsWgt; // h_cutflow_wgt, bin 1
+  std::vector<Float_t> puObs;
+  std::vector<Float_t> puObsWgt;
+  std::vector<Float_t> puTrue;
+  std::vector<Float_t> puTrueWgt;
+  std::vector<Float_t> puObsErr2;
+  std::vector<Float_t> puObsWgtErr2;
+  std::vector<Float_t> puTrueErr2;
+  std::vector<Float_t> puTrueWgtErr2;
+};
+
+class SampleManifest
+{
+public:
+  SampleManifest(const TString & manifestname);
+  ~SampleManifest() {}
+
+  // persistence
+  void Read();
+  void Write();
+
+  // harvesting: only opens new or changed files, drops files no longer listed
+  void Harvest(const TString & indir, const TString & filesconfig);
+  void HarvestFile(const TString & filename, FileMetadata & metadata);
+
+  // outputs
+  Float_t GetSumWgts() const;
+  Long64_t GetNEntries() const;
+  const FileMetadata * GetMetadata(const TString & filename) const;
+  void DumpSumWeights(const TString & wgtfile) const;
+  void MakePUWeights(const TString & puwgtfile) const;
+
+  // helpers
+  static Bool_t GetFileIdentity(const TString & filename, Long64_t & size, Long64_t & mtime);
+  void FillPUHist(TH1F *& hist, const TString & histname) const;
+
+private:
+  const TString fManifestName;
+  std::map<std::string,FileMetadata> fMetadataMap;
+};
+
+#endif
@@ -1,7 +1,9 @@
 #include "SignalSkimmer.hh"
 
-SignalSkimmer::SignalSkimmer(const TString & cutflowconfig, const TString & inskimdir, const TString & outtext)
-  : fCutFlowConfig(cutflowconfig), fInSkimDir(inskimdir), fOutFileText(outtext)
+SignalSkimmer::SignalSkimmer(const TString & cutflowconfig, const TString & inskimdir, const TString & outtext,
+			     const TString & listcachename)
+  : fCutFlowConfig(cutflowconfig), fInSkimDir(inskimdir), fOutFileText(outtext),
+    fListCacheName(listcachename), fListCache(listcachename)
 {
   std::cout << "Initializing SignalSkimmer..." << std::endl;
 
@@ -23,10 +25,15 @@ SignalSkimmer::~SignalSkimmer()
   // delete everything else already not deleted
   delete fConfigPave;
   delete fOutFile;
+
+  // where the time went
+  Profiler::Dump(fOutFileText);
 }
 
 void SignalSkimmer::MakeSkims()
 {
+  PROFILE_SCOPE("SignalSkimmer::MakeSkims");
+
   // Make TEntryLists for each cut, clone and save final tree
   SignalSkimmer::MakeSkimsFromTrees();
 
@@ -36,6 +43,8 @@ void SignalSkimmer::MakeSkims()
 
 void SignalSkimmer::MakeSkimsFromTrees()
 {
+  PROFILE_READ_SCOPE("SignalSkimmer::MakeSkimsFromTrees");
+
   std::cout << "Skimming trees from cut flow vector..." << std::endl;
 
   for (const auto & SamplePair : Common::SampleMap)
@@ -46,21 +55,22 @@ void SignalSkimmer::MakeSkimsFromTrees()
     std::cout << "Working on input: " << input.Data() << std::endl;
 
     // Get File
-    const TString infilename = Form("%s/%s/%s/%s/%s",Common::eosDir.Data(),Common::baseDir.Data(),fInSkimDir.Data(),input.Data(),Common::tupleFileName.Data());
+    const TString infilename = Common::GetSkimFileName(fInSkimDir,input);
     auto infile = TFile::Open(Form("%s",infilename.Data()));
     Common::CheckValidFile(infile,infilename);
 	
     // Get TTree
     auto intree = (TTree*)infile->Get(Form("%s",Common::disphotreename.Data()));
     Common::CheckValidTree(intree,Common::disphotreename,infilename);
+    Profiler::Count("entries",intree->GetEntries());
 
     // Get Input Cut Flow Histogram 
     auto inhist = (TH1F*)infile->Get(Form("%s",Common::h_cutflow_scaledname.Data()));
     Common::CheckValidHist(inhist,Common::h_cutflow_scaledname,infilename);
 
     // Init Output Cut Flow Histogram 
-    std::map<TString,Int_t> binlabels;
-    auto outhist = Common::SetupOutCutFlowHist(inhist,Common::SignalCutFlowHistNameMap[sample],binlabels);
+    CutFlow cutflow;
+    auto outhist = Common::SetupOutCutFlowHist(inhist,Common::SignalCutFlowHistNameMap[sample],cutflow);
 
     // Initialize map of lists
     std::map<TString,TEntryList*> listmap;
@@ -72,11 +82,16 @@ void SignalSkimmer::MakeSkimsFromTrees()
     TBranch * b_evtwgt = 0;
     intree->SetBranchAddress("evtwgt",&evtwgt,&b_evtwgt);
 
+    // key for cached lists, and the cuts applied so far
+    const auto treekey = fListCache.GetTreeKey(infile,Common::disphotreename);
+    TString chain = "";
+
     // Loop over cuts, and make entry list for each cut, 
     for (const auto & CutFlowPair : Common::CutFlowPairVec)
     {
       // Get entry list
       const auto & label = CutFlowPair.first;
+      const auto slot = cutflow.GetSlot(label.Data());
       auto & list = listmap[label];
       list->SetDirectory(infile);
       infile->cd();
@@ -85,12 +100,16 @@ void SignalSkimmer::MakeSkimsFromTrees()
       if (label.Contains("HLT",TString::kExact) && sample.EqualTo("GMSB_L200_CTau400")) continue;
     
       std::cout << "Computing entries for cut: " << label.Data() << std::endl;
+      TStopwatch timer; // cost of this cut: entry list plus cut flow fill
 
       // get cut string
       const auto & cutstring = CutFlowPair.second;
 
-      // use ttree::draw() to generate entry list
-      intree->Draw(Form(">>%s",list->GetName()),Form("%s",cutstring.Data()),"entrylist");
+      // use ttree::draw() to generate entry list, unless cached
+      {
+	PROFILE_SCOPE("SignalSkimmer::MakeList");
+	fListCache.MakeList(intree,treekey,cutstring,list,chain);
+      }
 
       // store result of number of entries into cutflow th1
       for (auto ientry = 0U; ientry < intree->GetEntries(); ientry++)
@@ -103,8 +122,9 @@ void SignalSkimmer::MakeSkimsFromTrees()
       	if (localEntry < 0) break;
       
       	b_evtwgt->GetEntry(localEntry);
-      	outhist->Fill((binlabels[label]*1.f)-0.5f,1.f);
+      	cutflow.Fill(slot);
       }
+      cutflow.AddTime(slot,timer.RealTime());
 
       // recursively set entry list for input tree
       intree->SetEntryList(list);
@@ -115,9 +135,14 @@ void SignalSkimmer::MakeSkimsFromTrees()
     // Write out a copy of the last skim
     fOutFile->cd();
     auto outtree = intree->CopyTree("");
+    Profiler::Count("selected",outtree->GetEntries());
     outtree->SetName(Form("%s",Common::TreeNameMap[sample].Data()));
     outtree->Write(outtree->GetName(),TObject::kWriteDelete);
 
+    // Export cuts to hist, and report efficiency and cost per cut
+    cutflow.Export(outhist,NULL,NULL);
+    cutflow.Dump();
+
     // Write out hist
     fOutFile->cd();
     outhist->Write(outhist->GetName(),TObject::kWriteDelete);
@@ -144,6 +169,8 @@ void SignalSkimmer::MakeSkimsFromTrees()
 
 void SignalSkimmer::MakeConfigPave()
 {
+  PROFILE_SCOPE("SignalSkimmer::MakeConfigPave");
+
   std::cout << "Dumping config to a pave..." << std::endl;
 
   // create the pave
@@ -156,6 +183,9 @@ void SignalSkimmer::MakeConfigPave()
   // dump cut config
   Common::AddTextFromInputConfig(fConfigPave,"SignalSkimmer Cut Config",fCutFlowConfig);
 
+  // save name of entry list cache
+  fConfigPave->AddText(Form("Entry list cache: %s",fListCacheName.Data()));
+
   // save to output file
   fOutFile->cd();
   fConfigPave->Write(fConfigPave->GetName(),TObject::kWriteDelete);
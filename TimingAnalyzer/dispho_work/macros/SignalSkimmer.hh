@@ -7,6 +7,7 @@
 #include "TH1F.h"
 #include "TString.h"
 #include "TEntryList.h"
+#include "TStopwatch.h"
 #include "TPaveText.h"
 
 // STL includes
@@ -17,11 +18,13 @@
 
 // Common include
 #include "Common.hh"
+#include "EntryListCache.hh"
 
 class SignalSkimmer
 {
 public:
-  SignalSkimmer(const TString & cutflowconfig, const TString & inskimdir, const TString & outfiletext);
+  SignalSkimmer(const TString & cutflowconfig, const TString & inskimdir, const TString & outfiletext,
+		const TString & listcachename = "");
   ~SignalSkimmer();
 
   // Initialize
@@ -44,6 +47,10 @@ private:
   const TString fCutFlowConfig;
   const TString fInSkimDir;
   const TString fOutFileText;
+  const TString fListCacheName;
+
+  // selections computed in previous runs
+  EntryListCache fListCache;
 
   // Output
   TFile * fOutFile;
@@ -0,0 +1,381 @@
+// Class include
+#include "SkimDriver.hh"
+
+SkimDriver::SkimDriver(const TString & indir, const TString & outdir, const TString & filesconfig,
+		       const Float_t sumwgts, const TString & skimtype, const TString & puwgtfilename, const TString & manifestname,
+		       const Int_t nworkers, const Int_t nretries, const Int_t mergechunk)
+  : fInDir(indir), fOutDir(outdir), fFilesConfig(filesconfig),
+    fSumWgts(sumwgts), fSkimType(skimtype), fPUWgtFileName(puwgtfilename), fManifestName(manifestname),
+    fNWorkers(std::max(nworkers,1)), fNRetries(std::max(nretries,0)), fMergeChunk(std::max(mergechunk,1))
+{
+  std::cout << "Initializing SkimDriver..." << std::endl;
+
+  ////////////////
+  //            //
+  // Initialize //
+  //            //
+  ////////////////
+
+  fJournalName = Form("%s/skim_journal.%s",fOutDir.Data(),Common::outTextExt.Data());
+  fNPartials = 0;
+  fNInFlight = 0;
+  fWallTime = 0;
+  fStats.resize(fNWorkers);
+
+  // pick up where the last run left off, then build the task list
+  SkimDriver::ReadJournal();
+  SkimDriver::SetupJobs();
+}
+
+void SkimDriver::ReadJournal()
+{
+  std::cout << "Reading journal: " << fJournalName.Data() << std::endl;
+
+  if (Common::IsNullFile(fJournalName))
+  {
+    std::cout << "No journal found, starting from scratch" << std::endl;
+    return;
+  }
+
+  // SKIM <file>
+  // MERGE <partial> <file1> <file2> ...
+  std::ifstream journal(fJournalName.Data(),std::ios::in);
+  std::string str;
+  while (std::getline(journal,str))
+  {
+    if (str == "") continue;
+
+    std::stringstream ss(str);
+    std::string key, name;
+    ss >> key >> name;
+
+    if (key == "SKIM")
+    {
+      fSkimmed.insert(name);
+    }
+    else if (key == "MERGE")
+    {
+      // partial lost? then its inputs are gone too --> redo them
+      const Bool_t isGoodPartial = !Common::IsNullFile(Form("%s/%s",fOutDir.Data(),name.c_str()));
+      if (isGoodPartial) fPartials.emplace_back(name);
+
+      std::string filename;
+      while (ss >> filename)
+      {
+	if (isGoodPartial) fMerged.insert(filename);
+	else               fSkimmed.erase(filename);
+      }
+      fNPartials++;
+    }
+    else
+    {
+      std::cerr << "Aye... your journal is messed up, skipping line: " << str.c_str() << std::endl;
+    }
+  }
+
+  std::cout << "Journal has " << fSkimmed.size() << " skimmed files and " << fPartials.size() << " partial merges" << std::endl;
+}
+
+void SkimDriver::SetupJobs()
+{
+  std::cout << "Setting up jobs..." << std::endl;
+
+  // manifest gives the number of entries per file for throughput, and the sum of weights: read once here, not by every skim
+  const Bool_t useManifest = (fManifestName != "" && !Common::IsNullFile(fManifestName));
+  const SampleManifest manifest(useManifest ? fManifestName : "");
+  if (useManifest)
+  {
+    fSumWgts = manifest.GetSumWgts();
+    std::cout << "Sum of weights from manifest: " << fSumWgts << std::endl;
+  }
+
+  std::ifstream infiles(fFilesConfig.Data(),std::ios::in);
+  TString infile = "";
+  auto nDone = 0U;
+  while (infiles >> infile)
+  {
+    const std::string filename = infile.Data();
+
+    // already in a partial merge
+    if (fMerged.count(filename)) {nDone++; continue;}
+
+    // skimmed but not yet merged: only if the output is still there
+    if (fSkimmed.count(filename) && !Common::IsNullFile(Form("%s/%s",fOutDir.Data(),filename.c_str())))
+    {
+      fUnmerged.emplace_back(filename);
+      nDone++;
+      continue;
+    }
+
+    // needs (re)skimming
+    SkimTask task(SkimFile);
+    task.filename = filename;
+
+    const TString infilename = Form("%s/%s",fInDir.Data(),filename.c_str());
+    Long64_t mtime = 0;
+    SampleManifest::GetFileIdentity(infilename,task.nBytes,mtime);
+
+    if (useManifest)
+    {
+      const auto metadata = manifest.GetMetadata(infilename);
+      if (metadata != (FileMetadata*) NULL) task.nEntries = metadata->nEntries;
+    }
+
+    fTasks.emplace_back(task);
+  }
+  fNSkimsLeft = fTasks.size();
+
+  std::cout << "Files to skim: " << fNSkimsLeft << " Already done: " << nDone << std::endl;
+}
+
+void SkimDriver::Run()
+{
+  std::cout << "Running " << fNWorkers << " workers..." << std::endl;
+
+  const auto start = std::chrono::steady_clock::now();
+
+  // leftovers from a previous run can be merged right away
+  SkimDriver::QueueMerge(fNSkimsLeft == 0);
+
+  // spin up the pool
+  std::vector<std::thread> workers;
+  for (auto iworker = 0; iworker < fNWorkers; iworker++)
+  {
+    workers.emplace_back(&SkimDriver::WorkerLoop,this,iworker);
+  }
+  for (auto & worker : workers) worker.join();
+
+  // only merge it all if nothing failed, else rerun will pick up from the journal
+  if (fFailed.empty())
+  {
+    if (!SkimDriver::FinalMerge()) fFailed.emplace_back("final merge");
+  }
+
+  fWallTime = std::chrono::duration<Double_t>(std::chrono::steady_clock::now()-start).count();
+
+  SkimDriver::DumpThroughput();
+
+  if (!fFailed.empty())
+  {
+    std::cerr << "Failed jobs (rerun to retry only these):" << std::endl;
+    for (const auto & failed : fFailed) std::cerr << "  " << failed.c_str() << std::endl;
+    exit(1);
+  }
+}
+
+void SkimDriver::WorkerLoop(const Int_t iworker)
+{
+  while (true)
+  {
+    SkimTask task;
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fCondition.wait(lock,[&]{return (!fTasks.empty() || fNInFlight == 0);});
+
+      // nothing queued and nothing running that could queue more
+      if (fTasks.empty()) break;
+
+      task = fTasks.front();
+      fTasks.pop_front();
+      fNInFlight++;
+    }
+
+    if (task.type == SkimFile)
+    {
+      const auto isGood = SkimDriver::RunSkimTask(task,iworker);
+
+      std::lock_guard<std::mutex> lock(fMutex);
+      fNSkimsLeft--;
+      if (isGood) fUnmerged.emplace_back(task.filename);
+      else        fFailed  .emplace_back(task.filename);
+      SkimDriver::QueueMerge(fNSkimsLeft == 0);
+    }
+    else
+    {
+      const auto isGood = SkimDriver::RunMergeTask(task,iworker);
+
+      std::lock_guard<std::mutex> lock(fMutex);
+      if (!isGood) fFailed.emplace_back("merge of "+std::to_string(task.outfiles.size())+" skims");
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fNInFlight--;
+    }
+    fCondition.notify_all();
+  }
+}
+
+Bool_t SkimDriver::RunSkimTask(const SkimTask & task, const Int_t iworker)
+{
+  auto & stats = fStats[iworker];
+
+  const std::string outfilename = std::string(fOutDir.Data())+"/"+task.filename;
+  const std::string logname = outfilename+".skimlog";
+
+  // sum of weights in full: std::to_string() keeps only 6 decimals
+  std::ostringstream sumwgts;
+  sumwgts << std::setprecision(17) << fSumWgts;
+
+  const std::string command = "root -b -q -l 'runSkimmer.C(\""+std::string(fInDir.Data())+"\",\""+fOutDir.Data()+"\",\""+task.filename+"\","
+    +sumwgts.str()+",\""+fSkimType.Data()+"\",\""+fPUWgtFileName.Data()+"\")' > "+logname+" 2>&1";
+
+  for (auto attempt = 0; attempt <= fNRetries; attempt++)
+  {
+    if (attempt > 0) stats.nRetries++;
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto status = std::system(command.c_str());
+    const auto time = std::chrono::duration<Double_t>(std::chrono::steady_clock::now()-start).count();
+
+    if (status == 0 && !Common::IsNullFile(outfilename.c_str()))
+    {
+      stats.nSkims++;
+      stats.nEvents  += task.nEntries;
+      stats.nBytes   += task.nBytes;
+      stats.skimTime += time;
+
+      SkimDriver::AppendToJournal("SKIM "+task.filename);
+      std::remove(logname.c_str());
+
+      std::lock_guard<std::mutex> lock(fMutex);
+      std::cout << "[worker " << iworker << "] Skimmed: " << task.filename.c_str() << " in " << time << " s" << std::endl;
+      return true;
+    }
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    std::cerr << "[worker " << iworker << "] Failed (attempt " << attempt+1 << "): " << task.filename.c_str() << " see: " << logname.c_str() << std::endl;
+  }
+
+  stats.nFailed++;
+  return false;
+}
+
+Bool_t SkimDriver::RunMergeTask(const SkimTask & task, const Int_t iworker)
+{
+  auto & stats = fStats[iworker];
+
+  // partial name is the first entry
+  const std::string & partial = task.outfiles.front();
+  const std::string outdir = fOutDir.Data();
+
+  // a partial left by a run that died before journaling it: not in the journal, so its inputs are still here
+  std::remove((outdir+"/"+partial).c_str());
+
+  // fast merge: keep input compression so baskets are copied, not recompressed
+  std::string command = "hadd -ff -k "+outdir+"/"+partial;
+  for (auto ifile = 1U; ifile < task.outfiles.size(); ifile++) command += " "+outdir+"/"+task.outfiles[ifile];
+  command += " > "+outdir+"/"+partial+".mergelog 2>&1";
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto status = std::system(command.c_str());
+  const auto time = std::chrono::duration<Double_t>(std::chrono::steady_clock::now()-start).count();
+
+  if (status != 0)
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    std::cerr << "[worker " << iworker << "] Failed merging: " << partial.c_str() << std::endl;
+    return false;
+  }
+
+  stats.nMerges++;
+  stats.mergeTime += time;
+
+  // record, then clean up inputs
+  std::string line = "MERGE "+partial;
+  for (auto ifile = 1U; ifile < task.outfiles.size(); ifile++) line += " "+task.outfiles[ifile];
+  SkimDriver::AppendToJournal(line);
+
+  for (auto ifile = 1U; ifile < task.outfiles.size(); ifile++) std::remove((outdir+"/"+task.outfiles[ifile]).c_str());
+  std::remove((outdir+"/"+partial+".mergelog").c_str());
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  fPartials.emplace_back(partial);
+  std::cout << "[worker " << iworker << "] Merged " << task.outfiles.size()-1 << " skims into: " << partial.c_str() << " in " << time << " s" << std::endl;
+
+  return true;
+}
+
+Bool_t SkimDriver::FinalMerge()
+{
+  std::cout << "Merging " << fPartials.size() << " partial merges..." << std::endl;
+
+  if (fPartials.empty())
+  {
+    std::cerr << "Nothing to merge!" << std::endl;
+    return false;
+  }
+
+  // final merge re-optimizes the baskets, as with the old hadd -O
+  const TString outfilename = Form("%s/%s",fOutDir.Data(),Common::tupleFileName.Data());
+  TString command = Form("hadd -O -k -f %s",outfilename.Data());
+  for (const auto & partial : fPartials) command += Form(" %s/%s",fOutDir.Data(),partial.c_str());
+
+  if (std::system(command.Data()) != 0) return false;
+
+  // all done: partials and journal no longer needed
+  for (const auto & partial : fPartials) std::remove(Form("%s/%s",fOutDir.Data(),partial.c_str()));
+  std::remove(fJournalName.Data());
+
+  return true;
+}
+
+void SkimDriver::QueueMerge(const Bool_t flush)
+{
+  // caller holds the lock (or is single threaded)
+  while ((fUnmerged.size() >= UInt_t(fMergeChunk)) || (flush && !fUnmerged.empty()))
+  {
+    const auto nfiles = std::min(fUnmerged.size(),size_t(fMergeChunk));
+
+    SkimTask task(MergeChunk);
+    task.outfiles.emplace_back("partial_"+std::to_string(fNPartials++)+".root");
+    task.outfiles.insert(task.outfiles.end(),fUnmerged.begin(),fUnmerged.begin()+nfiles);
+    fUnmerged.erase(fUnmerged.begin(),fUnmerged.begin()+nfiles);
+
+    // merges first, to keep tmp disk usage down
+    fTasks.emplace_front(task);
+  }
+}
+
+void SkimDriver::AppendToJournal(const std::string & line)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  // reopen + close each time so a crash leaves a complete journal
+  std::ofstream journal(fJournalName.Data(),std::ios_base::app);
+  journal << line.c_str() << std::endl;
+}
+
+void SkimDriver::DumpThroughput() const
+{
+  std::cout << "Throughput per worker:" << std::endl;
+  std::cout << Form("%8s %7s %7s %7s %7s %12s %10s %10s %10s %10s %10s",
+		    "worker","skims","merges","retries","failed","events","MB","skim [s]","merge [s]","events/s","MB/s") << std::endl;
+
+  WorkerStats total;
+  for (auto iworker = 0U; iworker < fStats.size(); iworker++)
+  {
+    const auto & stats = fStats[iworker];
+    const Double_t MB = stats.nBytes / (1024.0*1024.0);
+
+    std::cout << Form("%8u %7u %7u %7u %7u %12lld %10.1f %10.1f %10.1f %10.1f %10.2f",
+		      iworker,stats.nSkims,stats.nMerges,stats.nRetries,stats.nFailed,stats.nEvents,MB,stats.skimTime,stats.mergeTime,
+		      (stats.skimTime > 0 ? stats.nEvents/stats.skimTime : 0.0),(stats.skimTime > 0 ? MB/stats.skimTime : 0.0)) << std::endl;
+
+    total.nSkims    += stats.nSkims;
+    total.nMerges   += stats.nMerges;
+    total.nRetries  += stats.nRetries;
+    total.nFailed   += stats.nFailed;
+    total.nEvents   += stats.nEvents;
+    total.nBytes    += stats.nBytes;
+    total.skimTime  += stats.skimTime;
+    total.mergeTime += stats.mergeTime;
+  }
+
+  // totals are per wall clock
+  const Double_t MB = total.nBytes / (1024.0*1024.0);
+  std::cout << Form("%8s %7u %7u %7u %7u %12lld %10.1f %10.1f %10.1f %10.1f %10.2f",
+		    "total",total.nSkims,total.nMerges,total.nRetries,total.nFailed,total.nEvents,MB,total.skimTime,total.mergeTime,
+		    (fWallTime > 0 ? total.nEvents/fWallTime : 0.0),(fWallTime > 0 ? MB/fWallTime : 0.0)) << std::endl;
+  std::cout << "Wall time: " << fWallTime << " s" << std::endl;
+}
@@ -0,0 +1,117 @@
+#ifndef __SkimDriver__
+#define __SkimDriver__
+
+// ROOT includes
+#include "TString.h"
+
+// STL includes
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+// Common include
+#include "Common.hh"
+#include "SampleManifest.hh"
+
+// one unit of work for the pool: skim a single file, or fast-merge a chunk of skims
+enum SkimTaskType {SkimFile, MergeChunk};
+
+struct SkimTask
+{
+  SkimTask() {}
+  SkimTask(const SkimTaskType type) : type(type), nEntries(0), nBytes(0) {}
+
+  SkimTaskType type;
+  std::string filename;              // SkimFile: input file name (same name for output)
+  Long64_t nEntries;                 // SkimFile: from manifest, if any
+  Long64_t nBytes;                   // SkimFile: input size on disk
+  std::vector<std::string> outfiles; // MergeChunk: skim outputs to merge
+};
+
+struct WorkerStats
+{
+  WorkerStats() : nSkims(0), nMerges(0), nRetries(0), nFailed(0), nEvents(0), nBytes(0), skimTime(0), mergeTime(0) {}
+
+  UInt_t   nSkims;
+  UInt_t   nMerges;
+  UInt_t   nRetries;
+  UInt_t   nFailed;
+  Long64_t nEvents;
+  Long64_t nBytes;
+  Double_t skimTime;  // seconds
+  Double_t mergeTime; // seconds
+};
+
+class SkimDriver
+{
+public:
+  SkimDriver(const TString & indir, const TString & outdir, const TString & filesconfig,
+	     const Float_t sumwgts, const TString & skimtype, const TString & puwgtfilename, const TString & manifestname,
+	     const Int_t nworkers, const Int_t nretries = 2, const Int_t mergechunk = 50);
+  ~SkimDriver() {}
+
+  // Initialize
+  void SetupJobs();
+  void ReadJournal();
+
+  // Main call
+  void Run();
+
+  // Subroutines for running
+  void WorkerLoop(const Int_t iworker);
+  Bool_t RunSkimTask(const SkimTask & task, const Int_t iworker);
+  Bool_t RunMergeTask(const SkimTask & task, const Int_t iworker);
+  Bool_t FinalMerge();
+
+  // Helper functions
+  void AppendToJournal(const std::string & line);
+  void QueueMerge(const Bool_t flush);
+  void DumpThroughput() const;
+
+private:
+  // Settings
+  const TString fInDir;
+  const TString fOutDir;
+  const TString fFilesConfig;
+  Float_t fSumWgts; // from the manifest, if any
+  const TString fSkimType;
+  const TString fPUWgtFileName;
+  const TString fManifestName;
+  const Int_t   fNWorkers;
+  const Int_t   fNRetries;
+  const Int_t   fMergeChunk;
+
+  // journal of finished outputs
+  TString fJournalName;
+  std::set<std::string> fSkimmed;
+  std::set<std::string> fMerged;
+  std::vector<std::string> fPartials;
+  UInt_t fNPartials;
+
+  // shared state for the pool
+  std::deque<SkimTask> fTasks;
+  std::vector<std::string> fUnmerged;
+  std::vector<std::string> fFailed;
+  UInt_t fNSkimsLeft;
+  UInt_t fNInFlight;
+  std::mutex fMutex;
+  std::condition_variable fCondition;
+
+  // throughput
+  std::vector<WorkerStats> fStats;
+  Double_t fWallTime;
+};
+
+#endif
@@ -0,0 +1,268 @@
+// Class include
+#include "SkimLayout.hh"
+
+SkimLayout::SkimLayout(const TString & layoutconfig)
+  : fLayoutConfig(layoutconfig)
+{
+  SkimLayout::SetupDefaults();
+  if (fLayoutConfig == "") return;
+
+  std::cout << "Initializing SkimLayout: " << fLayoutConfig.Data() << std::endl;
+
+  SkimLayout::SetupLayoutConfig();
+}
+
+void SkimLayout::Apply(TTree * tree, TTree * source) const
+{
+  if (!SkimLayout::IsActive()) return;
+
+  // bytes per entry of every branch, from the source if it has any entries
+  const auto branches = SkimLayout::GetBranches(tree);
+  if (branches.empty()) return;
+
+  std::vector<Double_t> sizes;
+  Double_t totalsize = 0.0, hotsize = 0.0;
+  Int_t nhot = 0;
+  for (auto branch : branches)
+  {
+    const auto insource = (source ? source->GetBranch(branch->GetName()) : (TBranch*) NULL);
+    const auto size = SkimLayout::GetBytesPerEntry(branch,insource);
+    sizes.emplace_back(size);
+
+    totalsize += size;
+    if (SkimLayout::IsHot(branch->GetName())) {hotsize += size; nhot++;}
+  }
+
+  // cluster: a hot branch of average size writes hot_basket_kb per cluster, unless the whole cluster gets too big to buffer
+  auto nentries = fClusterEntries;
+  if (nentries <= 0)
+  {
+    const auto typicalsize = (nhot > 0 ? hotsize/nhot : totalsize/branches.size());
+    nentries = Long64_t(fHotBasketKB*1024.0/typicalsize);
+    nentries = std::min(nentries,Long64_t(fMaxClusterMB*1024.0*1024.0/totalsize));
+    nentries = std::max(nentries,Long64_t(1));
+  }
+  tree->SetAutoFlush(nentries);
+
+  // no basket bigger than what the tree will hold
+  const auto nbasketentries = ((source && source->GetEntries() > 0) ? std::min(nentries,source->GetEntries()) : nentries);
+
+  // compression per branch, one basket per cluster
+  for (auto ibranch = 0U; ibranch < branches.size(); ibranch++)
+  {
+    auto branch = branches[ibranch];
+    branch->SetCompressionSettings(SkimLayout::GetCompression(branch->GetName()));
+
+    const auto basketsize = std::min(std::max(sizes[ibranch]*nbasketentries+1024.0,fMinBasketKB*1024.0),fMaxBasketKB*1024.0);
+    branch->SetBasketSize(Int_t(basketsize));
+  }
+
+  std::cout << "SkimLayout: " << tree->GetName() << ": " << branches.size() << " branches (" << nhot << " hot), "
+	    << nentries << " entries per cluster, " << Form("%.1f",nentries*totalsize/(1024.0*1024.0)) << " MB per cluster before compression" << std::endl;
+}
+
+TTree * SkimLayout::CopyTree(TTree * intree) const
+{
+  if (!SkimLayout::IsActive()) return intree->CopyTree("");
+
+  // as TTree::CopyTree(""): structure first, then the entries of the current entry list, if any
+  auto outtree = intree->CloneTree(0);
+  SkimLayout::Apply(outtree,intree);
+
+  for (auto ientry = 0LL; ientry < intree->GetEntries(); ientry++)
+  {
+    const auto entry = intree->GetEntryNumber(ientry);
+    if (entry < 0) break;
+
+    intree->GetEntry(entry);
+    outtree->Fill();
+  }
+
+  return outtree;
+}
+
+TTree * SkimLayout::MergeTrees(TList * trees) const
+{
+  if (!SkimLayout::IsActive()) return TTree::MergeTrees(trees);
+
+  // as TTree::MergeTrees(): structure of the first non-empty tree, entries of all of them
+  TTree * outtree = NULL;
+  TIter next(trees);
+  while (auto obj = next())
+  {
+    if (!obj->InheritsFrom(TTree::Class())) continue;
+
+    auto tree = (TTree*)obj;
+    if (tree->GetEntries() == 0) continue;
+
+    if (outtree == (TTree*) NULL)
+    {
+      // laid out from the first, the others are the same skim of other subsamples
+      outtree = tree->CloneTree(0);
+      SkimLayout::Apply(outtree,tree);
+
+      // separate them, as TTree::MergeTrees() does: the output then owns its own buffers
+      tree->GetListOfClones()->Remove(outtree);
+      tree->ResetBranchAddresses();
+      outtree->ResetBranchAddresses();
+    }
+
+    // read each input straight into the output's buffers, else CopyEntries() fills whatever they hold (zeros)
+    outtree->CopyAddresses(tree);
+    outtree->CopyEntries(tree);
+    tree->ResetBranchAddresses();
+  }
+
+  return outtree;
+}
+
+Bool_t SkimLayout::IsHot(const TString & name) const
+{
+  for (const auto & pattern : fHotBranches)
+  {
+    Ssiz_t length = 0;
+    if (name.Index(TRegexp(pattern,kTRUE),&length) == 0 && length == name.Length()) return true;
+  }
+  return false;
+}
+
+void SkimLayout::Dump(TTree * tree) const
+{
+  if (!SkimLayout::IsActive() || tree == (TTree*) NULL) return;
+
+  Long64_t hottot = 0, hotzip = 0, coldtot = 0, coldzip = 0;
+  for (auto branch : SkimLayout::GetBranches(tree))
+  {
+    const Bool_t isHot = SkimLayout::IsHot(branch->GetName());
+    (isHot ? hottot : coldtot) += branch->GetTotBytes();
+    (isHot ? hotzip : coldzip) += branch->GetZipBytes();
+  }
+
+  const Double_t nentries = std::max(tree->GetEntries(),1LL);
+  std::cout << "SkimLayout: " << tree->GetName() << ": " << tree->GetEntries() << " entries" << std::endl;
+  std::cout << Form("  hot  branches: %8.1f bytes/entry, %8.1f compressed (%.2fx)",hottot/nentries,hotzip/nentries,(hotzip > 0 ? Double_t(hottot)/hotzip : 0.0)) << std::endl;
+  std::cout << Form("  cold branches: %8.1f bytes/entry, %8.1f compressed (%.2fx)",coldtot/nentries,coldzip/nentries,(coldzip > 0 ? Double_t(coldtot)/coldzip : 0.0)) << std::endl;
+}
+
+Int_t SkimLayout::GetCompressionSetting(const TString & algo, const Int_t level)
+{
+  // ROOT::ECompressionAlgorithm, as algorithm*100+level
+  Int_t ialgo = 0;
+  if      (algo.EqualTo("ZLIB",TString::kIgnoreCase)) ialgo = 1;
+  else if (algo.EqualTo("LZMA",TString::kIgnoreCase)) ialgo = 2;
+  else if (algo.EqualTo("LZ4" ,TString::kIgnoreCase)) ialgo = 4;
+  else if (algo.EqualTo("ZSTD",TString::kIgnoreCase)) ialgo = 5;
+  else
+  {
+    std::cerr << "Aye... your layout config is messed up, compression is one of: ZLIB, LZMA, LZ4, ZSTD! Offending algorithm: " << algo.Data() << std::endl;
+    exit(1);
+  }
+
+  if (level < 0 || level > 9)
+  {
+    std::cerr << "Aye... your layout config is messed up, compression level goes from 0 to 9! Offending level: " << level << std::endl;
+    exit(1);
+  }
+
+  return 100*ialgo+level;
+}
+
+Double_t SkimLayout::GetBytesPerEntry(TBranch * branch, TBranch * source)
+{
+  // observed, before compression
+  if (source && source->GetEntries() > 0) return std::max(Double_t(source->GetTotBytes())/source->GetEntries(),1.0);
+
+  // else from the leaf types: arrays at their maximum length; vectors and objects unknown, so a few words
+  Double_t size = 0.0;
+  const auto leaves = branch->GetListOfLeaves();
+  for (auto ileaf = 0; ileaf < leaves->GetEntriesFast(); ileaf++)
+  {
+    const auto leaf = static_cast<TLeaf*>(leaves->UncheckedAt(ileaf));
+    size += std::max(leaf->GetLenType(),0)*std::max(leaf->GetLenStatic(),1);
+  }
+  return std::max(size,8.0);
+}
+
+std::vector<TBranch*> SkimLayout::GetBranches(TTree * tree)
+{
+  // branches holding the data: those of the leaves
+  std::vector<TBranch*> branches;
+  const auto leaves = tree->GetListOfLeaves();
+  for (auto ileaf = 0; ileaf < leaves->GetEntriesFast(); ileaf++)
+  {
+    const auto branch = static_cast<TLeaf*>(leaves->UncheckedAt(ileaf))->GetBranch();
+    if (std::find(branches.begin(),branches.end(),branch) == branches.end()) branches.emplace_back(branch);
+  }
+  return branches;
+}
+
+void SkimLayout::SetupDefaults()
+{
+  fHotCompression  = SkimLayout::GetCompressionSetting("LZ4",4);
+  fColdCompression = SkimLayout::GetCompressionSetting("ZSTD",5);
+  fHotBasketKB     = 128;
+  fMinBasketKB     = 4;
+  fMaxBasketKB     = 4096;
+  fMaxClusterMB    = 64;
+  fClusterEntries  = 0;
+}
+
+void SkimLayout::SetupLayoutConfig()
+{
+  std::cout << "Reading layout config..." << std::endl;
+
+  std::ifstream infile(Form("%s",fLayoutConfig.Data()),std::ios::in);
+  std::string str;
+  while (std::getline(infile,str))
+  {
+    if (str == "") continue;
+    else if (str.find("hot_branches=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"hot_branches=");
+      std::stringstream ss(str);
+      TString pattern;
+      while (ss >> pattern) fHotBranches.emplace_back(pattern);
+    }
+    else if (str.find("hot_compression=") != std::string::npos || str.find("cold_compression=") != std::string::npos)
+    {
+      const Bool_t isHot = (str.find("hot_compression=") != std::string::npos);
+      str = Common::RemoveDelim(str,(isHot ? "hot_compression=" : "cold_compression="));
+      std::stringstream ss(str);
+      TString algo;
+      Int_t level = -1;
+      ss >> algo >> level;
+      (isHot ? fHotCompression : fColdCompression) = SkimLayout::GetCompressionSetting(algo,level);
+    }
+    else if (str.find("hot_basket_kb=") != std::string::npos)
+    {
+      fHotBasketKB = std::stoi(Common::RemoveDelim(str,"hot_basket_kb="));
+    }
+    else if (str.find("min_basket_kb=") != std::string::npos)
+    {
+      fMinBasketKB = std::stoi(Common::RemoveDelim(str,"min_basket_kb="));
+    }
+    else if (str.find("max_basket_kb=") != std::string::npos)
+    {
+      fMaxBasketKB = std::stoi(Common::RemoveDelim(str,"max_basket_kb="));
+    }
+    else if (str.find("max_cluster_mb=") != std::string::npos)
+    {
+      fMaxClusterMB = std::stoi(Common::RemoveDelim(str,"max_cluster_mb="));
+    }
+    else if (str.find("cluster_entries=") != std::string::npos)
+    {
+      fClusterEntries = std::stoll(Common::RemoveDelim(str,"cluster_entries="));
+    }
+    else
+    {
+      std::cerr << "Aye... your layout config is messed up, try again! Offending line: " << str.c_str() << std::endl;
+      exit(1);
+    }
+  }
+
+  if (fHotBasketKB <= 0 || fMinBasketKB <= 0 || fMaxBasketKB < fMinBasketKB || fMaxClusterMB <= 0)
+  {
+    std::cerr << "Aye... your layout config is messed up, basket and cluster sizes must be positive (and min <= max)!" << std::endl;
+    exit(1);
+  }
+}
@@ -0,0 +1,79 @@
+#ifndef __SkimLayout__
+#define __SkimLayout__
+
+// ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TList.h"
+#include "TObjArray.h"
+#include "TRegexp.h"
+#include "TPaveText.h"
+#include "TString.h"
+
+// STL includes
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+// Common include
+#include "Common.hh"
+
+// On-disk layout of skim output trees. Downstream plotters, fitters and the time adjuster
+// read a few branches out of hundreds, so:
+//  - hot branches (the ones they read) get a compression that is fast to decompress, the rest a dense one
+//  - clusters (AutoFlush) are sized so a typical hot branch writes about hot_basket_kb per cluster
+//  - each branch starts with a basket holding one whole cluster, from its bytes per entry in the
+//    source tree if it has entries, else from its leaf types
+// ROOT resizes baskets from the first cluster it flushes (TTree::OptimizeBaskets), which then
+// only corrects branches whose size could not be known up front (e.g. vectors).
+class SkimLayout
+{
+public:
+  SkimLayout(const TString & layoutconfig); // "": ROOT defaults, no tree is touched
+  ~SkimLayout() {}
+
+  Bool_t IsActive() const {return (fLayoutConfig != "");}
+
+  // set up tree before it is filled; source: the tree it will be filled from, if any
+  void Apply(TTree * tree, TTree * source = NULL) const;
+
+  // TTree::CopyTree("") and TTree::MergeTrees(), with the layout applied: output trees go to the current directory
+  TTree * CopyTree(TTree * intree) const;
+  TTree * MergeTrees(TList * trees) const;
+
+  // hot or cold, and the compression that goes with it (algorithm*100+level)
+  Bool_t IsHot(const TString & name) const;
+  Int_t GetCompression(const TString & name) const {return (SkimLayout::IsHot(name) ? fHotCompression : fColdCompression);}
+
+  // bytes per entry, compressed and not, of hot and cold branches of a filled tree
+  void Dump(TTree * tree) const;
+
+  // helpers
+  static Int_t GetCompressionSetting(const TString & algo, const Int_t level);
+  static Double_t GetBytesPerEntry(TBranch * branch, TBranch * source);
+  static std::vector<TBranch*> GetBranches(TTree * tree);
+
+  // intermediate files, read back once: cheapest to write
+  static const Int_t ScratchCompression = 401; // LZ4, level 1
+
+private:
+  void SetupDefaults();
+  void SetupLayoutConfig();
+
+  const TString fLayoutConfig;
+
+  std::vector<TString> fHotBranches; // wildcards as in TTree::SetBranchStatus
+  Int_t    fHotCompression;
+  Int_t    fColdCompression;
+  Int_t    fHotBasketKB;
+  Int_t    fMinBasketKB;
+  Int_t    fMaxBasketKB;
+  Int_t    fMaxClusterMB;
+  Long64_t fClusterEntries; // > 0: fixed, instead of from hot_basket_kb
+};
+
+#endif
@@ -4,10 +4,14 @@
 #include <iostream>
 
 Skimmer::Skimmer(const TString & indir, const TString & outdir, const TString & filename, 
-		 const Float_t sumwgts, const TString & skimtype, const TString & puwgtfilename)
+		 const Float_t sumwgts, const TString & skimtype, const TString & puwgtfilename,
+		 const TString & manifestname, const TString & layoutconfig)
   : fInDir(indir), fOutDir(outdir), fFileName(filename), 
-    fSumWgts(sumwgts), fSkimType(skimtype), fPUWgtFileName(puwgtfilename)
+    fSumWgts(sumwgts), fSkimType(skimtype), fPUWgtFileName(puwgtfilename), fManifestName(manifestname),
+    fLayoutConfig(layoutconfig), fLayout(layoutconfig)
 {
+  PROFILE_READ_SCOPE("Skimmer::Setup");
+
   // because root is dumb?
   gROOT->ProcessLine("#include <vector>");
 
@@ -36,7 +40,8 @@ Skimmer::Skimmer(const TString & indir, const TString & outdir, const TString &
   Common::CheckValidTree(fInConfigTree,inconfigtreename,infilename);
   Skimmer::GetInConfig();
 
-  // get sample weight from in config
+  // get sample weight from in config (sum of weights from manifest if provided)
+  if (fManifestName != "") Skimmer::GetSumWgtsFromManifest();
   Skimmer::GetSampleWeight();
 
   // Get main input tree and initialize it
@@ -55,7 +60,6 @@ Skimmer::Skimmer(const TString & indir, const TString & outdir, const TString &
   Common::CheckValidHist(fInCutFlowWgt,inh_cutflow_wgtname,infilename);
 
   // Get PU weights input
-  fPUWeights.clear();
   if (fIsMC)
   {
     fInPUWgtFile = TFile::Open(fPUWgtFileName);
@@ -84,11 +88,13 @@ Skimmer::Skimmer(const TString & indir, const TString & outdir, const TString &
   Skimmer::InitAndSetOutConfig();
   Skimmer::InitOutTree();
   Skimmer::InitOutCutFlowHists();
+
+  // compression, baskets and clusters of the skim, before it is filled
+  fLayout.Apply(fOutTree);
 }
 
 Skimmer::~Skimmer()
 {
-  fPUWeights.clear();
   if (fIsMC)
   {
     delete fInPUWgtHist;
@@ -107,10 +113,29 @@ Skimmer::~Skimmer()
   delete fOutTree;
   delete fOutConfigTree;
   delete fOutFile;
+
+  // where the time went
+  TString outtext = Form("%s/%s", fOutDir.Data(), fFileName.Data());
+  outtext.ReplaceAll(".root","");
+  Profiler::Dump(outtext);
 }
 
 void Skimmer::EventLoop()
 {
+  PROFILE_READ_SCOPE("Skimmer::EventLoop");
+
+  // cut flow slots: looked up once, not per event (-1 if not used by this skim)
+  const auto cut_nPhotons     = fCutFlow.GetSlot("nPhotons");
+  const auto cut_ph0isEB      = fCutFlow.GetSlot("ph0isEB");
+  const auto cut_ph0pt70      = fCutFlow.GetSlot("ph0pt70");
+  const auto cut_METFlag      = fCutFlow.GetSlot("METFlag");
+  const auto cut_diEleHLT     = fCutFlow.GetSlot("diEleHLT");
+  const auto cut_goodPho1     = fCutFlow.GetSlot("goodPho1");
+  const auto cut_goodPho2     = fCutFlow.GetSlot("goodPho2");
+  const auto cut_diPhoMZrange = fCutFlow.GetSlot("diPhoMZrange");
+  const auto cut_goodDiXtal   = fCutFlow.GetSlot("goodDiXtal");
+  const auto cut_badPU        = fCutFlow.GetSlot("badPU");
+
   // do loop over events, reading in branches as needed, skimming, filling output trees and hists
   const auto nEntries = fInTree->GetEntries();
   for (auto entry = 0U; entry < nEntries; entry++)
@@ -118,6 +143,9 @@ void Skimmer::EventLoop()
     // dump status check
     if (entry%Common::nEvCheck == 0 || entry == 0) std::cout << "Processing Entry: " << entry << " out of " << nEntries << std::endl;
 
+    // start the clock for the first cut
+    fCutFlow.StartEvent();
+
     // get event weight: no scaling by BR, xsec, lumi, etc.
     if (fIsMC) fInEvent.b_genwgt->GetEntry(entry);
     const auto wgt    = (fIsMC ? fInEvent.genwgt : 1.f);
@@ -129,21 +157,15 @@ void Skimmer::EventLoop()
       // leading photon skim section
       fInEvent.b_nphotons->GetEntry(entry);
       if (fInEvent.nphotons <= 0) continue;
-      fOutCutFlow   ->Fill((cutLabels["nPhotons"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["nPhotons"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["nPhotons"]*1.f)-0.5f,evtwgt);
+      fCutFlow.Pass(cut_nPhotons,wgt,evtwgt);
       
       fInPhos.front().b_isEB->GetEntry(entry);
       if (!fInPhos.front().isEB) continue;
-      fOutCutFlow   ->Fill((cutLabels["ph0isEB"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["ph0isEB"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["ph0isEB"]*1.f)-0.5f,evtwgt);
+      fCutFlow.Pass(cut_ph0isEB,wgt,evtwgt);
 
       fInPhos.front().b_pt->GetEntry(entry);
       if (fInPhos.front().pt < 70.f) continue;
-      fOutCutFlow   ->Fill((cutLabels["ph0pt70"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["ph0pt70"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["ph0pt70"]*1.f)-0.5f,evtwgt);
+      fCutFlow.Pass(cut_ph0pt70,wgt,evtwgt);
 
       // filter on MET Flags
       fInEvent.b_metPV->GetEntry(entry);
@@ -161,9 +183,7 @@ void Skimmer::EventLoop()
       if (!fIsMC && !fInEvent.metEESC) continue;
       
       // fill cutflow for MET filters
-      fOutCutFlow   ->Fill((cutLabels["METFlag"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["METFlag"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["METFlag"]*1.f)-0.5f,evtwgt);
+      fCutFlow.Pass(cut_METFlag,wgt,evtwgt);
 
       // fill photon list in standard fashion
       Skimmer::FillPhoListStandard();
@@ -174,9 +194,7 @@ void Skimmer::EventLoop()
       //      fInEvent.b_hltDiEle33MW->GetEntry(entry);
       
       //       if (!fInEvent.hltDiEle33MW) continue;
-      fOutCutFlow   ->Fill((cutLabels["diEleHLT"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["diEleHLT"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["diEleHLT"]*1.f)-0.5f,evtwgt);
+      fCutFlow.Pass(cut_diEleHLT,wgt,evtwgt);
 
       // build list of "good electrons"
       std::vector<Int_t> good_phos;
@@ -201,61 +219,31 @@ void Skimmer::EventLoop()
       
       // make sure have at least 1 good photon
       if (good_phos.size() < 1) continue;
-      fOutCutFlow   ->Fill((cutLabels["goodPho1"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["goodPho1"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["goodPho1"]*1.f)-0.5f,evtwgt);
+      fCutFlow.Pass(cut_goodPho1,wgt,evtwgt);
 
       // make sure have at least 2 good photons
       if (good_phos.size() < 2) continue;
-      fOutCutFlow   ->Fill((cutLabels["goodPho2"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["goodPho2"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["goodPho2"]*1.f)-0.5f,evtwgt);
-
-      // object for containing mass pairs
-      std::vector<MassStruct> phopairs;
+      fCutFlow.Pass(cut_goodPho2,wgt,evtwgt);
 
-      // double loop over photons, make masses
-      for (auto i = 0U; i < good_phos.size(); i++)
+      // four-vectors of good photons, to pair up
+      fPhoVecs.clear();
+      for (const auto ipho : good_phos)
       {
-	auto & pho1 = fInPhos[good_phos[i]];
-	pho1.b_pt ->GetEntry(entry);
-	pho1.b_eta->GetEntry(entry);
-	pho1.b_phi->GetEntry(entry);
-	pho1.b_E  ->GetEntry(entry);
-	TLorentzVector pho1vec; pho1vec.SetPtEtaPhiE(pho1.pt, pho1.eta, pho1.phi, pho1.E);
-
-	for (auto j = i+1; j < good_phos.size(); j++)
-	{
-	  auto & pho2 = fInPhos[good_phos[j]];
-	  pho2.b_pt ->GetEntry(entry);
-	  pho2.b_eta->GetEntry(entry);
-	  pho2.b_phi->GetEntry(entry);
-	  pho2.b_E  ->GetEntry(entry);
-	  TLorentzVector pho2vec; pho2vec.SetPtEtaPhiE(pho2.pt, pho2.eta, pho2.phi, pho2.E);
-
-	  // get invariant mass
-	  pho1vec += pho2vec;
-	  phopairs.emplace_back(good_phos[i],good_phos[j],pho1vec.M());
-	}
+	auto & pho = fInPhos[ipho];
+	pho.b_pt ->GetEntry(entry);
+	pho.b_eta->GetEntry(entry);
+	pho.b_phi->GetEntry(entry);
+	pho.b_E  ->GetEntry(entry);
+	fPhoVecs.emplace_back(pho.pt, pho.eta, pho.phi, pho.E);
       }
 
-      // sort the mass structs
-      std::sort(phopairs.begin(),phopairs.end(),
-		[=](const auto & phopair1, const auto & phopair2)
-		{
-		  const auto diff1 = std::abs(phopair1.mass-Common::Zmass);
-		  const auto diff2 = std::abs(phopair2.mass-Common::Zmass);
-		  return diff1 < diff2;
-		});
-          
-      // get best pair
-      const auto & phopair = phopairs.front();
+      // get best pair: closest to the Z mass, in one pass over all pairs
+      const auto bestpair = Kinematics::FindBestPair(fPhoVecs,Common::Zmass);
+      const MassStruct phopair(good_phos[bestpair.i],good_phos[bestpair.j],bestpair.mass);
       
       // make sure within 30 GeV
       if ((phopair.mass < 60.f) || (phopair.mass > 150.f)) continue;
-      fOutCutFlow   ->Fill((cutLabels["diPhoMZrange"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["diPhoMZrange"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["diPhoMZrange"]*1.f)-0.5f,evtwgt);
+      fCutFlow.Pass(cut_diPhoMZrange,wgt,evtwgt);
 
       // re-order photons based on pairs
       auto & pho1 = fInPhos[phopair.ipho1];
@@ -336,9 +324,7 @@ void Skimmer::EventLoop()
 
       // skip if no pairs found
       if (good_pairs.size() == 0) continue;
-      fOutCutFlow   ->Fill((cutLabels["goodDiXtal"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["goodDiXtal"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["goodDiXtal"]*1.f)-0.5f,evtwgt);
+      fCutFlow.Pass(cut_goodDiXtal,wgt,evtwgt);
 
       // sort pairs by highest energy for E1
       std::sort(good_pairs.begin(),good_pairs.end(),
@@ -370,13 +356,11 @@ void Skimmer::EventLoop()
       if (fIsMC)
       {
 	fInEvent.b_genputrue->GetEntry(entry);
-	if ((fInEvent.genputrue < 0) || (UInt_t(fInEvent.genputrue) >= fPUWeights.size())) continue;
+	if (fPUWeights.IsFlow(fPUWeights.FindBin(fInEvent.genputrue))) continue;
       }
 
       // fill cutflow
-      fOutCutFlow   ->Fill((cutLabels["badPU"]*1.f)-0.5f);
-      fOutCutFlowWgt->Fill((cutLabels["badPU"]*1.f)-0.5f,wgt);
-      fOutCutFlowScl->Fill((cutLabels["badPU"]*1.f)-0.5f,evtwgt);
+      fCutFlow.Pass(cut_badPU,wgt,evtwgt);
     }
     
     // end of skim, now copy... dropping rechits
@@ -390,18 +374,31 @@ void Skimmer::EventLoop()
     // fill the tree
     fOutTree->Fill();
   } // end loop over events
+  Profiler::Count("entries",nEntries);
+  Profiler::Count("selected",fOutTree->GetEntries());
+
+  // export skim cuts to the cut flow hists, plus the time spent per cut
+  fCutFlow.Export(fOutCutFlow,fOutCutFlowWgt,fOutCutFlowScl);
+  auto outh_cutflow_time = fCutFlow.MakeTimeHist(Common::h_cutflow_timename);
+  fCutFlow.Dump();
 
   // write out the output!
+  PROFILE_SCOPE("Skimmer::Write");
   fOutFile->cd();
   fOutCutFlow->Write();
   fOutCutFlowWgt->Write();
   fOutCutFlowScl->Write();
+  outh_cutflow_time->Write();
+  delete outh_cutflow_time;
   fOutConfigTree->Write();
   fOutTree->Write();
+  fLayout.Dump(fOutTree);
 }
 
 void Skimmer::FillOutGMSBs(const UInt_t entry)
 {
+  PROFILE_SCOPE("Skimmer::FillOutGMSBs");
+
   // get input branches
   for (auto igmsb = 0; igmsb < Common::nGMSBs; igmsb++)
   {
@@ -461,6 +458,8 @@ void Skimmer::FillOutGMSBs(const UInt_t entry)
 
 void Skimmer::FillOutHVDSs(const UInt_t entry)
 {
+  PROFILE_SCOPE("Skimmer::FillOutHVDSs");
+
   // get input branches
   for (auto ihvds = 0; ihvds < Common::nHVDSs; ihvds++)
   {
@@ -521,6 +520,8 @@ void Skimmer::FillOutHVDSs(const UInt_t entry)
 
 void Skimmer::FillOutToys(const UInt_t entry)
 {
+  PROFILE_SCOPE("Skimmer::FillOutToys");
+
   // get input branches
   for (auto itoy = 0; itoy < Common::nToys; itoy++)
   {
@@ -555,6 +556,8 @@ void Skimmer::FillOutToys(const UInt_t entry)
 
 void Skimmer::FillOutEvent(const UInt_t entry, const Float_t evtwgt)
 {
+  PROFILE_SCOPE("Skimmer::FillOutEvent");
+
   // get input branches
   fInEvent.b_run->GetEntry(entry);
   fInEvent.b_lumi->GetEntry(entry);
@@ -662,12 +665,14 @@ void Skimmer::FillOutEvent(const UInt_t entry, const Float_t evtwgt)
     }
 
     // pileup weight!!
-    fOutEvent.puwgt = fPUWeights[fInEvent.genputrue];
+    fOutEvent.puwgt = fPUWeights.Get(fInEvent.genputrue);
   }
 }
 
 void Skimmer::FillOutJets(const UInt_t entry)
 {
+  PROFILE_SCOPE("Skimmer::FillOutJets");
+
   fInJets.b_E->GetEntry(entry);
   fInJets.b_pt->GetEntry(entry);
   fInJets.b_phi->GetEntry(entry);
@@ -699,6 +704,8 @@ void Skimmer::FillOutJets(const UInt_t entry)
 
 void Skimmer::FillOutPhos(const UInt_t entry)
 {  
+  PROFILE_SCOPE("Skimmer::FillOutPhos");
+
   // get input photon branches
   for (auto ipho : fPhoList)
   {
@@ -1485,7 +1492,7 @@ void Skimmer::InitAndSetOutConfig()
   // include computed variables for ease of use
   fOutConfig.sumWgts = fSumWgts;
   fOutConfig.sampleWeight = fSampleWeight;
-  fOutConfig.puWeights = fPUWeights;
+  fOutConfig.puWeights = fPUWeights.GetInRangeContents();
 
   // and fill it once
   fOutConfigTree->Fill();
@@ -1750,9 +1757,13 @@ void Skimmer::InitOutBranches()
 
 void Skimmer::InitOutCutFlowHists()
 {
-  Skimmer::InitOutCutFlowHist(fInCutFlow,fOutCutFlow,Common::h_cutflowname);
-  Skimmer::InitOutCutFlowHist(fInCutFlowWgt,fOutCutFlowWgt,Common::h_cutflow_wgtname);
-  Skimmer::InitOutCutFlowHist(fInCutFlowWgt,fOutCutFlowScl,Common::h_cutflow_scaledname);
+  // cut flow slots: input labels first, then skim cuts
+  Skimmer::InitCutFlow();
+
+  // input hist is copied into the new bins, skim cuts are exported after the event loop
+  fOutCutFlow    = fCutFlow.MakeHist(Common::h_cutflowname,fInCutFlow->GetTitle(),fInCutFlow);
+  fOutCutFlowWgt = fCutFlow.MakeHist(Common::h_cutflow_wgtname,fInCutFlowWgt->GetTitle(),fInCutFlowWgt);
+  fOutCutFlowScl = fCutFlow.MakeHist(Common::h_cutflow_scaledname,fInCutFlowWgt->GetTitle(),fInCutFlowWgt);
 
   // rescale input of scaled histogram by sample weight!
   fOutCutFlowScl->Scale(fSampleWeight);
@@ -1760,33 +1771,28 @@ void Skimmer::InitOutCutFlowHists()
   fOutCutFlowScl->GetYaxis()->SetTitle("nEvents");
 }
 
-void Skimmer::InitOutCutFlowHist(const TH1F * inh_cutflow, TH1F *& outh_cutflow, const TString & histname)
+void Skimmer::InitCutFlow()
 {
   // get cut flow labels
-  const auto inNbinsX = inh_cutflow->GetNbinsX();
-  for (auto ibin = 1; ibin <= inNbinsX; ibin++)
-  {
-    cutLabels[inh_cutflow->GetXaxis()->GetBinLabel(ibin)] = ibin;
-  }
-  auto inNbinsX_new = inNbinsX;
+  fCutFlow.Inherit(fInCutFlow);
 
   if (fSkim == Standard)
   {
-    cutLabels["nPhotons"] = ++inNbinsX_new;
-    cutLabels["ph0isEB"] = ++inNbinsX_new;
-    cutLabels["ph0pt70"] = ++inNbinsX_new;
-    cutLabels["METFlag"] = ++inNbinsX_new;
+    fCutFlow.Register("nPhotons");
+    fCutFlow.Register("ph0isEB");
+    fCutFlow.Register("ph0pt70");
+    fCutFlow.Register("METFlag");
   }
   else if (fSkim == Zee)
   {
-    cutLabels["diEleHLT"] = ++inNbinsX_new;
-    cutLabels["goodPho1"] = ++inNbinsX_new;
-    cutLabels["goodPho2"] = ++inNbinsX_new;
-    cutLabels["diPhoMZrange"] = ++inNbinsX_new;
+    fCutFlow.Register("diEleHLT");
+    fCutFlow.Register("goodPho1");
+    fCutFlow.Register("goodPho2");
+    fCutFlow.Register("diPhoMZrange");
   }
   else if (fSkim == DiXtal)
   {
-    cutLabels["goodDiXtal"] = ++inNbinsX_new;
+    fCutFlow.Register("goodDiXtal");
   }
   else
   {
@@ -1795,24 +1801,19 @@ void Skimmer::InitOutCutFlowHist(const TH1F * inh_cutflow, TH1F *& outh_cutflow,
   }
 
   // common skim
-  cutLabels["badPU"] = ++inNbinsX_new;
-
-  // make new cut flow
-  outh_cutflow = new TH1F(Form("%s",histname.Data()),inh_cutflow->GetTitle(),cutLabels.size(),0,cutLabels.size());
-  outh_cutflow->Sumw2();
+  fCutFlow.Register("badPU");
 
-  for (const auto & cutlabel : cutLabels)
-  {
-    const auto ibin = cutlabel.second;
-
-    outh_cutflow->GetXaxis()->SetBinLabel(ibin,cutlabel.first.c_str());
+  // no cuts applied to toys
+  fCutFlow.SetTiming(!fOutConfig.isToy);
+}
 
-    if (ibin > inNbinsX) continue;
+void Skimmer::GetSumWgtsFromManifest()
+{
+  // manifest is harvested before skimming, so it holds every file in the sample
+  const SampleManifest manifest(fManifestName);
+  fSumWgts = manifest.GetSumWgts();
 
-    outh_cutflow->SetBinContent(ibin,inh_cutflow->GetBinContent(ibin));
-    outh_cutflow->SetBinError(ibin,inh_cutflow->GetBinError(ibin));
-  }
-  outh_cutflow->GetYaxis()->SetTitle(inh_cutflow->GetYaxis()->GetTitle());
+  std::cout << "Sum of weights from manifest: " << fSumWgts << std::endl;
 }
 
 void Skimmer::GetSampleWeight()
@@ -1823,10 +1824,7 @@ void Skimmer::GetSampleWeight()
 
 void Skimmer::GetPUWeights()
 {
-  for (auto ibin = 1; ibin <= fInPUWgtHist->GetNbinsX(); ibin++)
-  {
-    fPUWeights.emplace_back(fInPUWgtHist->GetBinContent(ibin));
-  }
+  fPUWeights.Init(fInPUWgtHist);
 }
 
 void Skimmer::FillPhoListStandard()
@@ -3,10 +3,13 @@
 
 #include "SkimmerTypes.hh"
 #include "Common.hh"
+#include "HistLookup.hh"
+#include "SampleManifest.hh"
+#include "SkimLayout.hh"
+#include "../../plugins/Kinematics.hh"
 
 #include "TTree.h"
 #include "TFile.h"
-#include "TLorentzVector.h"
 
 #include <vector>
 #include <map>
@@ -17,7 +20,8 @@ class Skimmer
 public:
   // functions
   Skimmer(const TString & indir, const TString & outdir, const TString & filename, 
-	  const Float_t sumwgts, const TString & skimtype = "Standard", const TString & puwgtfilename = "");
+	  const Float_t sumwgts, const TString & skimtype = "Standard", const TString & puwgtfilename = "",
+	  const TString & manifestname = "", const TString & layoutconfig = "");
   ~Skimmer();
 
   // setup skim type
@@ -35,6 +39,7 @@ public:
   void InitInBranches();
 
   // setup gen inputs
+  void GetSumWgtsFromManifest();
   void GetSampleWeight();
   void GetPUWeights();
 
@@ -44,7 +49,7 @@ public:
   void InitOutStructs();
   void InitOutBranches();
   void InitOutCutFlowHists();
-  void InitOutCutFlowHist(const TH1F * inh_cutflow, TH1F *& outh_cutflow, const TString & name);
+  void InitCutFlow();
 
   // skim and fill outputs
   void EventLoop();
@@ -63,10 +68,13 @@ private:
   const TString fInDir;
   const TString fOutDir;
   const TString fFileName;
-  const Float_t fSumWgts;
+  Float_t fSumWgts;
   const TString fSkimType;
   const TString fPUWgtFileName;
-  std::map<std::string,int> cutLabels;
+  const TString fManifestName;
+  const TString fLayoutConfig;
+  SkimLayout fLayout;
+  CutFlow fCutFlow;
   Bool_t fIsMC;
   Float_t fNOutPhos;
 
@@ -80,7 +88,7 @@ private:
   TFile * fInPUWgtFile;
   TH1F  * fInPUWgtHist;
   Float_t fSampleWeight;
-  std::vector<Float_t> fPUWeights;
+  HistLookup fPUWeights;
   
   GmsbVec fInGMSBs;
   HvdsVec fInHVDSs;
@@ -94,6 +102,9 @@ private:
 
   // list of photon indices
   std::vector<Int_t> fPhoList;
+
+  // scratch four-vectors for pairing photons
+  Kinematics::FourVecs fPhoVecs;
   
   // Output
   TFile * fOutFile;
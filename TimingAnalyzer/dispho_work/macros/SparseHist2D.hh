@@ -0,0 +1,515 @@
+#ifndef __SparseHist2D__
+#define __SparseHist2D__
+
+// ROOT includes
+#include "TH1F.h"
+#include "TH2F.h"
+#include "THnSparse.h"
+#include "TAxis.h"
+#include "TString.h"
+
+// STL includes
+#include <vector>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// AxisLookup
+#include "HistLookup.hh"
+
+///////////////////////////////////////////////////////////////////////
+//                                                                   //
+// Blocked sparse 2D histogram: the cell grid (incl. under/overflow) //
+// is tiled into kBlockSide x kBlockSide blocks, and a block is only //
+// allocated once something lands in it. Meant for big, mostly empty //
+// maps (time vs run, ieta/iphi): fill, merge and project touch only //
+// the filled blocks; TH2F/THnSparse conversions for plotting and    //
+// I/O. Bin numbering follows ROOT: 0 = underflow, nbins+1 = overflow//
+//                                                                   //
+// Fill() is for one thread. FillConcurrent() may be called from     //
+// many threads at once: blocks are created with a CAS, and filled   //
+// under their own lock, so threads only contend within a block.     //
+//                                                                   //
+///////////////////////////////////////////////////////////////////////
+
+class SparseHist2D
+{
+public:
+  static const Int_t kBlockSide = 16;
+  static const Int_t kBlockCells = kBlockSide*kBlockSide;
+
+  struct Block
+  {
+    Block() {contents.fill(0.0); sumw2.fill(0.0);}
+
+    std::mutex mutex;
+    std::array<Double_t,kBlockCells> contents;
+    std::array<Double_t,kBlockCells> sumw2;
+  };
+
+  SparseHist2D(const TString & name, const TString & title,
+	       const Int_t nbinsx, const Double_t xlow, const Double_t xup,
+	       const Int_t nbinsy, const Double_t ylow, const Double_t yup)
+    : fName(name), fTitle(title), fXAxis(nbinsx,xlow,xup), fYAxis(nbinsy,ylow,yup) {SparseHist2D::Init();}
+
+  SparseHist2D(const TString & name, const TString & title,
+	       const std::vector<Double_t> & xbins, const std::vector<Double_t> & ybins)
+    : fName(name), fTitle(title), fXAxis(xbins.size()-1,&xbins[0]), fYAxis(ybins.size()-1,&ybins[0]) {SparseHist2D::Init();}
+
+  // same binning and titles as hist, empty
+  SparseHist2D(const TH1 * hist)
+    : fName(hist->GetName()), fTitle(hist->GetTitle()), fXAxis(*hist->GetXaxis()), fYAxis(*hist->GetYaxis()) {SparseHist2D::Init();}
+
+  ~SparseHist2D() {SparseHist2D::Reset();}
+
+  // blocks are owned: no copies
+  SparseHist2D(const SparseHist2D &) = delete;
+  SparseHist2D & operator=(const SparseHist2D &) = delete;
+
+  ////////////
+  // Fill   //
+  ////////////
+
+  inline void Fill(const Double_t x, const Double_t y, const Double_t w = 1.0)
+  {
+    SparseHist2D::FillBin(fXLookup.FindBin(x),fYLookup.FindBin(y),w);
+  }
+
+  inline void FillBin(const Int_t binx, const Int_t biny, const Double_t w = 1.0)
+  {
+    auto block = SparseHist2D::GetOrMakeBlock(SparseHist2D::GetBlockIndex(binx,biny));
+    const auto cell = SparseHist2D::GetCellIndex(binx,biny);
+    block->contents[cell] += w;
+    block->sumw2   [cell] += w*w;
+    fEntries.fetch_add(1,std::memory_order_relaxed);
+  }
+
+  inline void FillConcurrent(const Double_t x, const Double_t y, const Double_t w = 1.0)
+  {
+    const auto binx = fXLookup.FindBin(x);
+    const auto biny = fYLookup.FindBin(y);
+
+    auto block = SparseHist2D::GetOrMakeBlockConcurrent(SparseHist2D::GetBlockIndex(binx,biny));
+    const auto cell = SparseHist2D::GetCellIndex(binx,biny);
+    {
+      std::lock_guard<std::mutex> lock(block->mutex);
+      block->contents[cell] += w;
+      block->sumw2   [cell] += w*w;
+    }
+    fEntries.fetch_add(1,std::memory_order_relaxed);
+  }
+
+  ////////////
+  // Merge  //
+  ////////////
+
+  // block-wise: only blocks filled in other are visited
+  void Add(const SparseHist2D & other, const Double_t c = 1.0)
+  {
+    if (!SparseHist2D::IsSameBinning(other))
+    {
+      std::cerr << "Cannot add " << other.fName.Data() << " to " << fName.Data() << ": binning differs! Exiting..." << std::endl;
+      exit(1);
+    }
+
+    for (auto iblock = 0U; iblock < fNBlocks; iblock++)
+    {
+      const auto otherblock = other.fBlocks[iblock].load(std::memory_order_acquire);
+      if (otherblock == (Block*) NULL) continue;
+
+      auto block = SparseHist2D::GetOrMakeBlock(iblock);
+      for (auto cell = 0; cell < kBlockCells; cell++)
+      {
+	block->contents[cell] += c   * otherblock->contents[cell];
+	block->sumw2   [cell] += c*c * otherblock->sumw2   [cell];
+      }
+    }
+    fEntries.fetch_add(other.GetEntries(),std::memory_order_relaxed);
+  }
+
+  void Reset()
+  {
+    for (auto iblock = 0U; iblock < fNBlocks; iblock++)
+    {
+      delete fBlocks[iblock].exchange((Block*) NULL);
+    }
+    fEntries.store(0);
+  }
+
+  ////////////////
+  // Projection //
+  ////////////////
+
+  // same conventions as TH2::ProjectionY(name,firstxbin,lastxbin): defaults include the flow bins
+  TH1F * ProjectionY(const TString & name, Int_t firstxbin = 0, Int_t lastxbin = -1) const
+  {
+    SparseHist2D::FixRange(firstxbin,lastxbin,fXLookup.nbins);
+
+    auto hist = SparseHist2D::MakeHist1D(name,fYAxis);
+    std::vector<Double_t> contents(fYLookup.nbins+2,0.0), sumw2(fYLookup.nbins+2,0.0);
+
+    for (auto iblockx = firstxbin / kBlockSide; iblockx <= lastxbin / kBlockSide; iblockx++)
+    {
+      for (auto iblocky = 0U; iblocky < fNBlocksY; iblocky++)
+      {
+	const auto block = fBlocks[iblockx + iblocky*fNBlocksX].load(std::memory_order_acquire);
+	if (block == (Block*) NULL) continue;
+
+	for (auto binx = std::max(firstxbin,iblockx*kBlockSide); binx <= std::min(lastxbin,(iblockx+1)*kBlockSide-1); binx++)
+	{
+	  for (auto biny = Int_t(iblocky)*kBlockSide; biny < std::min(fYLookup.nbins+2,Int_t(iblocky+1)*kBlockSide); biny++)
+	  {
+	    const auto cell = SparseHist2D::GetCellIndex(binx,biny);
+	    contents[biny] += block->contents[cell];
+	    sumw2   [biny] += block->sumw2   [cell];
+	  }
+	}
+      }
+    }
+
+    SparseHist2D::SetHist1D(hist,contents,sumw2);
+    return hist;
+  }
+
+  TH1F * ProjectionX(const TString & name, Int_t firstybin = 0, Int_t lastybin = -1) const
+  {
+    SparseHist2D::FixRange(firstybin,lastybin,fYLookup.nbins);
+
+    auto hist = SparseHist2D::MakeHist1D(name,fXAxis);
+    std::vector<Double_t> contents(fXLookup.nbins+2,0.0), sumw2(fXLookup.nbins+2,0.0);
+
+    for (auto iblocky = firstybin / kBlockSide; iblocky <= lastybin / kBlockSide; iblocky++)
+    {
+      for (auto iblockx = 0U; iblockx < fNBlocksX; iblockx++)
+      {
+	const auto block = fBlocks[iblockx + iblocky*fNBlocksX].load(std::memory_order_acquire);
+	if (block == (Block*) NULL) continue;
+
+	for (auto biny = std::max(firstybin,iblocky*kBlockSide); biny <= std::min(lastybin,(iblocky+1)*kBlockSide-1); biny++)
+	{
+	  for (auto binx = Int_t(iblockx)*kBlockSide; binx < std::min(fXLookup.nbins+2,Int_t(iblockx+1)*kBlockSide); binx++)
+	  {
+	    const auto cell = SparseHist2D::GetCellIndex(binx,biny);
+	    contents[binx] += block->contents[cell];
+	    sumw2   [binx] += block->sumw2   [cell];
+	  }
+	}
+      }
+    }
+
+    SparseHist2D::SetHist1D(hist,contents,sumw2);
+    return hist;
+  }
+
+  /////////////////
+  // Conversions //
+  /////////////////
+
+  // dense copy, for plotting
+  TH2F * ToTH2F(const TString & name = "") const
+  {
+    auto hist = SparseHist2D::MakeHist2D(name != "" ? name : fName);
+
+    SparseHist2D::ForEachFilledCell([&](const Int_t binx, const Int_t biny, const Double_t content, const Double_t sumw2)
+    {
+      const auto bin = hist->GetBin(binx,biny);
+      hist->SetBinContent(bin,content);
+      hist->SetBinError  (bin,std::sqrt(sumw2));
+    });
+    hist->SetEntries(SparseHist2D::GetEntries());
+
+    return hist;
+  }
+
+  // sparse on-disk form: only the filled cells are stored
+  THnSparseF * ToTHnSparse(const TString & name = "") const
+  {
+    const Int_t nbins[2] = {fXLookup.nbins,fYLookup.nbins};
+    const Double_t xmin[2] = {fXAxis.GetXmin(),fYAxis.GetXmin()};
+    const Double_t xmax[2] = {fXAxis.GetXmax(),fYAxis.GetXmax()};
+
+    auto hist = new THnSparseF((name != "" ? name : fName).Data(),fTitle.Data(),2,nbins,xmin,xmax);
+    if (fXAxis.IsVariableBinSize()) hist->SetBinEdges(0,fXAxis.GetXbins()->GetArray());
+    if (fYAxis.IsVariableBinSize()) hist->SetBinEdges(1,fYAxis.GetXbins()->GetArray());
+    hist->GetAxis(0)->SetTitle(fXAxis.GetTitle());
+    hist->GetAxis(1)->SetTitle(fYAxis.GetTitle());
+    hist->Sumw2();
+
+    SparseHist2D::ForEachFilledCell([&](const Int_t binx, const Int_t biny, const Double_t content, const Double_t sumw2)
+    {
+      const Int_t coord[2] = {binx,biny};
+      const auto bin = hist->GetBin(coord);
+      hist->SetBinContent(bin,content);
+      hist->SetBinError2 (bin,sumw2);
+    });
+    hist->SetEntries(SparseHist2D::GetEntries());
+
+    return hist;
+  }
+
+  static SparseHist2D * FromTH2F(const TH2F * hist)
+  {
+    auto sparse = new SparseHist2D(hist);
+
+    const auto nbinsx = hist->GetXaxis()->GetNbins();
+    const auto nbinsy = hist->GetYaxis()->GetNbins();
+    for (auto biny = 0; biny <= nbinsy+1; biny++)
+    {
+      for (auto binx = 0; binx <= nbinsx+1; binx++)
+      {
+	const auto bin = hist->GetBin(binx,biny);
+	const auto content = hist->GetBinContent(bin);
+	const auto error   = hist->GetBinError  (bin);
+	if (content == 0 && error == 0) continue;
+
+	sparse->SetBin(binx,biny,content,error*error);
+      }
+    }
+    sparse->fEntries.store(Long64_t(hist->GetEntries()));
+
+    return sparse;
+  }
+
+  static SparseHist2D * FromTHnSparse(const THnSparse * hist)
+  {
+    if (hist->GetNdimensions() != 2)
+    {
+      std::cerr << "Cannot make SparseHist2D from " << hist->GetName() << ": not 2D! Exiting..." << std::endl;
+      exit(1);
+    }
+
+    auto sparse = new SparseHist2D(hist->GetName(),hist->GetTitle(),SparseHist2D::GetEdges(hist->GetAxis(0)),SparseHist2D::GetEdges(hist->GetAxis(1)));
+    sparse->fXAxis.SetTitle(hist->GetAxis(0)->GetTitle());
+    sparse->fYAxis.SetTitle(hist->GetAxis(1)->GetTitle());
+
+    Int_t coord[2];
+    for (Long64_t ibin = 0; ibin < hist->GetNbins(); ibin++)
+    {
+      const auto content = hist->GetBinContent(ibin,coord);
+      sparse->SetBin(coord[0],coord[1],content,hist->GetBinError2(ibin));
+    }
+    sparse->fEntries.store(Long64_t(hist->GetEntries()));
+
+    return sparse;
+  }
+
+  ///////////////
+  // Accessors //
+  ///////////////
+
+  Double_t GetBinContent(const Int_t binx, const Int_t biny) const
+  {
+    const auto block = fBlocks[SparseHist2D::GetBlockIndex(binx,biny)].load(std::memory_order_acquire);
+    return (block ? block->contents[SparseHist2D::GetCellIndex(binx,biny)] : 0.0);
+  }
+
+  Double_t GetBinError(const Int_t binx, const Int_t biny) const
+  {
+    const auto block = fBlocks[SparseHist2D::GetBlockIndex(binx,biny)].load(std::memory_order_acquire);
+    return (block ? std::sqrt(block->sumw2[SparseHist2D::GetCellIndex(binx,biny)]) : 0.0);
+  }
+
+  // in-range cells only, as TH2::Integral()
+  Double_t Integral() const
+  {
+    Double_t integral = 0.0;
+    SparseHist2D::ForEachFilledCell([&](const Int_t binx, const Int_t biny, const Double_t content, const Double_t)
+    {
+      if (!fXLookup.IsFlow(binx) && !fYLookup.IsFlow(biny)) integral += content;
+    });
+    return integral;
+  }
+
+  UInt_t GetNFilledBlocks() const
+  {
+    UInt_t nfilled = 0;
+    for (auto iblock = 0U; iblock < fNBlocks; iblock++)
+    {
+      if (fBlocks[iblock].load(std::memory_order_acquire)) nfilled++;
+    }
+    return nfilled;
+  }
+
+  // memory in use by the cells, vs. a dense TH2F with errors
+  size_t GetNBytes() const {return SparseHist2D::GetNFilledBlocks() * sizeof(Block);}
+  size_t GetNBytesDense() const {return size_t(fXLookup.nbins+2) * size_t(fYLookup.nbins+2) * (sizeof(Float_t)+sizeof(Double_t));}
+
+  const TString & GetName() const {return fName;}
+  const TString & GetTitle() const {return fTitle;}
+  Long64_t GetEntries() const {return fEntries.load(std::memory_order_relaxed);}
+  Int_t GetNbinsX() const {return fXLookup.nbins;}
+  Int_t GetNbinsY() const {return fYLookup.nbins;}
+  const TAxis * GetXaxis() const {return &fXAxis;}
+  const TAxis * GetYaxis() const {return &fYAxis;}
+
+private:
+  void Init()
+  {
+    SparseHist2D::SplitTitle();
+
+    fXLookup = AxisLookup(&fXAxis);
+    fYLookup = AxisLookup(&fYAxis);
+
+    fNBlocksX = (fXLookup.nbins+2 + kBlockSide-1) / kBlockSide;
+    fNBlocksY = (fYLookup.nbins+2 + kBlockSide-1) / kBlockSide;
+    fNBlocks  = fNBlocksX * fNBlocksY;
+
+    fBlocks.reset(new std::atomic<Block*>[fNBlocks]);
+    for (auto iblock = 0U; iblock < fNBlocks; iblock++) fBlocks[iblock].store((Block*) NULL);
+    fEntries.store(0);
+  }
+
+  // "title;xtitle;ytitle", as for TH1: the axis titles go on the axes, not into fTitle
+  void SplitTitle()
+  {
+    const auto ix = fTitle.Index(";");
+    if (ix == kNPOS) return;
+
+    const TString axes = fTitle(ix+1,fTitle.Length());
+    fTitle.Remove(ix);
+
+    const auto iy = axes.Index(";");
+    fXAxis.SetTitle(TString(axes(0,(iy == kNPOS ? axes.Length() : iy))).Data());
+    if (iy != kNPOS) fYAxis.SetTitle(TString(axes(iy+1,axes.Length())).Data());
+  }
+
+  inline UInt_t GetBlockIndex(const Int_t binx, const Int_t biny) const {return (binx / kBlockSide) + (biny / kBlockSide) * fNBlocksX;}
+  inline Int_t GetCellIndex(const Int_t binx, const Int_t biny) const {return (binx % kBlockSide) + (biny % kBlockSide) * kBlockSide;}
+
+  inline Block * GetOrMakeBlock(const UInt_t iblock)
+  {
+    auto block = fBlocks[iblock].load(std::memory_order_relaxed);
+    if (block == (Block*) NULL)
+    {
+      block = new Block();
+      fBlocks[iblock].store(block,std::memory_order_release);
+    }
+    return block;
+  }
+
+  inline Block * GetOrMakeBlockConcurrent(const UInt_t iblock)
+  {
+    auto block = fBlocks[iblock].load(std::memory_order_acquire);
+    if (block != (Block*) NULL) return block;
+
+    // losers of the race drop their block and take the winner's
+    auto newblock = new Block();
+    if (fBlocks[iblock].compare_exchange_strong(block,newblock,std::memory_order_acq_rel)) return newblock;
+
+    delete newblock;
+    return block;
+  }
+
+  void SetBin(const Int_t binx, const Int_t biny, const Double_t content, const Double_t sumw2)
+  {
+    auto block = SparseHist2D::GetOrMakeBlock(SparseHist2D::GetBlockIndex(binx,biny));
+    const auto cell = SparseHist2D::GetCellIndex(binx,biny);
+    block->contents[cell] = content;
+    block->sumw2   [cell] = sumw2;
+  }
+
+  template <typename F>
+  void ForEachFilledCell(F func) const
+  {
+    for (auto iblock = 0U; iblock < fNBlocks; iblock++)
+    {
+      const auto block = fBlocks[iblock].load(std::memory_order_acquire);
+      if (block == (Block*) NULL) continue;
+
+      const Int_t binx0 = (iblock % fNBlocksX) * kBlockSide;
+      const Int_t biny0 = (iblock / fNBlocksX) * kBlockSide;
+      for (auto cell = 0; cell < kBlockCells; cell++)
+      {
+	if (block->contents[cell] == 0 && block->sumw2[cell] == 0) continue;
+
+	const auto binx = binx0 + (cell % kBlockSide);
+	const auto biny = biny0 + (cell / kBlockSide);
+	if (binx > fXLookup.nbins+1 || biny > fYLookup.nbins+1) continue;
+
+	func(binx,biny,block->contents[cell],block->sumw2[cell]);
+      }
+    }
+  }
+
+  Bool_t IsSameBinning(const SparseHist2D & other) const
+  {
+    return ((fXLookup.nbins == other.fXLookup.nbins) && (fYLookup.nbins == other.fYLookup.nbins) &&
+	    (fXAxis.GetXmin() == other.fXAxis.GetXmin()) && (fXAxis.GetXmax() == other.fXAxis.GetXmax()) &&
+	    (fYAxis.GetXmin() == other.fYAxis.GetXmin()) && (fYAxis.GetXmax() == other.fYAxis.GetXmax()) &&
+	    (fXLookup.edges == other.fXLookup.edges) && (fYLookup.edges == other.fYLookup.edges));
+  }
+
+  static void FixRange(Int_t & first, Int_t & last, const Int_t nbins)
+  {
+    if (first < 0) first = 0;
+    if (last < first || last > nbins+1) last = nbins+1;
+  }
+
+  static std::vector<Double_t> GetEdges(const TAxis * axis)
+  {
+    std::vector<Double_t> edges;
+    for (auto ibin = 1; ibin <= axis->GetNbins()+1; ibin++) edges.emplace_back(axis->GetBinLowEdge(ibin));
+    return edges;
+  }
+
+  TH1F * MakeHist1D(const TString & name, const TAxis & axis) const
+  {
+    auto hist = (axis.IsVariableBinSize() ?
+		 new TH1F(name.Data(),fTitle.Data(),axis.GetNbins(),axis.GetXbins()->GetArray()) :
+		 new TH1F(name.Data(),fTitle.Data(),axis.GetNbins(),axis.GetXmin(),axis.GetXmax()));
+    hist->GetXaxis()->SetTitle(axis.GetTitle());
+    hist->Sumw2();
+    return hist;
+  }
+
+  static void SetHist1D(TH1F * hist, const std::vector<Double_t> & contents, const std::vector<Double_t> & sumw2)
+  {
+    Double_t entries = 0.0;
+    for (auto bin = 0U; bin < contents.size(); bin++)
+    {
+      hist->SetBinContent(bin,contents[bin]);
+      hist->SetBinError  (bin,std::sqrt(sumw2[bin]));
+      if (sumw2[bin] > 0) entries += (contents[bin]*contents[bin]) / sumw2[bin]; // effective entries
+    }
+    hist->SetEntries(entries);
+  }
+
+  TH2F * MakeHist2D(const TString & name) const
+  {
+    TH2F * hist = NULL;
+    if (fXAxis.IsVariableBinSize() || fYAxis.IsVariableBinSize())
+    {
+      const auto xedges = SparseHist2D::GetEdges(&fXAxis);
+      const auto yedges = SparseHist2D::GetEdges(&fYAxis);
+      hist = new TH2F(name.Data(),fTitle.Data(),fXLookup.nbins,&xedges[0],fYLookup.nbins,&yedges[0]);
+    }
+    else
+    {
+      hist = new TH2F(name.Data(),fTitle.Data(),fXLookup.nbins,fXAxis.GetXmin(),fXAxis.GetXmax(),fYLookup.nbins,fYAxis.GetXmin(),fYAxis.GetXmax());
+    }
+    hist->GetXaxis()->SetTitle(fXAxis.GetTitle());
+    hist->GetYaxis()->SetTitle(fYAxis.GetTitle());
+    hist->Sumw2();
+    return hist;
+  }
+
+  TString fName;
+  TString fTitle;
+  TAxis fXAxis;
+  TAxis fYAxis;
+  AxisLookup fXLookup;
+  AxisLookup fYLookup;
+
+  // block table: [iblockx + iblocky*fNBlocksX], NULL until first filled
+  UInt_t fNBlocksX;
+  UInt_t fNBlocksY;
+  UInt_t fNBlocks;
+  std::unique_ptr<std::atomic<Block*>[]> fBlocks;
+  std::atomic<Long64_t> fEntries;
+};
+
+#endif
@@ -1,9 +1,11 @@
 #include "SuperFastSkimmer.hh"
 
 SuperFastSkimmer::SuperFastSkimmer(const TString & cutflowconfig, const TString & infilename, 
-				   const Bool_t issignalfile, const TString & outtext)
+				   const Bool_t issignalfile, const TString & outtext, const TString & listcachename,
+				   const TString & layoutconfig)
   : fCutFlowConfig(cutflowconfig), fInFileName(infilename), 
-    fIsSignalFile(issignalfile), fOutFileText(outtext)
+    fIsSignalFile(issignalfile), fOutFileText(outtext),
+    fListCacheName(listcachename), fLayoutConfig(layoutconfig), fListCache(listcachename), fLayout(layoutconfig)
 {
   std::cout << "Initializing SuperFastSkimmer..." << std::endl;
 
@@ -64,13 +66,17 @@ void SuperFastSkimmer::MakeSkimsFromTrees()
     auto inhist = (TH1F*)fInFile->Get(Form("%s",iohistname.Data()));
     Common::CheckValidHist(inhist,iohistname,fInFileName);
 
+    // key for cached lists (before renaming), and the cuts applied so far
+    const auto treekey = fListCache.GetTreeKey(fInFile,iotreename);
+    TString chain = "";
+
     // temporarily rename so as not to confuse things
     intree->SetName("tmpInTree");
     inhist->SetName("tmpInHist");
 
     // Init Output Cut Flow Histogram 
-    std::map<TString,Int_t> binlabels;
-    auto outhist = Common::SetupOutCutFlowHist(inhist,iohistname,binlabels);
+    CutFlow cutflow;
+    auto outhist = Common::SetupOutCutFlowHist(inhist,iohistname,cutflow);
 
     // Initialize map of lists
     std::map<TString,TEntryList*> listmap;
@@ -87,6 +93,7 @@ void SuperFastSkimmer::MakeSkimsFromTrees()
     {
       // Get entry list
       const auto & label = CutFlowPair.first;
+      const auto slot = cutflow.GetSlot(label.Data());
       auto & list = listmap[label];
       list->SetDirectory(fInFile);
       fInFile->cd();
@@ -95,12 +102,13 @@ void SuperFastSkimmer::MakeSkimsFromTrees()
       if (label.Contains("HLT",TString::kExact) && sample.EqualTo("GMSB_L200_CTau400")) continue;
     
       std::cout << "Computing entries for cut: " << label.Data() << std::endl;
+      TStopwatch timer; // cost of this cut: entry list plus cut flow fill
 
       // get cut string
       const auto & cutstring = CutFlowPair.second;
 
-      // use ttree::draw() to generate entry list
-      intree->Draw(Form(">>%s",list->GetName()),Form("%s",cutstring.Data()),"entrylist");
+      // use ttree::draw() to generate entry list, unless cached
+      fListCache.MakeList(intree,treekey,cutstring,list,chain);
 
       // store result of number of entries into cutflow th1
       for (auto ientry = 0U; ientry < intree->GetEntries(); ientry++)
@@ -113,8 +121,9 @@ void SuperFastSkimmer::MakeSkimsFromTrees()
       	if (localEntry < 0) break;
       
       	b_evtwgt->GetEntry(localEntry);
-      	outhist->Fill((binlabels[label]*1.f)-0.5f,1.f);
+      	cutflow.Fill(slot);
       }
+      cutflow.AddTime(slot,timer.RealTime());
 
       // recursively set entry list for input tree
       intree->SetEntryList(list);
@@ -124,9 +133,14 @@ void SuperFastSkimmer::MakeSkimsFromTrees()
 
     // Write out a copy of the last skim
     fOutFile->cd();
-    auto outtree = intree->CopyTree("");
+    auto outtree = fLayout.CopyTree(intree);
     outtree->SetName(Form("%s",iotreename.Data()));
     outtree->Write(outtree->GetName(),TObject::kWriteDelete);
+    fLayout.Dump(outtree);
+
+    // Export cuts to hist, and report efficiency and cost per cut
+    cutflow.Export(outhist,NULL,NULL);
+    cutflow.Dump();
 
     // Write out hist
     fOutFile->cd();
@@ -171,6 +185,12 @@ void SuperFastSkimmer::MakeConfigPave()
   // save name of infile
   fConfigPave->AddText(Form("InFile name: %s (isSignal : %s",fInFileName.Data(),Common::PrintBool(fIsSignalFile).Data()));
 
+  // save name of entry list cache
+  fConfigPave->AddText(Form("Entry list cache: %s",fListCacheName.Data()));
+
+  // save layout of the skims
+  if (fLayout.IsActive()) Common::AddTextFromInputConfig(fConfigPave,"Skim Layout Config",fLayoutConfig);
+
   // dump in old config
   Common::AddTextFromInputPave(fConfigPave,fInFile);
 
@@ -7,6 +7,7 @@
 #include "TH1F.h"
 #include "TString.h"
 #include "TEntryList.h"
+#include "TStopwatch.h"
 #include "TPaveText.h"
 
 // STL includes
@@ -17,12 +18,15 @@
 
 // Common include
 #include "Common.hh"
+#include "EntryListCache.hh"
+#include "SkimLayout.hh"
 
 class SuperFastSkimmer
 {
 public:
   SuperFastSkimmer(const TString & cutflowconfig, const TString & infilename,
-		   const Bool_t issignalfile, const TString & outfiletext);
+		   const Bool_t issignalfile, const TString & outfiletext, const TString & listcachename = "",
+		   const TString & layoutconfig = "");
   ~SuperFastSkimmer();
 
   // Initialize
@@ -46,6 +50,14 @@ private:
   const TString fInFileName;
   const Bool_t  fIsSignalFile;
   const TString fOutFileText;
+  const TString fListCacheName;
+  const TString fLayoutConfig;
+
+  // selections computed in previous runs
+  EntryListCache fListCache;
+
+  // compression, baskets and clusters of the skims
+  SkimLayout fLayout;
 
   // Input
   TFile * fInFile;
@@ -0,0 +1,297 @@
+// Class include
+#include "SystFiller.hh"
+
+SystFiller::SystFiller(const TString & systconfig, const UInt_t nboot, const ULong64_t bootseed)
+  : fSystConfig(systconfig), fNBoot(nboot), fBootSeed(bootseed)
+{
+  std::cout << "Initializing SystFiller..." << std::endl;
+
+  if (fSystConfig != "") SystFiller::SetupSystConfig();
+  if (fNBoot > 0) SystFiller::SetupPoissonCDF();
+}
+
+std::vector<TH1*> SystFiller::Fill(TTree * tree, const TString & sample, TH1 * hist)
+{
+  std::cout << "Filling hist, " << fVariations.size() << " variations, and " << fNBoot << " bootstrap replicas from tree..." << std::endl;
+
+  const Bool_t is2D = (hist->GetDimension() == 2);
+  const UInt_t ncells = hist->GetNcells();
+  const auto nvars = fVariations.size();
+
+  // nominal, exactly as drawn by the plotters
+  const TString xvar = Common::XVarMap[sample];
+  const TString yvar = (is2D ? Common::YVarMap[sample] : "");
+  auto cutwgtform = SystFiller::MakeFormula(Common::CutWgtMap[sample],tree);
+  auto xform      = SystFiller::MakeFormula(xvar,tree);
+  auto yform      = (is2D ? SystFiller::MakeFormula(yvar,tree) : (TTreeFormula*) NULL);
+
+  // each variation applied to this sample gets a slot after the nominal; the rest are copies of it (slot 0)
+  std::vector<UInt_t> slots(nvars,0);
+  std::vector<TTreeFormula*> wgtforms(nvars,NULL), xforms(nvars,NULL), yforms(nvars,NULL);
+  std::vector<UInt_t> applied;
+  for (auto ivar = 0U; ivar < nvars; ivar++)
+  {
+    const auto & variation = fVariations[ivar];
+    if (!SystFiller::IsApplied(variation,sample)) continue;
+
+    const auto & type = variation.type;
+    if (!is2D && (type == SystYVar || type == SystYVarMod)) continue;
+
+    if      (type == SystWeight)  wgtforms[ivar] = SystFiller::MakeFormula(variation.expr,tree);
+    else if (type == SystXVar)    xforms  [ivar] = SystFiller::MakeFormula(variation.expr,tree);
+    else if (type == SystXVarMod) xforms  [ivar] = SystFiller::MakeFormula(xvar+variation.expr,tree);
+    else if (type == SystYVar)    yforms  [ivar] = SystFiller::MakeFormula(variation.expr,tree);
+    else if (type == SystYVarMod) yforms  [ivar] = SystFiller::MakeFormula(yvar+variation.expr,tree);
+
+    slots[ivar] = applied.size()+1;
+    applied.emplace_back(ivar);
+  }
+
+  // event identity for the replica weights: fall back on the entry if the tree has no event info
+  const Bool_t hasEventID = (tree->GetBranch("run") && tree->GetBranch("lumi") && tree->GetBranch("event"));
+  auto runform   = ((fNBoot > 0 && hasEventID) ? SystFiller::MakeFormula("run",tree)   : (TTreeFormula*) NULL);
+  auto lumiform  = ((fNBoot > 0 && hasEventID) ? SystFiller::MakeFormula("lumi",tree)  : (TTreeFormula*) NULL);
+  auto eventform = ((fNBoot > 0 && hasEventID) ? SystFiller::MakeFormula("event",tree) : (TTreeFormula*) NULL);
+  const auto samplekey = SystFiller::Mix(fBootSeed ^ ULong64_t(sample.Hash()));
+
+  // clean slate
+  const auto nslots = applied.size()+1;
+  fContents.assign(nslots*ncells,0.0);
+  fSumW2   .assign(nslots*ncells,0.0);
+  fEntries .assign(nslots,0.0);
+  fBootContents.assign(fNBoot*ncells,0.f);
+
+  // the one pass
+  const auto nEntries = tree->GetEntries();
+  for (auto entry = 0LL; entry < nEntries; entry++)
+  {
+    if (tree->LoadTree(entry) < 0) break;
+
+    // loads the branches; entries with an empty array are skipped, as in TTree::Draw
+    Bool_t isEmpty = false;
+    for (auto formula : fFormulas)
+    {
+      if (formula->GetNdata() == 0) {isEmpty = true; break;}
+    }
+    if (isEmpty) continue;
+
+    // failing the cut is a zero weight
+    const auto wgt = cutwgtform->EvalInstance();
+    if (wgt == 0) continue;
+
+    const auto x = xform->EvalInstance();
+    const auto y = (is2D ? yform->EvalInstance() : 0.0);
+    const auto cell = (is2D ? hist->FindFixBin(x,y) : hist->FindFixBin(x));
+
+    fContents[cell] += wgt;
+    fSumW2   [cell] += wgt*wgt;
+    fEntries [0]    += 1;
+
+    if (fNBoot > 0)
+    {
+      auto eventkey = samplekey;
+      if (hasEventID)
+      {
+	eventkey = SystFiller::Mix(eventkey ^ ULong64_t(runform ->EvalInstance64()));
+	eventkey = SystFiller::Mix(eventkey ^ ULong64_t(lumiform->EvalInstance64()));
+	eventkey = SystFiller::Mix(eventkey ^ ULong64_t(eventform->EvalInstance64()));
+      }
+      else
+      {
+	eventkey = SystFiller::Mix(eventkey ^ ULong64_t(entry));
+      }
+
+      // replica number is the counter
+      for (auto iboot = 0U; iboot < fNBoot; iboot++)
+      {
+	const auto count = SystFiller::GetPoissonCount(SystFiller::Mix(eventkey+iboot));
+	if (count > 0) fBootContents[iboot*ncells+cell] += count*wgt;
+      }
+    }
+
+    for (const auto ivar : applied)
+    {
+      auto varwgt  = wgt;
+      auto varcell = cell;
+
+      if (wgtforms[ivar])
+      {
+	varwgt *= wgtforms[ivar]->EvalInstance();
+      }
+      else
+      {
+	const auto varx = (xforms[ivar] ? xforms[ivar]->EvalInstance() : x);
+	const auto vary = (yforms[ivar] ? yforms[ivar]->EvalInstance() : y);
+	varcell = (is2D ? hist->FindFixBin(varx,vary) : hist->FindFixBin(varx));
+      }
+
+      const auto index = slots[ivar]*ncells+varcell;
+      fContents[index] += varwgt;
+      fSumW2   [index] += varwgt*varwgt;
+      fEntries [slots[ivar]] += 1;
+    }
+  }
+
+  // unpack buffer into the hists
+  SystFiller::FillHist(hist,0,ncells);
+
+  auto systhists = SystFiller::CloneHists(hist);
+  for (auto ivar = 0U; ivar < nvars; ivar++)
+  {
+    SystFiller::FillHist(systhists[ivar],slots[ivar],ncells);
+  }
+
+  // formulas are per tree
+  for (auto formula : fFormulas) delete formula;
+  fFormulas.clear();
+
+  return systhists;
+}
+
+std::vector<TH1*> SystFiller::CloneHists(const TH1 * hist) const
+{
+  std::vector<TH1*> systhists;
+  for (const auto & variation : fVariations)
+  {
+    auto systhist = (TH1*)hist->Clone(Form("%s_%s",hist->GetName(),variation.name.Data()));
+    systhist->SetDirectory(0);
+    systhists.emplace_back(systhist);
+  }
+  return systhists;
+}
+
+TH2F * SystFiller::MakeBootHist(const TH1 * hist, const Bool_t isFilled) const
+{
+  const UInt_t ncells = hist->GetNcells();
+
+  auto boothist = new TH2F(Form("%s_boot",hist->GetName()),Form("%s bootstrap replicas;Global Cell;Replica",hist->GetTitle()),
+			   ncells,0,ncells,fNBoot,0,fNBoot);
+  boothist->Sumw2(false);
+  boothist->SetDirectory(0);
+
+  if (!isFilled || fBootContents.size() != fNBoot*ncells) return boothist;
+
+  for (auto iboot = 0U; iboot < fNBoot; iboot++)
+  {
+    const auto offset = iboot*ncells;
+    for (auto cell = 0U; cell < ncells; cell++)
+    {
+      boothist->SetBinContent(cell+1,iboot+1,fBootContents[offset+cell]);
+    }
+  }
+  boothist->SetEntries(hist->GetEntries());
+
+  return boothist;
+}
+
+void SystFiller::FillHist(TH1 * hist, const UInt_t islot, const UInt_t ncells) const
+{
+  hist->Reset();
+
+  const auto offset = islot*ncells;
+  for (auto cell = 0U; cell < ncells; cell++)
+  {
+    hist->SetBinContent(cell,fContents[offset+cell]);
+    hist->SetBinError  (cell,std::sqrt(fSumW2[offset+cell]));
+  }
+  hist->SetEntries(fEntries[islot]);
+}
+
+TTreeFormula * SystFiller::MakeFormula(const TString & expr, TTree * tree)
+{
+  auto formula = new TTreeFormula(Form("syst_formula_%u",UInt_t(fFormulas.size())),expr.Data(),tree);
+  if (formula->GetNdim() == 0)
+  {
+    std::cerr << "Cannot compile expression: " << expr.Data() << " ...exiting..." << std::endl;
+    exit(1);
+  }
+
+  fFormulas.emplace_back(formula);
+  return formula;
+}
+
+void SystFiller::SetupPoissonCDF()
+{
+  fPoissonCDF.clear();
+
+  // P(k) = e^-1 / k!
+  auto pmf = std::exp(-1.0);
+  auto cdf = 0.0;
+  for (auto k = 0U; k < Common::bootPoissonMax; k++)
+  {
+    cdf += pmf;
+    fPoissonCDF.emplace_back(cdf);
+    pmf /= Double_t(k+1);
+  }
+}
+
+UInt_t SystFiller::GetPoissonCount(const ULong64_t hash) const
+{
+  // top 53 bits to a uniform in [0,1), then invert the cdf (k <= 1 for ~74% of draws)
+  const auto uniform = Double_t(hash >> 11) * (1.0 / 9007199254740992.0);
+
+  auto k = 0U;
+  while (k < fPoissonCDF.size() && uniform >= fPoissonCDF[k]) k++;
+  return k;
+}
+
+ULong64_t SystFiller::Mix(ULong64_t x)
+{
+  // splitmix64 finalizer
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+Bool_t SystFiller::IsApplied(const SystVariation & variation, const TString & sample) const
+{
+  if (variation.group == "all") return true;
+
+  const auto & group = Common::GroupMap[sample];
+  if      (variation.group == "data") return (group == SampleGroup::isData);
+  else if (variation.group == "bkgd") return (group == SampleGroup::isBkgd);
+  else if (variation.group == "sign") return (group == SampleGroup::isSignal);
+  else                                return false;
+}
+
+void SystFiller::SetupSystConfig()
+{
+  std::cout << "Reading syst config..." << std::endl;
+
+  // <name> <wgt|x_var|x_var_mod|y_var|y_var_mod> <all|data|bkgd|sign> <expression>
+  std::ifstream infile(Form("%s",fSystConfig.Data()),std::ios::in);
+  std::string str;
+  while (std::getline(infile,str))
+  {
+    if (str == "") continue;
+
+    std::stringstream ss(str);
+    std::string name, type, group, expr;
+    ss >> name >> type >> group;
+    std::getline(ss,expr);
+    expr.erase(0,expr.find_first_not_of(" \t"));
+
+    SystType systtype = SystWeight;
+    if      (type == "wgt")       systtype = SystWeight;
+    else if (type == "x_var")     systtype = SystXVar;
+    else if (type == "x_var_mod") systtype = SystXVarMod;
+    else if (type == "y_var")     systtype = SystYVar;
+    else if (type == "y_var_mod") systtype = SystYVarMod;
+    else
+    {
+      std::cerr << "Aye... your syst config is messed up, try again!" << std::endl;
+      std::cerr << "Offending line: " << str.c_str() << std::endl;
+      exit(1);
+    }
+
+    if ((group != "all" && group != "data" && group != "bkgd" && group != "sign") || expr == "")
+    {
+      std::cerr << "Aye... your syst config is messed up, try again!" << std::endl;
+      std::cerr << "Offending line: " << str.c_str() << std::endl;
+      exit(1);
+    }
+
+    fVariations.emplace_back(name,systtype,group,expr);
+  }
+}
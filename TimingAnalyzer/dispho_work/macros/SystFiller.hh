@@ -0,0 +1,96 @@
+#ifndef __SystFiller__
+#define __SystFiller__
+
+// ROOT includes
+#include "TTree.h"
+#include "TTreeFormula.h"
+#include "TH1.h"
+#include "TH2F.h"
+#include "TString.h"
+
+// STL includes
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <vector>
+#include <string>
+
+// Common include
+#include "Common.hh"
+
+// weight: extra factor on the nominal cut*weight; var: replaces the x/y var; var_mod: appended to it
+enum SystType {SystWeight, SystXVar, SystXVarMod, SystYVar, SystYVarMod};
+
+struct SystVariation
+{
+  SystVariation() {}
+  SystVariation(const TString & name, const SystType type, const TString & group, const TString & expr)
+    : name(name), type(type), group(group), expr(expr) {}
+
+  TString name;  // output hists: <nominal hist name>_<name>, e.g. GMSB_L200_CTau400_Hist_puwgtUp
+  SystType type;
+  TString group; // all, data, bkgd, or sign: other samples get a copy of the nominal
+  TString expr;
+};
+
+namespace Common
+{
+  // Poisson(1) pmf beyond this count is below double precision
+  static const UInt_t bootPoissonMax = 20;
+};
+
+// Fills the nominal hist of a sample and all of its variations in one pass over the tree.
+// Cells of all hists live in one contiguous buffer, shared by every sample: [hist][cell].
+// With nboot > 0, also fills nboot Poisson(1)-weighted bootstrap replicas of the nominal.
+// Replica weights come from a counter-based hash of (seed, sample, run, lumi, event, replica),
+// so an event gets the same weights in every hist and every skim it shows up in.
+class SystFiller
+{
+public:
+  SystFiller(const TString & systconfig, const UInt_t nboot = 0, const ULong64_t bootseed = 0);
+  ~SystFiller() {}
+
+  // fills hist (binning and name as set up by the plotter), and returns one new hist per variation
+  std::vector<TH1*> Fill(TTree * tree, const TString & sample, TH1 * hist);
+
+  // one copy of hist per variation, named for it (e.g. for samples without a tree)
+  std::vector<TH1*> CloneHists(const TH1 * hist) const;
+
+  // replicas of the last Fill() (or empty ones) packed as <hist>_boot: x = global cell of hist, y = replica
+  // contents are raw sums of weights, stored as floats and without errors
+  TH2F * MakeBootHist(const TH1 * hist, const Bool_t isFilled) const;
+
+  const std::vector<SystVariation> & GetVariations() const {return fVariations;}
+  UInt_t GetNBoot() const {return fNBoot;}
+
+private:
+  void SetupSystConfig();
+  Bool_t IsApplied(const SystVariation & variation, const TString & sample) const;
+  TTreeFormula * MakeFormula(const TString & expr, TTree * tree);
+  void FillHist(TH1 * hist, const UInt_t islot, const UInt_t ncells) const;
+  void SetupPoissonCDF();
+  UInt_t GetPoissonCount(const ULong64_t hash) const;
+  static ULong64_t Mix(ULong64_t x);
+
+  const TString fSystConfig;
+  std::vector<SystVariation> fVariations;
+
+  // bootstrap settings, and the Poisson(1) cdf the hashes are mapped onto
+  const UInt_t fNBoot;
+  const ULong64_t fBootSeed;
+  std::vector<Double_t> fPoissonCDF;
+
+  // formulas of the current tree
+  std::vector<TTreeFormula*> fFormulas;
+
+  // per slot (0: nominal): contents, sum of weights^2, and entries
+  std::vector<Double_t> fContents;
+  std::vector<Double_t> fSumW2;
+  std::vector<Double_t> fEntries;
+
+  // nominal replicas: [replica][cell]
+  std::vector<Float_t> fBootContents;
+};
+
+#endif
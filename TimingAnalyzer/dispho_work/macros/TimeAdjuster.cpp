@@ -36,10 +36,17 @@ TimeAdjuster::~TimeAdjuster()
 
   delete fSignalSkimFile;
   delete fSkimFile;
+
+  // where the time went: next to the skim it adjusted
+  TString outtext = fSkimFileName;
+  outtext.ReplaceAll(".root","");
+  Profiler::Dump(outtext+"_timeadjust");
 }
 
 void TimeAdjuster::AdjustTime()
 {
+  PROFILE_SCOPE("TimeAdjuster::AdjustTime");
+
   std::cout << "Adjusting time..." << std::endl;
 
   // prepare for time adjustments: data
@@ -67,6 +74,8 @@ void TimeAdjuster::AdjustTime()
 
 void TimeAdjuster::PrepAdjustments(FitStruct & FitInfo)
 {
+  PROFILE_READ_SCOPE("TimeAdjuster::PrepAdjustments");
+
   const auto & label = FitInfo.label;
   std::cout << "Preparing time adjustments for: " << label.Data() << std::endl;
 
@@ -76,10 +85,15 @@ void TimeAdjuster::PrepAdjustments(FitStruct & FitInfo)
   // Get input resolution fits
   //  if (fDoSmear) TimeAdjuster::GetInputSigmaFits(FitInfo);
   if (fDoSmear) TimeAdjuster::GetInputSigmaHists(FitInfo);
+
+  // flatten hists into lookups for the event loop
+  TimeAdjuster::PrepLookups(FitInfo);
 }
 
 void TimeAdjuster::CorrectData(FitStruct & DataInfo)
 {
+  PROFILE_READ_SCOPE("TimeAdjuster::CorrectData");
+
   std::cout << "Correcting data!" << std::endl;
 
   ////////////////////////////
@@ -125,14 +139,6 @@ void TimeAdjuster::CorrectData(FitStruct & DataInfo)
     //    ev.b_run->GetEntry(entry);
     ev.b_nphotons->GetEntry(entry);
 
-    // get era
-    // const auto & era = std::find_if(Common::EraMap.begin(),Common::EraMap.end(),
-    // 				    [=](const std::pair<TString,EraStruct> & EraPair)
-    // 				    {
-    // 				      return ( (EraPair.first != "Full") && ((ev.run >= EraPair.second.startRun) && (ev.run <= EraPair.second.endRun)) );
-    // 				    })->first;
-    const TString era = "Full";
-
     // loop over nphotons
     const auto nphos = std::min(ev.nphotons,Common::nPhotons);
     for (auto ipho = 0; ipho < nphos; ipho++)
@@ -144,22 +150,10 @@ void TimeAdjuster::CorrectData(FitStruct & DataInfo)
       pho.b_isEB->GetEntry(entry);
       
       // get the correction
-      const TString key = Form("%s_%s",(pho.isEB?"EB":"EE"),era.Data());
-      const auto & hist = DataInfo.MuHistMap[key];
-      
-      // get bin which corresponds to the pt of the object
-      const auto bin = hist->FindBin(pho.adjustvar);
+      const auto & lookup = DataInfo.MuLookups[pho.isEB];
 
       // set correction branch if bin is found, else no correction
-      if (bin != 0 && bin != hist->GetXaxis()->GetNbins()+1)
-      {
-	const auto shift = hist->GetBinContent(bin);
-	pho.timeSHIFT = -shift;
-      }
-      else
-      {
-	pho.timeSHIFT = 0.f;
-      }
+      pho.timeSHIFT = -lookup.GetInRange(pho.adjustvar,0.f);
       
       // fill branch
       pho.b_timeSHIFT->Fill();
@@ -178,6 +172,7 @@ void TimeAdjuster::CorrectData(FitStruct & DataInfo)
     } // end loop over remainder photons
     
   } // end loop over entries
+  Profiler::Count("entries",nEntries);
   
   //////////////
   // Clean up //
@@ -192,6 +187,8 @@ void TimeAdjuster::CorrectData(FitStruct & DataInfo)
 
 void TimeAdjuster::CorrectMC(FitStruct & DataInfo, FitStruct & MCInfo)
 {
+  PROFILE_READ_SCOPE("TimeAdjuster::CorrectMC");
+
   std::cout << "Correcting MC!" << std::endl;
 
   //////////////////////////
@@ -273,31 +270,14 @@ void TimeAdjuster::CorrectMC(FitStruct & DataInfo, FitStruct & MCInfo)
 	  pho.b_adjustvar->GetEntry(entry);
 	  pho.b_isEB->GetEntry(entry);
       
-	  // era to use
-	  const TString era = "Full";
-
-	  // get the key
-	  const TString key = Form("%s_%s",(pho.isEB?"EB":"EE"),era.Data());
-
 	  // set shift correction branch
 	  if (fDoShift)
 	  {
-	    // get the right hist
-	    const auto & hist = MCInfo.MuHistMap[key];
+	    // get the right lookup
+	    const auto & lookup = MCInfo.MuLookups[pho.isEB];
 
-	    // get the bin for the pt of the object
-	    const auto bin = hist->FindBin(pho.adjustvar);
-	    
 	    // set correction branch if bin is found, else no correction
-	    if (bin != 0 && bin != hist->GetXaxis()->GetNbins()+1)
-	    {
-	      const auto shift = hist->GetBinContent(bin);
-	      pho.timeSHIFT = -shift;
-	    }
-	    else
-	    {
-	      pho.timeSHIFT = 0.f;
-	    }
+	    pho.timeSHIFT = -lookup.GetInRange(pho.adjustvar,0.f);
 	  }
 
 	  // set smear correction branch
@@ -307,18 +287,18 @@ void TimeAdjuster::CorrectMC(FitStruct & DataInfo, FitStruct & MCInfo)
 	    // const auto & mcfit   = MCInfo  .SigmaFitMap[key];
 	    // const auto sigma     = std::sqrt(std::pow(datafit->Eval(pho.pt),2.f)-std::pow(mcfit->Eval(pho.pt),2.f));
 
-	    // get the right hists
-	    const auto & datahist = DataInfo.SigmaHistMap[key];
-	    const auto & mchist   = MCInfo  .SigmaHistMap[key];
+	    // get the right lookups
+	    const auto & datalookup = DataInfo.SigmaLookups[pho.isEB];
+	    const auto & mclookup   = MCInfo  .SigmaLookups[pho.isEB];
 
 	    // get the right bins based on pt
-	    const auto & databin = datahist->FindBin(pho.adjustvar);
-	    const auto & mcbin   = mchist  ->FindBin(pho.adjustvar);
-	    
+	    const auto databin = datalookup.FindBin(pho.adjustvar);
+	    const auto mcbin   = mclookup  .FindBin(pho.adjustvar);
+
 	    // make smear if bins within range
-	    if ( (databin != 0 && databin != datahist->GetXaxis()->GetNbins()+1) && (mcbin != 0 && mcbin != mchist->GetXaxis()->GetNbins()+1) )
+	    if (!datalookup.IsFlow(databin) && !mclookup.IsFlow(mcbin))
 	    {
-	      const auto sigma  = std::sqrt(std::pow(datahist->GetBinContent(databin),2.f)-std::pow(mchist->GetBinContent(mcbin),2.f));
+	      const auto sigma  = std::sqrt(std::pow(datalookup.GetBinContent(databin),2.f)-std::pow(mclookup.GetBinContent(mcbin),2.f));
 	      pho.timeSMEAR = rand->Gaus(0.f,sigma);
 	    }
 	    else
@@ -347,6 +327,7 @@ void TimeAdjuster::CorrectMC(FitStruct & DataInfo, FitStruct & MCInfo)
 	} // end loop over remainder photons
     
       } // end loop over entries
+      Profiler::Count("entries",nEntries);
   
       //////////////
       // Clean up //
@@ -448,8 +429,29 @@ void TimeAdjuster::GetInputSigmaFits(FitStruct & FitInfo)
   }
 }
 
+void TimeAdjuster::PrepLookups(FitStruct & FitInfo)
+{
+  const auto & label = FitInfo.label;
+  std::cout << "Preparing lookups for: " << label.Data() << std::endl;
+
+  // era to use: only Full for now
+  const TString era = "Full";
+
+  // index by isEB
+  const std::vector<TString> ecals = {"EE","EB"};
+  for (auto iecal = 0U; iecal < ecals.size(); iecal++)
+  {
+    const TString key = Form("%s_%s",ecals[iecal].Data(),era.Data());
+
+    if (fDoShift) FitInfo.MuLookups   [iecal].Init(FitInfo.MuHistMap   [key]);
+    if (fDoSmear) FitInfo.SigmaLookups[iecal].Init(FitInfo.SigmaHistMap[key]);
+  }
+}
+
 void TimeAdjuster::MakeConfigPave(TFile *& SkimFile)
 {
+  PROFILE_SCOPE("TimeAdjuster::MakeConfigPave");
+
   std::cout << "Dumping config to a pave for: " << SkimFile->GetName() << std::endl;
 
   // create the pave, copying in old info
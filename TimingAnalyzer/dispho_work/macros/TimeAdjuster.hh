@@ -21,6 +21,7 @@
 
 // Common include
 #include "Common.hh"
+#include "HistLookup.hh"
 
 struct Event
 {
@@ -65,6 +66,10 @@ struct FitStruct
   std::map<TString,TH1F*> MuHistMap;
   std::map<TString,TH1F*> SigmaHistMap;
   std::map<TString,TF1*>  SigmaFitMap;
+
+  // per-entry lookups for the era in use, indexed by isEB (0: EE, 1: EB)
+  HistLookup MuLookups[2];
+  HistLookup SigmaLookups[2];
 };
 
 class TimeAdjuster
@@ -90,6 +95,7 @@ public:
   void GetInputMuHists(FitStruct & FitInfo);
   void GetInputSigmaHists(FitStruct & FitInfo);
   void GetInputSigmaFits(FitStruct & FitInfo);
+  void PrepLookups(FitStruct & FitInfo);
 
   // Meta data
   void MakeConfigPave(TFile *& SkimFile);
@@ -45,10 +45,15 @@ TimeFitter::~TimeFitter()
   delete fOutFile;
   delete fTDRStyle;
   delete fInFile;
+
+  // where the time went
+  Profiler::Dump(fOutFileText);
 }
 
 void TimeFitter::MakeTimeFits()
 {
+  PROFILE_SCOPE("TimeFitter::MakeTimeFits");
+
   std::cout << "Making time fits..." << std::endl;
   
   // Do data first
@@ -82,6 +87,8 @@ void TimeFitter::MakeTimeFits()
 
 void TimeFitter::MakeTimeFit(FitStruct & FitInfo)
 {
+  PROFILE_SCOPE("TimeFitter::MakeTimeFit");
+
   const auto & label = FitInfo.label;
   std::cout << "Making time fits for: " << label.Data() << std::endl;
 
@@ -103,6 +110,8 @@ void TimeFitter::MakeTimeFit(FitStruct & FitInfo)
 
 void TimeFitter::MakeSigmaFit(FitStruct & FitInfo)
 {
+  PROFILE_SCOPE("TimeFitter::MakeSigmaFit");
+
   const auto & label = FitInfo.label;
   std::cout << "Making sigma fit for: " << label.Data() << std::endl;
   
@@ -115,6 +124,8 @@ void TimeFitter::MakeSigmaFit(FitStruct & FitInfo)
 
 void TimeFitter::MakePlots(FitStruct & DataInfo, FitStruct & MCInfo)
 {
+  PROFILE_SCOPE("TimeFitter::MakePlots");
+
   std::cout << "Make overlay plots..." << std::endl;
 
   // make temp vector of hist key names
@@ -141,6 +152,8 @@ void TimeFitter::MakePlots(FitStruct & DataInfo, FitStruct & MCInfo)
 
 void TimeFitter::GetInputHist(FitStruct & FitInfo)
 {
+  PROFILE_READ_SCOPE("TimeFitter::GetInputHist");
+
   const auto & label = FitInfo.label;
   std::cout << "Getting input hist: " << label.Data() << std::endl;
   
@@ -158,6 +171,8 @@ void TimeFitter::GetInputHist(FitStruct & FitInfo)
 
 void TimeFitter::InitTimeFits(FitStruct & FitInfo)
 {
+  PROFILE_SCOPE("TimeFitter::InitTimeFits");
+
   const auto & label = FitInfo.label;
   std::cout << "Initializing TimeFitStructMap for: " << label.Data() << std::endl;
   
@@ -173,6 +188,8 @@ void TimeFitter::InitTimeFits(FitStruct & FitInfo)
 
 void TimeFitter::Project2Dto1DHists(FitStruct & FitInfo)
 {
+  PROFILE_SCOPE("TimeFitter::Project2Dto1DHists");
+
   const auto & label = FitInfo.label;
   std::cout << "Projecting to 1D from 2D plot: " << label.Data() << std::endl;
   
@@ -190,6 +207,8 @@ void TimeFitter::Project2Dto1DHists(FitStruct & FitInfo)
 
 void TimeFitter::Fit1DHists(FitStruct & FitInfo)
 {
+  PROFILE_SCOPE("TimeFitter::Fit1DHists");
+
   const auto & label = FitInfo.label;
   std::cout << "Fitting hists for: " << label.Data() << std::endl;
   
@@ -209,6 +228,7 @@ void TimeFitter::Fit1DHists(FitStruct & FitInfo)
     
     // do the fit!
     TimeFit->DoFit();
+    Profiler::Count("fits");
 
     // save output
     fOutFile->cd();
@@ -220,6 +240,8 @@ void TimeFitter::Fit1DHists(FitStruct & FitInfo)
 
 void TimeFitter::ExtractFitResults(FitStruct & FitInfo)
 {
+  PROFILE_SCOPE("TimeFitter::ExtractFitResults");
+
   const auto & label = FitInfo.label;
   std::cout << "Extracting results for: " << label.Data() << std::endl;
 
@@ -467,6 +489,8 @@ void TimeFitter::GetMinMax(const TH1F * hist, Float_t & min, Float_t & max, cons
 
 void TimeFitter::MakeConfigPave()
 {
+  PROFILE_SCOPE("TimeFitter::MakeConfigPave");
+
   std::cout << "Dumping config to a pave..." << std::endl;
 
   // create the pave, copying in old info
@@ -505,6 +529,8 @@ void TimeFitter::MakeConfigPave()
 
 void TimeFitter::DumpFitInfo(FitStruct & DataInfo, FitStruct & MCInfo)
 {
+  PROFILE_SCOPE("TimeFitter::DumpFitInfo");
+
   std::cout << "Dumping fit info into text file..." << std::endl;
 
   // get histograms!
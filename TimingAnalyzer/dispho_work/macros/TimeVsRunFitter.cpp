@@ -55,6 +55,7 @@ TimeVsRunFitter::~TimeVsRunFitter()
     delete TimeFit;
   }
 
+  delete SparseHist;
   delete Hist2D;
 
   delete fOutFile;
@@ -95,8 +96,24 @@ void TimeVsRunFitter::GetInputHist()
 {
   std::cout << "Getting input hists..." << std::endl;
   
-  // get the hist
-  Hist2D = (TH2F*)fInFile->Get(Common::HistNameMap["Data"]);
+  // get the hist: either a dense TH2F, or a THnSparse from SparseHist2D
+  const auto & histname = Common::HistNameMap["Data"];
+  auto object = fInFile->Get(histname.Data());
+  Common::CheckValidHist(object,histname,fInFileName);
+
+  if (object->InheritsFrom(THnSparse::Class()))
+  {
+    SparseHist = SparseHist2D::FromTHnSparse((THnSparse*)object);
+    Hist2D = SparseHist->ToTH2F();
+    delete object;
+  }
+  else
+  {
+    Hist2D = (TH2F*)object;
+    SparseHist = SparseHist2D::FromTH2F(Hist2D);
+  }
+  std::cout << "Input hist: " << SparseHist->GetNFilledBlocks() << " filled blocks, " << SparseHist->GetNBytes() 
+	    << " bytes (dense: " << SparseHist->GetNBytesDense() << " bytes)" << std::endl;
 
   // save to output
   fOutFile->cd();
@@ -118,13 +135,13 @@ void TimeVsRunFitter::Project2Dto1DHists()
 {
   std::cout << "Projecting to 1D from 2D plot..." << std::endl;
   
-  // get inputs/outputs
+  // get inputs/outputs: only the filled blocks of each run column are visited
   const TString histname = Hist2D->GetName();
 
   for (auto ibinX = 1; ibinX <= fNBinsX; ibinX++)
   {
     auto & hist = TimeFitStructMap[ibinX]->hist;
-    hist = (TH1F*)Hist2D->ProjectionY(Form("%s_ibin%i",histname.Data(),ibinX),ibinX,ibinX);
+    hist = SparseHist->ProjectionY(Form("%s_ibin%i",histname.Data(),ibinX),ibinX,ibinX);
   }
 }
 
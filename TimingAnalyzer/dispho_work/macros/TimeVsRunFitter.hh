@@ -24,6 +24,7 @@
 // Common include(s)
 #include "Common.hh"
 #include "CommonTimeFit.hh"
+#include "SparseHist2D.hh"
 
 class TimeVsRunFitter
 {
@@ -83,6 +84,7 @@ private:
   
   // tmp I/O
   TH2F * Hist2D;
+  SparseHist2D * SparseHist;
   std::map<Int_t,TimeFitStruct*> TimeFitStructMap;
   std::map<TString,TH1F*> ResultsMap;
 
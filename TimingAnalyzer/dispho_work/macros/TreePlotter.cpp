@@ -43,8 +43,16 @@ TreePlotter::TreePlotter(const TString & infilename, const TString & insignalfil
   TreePlotter::SetupHistsStyle();
 }
 
+TreePlotter::~TreePlotter()
+{
+  // where the time went: derived plotters that skip the main constructor have no output name
+  if (fOutFileText != "") Profiler::Dump(fOutFileText);
+}
+
 void TreePlotter::MakeTreePlot()
 {
+  PROFILE_SCOPE("TreePlotter::MakeTreePlot");
+
   // Fill Hists from TTrees
   TreePlotter::MakeHistFromTrees(fInFile,fInSignalFile);
 
@@ -87,8 +95,14 @@ void TreePlotter::MakeTreePlot()
 
 void TreePlotter::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
 {
+  PROFILE_READ_SCOPE("TreePlotter::MakeHistFromTrees");
+
   std::cout << "Making hists from input trees..." << std::endl;
 
+  // variations, filled in the same pass as the nominal
+  // and bootstrap replicas of the nominal
+  auto systFiller = ((fSystConfig != "" || fNBoot > 0) ? new SystFiller(fSystConfig,fNBoot,fBootSeed) : (SystFiller*) NULL);
+
   // loop over sample groups for each tree
   for (const auto & TreeNamePair : Common::TreeNameMap)
   {
@@ -108,12 +122,21 @@ void TreePlotter::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
     if (!isnull)
     {
       std::cout << "Filling hist from tree..." << std::endl;
+      Profiler::Count("entries",intree->GetEntries());
 
       // get the hist we wish to write to (and holy crap, ROOT's internal memory residency is stupid)
       auto & hist = HistMap[sample];
       hist->SetDirectory(infile);
 
-      intree->Draw(Form("%s>>%s",Common::XVarMap[sample].Data(),hist->GetName()),Form("%s",Common::CutWgtMap[sample].Data()),"goff");
+      if (systFiller)
+      {
+	for (auto systhist : systFiller->Fill(intree,sample,hist)) SystHistMap[systhist->GetName()] = (TH1F*)systhist;
+	if (fNBoot > 0) BootHistMap[sample] = systFiller->MakeBootHist(hist,true);
+      }
+      else
+      {
+	intree->Draw(Form("%s>>%s",Common::XVarMap[sample].Data(),hist->GetName()),Form("%s",Common::CutWgtMap[sample].Data()),"goff");
+      }
 
       // delete tree;
       delete intree;
@@ -121,8 +144,16 @@ void TreePlotter::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
     else
     {
       std::cout << "Skipping null tree..." << std::endl;
+
+      // variations still needed downstream
+      if (systFiller)
+      {
+	for (auto systhist : systFiller->CloneHists(HistMap[sample])) SystHistMap[systhist->GetName()] = (TH1F*)systhist;
+	if (fNBoot > 0) BootHistMap[sample] = systFiller->MakeBootHist(HistMap[sample],false);
+      }
     }
   }
+  delete systFiller;
 
   // rescale bins by widths if variable size
   if (fXVarBins)
@@ -133,6 +164,17 @@ void TreePlotter::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
       auto & hist = HistPair.second;
       Common::Scale(hist,isUp);
     }
+    for (auto & HistPair : SystHistMap)
+    {
+      auto & hist = HistPair.second;
+      Common::Scale(hist,isUp);
+    }
+    for (auto & HistPair : BootHistMap)
+    {
+      const auto & sample = HistPair.first;
+      auto & boot = HistPair.second;
+      Common::ScaleBoot(boot,HistMap[sample],isUp,true,false);
+    }
   }
 
   // save totals to output file
@@ -142,10 +184,26 @@ void TreePlotter::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
     const auto & hist = HistPair.second;
     hist->Write(hist->GetName(),TObject::kWriteDelete);
   }
+
+  // variations are saved, not plotted
+  for (const auto & HistPair : SystHistMap)
+  { 
+    const auto & hist = HistPair.second;
+    hist->Write(hist->GetName(),TObject::kWriteDelete);
+  }
+
+  // as are the bootstrap replicas
+  for (const auto & HistPair : BootHistMap)
+  { 
+    const auto & boot = HistPair.second;
+    boot->Write(boot->GetName(),TObject::kWriteDelete);
+  }
 }
 
 void TreePlotter::MakeDataOutput()
 {
+  PROFILE_SCOPE("TreePlotter::MakeDataOutput");
+
   std::cout << "Making Data Output..." << std::endl;
 
   // Make new data hist in case we are blinded
@@ -180,6 +238,8 @@ void TreePlotter::MakeDataOutput()
 
 void TreePlotter::MakeBkgdOutput()
 {
+  PROFILE_SCOPE("TreePlotter::MakeBkgdOutput");
+
   std::cout << "Making Bkgd Output..." << std::endl;
 
   // Extra Hists
@@ -263,6 +323,8 @@ void TreePlotter::MakeBkgdOutput()
 
 void TreePlotter::MakeSignalOutput()
 {
+  PROFILE_SCOPE("TreePlotter::MakeSignalOutput");
+
   std::cout << "Making Signal Output..." << std::endl;
 
   // no need to make new hists, just rescale and save as "_Plotted"
@@ -284,6 +346,8 @@ void TreePlotter::MakeSignalOutput()
 
 void TreePlotter::MakeRatioOutput()
 {
+  PROFILE_SCOPE("TreePlotter::MakeRatioOutput");
+
   std::cout << "Making Ratio Output..." << std::endl;
 
   // ratio value plot
@@ -420,6 +484,8 @@ void TreePlotter::InitOutputCanvPads()
 
 void TreePlotter::DrawUpperPad()
 {
+  PROFILE_SCOPE("TreePlotter::DrawUpperPad");
+
   std::cout << "Drawing upper pad..." << std::endl;
 
   // Pad Gymnastics
@@ -482,6 +548,8 @@ void TreePlotter::DrawUpperPad()
 
 void TreePlotter::DrawLowerPad()
 {  
+  PROFILE_SCOPE("TreePlotter::DrawLowerPad");
+
   std::cout << "Drawing lower pad..." << std::endl;
 
   // Pad gymnastics
@@ -510,6 +578,8 @@ void TreePlotter::DrawLowerPad()
 
 void TreePlotter::SaveOutput(const TString & outfiletext, const TString & era)
 {
+  PROFILE_SCOPE("TreePlotter::SaveOutput");
+
   std::cout << "Saving hist as images..." << std::endl;
 
   // Go back to the main canvas before saving and write out lumi info
@@ -555,6 +625,8 @@ void TreePlotter::PrintCanvas(const TString & outfiletext, const Bool_t isLogy)
 
 void TreePlotter::MakeConfigPave()
 {
+  PROFILE_SCOPE("TreePlotter::MakeConfigPave");
+
   std::cout << "Dumping config to a pave..." << std::endl;
 
   // create the pave, copying in old info
@@ -580,6 +652,9 @@ void TreePlotter::MakeConfigPave()
   // store last bits of info from misc
   Common::AddTextFromInputConfig(fConfigPave,"Miscellaneous Config",fMiscConfig); 
 
+  // dump variations
+  if (fSystConfig != "") Common::AddTextFromInputConfig(fConfigPave,"Syst Config",fSystConfig);
+
   // padding
   Common::AddPaddingToPave(fConfigPave,3);
 
@@ -602,6 +677,8 @@ void TreePlotter::MakeConfigPave()
 
 TString TreePlotter::DumpIntegrals(const TString & outfiletext)
 {
+  PROFILE_SCOPE("TreePlotter::DumpIntegrals");
+
   std::cout << "Dumping integrals into text file..." << std::endl;
 
   // make dumpfile object
@@ -676,6 +753,12 @@ void TreePlotter::DeleteMemory(const Bool_t deleteInternal)
   delete BkgdHist;
   delete DataHist;
 
+  for (auto & HistPair : SystHistMap) delete HistPair.second;
+  SystHistMap.clear();
+
+  for (auto & HistPair : BootHistMap) delete HistPair.second;
+  BootHistMap.clear();
+
   for (auto & HistPair : HistMap) delete HistPair.second;
   HistMap.clear();
 
@@ -815,6 +898,9 @@ void TreePlotter::SetupDefaults()
   fBlindData = false;
   fSkipData = false;
   fSignalsOnly = false;
+  fSystConfig = "";
+  fNBoot = 0;
+  fBootSeed = 0;
 }
 
 void TreePlotter::SetupCommon()
@@ -955,6 +1041,20 @@ void TreePlotter::SetupMiscConfig(const TString & miscconfig)
       str = Common::RemoveDelim(str,"signals_only=");
       Common::SetupBool(str,fSignalsOnly);
     }
+    else if (str.find("syst_config=") != std::string::npos)
+    {
+      fSystConfig = Common::RemoveDelim(str,"syst_config=");
+    }
+    else if (str.find("n_boot=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"n_boot=");
+      fNBoot = std::atoi(str.c_str());
+    }
+    else if (str.find("boot_seed=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"boot_seed=");
+      fBootSeed = std::strtoull(str.c_str(),NULL,10);
+    }
     else 
     {
       std::cerr << "Aye... your miscellaneous plot config is messed up, try again!" << std::endl;
@@ -28,6 +28,7 @@
 
 // Common include
 #include "Common.hh"
+#include "SystFiller.hh"
 
 class TreePlotter
 {
@@ -36,7 +37,7 @@ public:
   TreePlotter(const TString & infilename, const TString & insignalfilename, const TString & cutconfig,
 	      const TString & varwgtmapconfig, const TString & plotconfig, const TString & miscconfig,
 	      const TString & era, const TString & outfiletext);
-  ~TreePlotter() {}
+  ~TreePlotter();
 
   // Initialize
   void SetupDefaults();
@@ -110,6 +111,9 @@ protected:
   Bool_t fBlindData;
   Bool_t fSkipData;
   Bool_t fSignalsOnly;
+  TString fSystConfig;
+  UInt_t fNBoot;
+  ULong64_t fBootSeed;
 
   // Style
   TStyle * fTDRStyle;
@@ -117,6 +121,8 @@ protected:
   // Output
   TFile * fOutFile;
   std::map<TString,TH1F*> HistMap;
+  std::map<TString,TH1F*> SystHistMap;
+  std::map<TString,TH2F*> BootHistMap;
   TH1F * DataHist;
   TH1F * BkgdHist;
   TH1F * EWKHist;
@@ -38,8 +38,16 @@ TreePlotter2D::TreePlotter2D(const TString & infilename, const TString & insigna
   fOutFile = TFile::Open(Form("%s.root",fOutFileText.Data()),"UPDATE");
 }
 
+TreePlotter2D::~TreePlotter2D()
+{
+  // where the time went: nothing to name it after if default constructed
+  if (fOutFileText != "") Profiler::Dump(fOutFileText);
+}
+
 void TreePlotter2D::MakeTreePlot2D()
 {
+  PROFILE_SCOPE("TreePlotter2D::MakeTreePlot2D");
+
   // Fill Hists from TTrees
   TreePlotter2D::MakeHistFromTrees(fInFile,fInSignalFile);
 
@@ -61,8 +69,14 @@ void TreePlotter2D::MakeTreePlot2D()
 
 void TreePlotter2D::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
 {
+  PROFILE_READ_SCOPE("TreePlotter2D::MakeHistFromTrees");
+
   std::cout << "Making hists from input trees..." << std::endl;
 
+  // variations, filled in the same pass as the nominal
+  // and bootstrap replicas of the nominal
+  auto systFiller = ((fSystConfig != "" || fNBoot > 0) ? new SystFiller(fSystConfig,fNBoot,fBootSeed) : (SystFiller*) NULL);
+
   // loop over sample groups for each tree
   for (const auto & TreeNamePair : Common::TreeNameMap)
   {
@@ -82,13 +96,22 @@ void TreePlotter2D::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
     if (!isnull)
     {
       std::cout << "Filling hist from tree..." << std::endl;
+      Profiler::Count("entries",intree->GetEntries());
 
       // get the hist we wish to write to --> ROOT and memory residency is satanic
       auto & hist = HistMap[sample];
       hist->SetDirectory(infile);
       
       // Fill from tree
-      intree->Draw(Form("%s:%s>>%s",Common::YVarMap[sample].Data(),Common::XVarMap[sample].Data(),hist->GetName()),Form("%s",Common::CutWgtMap[sample].Data()),"goff");
+      if (systFiller)
+      {
+	for (auto systhist : systFiller->Fill(intree,sample,hist)) SystHistMap[systhist->GetName()] = (TH2F*)systhist;
+	if (fNBoot > 0) BootHistMap[sample] = systFiller->MakeBootHist(hist,true);
+      }
+      else
+      {
+	intree->Draw(Form("%s:%s>>%s",Common::YVarMap[sample].Data(),Common::XVarMap[sample].Data(),hist->GetName()),Form("%s",Common::CutWgtMap[sample].Data()),"goff");
+      }
 
       // delete tree;
       delete intree;
@@ -96,8 +119,16 @@ void TreePlotter2D::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
     else
     {
       std::cout << "Skipping null tree..." << std::endl;
+
+      // variations still needed downstream
+      if (systFiller)
+      {
+	for (auto systhist : systFiller->CloneHists(HistMap[sample])) SystHistMap[systhist->GetName()] = (TH2F*)systhist;
+	if (fNBoot > 0) BootHistMap[sample] = systFiller->MakeBootHist(HistMap[sample],false);
+      }
     }
   }
+  delete systFiller;
 
   // rescale bins by widths if variable size
   if (fXVarBins || fYVarBins)
@@ -108,6 +139,17 @@ void TreePlotter2D::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
       auto & hist = HistPair.second;
       Common::Scale(hist,isUp,fXVarBins,fYVarBins);
     }
+    for (auto & HistPair : SystHistMap)
+    {
+      auto & hist = HistPair.second;
+      Common::Scale(hist,isUp,fXVarBins,fYVarBins);
+    }
+    for (auto & HistPair : BootHistMap)
+    {
+      const auto & sample = HistPair.first;
+      auto & boot = HistPair.second;
+      Common::ScaleBoot(boot,HistMap[sample],isUp,fXVarBins,fYVarBins);
+    }
   }
 
   // save totals to output file
@@ -117,10 +159,24 @@ void TreePlotter2D::MakeHistFromTrees(TFile *& inFile, TFile *& inSignalFile)
     const auto & hist = HistPair.second;
     hist->Write(hist->GetName(),TObject::kWriteDelete);
   }
+  for (const auto & HistPair : SystHistMap)
+  { 
+    const auto & hist = HistPair.second;
+    hist->Write(hist->GetName(),TObject::kWriteDelete);
+  }
+
+  // as are the bootstrap replicas
+  for (const auto & HistPair : BootHistMap)
+  { 
+    const auto & boot = HistPair.second;
+    boot->Write(boot->GetName(),TObject::kWriteDelete);
+  }
 }
 
 void TreePlotter2D::MakeDataOutput()
 {
+  PROFILE_SCOPE("TreePlotter2D::MakeDataOutput");
+
   std::cout << "Making Data Output..." << std::endl;
 
   // Make new data hist in case we are blinded
@@ -152,6 +208,8 @@ void TreePlotter2D::MakeDataOutput()
 
 void TreePlotter2D::MakeBkgdOutput()
 {
+  PROFILE_SCOPE("TreePlotter2D::MakeBkgdOutput");
+
   std::cout << "Making Bkgd Output..." << std::endl;
 
   // Extra Hists
@@ -185,6 +243,8 @@ void TreePlotter2D::MakeBkgdOutput()
 
 void TreePlotter2D::MakeRatioOutput()
 {
+  PROFILE_SCOPE("TreePlotter2D::MakeRatioOutput");
+
   std::cout << "Making Ratio Output..." << std::endl;
 
   // ratio value plot
@@ -205,6 +265,8 @@ void TreePlotter2D::MakeRatioOutput()
 
 void TreePlotter2D::MakeConfigPave()
 {
+  PROFILE_SCOPE("TreePlotter2D::MakeConfigPave");
+
   std::cout << "Dumping config to a pave..." << std::endl;
 
   // create the pave, copying in old info
@@ -227,6 +289,9 @@ void TreePlotter2D::MakeConfigPave()
   // store last bits of info
   Common::AddTextFromInputConfig(fConfigPave,"Miscellaneous Config",fMiscConfig);
 
+  // dump variations
+  if (fSystConfig != "") Common::AddTextFromInputConfig(fConfigPave,"Syst Config",fSystConfig);
+
   // padding
   Common::AddPaddingToPave(fConfigPave,3);
 
@@ -256,6 +321,12 @@ void TreePlotter2D::DeleteMemory(const Bool_t deleteInternal)
   delete BkgdHist;
   delete DataHist; 
 
+  for (auto & HistPair : SystHistMap) delete HistPair.second;
+  SystHistMap.clear();
+
+  for (auto & HistPair : BootHistMap) delete HistPair.second;
+  BootHistMap.clear();
+
   for (auto & HistPair : HistMap) delete HistPair.second;
   HistMap.clear();
 
@@ -274,6 +345,9 @@ void TreePlotter2D::SetupDefaults()
   fXVarBins = false;
   fYVarBins = false;
   fBlindData = false;
+  fSystConfig = "";
+  fNBoot = 0;
+  fBootSeed = 0;
 }
 
 void TreePlotter2D::SetupCommon()
@@ -426,6 +500,20 @@ void TreePlotter2D::SetupMiscConfig(const TString & miscconfig)
     {
       std::cout << "signals_only not currently implemented in 2D plotter, skipping..." << std::endl;
     }
+    else if (str.find("syst_config=") != std::string::npos)
+    {
+      fSystConfig = Common::RemoveDelim(str,"syst_config=");
+    }
+    else if (str.find("n_boot=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"n_boot=");
+      fNBoot = std::atoi(str.c_str());
+    }
+    else if (str.find("boot_seed=") != std::string::npos)
+    {
+      str = Common::RemoveDelim(str,"boot_seed=");
+      fBootSeed = std::strtoull(str.c_str(),NULL,10);
+    }
     else 
     {
       std::cerr << "Aye... your miscellaneous plot config is messed up, try again!" << std::endl;
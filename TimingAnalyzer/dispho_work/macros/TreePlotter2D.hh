@@ -22,6 +22,7 @@
 
 // Common include
 #include "Common.hh"
+#include "SystFiller.hh"
 
 class TreePlotter2D
 {
@@ -30,7 +31,7 @@ public:
   TreePlotter2D(const TString & infilename, const TString & insignalfilename, const TString & cutconfig,
 		const TString & varwgtmapconfig, const TString & plotconfig, const TString & miscconfig,
 		const TString & era, const TString & outfiletext);
-  ~TreePlotter2D() {}  
+  ~TreePlotter2D();
 
   // Initialize
   void SetupDefaults();
@@ -86,6 +87,9 @@ protected:
 
   // other plotting config
   Bool_t fBlindData;
+  TString fSystConfig;
+  UInt_t fNBoot;
+  ULong64_t fBootSeed;
 
   // Style
   TStyle * fTDRStyle;
@@ -93,6 +97,8 @@ protected:
   // Output
   TFile * fOutFile;
   std::map<TString,TH2F*> HistMap;
+  std::map<TString,TH2F*> SystHistMap;
+  std::map<TString,TH2F*> BootHistMap;
   TH2F * DataHist;
   TH2F * BkgdHist;
   TH2F * EWKHist;
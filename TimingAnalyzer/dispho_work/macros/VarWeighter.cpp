@@ -115,8 +115,8 @@ void VarWeighter::MakeWeightBranch(const TString & treename)
 {
   std::cout << "Working on adding weights for tree: " << treename.Data() << std::endl;
 
-  // make const ref
-  const auto & hist = HistMap["Ratio"];
+  // flatten ratio hist once for the loop
+  const HistLookup lookup(HistMap["Ratio"]);
 
   // get tree
   fSkimFile->cd();
@@ -140,7 +140,7 @@ void VarWeighter::MakeWeightBranch(const TString & treename)
     b_var->GetEntry(entry);
 
     // get weight from ratio hist
-    varwgt = hist->GetBinContent(hist->FindBin(var));
+    varwgt = lookup.Get(var);
   
     // fill single branch with weight
     b_varwgt->Fill();
@@ -20,6 +20,7 @@
 
 // Common include
 #include "Common.hh"
+#include "HistLookup.hh"
 
 class VarWeighter
 {
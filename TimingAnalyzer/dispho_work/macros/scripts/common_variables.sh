@@ -13,10 +13,13 @@ export reducedplotlist="reduced_analysis_plots"
 export crtosrconfigdir="crtosr_config"
 export cutconfigdir="cut_config"
 export fitconfigdir="fit_config"
+export genconfigdir="gen_config"
+export layoutconfigdir="layout_config"
 export miscconfigdir="misc_config"
 export plotconfigdir="plot_config"
 export rescaleconfigdir="rescale_config"
 export srplotconfigdir="srplot_config"
+export systconfigdir="syst_config"
 export varwgtconfigdir="varwgt_config"
 export fragdir="plot_config/fragments"
 
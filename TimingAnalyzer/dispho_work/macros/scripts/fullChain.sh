@@ -6,30 +6,124 @@ source scripts/common_variables.sh
 ## config
 outdir=${1:-"ntuples_v4/checks_v3/full_chain"}
 docleanup=${2:-"true"}
+usepipeline=${3:-"true"}
+njobs=${4:-$(nproc)}
+cachedir=${5:-"pipeline_cache"}
 
-## make signal efficiencies
-echo "Making Signal Efficiencies"
-./scripts/makeSignalEffs.sh "${outdir}/sig_effs"
+## derived config
+fulldir="${topdir}/${disphodir}/${outdir}"
+pipelineconfig="tmp_pipeline_config.${inTextExt}"
 
-## make Data/MC plots (no weights yet)
-echo "Making 1D Data/MC plots with no weights"
-./scripts/make1Dplots.sh "${outdir}/data_over_mc" "${reducedplotlist}" "false"
+## function to list skims of inputs
+function GetSkims ()
+{
+    local input
+    for input in "$@"
+    do
+	echo ${!input} | while read -r label infile insigfile sel varwgtmap
+	do
+	    echo -n " ${skimdir}/${infile}.root ${skimdir}/${insigfile}.root"
+	done
+    done
+}
 
-## make weights and related plots
-echo "Making variable event weights and plots"
-./scripts/makeWgtsAndPlots.sh "${outdir}/varwgts" "${docleanup}"
+## function to add a stage to the pipeline config
+function WriteStage ()
+{
+    local stage=${1}
+    local after=${2}
+    local inputs=${3}
+    local outputs=${4}
+    local command=${5}
+    local cache=${6:-"1"}
+    local inplace=${7:-""}
 
-## make SR plots
-echo "Making signal region plots"
-./scripts/makePlotsForSR.sh "${outdir}/srplots" "${reducedplotlist}" "${docleanup}"
+    echo "stage=${stage}" >> "${pipelineconfig}"
+    echo "after=${after}" >> "${pipelineconfig}"
+    echo "inputs=${inputs}" >> "${pipelineconfig}"
+    echo "outputs=${outputs}" >> "${pipelineconfig}"
+    echo "inplace=${inplace}" >> "${pipelineconfig}"
+    echo "cache=${cache}" >> "${pipelineconfig}"
+    echo "command=${command}" >> "${pipelineconfig}"
+}
 
-## make limit plots
-echo "Making limit plots"
-./scripts/makeAnalysis.sh "${outdir}/results" "${docleanup}"
+if [[ "${usepipeline}" == "true" ]]; then
+    ## common inputs
+    skims=$( GetSkims "${inputs[@]}" GJets QCD Signal )
+    configs="${cutconfigdir} ${plotconfigdir} ${miscconfigdir} $( echo ${varwgtconfigdir}/*.${inTextExt} )"
+    code="Common.cpp Common.hh SystFiller.cpp SystFiller.hh scripts"
+    limits="$( echo ${limitdir}/*.cpp ${limitdir}/*.hh ${limitdir}/*.C ) ${limitdir}/scripts ${limitdir}/cards ${limitdir}/limit_config ${limitdir}/signal_config"
+
+    ## reweighted CR skims, rewritten by VarWeighter
+    crskims=$( GetSkims GJets QCD | awk '{for (i = 1; i <= NF; i += 2) printf " %s", $i}' )
+
+    ## make the DAG
+    > "${pipelineconfig}"
+
+    WriteStage "sig_effs" "" \
+	"${skims} ${code} SigEffPlotter.cpp SigEffPlotter.hh" \
+	"${fulldir}/sig_effs" \
+	"./scripts/makeSignalEffs.sh ${outdir}/sig_effs"
+
+    WriteStage "data_over_mc" "" \
+	"${skims} ${configs} ${code} TreePlotter.cpp TreePlotter.hh" \
+	"${fulldir}/data_over_mc" \
+	"./scripts/make1Dplots.sh ${outdir}/data_over_mc ${reducedplotlist} false"
+
+    ## writes weights into the CR skims: after anything reading them without weights, and never restored from cache
+    WriteStage "varwgts" "data_over_mc" \
+	"${skims} ${configs} ${code} TreePlotter.cpp TreePlotter.hh CRtoSRPlotter.cpp CRtoSRPlotter.hh VarWeighter.cpp VarWeighter.hh" \
+	"${fulldir}/varwgts" \
+	"./scripts/makeWgtsAndPlots.sh ${outdir}/varwgts ${docleanup}" \
+	"0" "${crskims}"
+
+    WriteStage "srplots" "varwgts" \
+	"${skims} ${configs} ${srplotconfigdir}/${reducedplotlist}.${inTextExt} ${code} TreePlotter.cpp TreePlotter.hh SRPlotter.cpp SRPlotter.hh" \
+	"${fulldir}/srplots" \
+	"./scripts/makePlotsForSR.sh ${outdir}/srplots ${reducedplotlist} ${docleanup}"
+
+    WriteStage "results" "varwgts" \
+	"${skims} ${configs} ${code} TreePlotter2D.cpp TreePlotter2D.hh BinnedTemplateFit.cpp BinnedTemplateFit.hh Fitter.cpp Fitter.hh ${limits}" \
+	"${fulldir}/results" \
+	"./scripts/makeAnalysis.sh ${outdir}/results ${docleanup}"
+
+    ## run only what is stale, independent stages in parallel
+    echo "Running full chain as a pipeline"
+    ./scripts/runPipelineDriver.sh "${pipelineconfig}" "${cachedir}" "${njobs}"
+    status=$?
+
+    ## cleanup
+    rm "${pipelineconfig}"
+
+    if [[ ${status} != 0 ]]; then
+	echo "Pipeline failed, rerun to retry only failed stages"
+	exit ${status}
+    fi
+else
+    ## make signal efficiencies
+    echo "Making Signal Efficiencies"
+    ./scripts/makeSignalEffs.sh "${outdir}/sig_effs"
+
+    ## make Data/MC plots (no weights yet)
+    echo "Making 1D Data/MC plots with no weights"
+    ./scripts/make1Dplots.sh "${outdir}/data_over_mc" "${reducedplotlist}" "false"
+
+    ## make weights and related plots
+    echo "Making variable event weights and plots"
+    ./scripts/makeWgtsAndPlots.sh "${outdir}/varwgts" "${docleanup}"
+
+    ## make SR plots
+    echo "Making signal region plots"
+    ./scripts/makePlotsForSR.sh "${outdir}/srplots" "${reducedplotlist}" "${docleanup}"
+
+    ## make limit plots
+    echo "Making limit plots"
+    ./scripts/makeAnalysis.sh "${outdir}/results" "${docleanup}"
+fi
 
 ## final prep dir
 echo "Final prep outdir"
-PrepOutDir "${topdir}/${disphodir}/${outdir}"
+PrepOutDir "${fulldir}"
 
 ## all done
 echo "Finished full chain of analysis"
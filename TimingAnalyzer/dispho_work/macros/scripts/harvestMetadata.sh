@@ -0,0 +1,14 @@
+#!/bin/bash
+
+## config
+indir=${1}
+files=${2}
+manifest=${3}
+wgtfile=${4}
+puwgtfile=${5:-""}
+
+## run macro
+root -b -q -l harvestMetadata.C\(\"${indir}\",\"${files}\",\"${manifest}\",\"${wgtfile}\",\"${puwgtfile}\"\)
+
+## Final message
+echo "Finished HarvestingMetadata for:" ${files}
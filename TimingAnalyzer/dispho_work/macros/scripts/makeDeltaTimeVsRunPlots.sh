@@ -16,6 +16,7 @@ useshift=${3:-"false"}
 usesmear=${4:-"false"}
 triggertower=${5:-"Inclusive"}
 effseedE=${6:-0} # (15 for Zee, 30 for dixtal)
+usemonitor=${7:-"false"} # incremental: per-run sums kept in a store, only new skim entries read
 
 ## other info
 var="runno"
@@ -226,12 +227,19 @@ do
             ## extra outfile names
 	    outfile2D="deltaT_vs_${outfile}"
 	    timefile="timefit"
-
-	    ## run 2D plotter
-	    ./scripts/runTreePlotter2D.sh "${skimdir}/${infile}.root" "${skimdir}/${insigfile}.root" "${cut}" "${varwgtconfigdir}/${varwgtmap}.${inTextExt}" "${plot2D}" "${miscconfigdir}/${misc}.${inTextExt}" "${MainEra}" "${outfile2D}" "${outdir}"
-
-	    ## run fitter, getting 2D plots from before
-	    ./scripts/runTimeVsRunFitter.sh "${outfile2D}.root" "${plot2D}" "${timefit_config}" "${outfile}_${timefile}" "${outdir}"
+	    storefile="runstore" ## kept in place between calls
+
+	    if [[ "${usemonitor}" == "true" ]]
+	    then
+		## update the run store from the skim, refitting only changed runs
+		./scripts/runRunTimeMonitor.sh "${skimdir}/${infile}.root" "${cut}" "${plot2D}" "${timefit_config}" "${MainEra}" "${outfile}_${storefile}.root" "${outfile}_${timefile}" "${outdir}"
+	    else
+		## run 2D plotter
+		./scripts/runTreePlotter2D.sh "${skimdir}/${infile}.root" "${skimdir}/${insigfile}.root" "${cut}" "${varwgtconfigdir}/${varwgtmap}.${inTextExt}" "${plot2D}" "${miscconfigdir}/${misc}.${inTextExt}" "${MainEra}" "${outfile2D}" "${outdir}"
+
+		## run fitter, getting 2D plots from before
+		./scripts/runTimeVsRunFitter.sh "${outfile2D}.root" "${plot2D}" "${timefit_config}" "${outfile}_${timefile}" "${outdir}"
+	    fi
 	done ## read input
     done ## loop over inputs
 
@@ -13,6 +13,7 @@ source scripts/common_variables.sh
 outdir=${1:-"ntuples_v4/checks_v4/era_plots"}
 plot=${2:-"met_zoom"}
 usewgts=${3:-"true"}
+singlepass=${4:-"true"}
 
 ################
 ## Run Script ##
@@ -43,23 +44,31 @@ do
 	echo "in_file_text=${baseoutfile}" >> "${eraplotconfig}"
 	echo -n "eras=" >> "${eraplotconfig}"
 
+	## determine which misc file to use
+	misc=$( GetMisc ${input} ${plot} )
+
 	####################
 	## Loop Over Eras ##
 	####################
-	for era in "${eras[@]}"
-	do
-	    ## output filename
-	    outfile="${baseoutfile}_${era}"
-	    
-	    ## determine which misc file to use
-	    misc=$( GetMisc ${input} ${plot} )
+	if [[ "${singlepass}" == "true" ]]; then
+	    ## record all eras in config first
+	    echo " ${eras[@]}" >> "${eraplotconfig}"
+
+	    ## make plots for all eras in one pass over the trees
+	    ./scripts/runEraTreePlotter.sh "${skimdir}/${infile}.root" "${skimdir}/${insigfile}.root" "${cutconfigdir}/${sel}.${inTextExt}" "${varwgtconfigdir}/${varwgtmap}.${inTextExt}" "${plotconfigdir}/${plot}.${inTextExt}" "${miscconfigdir}/${misc}.${inTextExt}" "${eraplotconfig}" "${outdir}/${label}"
+	else
+	    for era in "${eras[@]}"
+	    do
+		## output filename
+		outfile="${baseoutfile}_${era}"
 
-	    ## make plot for each era
-	    ./scripts/runTreePlotter.sh "${skimdir}/${infile}.root" "${skimdir}/${insigfile}.root" "${cutconfigdir}/${sel}.${inTextExt}" "${varwgtconfigdir}/${varwgtmap}.${inTextExt}" "${plotconfigdir}/${plot}.${inTextExt}" "${miscconfigdir}/${misc}.${inTextExt}" "${outfile}" "${era}" "${outdir}/${label}"
+		## make plot for each era
+		./scripts/runTreePlotter.sh "${skimdir}/${infile}.root" "${skimdir}/${insigfile}.root" "${cutconfigdir}/${sel}.${inTextExt}" "${varwgtconfigdir}/${varwgtmap}.${inTextExt}" "${plotconfigdir}/${plot}.${inTextExt}" "${miscconfigdir}/${misc}.${inTextExt}" "${outfile}" "${era}" "${outdir}/${label}"
 
-	    ## record the era in config
-	    echo -n " ${era}" >> "${eraplotconfig}"
-	done
+		## record the era in config
+		echo -n " ${era}" >> "${eraplotconfig}"
+	    done
+	fi
 
 	##################
 	## Compare Eras ##
@@ -0,0 +1,18 @@
+#!/bin/bash
+
+## source first
+source scripts/common_variables.sh
+
+## config
+genconfig=${1:-"${genconfigdir}/data.${inTextExt}"}
+outfilename=${2:-"dispho.root"}
+
+## make output dir if needed
+outdir=$(dirname "${outfilename}")
+mkdir -p ${outdir}
+
+## generate ntuple
+root -l -b -q runDisPhoGenerator.C\(\"${genconfig}\",\"${outfilename}\"\)
+
+## Final message
+echo "Finished generating ntuple: ${outfilename}"
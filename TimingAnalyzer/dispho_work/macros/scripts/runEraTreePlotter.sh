@@ -0,0 +1,42 @@
+#!/bin/bash
+
+## source first
+source scripts/common_variables.sh
+
+## config
+infilename=${1:-"${skimdir}/sr.root"}
+insignalfilename=${2:-"${skimdir}signals_sr.root"}
+cutconfig=${3:-"${cutconfigdir}/always_true.${inTextExt}"}
+varwgtmapconfig=${4:-"${varwgtconfigdir}/empty.${inTextExt}"}
+plotconfig=${5:-"${plotconfigdir}/phopt_0.${inTextExt}"}
+miscconfig=${6:-"${miscconfigdir}/misc_blind.${inTextExt}"}
+eraplotconfig=${7:-"${plotconfigdir}/eras.${inTextExt}"}
+dir=${8:-"test"}
+
+## first make plots for all eras
+root -l -b -q runEraTreePlotter.C\(\"${infilename}\",\"${insignalfilename}\",\"${cutconfig}\",\"${varwgtmapconfig}\",\"${plotconfig}\",\"${miscconfig}\",\"${eraplotconfig}\"\)
+
+## make out dirs
+fulldir=${topdir}/${disphodir}/${dir}
+PrepOutDir ${fulldir}
+
+## read back outputs from era config
+infiletext=$( grep "in_file_text=" "${eraplotconfig}" | cut -d "=" -f 2 )
+eralist=$( grep "eras=" "${eraplotconfig}" | cut -d "=" -f 2 )
+
+## copy everything
+for era in ${eralist}
+do
+    outfiletext="${infiletext}_${era}"
+    for canvscale in "${canvscales[@]}"
+    do
+	for ext in "${exts[@]}"
+	do
+	    cp ${outfiletext}_${canvscale}.${ext} ${fulldir}
+	done
+    done
+    cp ${outfiletext}.root ${outfiletext}"_integrals".${outTextExt} ${fulldir}
+done
+
+## Final message
+echo "Finished EraTreePlotting for plot:" ${plotconfig}
@@ -10,9 +10,12 @@ inskimdir=${3:-"rereco_v4_metcorr"}
 outfiletext=${4:-"skim"}
 doskim=${5:-1}
 sampleconfig=${6:-""}
+listcachename=${7:-""} ## e.g. "${skimdir}/entrylist_cache.root": reuse selections from previous runs
+layoutconfig=${8:-""} ## e.g. "${layoutconfigdir}/standard.${inTextExt}": compression and baskets tuned for the downstream readers
+njobs=${9:-1} ## subsamples whose lists are made at once, with their files opened ahead; DISPHO_EOS_DIR=<dir> reads a local mirror of EOS
 
 ## produce slimmed skim
-root -l -b -q runFastSkimmer.C\(\"${cutflowconfig}\",\"${pdname}\",\"${inskimdir}\",\"${outfiletext}\",${doskim},\"${sampleconfig}\"\)
+root -l -b -q runFastSkimmer.C\(\"${cutflowconfig}\",\"${pdname}\",\"${inskimdir}\",\"${outfiletext}\",${doskim},\"${sampleconfig}\",\"${listcachename}\",\"${layoutconfig}\",${njobs}\)
 
 ## Final message
 echo "Finished FastSkimming"
@@ -0,0 +1,15 @@
+#!/bin/bash
+
+## config
+pipelineconfig=${1}
+cachedir=${2:-"pipeline_cache"}
+njobs=${3:-$(nproc)}
+
+## run macro
+mkdir -p "${cachedir}"
+root -b -q -l runPipelineDriver.C\(\"${pipelineconfig}\",\"${cachedir}\",${njobs}\)
+status=$?
+
+## Final message
+echo "Finished PipelineDriver for:" ${pipelineconfig}
+exit ${status}
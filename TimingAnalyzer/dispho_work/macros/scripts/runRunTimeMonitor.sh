@@ -0,0 +1,44 @@
+#!/bin/bash
+
+## source first
+source scripts/common_variables.sh
+
+## config
+infilename=${1:-"${skimdir}/sr.root"}
+cutconfig=${2:-"${cutconfigdir}/always_true.${inTextExt}"}
+plotconfig=${3:-"${plotconfigdir}/phopt_0.${inTextExt}"}
+timefitconfig=${4:-"time.${inTextExt}"}
+era=${5:-"Full"}
+storename=${6:-"runstore.root"}
+outfiletext=${7:-"plots"}
+dir=${8:-"test"}
+
+declare -a outputs=("mu" "sigma") ## can add back chi2prob, chi2ndf
+
+## update the per-run store with new skim entries only, refit changed runs, then make plots
+root -l -b -q runRunTimeMonitor.C\(\"${infilename}\",\"${cutconfig}\",\"${plotconfig}\",\"${timefitconfig}\",\"${era}\",\"${storename}\",\"${outfiletext}\"\)
+
+## make out dirs
+fulldir=${topdir}/${disphodir}/${dir}
+PrepOutDir ${fulldir}
+
+## copy everything
+for canvscale in "${canvscales[@]}"
+do
+    for ext in "${exts[@]}"
+    do
+	for output in "${outputs[@]}"
+	do
+	    if [[ "${canvscale}" == "log" ]] && [[ "${output}" == "mu" ]]
+	    then
+		continue ## do not produce logy plots for mu
+	    fi
+
+	    cp ${output}_${outfiletext}_${canvscale}.${ext} ${fulldir}
+	done
+    done
+done
+cp ${outfiletext}.root ${outfiletext}"_fitinfo".${outTextExt} ${fulldir}
+
+## Final message
+echo "Finished RunTimeMonitor for plot:" ${plotconfig}
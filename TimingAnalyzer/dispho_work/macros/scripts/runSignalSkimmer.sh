@@ -7,9 +7,10 @@ source scripts/common_variables.sh
 cutflowconfig=${1:-"${cutconfigdir}/one_at_a_time/signal.${inTextExt}"}
 inskimdir=${2:-"rereco_v4_metcorr"}
 outfiletext=${3:-"signal_skims"}
+listcachename=${4:-""} ## e.g. "${skimdir}/entrylist_cache.root": reuse selections from previous runs
 
 ## produce slimmed skims
-root -l -b -q runSignalSkimmer.C\(\"${cutflowconfig}\",\"${inskimdir}\",\"${outfiletext}\"\)
+root -l -b -q runSignalSkimmer.C\(\"${cutflowconfig}\",\"${inskimdir}\",\"${outfiletext}\",\"${listcachename}\"\)
 
 ## Final message
 echo "Finished SignalSkimming"
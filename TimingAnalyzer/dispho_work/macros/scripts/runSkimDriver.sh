@@ -0,0 +1,21 @@
+#!/bin/bash
+
+## config
+indir=${1}
+outdir=${2}
+files=${3}
+sumwgts=${4}
+skimtype=${5:-"Standard"}
+puwgtfilename=${6:-""}
+manifest=${7:-""}
+nworkers=${8:-$(nproc)}
+nretries=${9:-2}
+mergechunk=${10:-50}
+
+## run macro
+root -b -q -l runSkimDriver.C\(\"${indir}\",\"${outdir}\",\"${files}\",${sumwgts},\"${skimtype}\",\"${puwgtfilename}\",\"${manifest}\",${nworkers},${nretries},${mergechunk}\)
+status=$?
+
+## Final message
+echo "Finished SkimDriver for:" ${files}
+exit ${status}
@@ -7,9 +7,11 @@ filename=${3}
 sumwgts=${4}
 skimtype=${5:-"Standard"}
 puwgtfilename=${6:-""}
+manifest=${7:-""}
+layoutconfig=${8:-""} ## e.g. "layout_config/standard.txt": compression and baskets tuned for the downstream readers
 
 ## run macro
-root -b -q -l runSkimmer.C\(\"${indir}\",\"${outdir}\",\"${filename}\",${sumwgts},\"${skimtype}\",\"${puwgtfilename}\"\)
+root -b -q -l runSkimmer.C\(\"${indir}\",\"${outdir}\",\"${filename}\",${sumwgts},\"${skimtype}\",\"${puwgtfilename}\",\"${manifest}\",\"${layoutconfig}\"\)
 
 ## Final message
 echo "Finished Skimming for file:" ${filename}
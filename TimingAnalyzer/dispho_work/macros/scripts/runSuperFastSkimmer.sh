@@ -8,9 +8,11 @@ cutflowconfig=${1:-"${cutconfigdir}/one_at_a_time/signal.${inTextExt}"}
 infilename=${2:-"${skimdir}/signals.root"}
 issignalfile=${3:-1}
 outfiletext=${4:-"signal_skims"}
+listcachename=${5:-""} ## e.g. "${skimdir}/entrylist_cache.root": reuse selections from previous runs
+layoutconfig=${6:-""} ## e.g. "${layoutconfigdir}/standard.${inTextExt}": compression and baskets tuned for the downstream readers
 
 ## produce slimmed skims
-root -l -b -q runSuperFastSkimmer.C\(\"${cutflowconfig}\",\"${infilename}\",${issignalfile},\"${outfiletext}\"\)
+root -l -b -q runSuperFastSkimmer.C\(\"${cutflowconfig}\",\"${infilename}\",${issignalfile},\"${outfiletext}\",\"${listcachename}\",\"${layoutconfig}\"\)
 
 ## Final message
 echo "Finished SuperFastSkimming"
@@ -5,6 +5,8 @@ export eosbase="/eos/cms/store/user/${USER}/nTuples"
 export inbase="${eosbase}/unskimmed"
 export tmpbase="/tmp/${USER}"
 export outbase="${eosbase}/skims/2017/madv2_test_v1"
+export manifestbase="manifests"
+export nskimworkers=$(nproc)
 
 ## filenames
 export infiles="dispho_*.root"
@@ -16,6 +16,7 @@ skimtype=${6:-"Standard"}
 files="${text}_files.log"
 wgtfile="${text}_wgt.log"
 puwgtfile="${text}_puwgt.root"
+manifest="${manifestbase}/${text}_manifest.root"
 tmpfiles="tmp_${files}"
 timestamp=$(ls ${indir})
 eosdir="${indir}/${timestamp}/0000"
@@ -33,37 +34,29 @@ rm ${tmpfiles}
 echo "Making tmp dir"
 mkdir -p ${tmpdir}
 
-## produce sum of weights
-echo "Getting sum of weights"
-./scripts/computeSumWeights.sh ${eosdir} ${files} ${wgtfile}
-sumwgts=$(grep "Sum_of_weights: " ${wgtfile} | cut -d " " -f 2)
-
-## produce pu distribution
+## harvest sum of weights + pu distributions in one pass, only (re)opening new or changed files
+echo "Harvesting sum of weights and PU distributions"
+mkdir -p ${manifestbase}
 if (( ${usePUWeights} == 1 )) ; then
-    echo "Computing PU Weights"
-    ./scripts/computePUWeights.sh ${eosdir} ${files} ${puwgtfile}
+    ./scripts/harvestMetadata.sh ${eosdir} ${files} ${manifest} ${wgtfile} ${puwgtfile}
+else
+    ./scripts/harvestMetadata.sh ${eosdir} ${files} ${manifest} ${wgtfile}
 fi
+sumwgts=$(grep "Sum_of_weights: " ${wgtfile} | cut -d " " -f 2)
 
-## read in each file and skim
-echo "Running skimming macro"
-nfiles=$(wc -l ${files})
-counter="1"
-while IFS='' read -r line || [[ -n "${line}" ]]; do
-    echo "Working on file" ${counter} "out of" ${nfiles} "[filename: ${line}]"
-    ./scripts/runSkimmer.sh ${eosdir} ${tmpdir} ${line} ${sumwgts} ${skimtype} ${puwgtfile}
-    counter=$((${counter} + 1))
-done < "${files}"
+## skim every file over a pool of workers, merging as outputs come in: rerunning only redoes failed files
+echo "Running skim driver"
+./scripts/runSkimDriver.sh ${eosdir} ${tmpdir} ${files} ${sumwgts} ${skimtype} ${puwgtfile} ${manifest} ${nskimworkers}
+if (( $? != 0 )) ; then
+    echo "Skim driver had failures for: ${text}, rerun to resume... exiting"
+    exit 1
+fi
 
 ## remove log files
 echo "Removing log files"
 rm ${wgtfile}
 rm ${files}
 
-## Hadd on tmp 
-echo "Hadding skims on tmp and then removing individual skim files"
-hadd -O -k ${tmpdir}/${outfile} ${tmpdir}/${infiles}
-rm -rf ${tmpdir}/${infiles}
-
 ## Copy to EOS
 echo "Copying hadded skim to EOS"
 mkdir -p ${outdir}
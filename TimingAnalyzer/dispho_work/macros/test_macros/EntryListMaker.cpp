@@ -1,7 +1,8 @@
 #include "EntryListMaker.hh"
 
-EntryListMaker::EntryListMaker(const TString & cutflowconfig, const TString & filename, const TString & grouplabel)
-  : fCutFlowConfig(cutflowconfig), fFileName(filename), fGroupLabel(grouplabel)
+EntryListMaker::EntryListMaker(const TString & cutflowconfig, const TString & filename, const TString & grouplabel,
+			       const TString & listcachename)
+  : fCutFlowConfig(cutflowconfig), fFileName(filename), fGroupLabel(grouplabel), fListCache(listcachename)
 {
   std::cout << "Initializing EntryListMaker..." << std::endl;
 
@@ -56,6 +57,10 @@ void EntryListMaker::MakeListsFromTrees()
     std::map<TString,TEntryList*> listmap;
     EntryListMaker::InitListMap(listmap,name);
 
+    // key for cached lists, and the cuts applied so far
+    const auto treekey = fListCache.GetTreeKey(fFile,name);
+    TString chain = "";
+
     // loop over cut flow
     for (const auto & CutFlowPair : Common::CutFlowPairVec)
     {
@@ -72,8 +77,8 @@ void EntryListMaker::MakeListsFromTrees()
     
       std::cout << "Computing entries for cut: " << label.Data() << std::endl;
 
-      // use ttree::draw() to generate entry list
-      tree->Draw(Form(">>%s",list->GetName()),Form("%s",cut.Data()),"entrylist");
+      // use ttree::draw() to generate entry list, unless cached
+      fListCache.MakeList(tree,treekey,cut,list,chain);
 
       // recursively set entry list for input tree
       tree->SetEntryList(list);
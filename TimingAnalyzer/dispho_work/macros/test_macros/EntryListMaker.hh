@@ -19,11 +19,13 @@
 
 // Common include
 #include "Common.hh"
+#include "EntryListCache.hh"
 
 class EntryListMaker
 {
 public:
-  EntryListMaker(const TString & cutflowconfig, const TString & filename, const TString & grouplabel);
+  EntryListMaker(const TString & cutflowconfig, const TString & filename, const TString & grouplabel,
+		 const TString & listcachename = "");
   ~EntryListMaker();
 
   // Main call
@@ -44,6 +46,9 @@ private:
   const TString fFileName;
   const TString fGroupLabel;
 
+  // selections computed in previous runs
+  EntryListCache fListCache;
+
   // I/O
   TFile * fFile;
 
@@ -0,0 +1,153 @@
+#!/bin/bash
+
+## End-to-end throughput baseline on synthetic ntuples:
+## DisPhoGenerator -> Skimmer -> FastSkimmer (serial, then 4 workers) -> SignalSkimmer -> TimeAdjuster -> TreePlotter2D -> Fitter
+## Each stage appends "stage nevents wall_s events_per_s peakRSS_MB MBread" to ${benchdir}/bench.log.
+## A failing stage is logged as FAILED, the rest still run.
+## Run from the macros dir: ./test_macros/scripts/benchmarkChain.sh [benchdir] [nevents] [nsignalevents]
+
+source scripts/common_variables.sh
+
+## config
+benchdir=${1:-"${PWD}/bench"}
+nevents=${2:-100000}
+nsignalevents=${3:-2000}
+
+## derived
+gendir="${benchdir}/gen"
+skimsdir="${benchdir}/skims"
+configdir="${benchdir}/config"
+benchlog="${benchdir}/bench.log"
+stats="test_macros/benchStageStats.C"
+tree="tree/disphotree"
+
+mkdir -p ${gendir} ${skimsdir} ${configdir}
+rm -f ${benchlog}
+echo "$(printf '%-16s %12s %10s %12s %10s %10s' stage nevents wall_s events_per_s peakRSS_MB MBread)" > ${benchlog}
+
+## time now, for the stats macro
+function now
+{
+    date +%s.%N
+}
+
+## run one stage: name, inputs to count ("file:tree,..."), root macro call
+function runstage
+{
+    local stage=${1}
+    local inputs=${2}
+    local macro=${3}
+    local start=$(now)
+
+    root -l -b -q ${macro} ${stats}\(\"${stage}\",\"${inputs}\",\"${benchlog}\",${start}\) >> "${benchdir}/${stage}.${outTextExt}" 2>&1
+    if [[ $? -ne 0 ]] ; then
+	echo "$(printf '%-16s FAILED, see %s' ${stage} ${benchdir}/${stage}.${outTextExt})" >> ${benchlog}
+    fi
+}
+
+## compile everything once, so ACLiC is not part of the timing: in one session, helpers before the tools using them
+echo "Compiling macros"
+compile=""
+for macro in Common SampleManifest SkimLayout EntryListCache SystFiller BinnedTemplateFit DisPhoGenerator Skimmer FastSkimmer SignalSkimmer TimeAdjuster TreePlotter2D Fitter
+do
+    compile+="gSystem->CompileMacro(\"${macro}.cpp\",\"k\");"
+done
+root -l -b -q -e "${compile}" > /dev/null 2>&1
+
+## synthetic side inputs: PU weights, time adjustments, sample list
+root -l -b -q test_macros/makeSyntheticInputs.C\(\"${configdir}\"\)
+
+## generate + skim every sample FastSkimmer and SignalSkimmer will open
+skimfiles=""
+signalskimfiles=""
+seed=0
+while read -r input group lambda ctau
+do
+    seed=$((seed+1))
+    label=$(echo ${input} | tr '/' '_')
+
+    ## per sample gen config: later keys override earlier ones
+    genconfig="${configdir}/${label}.${inTextExt}"
+    cat "${genconfigdir}/${group}.${inTextExt}" > ${genconfig}
+    echo "seed=${seed}" >> ${genconfig}
+    if [[ "${group}" == "gmsb" ]] ; then
+	echo "n_events=${nsignalevents}" >> ${genconfig}
+	echo "llp_mass=${lambda}" >> ${genconfig}
+	echo "llp_ctau=${ctau}" >> ${genconfig}
+    else
+	echo "n_events=${nevents}" >> ${genconfig}
+    fi
+    ngen=$(grep "^n_events=" ${genconfig} | tail -n 1 | cut -d '=' -f 2)
+
+    ## generate
+    genfile="${gendir}/${label}.root"
+    runstage "gen_${label}" "${genfile}:${tree}" "runDisPhoGenerator.C(\"${genconfig}\",\"${genfile}\")"
+
+    ## skim: every generated event has genwgt = 1
+    outdir="${skimsdir}/${input}"
+    mkdir -p ${outdir}
+    puwgtfile=""
+    if [[ "${group}" != "data" ]] ; then
+	puwgtfile="${configdir}/puweights.root"
+    fi
+    runstage "skim_${label}" "${genfile}:${tree}" "runSkimmer.C(\"${gendir}\",\"${outdir}\",\"${label}.root\",${ngen},\"Standard\",\"${puwgtfile}\")"
+    mv "${outdir}/${label}.root" "${outdir}/tree.root" 2> /dev/null
+    if [[ "${group}" == "gmsb" ]] ; then
+	signalskimfiles+="${outdir}/tree.root:disphotree,"
+    else
+	skimfiles+="${outdir}/tree.root:disphotree,"
+    fi
+done < "${configdir}/samples.txt"
+
+## totals over the per sample stages
+function total
+{
+    local prefix=${1}
+    awk -v prefix="${prefix}" '$1 ~ "^"prefix && $2 != "FAILED" {n += $2; t += $3; if ($5 > m) m = $5; r += $6}
+    END {printf "%-16s %12d %10.2f %12.1f %10.1f %10.1f\n", prefix"total", n, t, (t > 0 ? n/t : 0), m, r}' ${benchlog} >> ${benchlog}
+}
+total "gen_"
+total "skim_"
+
+## merged SR skims
+srfile="${benchdir}/sr"
+signalsrfile="${benchdir}/signals_sr"
+rm -f ${srfile}.root ${signalsrfile}.root
+
+runstage "fastskim" "${skimfiles%,}" "runFastSkimmer.C(\"${cutconfigdir}/always_true_cutflow.${inTextExt}\",\"SinglePhoton\",\"${skimsdir}\",\"${srfile}\")"
+
+## same skim with 4 workers, reading the skims as if from EOS: a local mirror of Common::eosDir/baseDir
+eosmirror="${benchdir}/eos"
+mkdir -p ${eosmirror}/skims/2017
+ln -sfn ${skimsdir} ${eosmirror}/skims/2017/bench
+rm -f ${srfile}_mt.root
+DISPHO_EOS_DIR=${eosmirror} runstage "fastskim_mt" "${skimfiles%,}" "runFastSkimmer.C(\"${cutconfigdir}/always_true_cutflow.${inTextExt}\",\"SinglePhoton\",\"bench\",\"${srfile}_mt\",1,\"\",\"\",\"\",4)"
+
+runstage "signalskim" "${signalskimfiles%,}" "runSignalSkimmer.C(\"${cutconfigdir}/always_true_cutflow.${inTextExt}\",\"${skimsdir}\",\"${signalsrfile}\")"
+
+## time corrections, in place
+runstage "timeadjust" "${srfile}.root:Data_Tree" "runTimeAdjuster.C(\"${srfile}.root\",\"${signalsrfile}.root\",\"${configdir}/timeadjust.${inTextExt}\",\"phoE\",\"${base_time_var}\",1,1)"
+
+## 2D hists
+plotfile="${benchdir}/met_vs_time"
+rm -f ${plotfile}.root
+runstage "treeplot2D" "${srfile}.root:Data_Tree" "runTreePlotter2D.C(\"${srfile}.root\",\"${signalsrfile}.root\",\"${cutconfigdir}/always_true.${inTextExt}\",\"${varwgtconfigdir}/empty.${inTextExt}\",\"${plotconfigdir}/met_vs_time.${inTextExt}\",\"${miscconfigdir}/empty.${inTextExt}\",\"${MainEra}\",\"${plotfile}\")"
+
+## fit: SR hists stand in for the CRs, which need the GJets/QCD samples of the real analysis
+fitconfig="${configdir}/fit.${inTextExt}"
+cat > ${fitconfig} <<EOF
+CR_GJets_in=${plotfile}.root
+CR_QCD_in=${plotfile}.root
+SR_in=${plotfile}.root
+plot_config=${plotconfigdir}/met_vs_time.${inTextExt}
+era=${MainEra}
+fit_engine=native
+make_ws=0
+do_fits=1
+n_fits=10
+EOF
+runstage "fit" "" "runFitter.C(\"${fitconfig}\",\"${miscconfigdir}/empty.${inTextExt}\",\"${benchdir}/fit\")"
+
+## Final message
+cat ${benchlog}
+echo "Finished benchmarking the chain in: ${benchdir}"
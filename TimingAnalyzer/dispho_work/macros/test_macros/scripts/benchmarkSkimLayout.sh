@@ -0,0 +1,26 @@
+#!/bin/bash
+
+## Write cost, file size and read throughput of ROOT's default layout and of every layout config, on copies of one skim tree.
+## Results in ${benchdir}/layout_bench.log.
+## Run from the macros dir: ./test_macros/scripts/benchmarkSkimLayout.sh [infile] [tree] [benchdir] [readbranches]
+
+source scripts/common_variables.sh
+
+## config
+infile=${1:-"${skimdir}/sr.root"}
+tree=${2:-"Data_Tree"}
+benchdir=${3:-"${PWD}/bench_layout"}
+readbranches=${4:-"evtwgt phoseedtime_0 t1pfMETpt phoE_0 phoisEB_0"} ## what the plotters and the time adjuster read
+
+## candidates
+candidates="default"
+for layoutconfig in ${layoutconfigdir}/*.${inTextExt}
+do
+    candidates+=",${layoutconfig}"
+done
+
+mkdir -p ${benchdir}
+root -l -b -q test_macros/benchSkimLayout.C\(\"${infile}\",\"${tree}\",\"${candidates}\",\"${readbranches}\",\"${benchdir}\"\)
+
+## Final message
+echo "Finished benchmarking skim layouts in: ${benchdir}"
@@ -3,6 +3,7 @@
 cutflowconfig=${1:-"cut_config/one_at_a_time/control_qcd.txt"}
 filename=${2:-"skims/std_qcd.root"}
 grouplabel=${3:-"QCD_Flow"}
+listcachename=${4:-""} ## reuse selections from previous runs
 
 ## produce entrylists
-root -l -b -q runEntryListMaker.C\(\"${cutflowconfig}\",\"${filename}\",\"${grouplabel}\"\)
+root -l -b -q runEntryListMaker.C\(\"${cutflowconfig}\",\"${filename}\",\"${grouplabel}\",\"${listcachename}\"\)
@@ -1,6 +1,7 @@
 #include "../interface/Analysis.hh"
 #include "../interface/AnalysisUtils.hh"
 #include "TROOT.h"
+#include "TSystem.h"
 
 #include <algorithm>
 
@@ -67,13 +68,19 @@ Analysis::Analysis(const TString & sample, const Bool_t isMC) : fSample(sample),
     // end getting pile-up weights
   }  
 
-  // just do this everytime, who cares
-  fTH1Dump.open(Form("%s/%i/%s", Config::outdir.Data(), Config::year, Config::plotdumpname.Data()),std::ios_base::trunc);
-  fTH1PhoDump.open(Form("%s/%i/%s", Config::outdir.Data(), Config::year, Config::phoplotdumpname.Data()),std::ios_base::trunc);
+  // just do this everytime, who cares: written under a per-process name, and moved in place when closed,
+  // so samples analyzed concurrently never interleave writes to the same file
+  fTH1DumpName    = Form("%s/%i/%s", Config::outdir.Data(), Config::year, Config::plotdumpname.Data());
+  fTH1PhoDumpName = Form("%s/%i/%s", Config::outdir.Data(), Config::year, Config::phoplotdumpname.Data());
+  fTEffDumpName   = Form("%s/%i/%s", Config::outdir.Data(), Config::year, Config::effdumpname.Data());
+  fTmpExt = Form(".%i",gSystem->GetPid());
+
+  fTH1Dump.open((fTH1DumpName+fTmpExt).Data(),std::ios_base::trunc);
+  fTH1PhoDump.open((fTH1PhoDumpName+fTmpExt).Data(),std::ios_base::trunc);
 
   if (Config::doPhoEff)
   {
-    fTEffDump.open(Form("%s/%i/%s", Config::outdir.Data(), Config::year, Config::effdumpname.Data()),std::ios_base::trunc);
+    fTEffDump.open((fTEffDumpName+fTmpExt).Data(),std::ios_base::trunc);
   }
 }
 
@@ -84,9 +91,15 @@ Analysis::~Analysis()
   delete fOutFile;
 
   fTH1Dump.close();
+  gSystem->Rename((fTH1DumpName+fTmpExt).Data(),fTH1DumpName.Data());
   fTH1PhoDump.close();
+  gSystem->Rename((fTH1PhoDumpName+fTmpExt).Data(),fTH1PhoDumpName.Data());
 
-  if (Config::doPhoEff) fTEffDump.close();
+  if (Config::doPhoEff) 
+  {
+    fTEffDump.close();
+    gSystem->Rename((fTEffDumpName+fTmpExt).Data(),fTEffDumpName.Data());
+  }
 }
 
 void Analysis::EventLoop()
@@ -98,13 +111,17 @@ void Analysis::EventLoop()
   if (Config::doIsoNvtx)  Analysis::SetupIsoNvtxPlots();
   if (Config::doIsoPt)    Analysis::SetupIsoPtPlots();
   if (Config::doPhoEff)   Analysis::SetupPhotonEffPlots();
+  Analysis::SetupFillHandles();
+
+  // only the branches of the enabled plots
+  Analysis::SetupBranchGroups();
 
   // do loop over events, filling histos
   const UInt_t nEntries = (Config::doDemo?Config::demoNum:fInTree->GetEntries());
   for (UInt_t entry = 0; entry < nEntries; entry++)
   {
     // read in tree
-    fInTree->GetEntry(entry);
+    fBranches.GetEntry(entry);
 
     // dump status check
     if (entry%Config::nEvCheck == 0 || entry == 0) std::cout << "Processing Entry: " << entry << " out of " << nEntries << std::endl;
@@ -133,6 +150,7 @@ void Analysis::EventLoop()
     if (Config::doIsoPt)    Analysis::FillIsoPtPlots(Nphotons,eff_weight);
     if (Config::doPhoEff)   Analysis::FillPhotonEffPlots(Nphotons,eff_weight);
   } // end loop over events
+  fBranches.Report();
 
    // output hists
   if (Config::doEvStd)    Analysis::OutputEventStandardPlots();
@@ -183,6 +201,51 @@ Bool_t Analysis::PassOOTID(const Pho & pho)
   return true;
 }
 
+void Analysis::SetupBranchGroups()
+{
+  fBranches.SetTree(fInTree);
+
+  // weights, object counts, and what IsGoodPho() and the GED/OOT, EB/EE splits need
+  std::vector<TString> event = {"nphotons","njets","phopt_*","phoisOOT_*","phoisEB_*"};
+  if (fIsMC)
+  {
+    event.emplace_back("genwgt");
+    event.emplace_back("phoisGen_*");
+  }
+  fBranches.Declare("event",event);
+  fBranches.Enable("event");
+
+  // plot groups
+  fBranches.Declare("evstd",{"nvtx","rho"});
+
+  std::vector<TString> phostd = {"phophi_*","phoeta_*","phoHoE_*","phor9_*","phosieie_*","phosieip_*","phosipip_*","phosmaj_*","phosmin_*"};
+  if (Config::readRecHits) phostd.emplace_back("phoseed_*");
+  else
+  {
+    phostd.emplace_back("phoseedtime_*");
+    phostd.emplace_back("phoseedID_*");
+  }
+  fBranches.Declare("phostd",phostd);
+
+  fBranches.Declare("iso",{"rho","phosceta_*","phoChgHadIso_*","phoNeuHadIso_*","phoPhoIso_*","phoEcalPFClIso_*","phoHcalPFClIso_*","phoTrkIso_*"});
+  fBranches.Declare("isonvtx",{"nvtx","phoEcalPFClIso_*","phoHcalPFClIso_*","phoTrkIso_*"});
+  fBranches.Declare("isopt",{"phoChgHadIso_*","phoNeuHadIso_*","phoPhoIso_*","phoEcalPFClIso_*","phoHcalPFClIso_*","phoTrkIso_*"});
+  fBranches.Declare("phoeff",{"rho","phoeta_*","phophi_*","phoHoE_*","phosieie_*","phoEcalPFClIso_*","phoHcalPFClIso_*","phoTrkIso_*"});
+
+  // all rec hit times, only read once a good photon with a seed needs one
+  fBranches.Declare("rechits",{"rhtime"},true);
+
+  fBranches.Enable("evstd"  ,Config::doEvStd);
+  fBranches.Enable("phostd" ,Config::doPhoStd);
+  fBranches.Enable("iso"    ,Config::doIso);
+  fBranches.Enable("isonvtx",Config::doIsoNvtx);
+  fBranches.Enable("isopt"  ,Config::doIsoPt);
+  fBranches.Enable("phoeff" ,Config::doPhoEff);
+  fBranches.Enable("rechits",Config::doPhoStd && Config::readRecHits);
+
+  fBranches.Activate();
+}
+
 void Analysis::SetupEventStandardPlots()
 {
   // event based variables
@@ -350,10 +413,81 @@ void Analysis::SetupPhotonEffPlots()
   } // end loop over nphotons
 }
 
+void Analysis::SetupFillHandles()
+{
+  // names resolved here once: the fill functions only index the registries
+  fNvtxHandle    = fTH1s.Declare("nvtx");
+  fRhoNvtxHandle = fTH2s.Declare("rho_v_nvtx");
+
+  // same order as GetPhoSlot()
+  fPhoHandles.clear();
+  for (Int_t ipho = 0; ipho < Config::nPhotons; ipho++)
+  {
+    for (const auto & region : Config::regions)
+    {
+      for (const auto & split : Config::splits)
+      {
+	const TString name = Form("%i_%s_%s",ipho,region.Data(),split.Data());
+
+	fPhoHandles.emplace_back();
+	auto & handles = fPhoHandles.back();
+	handles.pt       = fTH1s.Declare("phopt_"+name);
+	handles.phi      = fTH1s.Declare("phophi_"+name);
+	handles.eta      = fTH1s.Declare("phoeta_"+name);
+	handles.hoe      = fTH1s.Declare("phohoe_"+name);
+	handles.r9       = fTH1s.Declare("phor9_"+name);
+	handles.sieie    = fTH1s.Declare("phosieie_"+name);
+	handles.sieip    = fTH1s.Declare("phosieip_"+name);
+	handles.sipip    = fTH1s.Declare("phosipip_"+name);
+	handles.smaj     = fTH1s.Declare("phosmaj_"+name);
+	handles.smin     = fTH1s.Declare("phosmin_"+name);
+	handles.seedtime = fTH1s.Declare("phoseedtime_"+name);
+
+	handles.chgiso  = fTH1s.Declare("phochgiso_"+name);
+	handles.neuiso  = fTH1s.Declare("phoneuiso_"+name);
+	handles.phoiso  = fTH1s.Declare("phophoiso_"+name);
+	handles.ecaliso = fTH1s.Declare("phoecaliso_"+name);
+	handles.hcaliso = fTH1s.Declare("phohcaliso_"+name);
+	handles.trkiso  = fTH1s.Declare("photrkiso_"+name);
+
+	handles.ecaliso_v_nvtx = fTH2s.Declare("phoecaliso_"+name+"_v_nvtx");
+	handles.hcaliso_v_nvtx = fTH2s.Declare("phohcaliso_"+name+"_v_nvtx");
+	handles.trkiso_v_nvtx  = fTH2s.Declare("photrkiso_"+name+"_v_nvtx");
+
+	handles.chgiso_v_pt  = fTH2s.Declare("phochgiso_"+name+"_v_pt");
+	handles.neuiso_v_pt  = fTH2s.Declare("phoneuiso_"+name+"_v_pt");
+	handles.phoiso_v_pt  = fTH2s.Declare("phophoiso_"+name+"_v_pt");
+	handles.ecaliso_v_pt = fTH2s.Declare("phoecaliso_"+name+"_v_pt");
+	handles.hcaliso_v_pt = fTH2s.Declare("phohcaliso_"+name+"_v_pt");
+	handles.trkiso_v_pt  = fTH2s.Declare("photrkiso_"+name+"_v_pt");
+
+	handles.effpt  = fTEffs.Declare("effpt_"+name);
+	handles.effeta = fTEffs.Declare("effeta_"+name);
+	handles.effphi = fTEffs.Declare("effphi_"+name);
+      } // end loop over split by type or inclusive
+    } // end loop over regions
+  } // end loop over nphotons
+
+  // plots not set up stay NULL: their fill functions are not called
+  fTH1s.Bind(stdevTH1Map);
+  fTH1s.Bind(stdphoTH1Map);
+  fTH1s.Bind(isoTH1Map);
+  fTH2s.Bind(stdevTH2Map);
+  fTH2s.Bind(isonvtxTH2Map);
+  fTH2s.Bind(isoptTH2Map);
+  fTEffs.Bind(phoTEffMap);
+}
+
+UInt_t Analysis::GetPhoSlot(const Int_t ipho, const Pho & pho)
+{
+  // photon index, then Config::regions (EB,EE), then Config::splits (GED,OOT)
+  return (ipho * Config::regions.size() + (pho.isEB ? 0 : 1)) * Config::splits.size() + (!pho.isOOT ? 0 : 1);
+}
+
 void Analysis::FillEventStandardPlots(const Float_t weight)
 {
-  stdevTH1Map["nvtx"]->Fill(nvtx,weight);
-  stdevTH2Map["rho_v_nvtx"]->Fill(nvtx,rho,weight);
+  fTH1s.Fill(fNvtxHandle,nvtx,weight);
+  fTH2s.Fill(fRhoNvtxHandle,nvtx,rho,weight);
 }
 
 void Analysis::FillPhotonStandardPlots(const Int_t Nphotons, const Float_t weight)
@@ -363,33 +497,36 @@ void Analysis::FillPhotonStandardPlots(const Int_t Nphotons, const Float_t weigh
   {
     const auto & pho = phos[ipho];
     const Int_t iPho = (!pho.isOOT ? iged++ : ioot++);
-    const TString name = Form("%i_%s_%s", (Config::splitPho ? iPho : ipho), (pho.isEB ? "EB" : "EE"), (!pho.isOOT ? "GED" : "OOT"));
+    const UInt_t islot = Analysis::GetPhoSlot((Config::splitPho ? iPho : ipho),pho);
 
     if (!Analysis::IsGoodPho(pho)) continue;
-
-    stdphoTH1Map[Form("phopt_%s",name.Data())]->Fill(pho.pt,weight);
-    stdphoTH1Map[Form("phophi_%s",name.Data())]->Fill(pho.phi,weight);
-    stdphoTH1Map[Form("phoeta_%s",name.Data())]->Fill(pho.eta,weight);
-    stdphoTH1Map[Form("phohoe_%s",name.Data())]->Fill(pho.HoE,weight);
-    stdphoTH1Map[Form("phor9_%s",name.Data())]->Fill(pho.r9,weight); 
-    stdphoTH1Map[Form("phosieie_%s",name.Data())]->Fill(pho.sieie,weight);
-    stdphoTH1Map[Form("phosieip_%s",name.Data())]->Fill(pho.sipip,weight);
-    stdphoTH1Map[Form("phosipip_%s",name.Data())]->Fill(pho.sieip,weight);
-    stdphoTH1Map[Form("phosmaj_%s",name.Data())]->Fill(pho.smaj,weight);
-    stdphoTH1Map[Form("phosmin_%s",name.Data())]->Fill(pho.smin,weight);
+    if (islot >= fPhoHandles.size()) continue;
+    const auto & handles = fPhoHandles[islot];
+
+    fTH1s.Fill(handles.pt,pho.pt,weight);
+    fTH1s.Fill(handles.phi,pho.phi,weight);
+    fTH1s.Fill(handles.eta,pho.eta,weight);
+    fTH1s.Fill(handles.hoe,pho.HoE,weight);
+    fTH1s.Fill(handles.r9,pho.r9,weight); 
+    fTH1s.Fill(handles.sieie,pho.sieie,weight);
+    fTH1s.Fill(handles.sieip,pho.sipip,weight);
+    fTH1s.Fill(handles.sipip,pho.sieip,weight);
+    fTH1s.Fill(handles.smaj,pho.smaj,weight);
+    fTH1s.Fill(handles.smin,pho.smin,weight);
 
     if (Config::readRecHits)
     {
       if (pho.seed >= 0)
       { 
-	stdphoTH1Map[Form("phoseedtime_%s",name.Data())]->Fill((*rhtime)[pho.seed],weight);
+	fBranches.Load("rechits");
+	fTH1s.Fill(handles.seedtime,(*rhtime)[pho.seed],weight);
       } // end check over seed
     }
     else
     {
       if (pho.seedID > 0) // and imperfect check
       { 
-	stdphoTH1Map[Form("phoseedtime_%s",name.Data())]->Fill(pho.seedtime,weight);
+	fTH1s.Fill(handles.seedtime,pho.seedtime,weight);
       } // end check over seed
     }
   } // end loop over nphotons
@@ -402,9 +539,11 @@ void Analysis::FillIsoPlots(const Int_t Nphotons, const Float_t weight)
   {
     const auto & pho = phos[ipho];
     const Int_t iPho = (!pho.isOOT ? iged++ : ioot++);
-    const TString name = Form("%i_%s_%s", (Config::splitPho ? iPho : ipho), (pho.isEB ? "EB" : "EE"), (!pho.isOOT ? "GED" : "OOT"));
+    const UInt_t islot = Analysis::GetPhoSlot((Config::splitPho ? iPho : ipho),pho);
 
     if (!Analysis::IsGoodPho(pho)) continue;
+    if (islot >= fPhoHandles.size()) continue;
+    const auto & handles = fPhoHandles[islot];
 
     const float abseta = std::abs(pho.sceta);
     
@@ -428,12 +567,12 @@ void Analysis::FillIsoPlots(const Int_t Nphotons, const Float_t weight)
     hcalPFClIso = (Config::detIsoPt ? std::max(hcalPFClIso - GetHcalPFClPt(pho.isEB,pho.pt),0.f) : hcalPFClIso);
     trkIso      = (Config::detIsoPt ? std::max(trkIso      - GetTrackPt   (pho.isEB,pho.pt),0.f) : trkIso);
 
-    isoTH1Map[Form("phochgiso_%s",name.Data())]->Fill(chgHadIso,weight);
-    isoTH1Map[Form("phoneuiso_%s",name.Data())]->Fill(neuHadIso,weight);
-    isoTH1Map[Form("phophoiso_%s",name.Data())]->Fill(phoIso,weight);
-    isoTH1Map[Form("phoecaliso_%s",name.Data())]->Fill(ecalPFClIso,weight);
-    isoTH1Map[Form("phohcaliso_%s",name.Data())]->Fill(hcalPFClIso,weight);
-    isoTH1Map[Form("photrkiso_%s",name.Data())]->Fill(trkIso,weight);
+    fTH1s.Fill(handles.chgiso,chgHadIso,weight);
+    fTH1s.Fill(handles.neuiso,neuHadIso,weight);
+    fTH1s.Fill(handles.phoiso,phoIso,weight);
+    fTH1s.Fill(handles.ecaliso,ecalPFClIso,weight);
+    fTH1s.Fill(handles.hcaliso,hcalPFClIso,weight);
+    fTH1s.Fill(handles.trkiso,trkIso,weight);
   } // end loop over photons
 }
 
@@ -444,11 +583,14 @@ void Analysis::FillIsoNvtxPlots(const Int_t Nphotons, const Float_t weight)
   {
     const auto & pho = phos[ipho];
     const Int_t iPho = (!pho.isOOT ? iged++ : ioot++);
-    const TString name = Form("%i_%s_%s_v_nvtx", (Config::splitPho ? iPho : ipho), (pho.isEB ? "EB" : "EE"), (!pho.isOOT ? "GED" : "OOT"));
+    const UInt_t islot = Analysis::GetPhoSlot((Config::splitPho ? iPho : ipho),pho);
+
+    if (islot >= fPhoHandles.size()) continue;
+    const auto & handles = fPhoHandles[islot];
 
-    isonvtxTH2Map[Form("phoecaliso_%s",name.Data())]->Fill(nvtx,pho.EcalPFClIso,weight);
-    isonvtxTH2Map[Form("phohcaliso_%s",name.Data())]->Fill(nvtx,pho.HcalPFClIso,weight);
-    isonvtxTH2Map[Form("photrkiso_%s",name.Data())]->Fill(nvtx,pho.TrkIso,weight);    
+    fTH2s.Fill(handles.ecaliso_v_nvtx,nvtx,pho.EcalPFClIso,weight);
+    fTH2s.Fill(handles.hcaliso_v_nvtx,nvtx,pho.HcalPFClIso,weight);
+    fTH2s.Fill(handles.trkiso_v_nvtx,nvtx,pho.TrkIso,weight);    
   } // end loop over nphotons
 }      
 
@@ -459,7 +601,10 @@ void Analysis::FillIsoPtPlots(const Int_t Nphotons, const Float_t weight)
   {
     const auto & pho = phos[ipho];
     const Int_t iPho = (!pho.isOOT ? iged++ : ioot++);
-    const TString name = Form("%i_%s_%s_v_pt", (Config::splitPho ? iPho : ipho), (pho.isEB ? "EB" : "EE"), (!pho.isOOT ? "GED" : "OOT"));
+    const UInt_t islot = Analysis::GetPhoSlot((Config::splitPho ? iPho : ipho),pho);
+
+    if (islot >= fPhoHandles.size()) continue;
+    const auto & handles = fPhoHandles[islot];
     
 //     const float abseta = std::abs(pho.sceta);
 
@@ -479,13 +624,13 @@ void Analysis::FillIsoPtPlots(const Int_t Nphotons, const Float_t weight)
     const float hcalPFClIso = pho.HcalPFClIso;
     const float trkIso      = pho.TrkIso;
 
-    isoptTH2Map[Form("phochgiso_%s",name.Data())]->Fill(pho.pt,chgHadIso,weight);
-    isoptTH2Map[Form("phoneuiso_%s",name.Data())]->Fill(pho.pt,neuHadIso,weight);
-    isoptTH2Map[Form("phophoiso_%s",name.Data())]->Fill(pho.pt,phoIso,weight);    
+    fTH2s.Fill(handles.chgiso_v_pt,pho.pt,chgHadIso,weight);
+    fTH2s.Fill(handles.neuiso_v_pt,pho.pt,neuHadIso,weight);
+    fTH2s.Fill(handles.phoiso_v_pt,pho.pt,phoIso,weight);    
 
-    isoptTH2Map[Form("phoecaliso_%s",name.Data())]->Fill(pho.pt,ecalPFClIso,weight);
-    isoptTH2Map[Form("phohcaliso_%s",name.Data())]->Fill(pho.pt,hcalPFClIso,weight);
-    isoptTH2Map[Form("photrkiso_%s",name.Data())]->Fill(pho.pt,trkIso,weight);    
+    fTH2s.Fill(handles.ecaliso_v_pt,pho.pt,ecalPFClIso,weight);
+    fTH2s.Fill(handles.hcaliso_v_pt,pho.pt,hcalPFClIso,weight);
+    fTH2s.Fill(handles.trkiso_v_pt,pho.pt,trkIso,weight);    
   } // end loop over nphotons
 }      
 
@@ -496,14 +641,16 @@ void Analysis::FillPhotonEffPlots(const Int_t Nphotons, const Float_t weight)
   {
     const auto & pho = phos[ipho];
     const Int_t iPho = (!pho.isOOT ? iged++ : ioot++);
-    const TString name = Form("%i_%s_%s", (Config::splitPho ? iPho : ipho), (pho.isEB ? "EB" : "EE"), (!pho.isOOT ? "GED" : "OOT"));
+    const UInt_t islot = Analysis::GetPhoSlot((Config::splitPho ? iPho : ipho),pho);
     
     if (!Analysis::IsGoodPho(pho)) continue;
+    if (islot >= fPhoHandles.size()) continue;
+    const auto & handles = fPhoHandles[islot];
     const Bool_t passed = Analysis::PassOOTID(pho);
 
-    phoTEffMap[Form("effpt_%s",name.Data())]->FillWeighted(passed,weight,pho.pt);
-    phoTEffMap[Form("effeta_%s",name.Data())]->FillWeighted(passed,weight,pho.eta);
-    phoTEffMap[Form("effphi_%s",name.Data())]->FillWeighted(passed,weight,pho.phi);
+    fTEffs[handles.effpt]->FillWeighted(passed,weight,pho.pt);
+    fTEffs[handles.effeta]->FillWeighted(passed,weight,pho.eta);
+    fTEffs[handles.effphi]->FillWeighted(passed,weight,pho.phi);
   }
 }
 
@@ -937,30 +1084,35 @@ void Analysis::MakeInclusiveSplitTEffs(TEffMap & teffmap, TStrMap & subdirmap)
 
 void Analysis::Make1DFrom2DPlots(const TH2F * hist2d, const TString & subdir2d, const TString & name)
 {
-  TH1Map th1dmap; TStrMap th1dsubmap; TStrIntMap th1dbinmap;
-  Analysis::Project2Dto1D(hist2d,subdir2d,th1dmap,th1dsubmap,th1dbinmap);
+  // quantiles and means of all x bins at once, from the 2D bin contents
   const TString hname = hist2d->GetName();
+  const Float_t qprob = Analysis::GetQuantProb(hname);
+  const auto columns  = ColumnStats::Compute(hist2d,qprob);
+
   if ( (Config::useMeanIso && (name.Contains("pho") && name.Contains("nvtx"))) ||
        (Config::useMeanRho && name.Contains("rho")) ||
        (Config::useMeanPt  && name.Contains("pt")) )
   {
-    Analysis::ProduceMeanHist(hist2d,subdir2d,th1dmap,th1dbinmap);
+    Analysis::ProduceMeanHist(hist2d,subdir2d,columns);
   }
   else 
   {
-    Analysis::ProduceQuantile(hist2d,subdir2d,th1dmap,th1dbinmap);
+    Analysis::ProduceQuantile(hist2d,subdir2d,qprob,columns);
   }
 
-  // store temp projected Hists?
+  // store temp projected Hists? only then are they made
   if (Config::saveTempHists) 
   {
+    TH1Map th1dmap; TStrMap th1dsubmap; TStrIntMap th1dbinmap;
+    Analysis::Project2Dto1D(hist2d,subdir2d,th1dmap,th1dsubmap,th1dbinmap);
+
     Analysis::SaveTH1s(th1dmap,th1dsubmap);
     Analysis::DumpTH1Names(th1dmap,th1dsubmap);
     Analysis::DumpTH1PhoNames(th1dmap,th1dsubmap);
-  }
 
-  // delete temporaries
-  Analysis::DeleteTH1s(th1dmap);
+    // delete temporaries
+    Analysis::DeleteTH1s(th1dmap);
+  }
 }
 
 void Analysis::Project2Dto1D(const TH2F * hist2d, const TString & subdir2d, TH1Map & th1dmap, TStrMap & subdir1dmap, TStrIntMap & th1dbinmap) 
@@ -1006,121 +1158,51 @@ void Analysis::Project2Dto1D(const TH2F * hist2d, const TString & subdir2d, TH1M
   }
 }
 
-void Analysis::ProduceQuantile(const TH2F * hist2d, const TString & subdir2d, TH1Map & th1dmap, TStrIntMap & th1dbinmap) 
+void Analysis::ProduceQuantile(const TH2F * hist2d, const TString & subdir2d, const Float_t qprob, const std::vector<ColumnStats::Column> & columns) 
 {
   // initialize new mean/sigma histograms
   const TString hname = hist2d->GetName();
-  const Float_t qprob = (hname.Contains("pho",TString::kExact) ? (hname.Contains("nvtx",TString::kExact) ? Config::quantProbIso : Config::quantProbPt) : Config::quantProbRho);
   TH1F * outhist_quant = Analysis::MakeTH1PlotFromTH2(hist2d,Form("%s_quant_%4.2f",hname.Data(),qprob),
 						      Form("%i%% Quantile of %s",Int_t(100*qprob),hist2d->GetYaxis()->GetTitle()));
 
-  // use this to store runs that by themselves produce bad fits
-  for (TH1MapIter mapiter = th1dmap.begin(); mapiter != th1dmap.end(); ++mapiter) 
+  // empty x bins are left empty
+  for (Int_t ibin = 1; ibin <= hist2d->GetNbinsX(); ibin++) 
   { 
-    const Int_t ibin = th1dbinmap[mapiter->first]; // returns which bin each th1 corresponds to one the new plot
+    const auto & column = columns[ibin];
+    if (!column.filled) continue;
 
-    // Perform quantile analysis
-    Float_t x = 0.f, dx_dn = 0.f, dx_up = 0.f;
-    Analysis::GetQuantileX(mapiter->second,x,dx_dn,dx_up);
-
-    outhist_quant->SetBinContent(ibin,x);
-    outhist_quant->SetBinError(ibin,(dx_dn>dx_up?dx_dn:dx_up)); // really should set with tgraphasymmerrors
-  } // end loop over th1s
+    outhist_quant->SetBinContent(ibin,column.quant);
+    outhist_quant->SetBinError(ibin,(column.equant_dn>column.equant_up?column.equant_dn:column.equant_up)); // really should set with tgraphasymmerrors
+  } // end loop over x bins
 
   Analysis::SaveProjectedTH1(outhist_quant,subdir2d);
 
   delete outhist_quant;
 }
 
-void Analysis::ProduceMeanHist(const TH2F * hist2d, const TString & subdir2d, TH1Map & th1dmap, TStrIntMap & th1dbinmap) 
+void Analysis::ProduceMeanHist(const TH2F * hist2d, const TString & subdir2d, const std::vector<ColumnStats::Column> & columns) 
 {
   // initialize new mean/sigma histograms
   TH1F * outhist_mean = Analysis::MakeTH1PlotFromTH2(hist2d,Form("%s_mean",hist2d->GetName()),Form("Mean of %s",hist2d->GetYaxis()->GetTitle()));
 
-  // use this to store runs that by themselves produce bad fits
-  for (TH1MapIter mapiter = th1dmap.begin(); mapiter != th1dmap.end(); ++mapiter) 
+  // empty x bins are left empty
+  for (Int_t ibin = 1; ibin <= hist2d->GetNbinsX(); ibin++) 
   { 
-    const Int_t ibin = th1dbinmap[mapiter->first]; // returns which bin each th1 corresponds to one the new plot
-    outhist_mean->SetBinContent(ibin,mapiter->second->GetMean());
-    outhist_mean->SetBinError(ibin,mapiter->second->GetMeanError());
-  } // end loop over th1s
+    const auto & column = columns[ibin];
+    if (!column.filled) continue;
+
+    outhist_mean->SetBinContent(ibin,column.mean);
+    outhist_mean->SetBinError(ibin,column.emean);
+  } // end loop over x bins
 
   Analysis::SaveProjectedTH1(outhist_mean,subdir2d);
 
   delete outhist_mean;
 }
 
-void Analysis::GetQuantileX(const TH1F * hist, Float_t & x, Float_t & dx_dn, Float_t & dx_up)
-{
-  const TString hname = hist->GetName();
-  const Float_t qprob = (hname.Contains("pho",TString::kExact) ? (hname.Contains("nvtx",TString::kExact) ? Config::quantProbIso : Config::quantProbPt) : Config::quantProbRho);
-  const Float_t integral = hist->Integral();
-  const Int_t   nBinsX   = hist->GetNbinsX();
-  
-  std::vector<Float_t> eff(nBinsX), eff_err(nBinsX), centers(nBinsX);
-  
-  Float_t sum = 0.f; 
-  for (Int_t ibin = 1; ibin <= nBinsX; ibin++)
-  { 
-    sum += hist->GetBinContent(ibin); 
-    centers[ibin-1] = hist->GetXaxis()->GetBinCenter(ibin);
-
-    if (sum != 0.f && integral != 0.f)
-    { 
-      eff    [ibin-1] = sum/integral;
-      eff_err[ibin-1] = std::sqrt(eff[ibin-1]*(1.f-eff[ibin-1])/integral); 
-    }
-    else
-    {
-      eff    [ibin-1] = 0.f;
-      eff_err[ibin-1] = 0.f; 
-    }
-  }
-
-  for (Int_t i = 0; i < nBinsX; i++)
-  {
-    if (eff[i] > qprob) 
-    {
-      x = centers[i];
-      break;
-    }
-  }
-
-  dx_dn = Analysis::FluctuateX(eff,eff_err,qprob,centers,x,false);
-  dx_up = Analysis::FluctuateX(eff,eff_err,qprob,centers,x,true);
-}
-
-Float_t Analysis::FluctuateX(const FltVec & eff, const FltVec & eff_err, const Float_t qprob, const FltVec & centers, const Float_t x, const Bool_t isUp)
+Float_t Analysis::GetQuantProb(const TString & hname)
 {
-  const Int_t nEffs = eff.size();
-  std::vector<Float_t> eff_v(nEffs); // v = variation
-  
-  Int_t i_v = -1;
-  for (Int_t i = 0; i < nEffs; i++)
-  {
-    eff_v[i] = eff[i] + ((isUp)?1.f:-1.f) * eff_err[i];
-    if (eff_v[i] > qprob) 
-    {
-      i_v = i;
-      break;
-    }
-  }
-
-  Float_t x_v = 0.f;
-  if (i_v != -1)
-  {
-    if (eff_v[i_v] > 0.f && eff_v[i_v-1] > 0.f && (centers[i_v]-centers[i_v-1]) > 0.f)
-    {
-      const Float_t slope = (eff_v[i_v]-eff_v[i_v-1])/(centers[i_v]-centers[i_v-1]);
-      if (slope > 0.f)
-      {
-	const Float_t intercept = eff_v[i_v]-slope*centers[i_v];
-	x_v = (qprob-intercept)/slope;
-      }
-    }
-  }
-
-  return ((i_v != -1) ? std::abs(x-x_v) : 0.f);
+  return (hname.Contains("pho",TString::kExact) ? (hname.Contains("nvtx",TString::kExact) ? Config::quantProbIso : Config::quantProbPt) : Config::quantProbRho);
 }
    
 TH1F * Analysis::MakeTH1Plot(const TString & hname, const TString & htitle, const Int_t nbinsx, Double_t xlow, Double_t xhigh,
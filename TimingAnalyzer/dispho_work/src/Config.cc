@@ -14,6 +14,7 @@ namespace Config
   Bool_t  doPhoStacks = false;
   Bool_t  doEffStacks = false;
   Bool_t  doDemo     = false;
+  Int_t   nJobs      = 1; // samples analyzed concurrently
   Bool_t  useDEG     = false; 
   Bool_t  useSPH     = false; 
   Bool_t  useDYll    = false; 
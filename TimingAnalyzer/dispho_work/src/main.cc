@@ -9,6 +9,7 @@
 #include "../interface/StackMCOnly.hh"
 #include "../interface/StackGEDOOT.hh"
 #include "../interface/StackEffs.hh"
+#include "../../plugins/SamplePool.hh"
 
 #include "TROOT.h"
 #include "TSystem.h"
@@ -197,6 +198,7 @@ int main(int argc, const char* argv[])
 	"  --do-phostacks                stack GED/OOT plots (def: %s)\n"
 	"  --do-effstacks                stack all efficiency plots (def: %s)\n"
 	"  --do-demo                     demo analysis (def: %s)\n"
+	"  --n-jobs        <int>         number of samples to analyze concurrently, one process each (def: %i)\n"
 	"  --use-DEG                     use doubleEG for data (def: %s)\n"
 	"  --use-SPH                     use singlePh for data (def: %s)\n"
 	"  --use-GMSB                    use GMSB with MC (def: %s)\n"
@@ -240,6 +242,7 @@ int main(int argc, const char* argv[])
 	PrintBool(Config::doPhoStacks),
 	PrintBool(Config::doEffStacks),
 	PrintBool(Config::doDemo),
+	Config::nJobs,
 	PrintBool(Config::useDEG),
 	PrintBool(Config::useSPH),
 	PrintBool(Config::useGMSB),
@@ -284,6 +287,7 @@ int main(int argc, const char* argv[])
     else if (*i == "--do-phostacks"){ Config::doPhoStacks = true; }
     else if (*i == "--do-effstacks"){ Config::doEffStacks = true; }
     else if (*i == "--do-demo")     { Config::doDemo     = true; Config::doAnalysis = true; Config::doEvStd = true; Config::doPhoStd = true; }
+    else if (*i == "--n-jobs")      { next_arg_or_die(mArgs, i); Config::nJobs = std::atoi(i->c_str()); }
     else if (*i == "--use-DEG")     { Config::useDEG     = true; }
     else if (*i == "--use-SPH")     { Config::useSPH     = true; }
     else if (*i == "--use-GMSB")    { Config::useGMSB    = true; }
@@ -359,12 +363,25 @@ int main(int argc, const char* argv[])
   if (Config::doAnalysis) 
   {
     std::cout << "Starting analysis section" << std::endl;
+    std::vector<SamplePool::Job> jobs;
     for (const auto & samplePair : Config::SampleMap)
     {
-      Analysis analysis(samplePair.first,samplePair.second);
-      std::cout << "Analyzing: " << (samplePair.second?"MC":"DATA") << " sample: " << samplePair.first << std::endl;
-      analysis.EventLoop();
-      std::cout << "Done analyzing: " << (samplePair.second?"MC":"DATA") << " sample: " << samplePair.first << std::endl;
+      jobs.push_back({samplePair.first,[samplePair]()
+      {
+	Analysis analysis(samplePair.first,samplePair.second);
+	std::cout << "Analyzing: " << (samplePair.second?"MC":"DATA") << " sample: " << samplePair.first << std::endl;
+	analysis.EventLoop();
+	std::cout << "Done analyzing: " << (samplePair.second?"MC":"DATA") << " sample: " << samplePair.first << std::endl;
+      }});
+    }
+
+    // samples are independent until hadd/stacking: with --n-jobs > 1, one process per sample, logs in outdir/year/logs
+    const TString logdir = Form("%s/%i/logs", Config::outdir.Data(), Config::year);
+    if (Config::nJobs > 1) MakeOutDir(logdir);
+    if (!SamplePool::Run(jobs,Config::nJobs,(Config::nJobs > 1 ? logdir : TString(""))))
+    {
+      std::cerr << "Analysis failed for at least one sample! Exiting..." << std::endl;
+      exit(1);
     }
     std::cout << "Finished analysis section" << std::endl;
   }
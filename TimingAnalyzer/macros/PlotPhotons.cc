@@ -5,6 +5,7 @@
 #include "TObject.h" 
 
 #include "common/common.h"
+#include "../plugins/ArrivalTime.hh"
 
 #include <iostream>
 
@@ -146,14 +147,76 @@ void PlotPhotons::SetupPlots(Bool_t geninfo, Bool_t vtxs, Bool_t met, Bool_t jet
   if (analysis) PlotPhotons::SetupAnalysis();
 }
 
+void PlotPhotons::SetupBranchGroups(Bool_t geninfo, Bool_t vtxs, Bool_t met, Bool_t jets, Bool_t photons, Bool_t ph1, Bool_t phdelay, Bool_t trigger, Bool_t analysis)
+{
+  fBranches.SetTree(fInTree);
+
+  // event selection (CountEvents): read for every entry
+  std::vector<TString> selection = {"nphotons","phpt","phVID","phr9","phsceta","phsmaj","phsmin","phseedpos","njets","jetpt","triggerBits"};
+  if (Config::ApplyrhECut)      selection.emplace_back("phrhE");
+  if (Config::ApplyHLTMatching) selection.emplace_back("phIsHLTMatched");
+  if (Config::ApplyPhMCMatchingCut)
+  {
+    if (fIsGMSB || fIsHVDS) selection.emplace_back("phmatch");
+    else if (fIsBkg)        selection.emplace_back("phIsGenMatched");
+  }
+  fBranches.Declare("selection",selection);
+  fBranches.Enable("selection");
+
+  // plot groups: only loaded for events that pass the event cut, on top of the selection branches
+  std::vector<TString> gen = {"genpuobs","genputrue"};
+  if (fIsGMSB)
+  {
+    for (const auto & name : {"nNeutralino","nNeutoPhGr","genN1*","genN2*","genph1*","genph2*","gengr1*","gengr2*","ngenjets","genjet*"}) gen.emplace_back(name);
+  }
+  if (fIsHVDS)
+  {
+    for (const auto & name : {"nvPions","genvPion*","genHVph*"}) gen.emplace_back(name);
+  }
+  fBranches.Declare("geninfo",gen,true);
+
+  fBranches.Declare("vtxs",{"nvtx"},true);
+  fBranches.Declare("met",{"t1pfMET*"},true);
+
+  std::vector<TString> jet = {"jetE","jetphi","jeteta"};
+  if (fIsGMSB) jet.emplace_back("jetmatch");
+  fBranches.Declare("jets",jet,true);
+
+  std::vector<TString> photon = {"phE","phphi","pheta","phHoE","phChgIso","phNeuIso","phIso","phsuisseX","phsieie","phsipip","phsieip","phalpha","phscE",
+				 "phnrh","phrhE","phrhtime","phrhOOT"};
+  if      (fIsGMSB || fIsHVDS) photon.emplace_back("phmatch");
+  else if (fIsBkg)             photon.emplace_back("phIsGenMatched");
+  fBranches.Declare("photons",photon,true);
+
+  fBranches.Declare("ph1",{"phHoE","phsieie","phalpha","phrhtime"},true);
+  fBranches.Declare("phdelay",{"phHoE","phsieie","phalpha","phrhtime"},true);
+  fBranches.Declare("trigger",{"phrhtime","phIsHLTMatched","nvtx"},true);
+  fBranches.Declare("analysis",{"phrhtime","t1pfMETpt"},true);
+
+  fBranches.Enable("geninfo" ,geninfo && fIsMC);
+  fBranches.Enable("vtxs"    ,vtxs);
+  fBranches.Enable("met"     ,met);
+  fBranches.Enable("jets"    ,jets);
+  fBranches.Enable("photons" ,photons);
+  fBranches.Enable("ph1"     ,ph1);
+  fBranches.Enable("phdelay" ,phdelay);
+  fBranches.Enable("trigger" ,trigger);
+  fBranches.Enable("analysis",analysis);
+
+  fBranches.Activate();
+}
+
 void PlotPhotons::EventLoop(Bool_t geninfo, Bool_t vtxs, Bool_t met, Bool_t jets, Bool_t photons, Bool_t ph1, Bool_t phdelay, Bool_t trigger, Bool_t analysis)
 {
-  for (UInt_t entry = 0; entry < fInTree->GetEntries(); entry++)
+  PlotPhotons::SetupBranchGroups(geninfo, vtxs, met, jets, photons, ph1, phdelay, trigger, analysis);
+
+  const Long64_t nEntries = fInTree->GetEntries();
+  for (Long64_t entry = 0; entry < nEntries; entry++)
   {
-    fInTree->GetEntry(entry);
+    fBranches.GetEntry(entry);
     
     // standard printout
-    if (entry%Config::NEvCheck == 0 || entry == 0) std::cout << "Entry " << entry << " out of " << fInTree->GetEntries() << std::endl;
+    if (entry%Config::NEvCheck == 0 || entry == 0) std::cout << "Entry " << entry << " out of " << nEntries << std::endl;
 
     // count events passing given selection
     const Bool_t passed = PlotPhotons::CountEvents();
@@ -162,6 +225,7 @@ void PlotPhotons::EventLoop(Bool_t geninfo, Bool_t vtxs, Bool_t met, Bool_t jets
     // plots!
     if (geninfo && fIsMC)
     {
+      fBranches.Load("geninfo");
       PlotPhotons::FillGenInfo();
       if (fIsGMSB)
       {	
@@ -174,15 +238,17 @@ void PlotPhotons::EventLoop(Bool_t geninfo, Bool_t vtxs, Bool_t met, Bool_t jets
       }
     }
 
-    if (vtxs)     PlotPhotons::FillVertices();
-    if (met)      PlotPhotons::FillMET();
-    if (jets)     PlotPhotons::FillJets();
-    if (photons)  PlotPhotons::FillRecoPhotons();
-    if (ph1)      PlotPhotons::FillLeading();
-    if (phdelay)  PlotPhotons::FillMostDelayed();
-    if (trigger)  PlotPhotons::FillTrigger();
-    if (analysis) PlotPhotons::FillAnalysis(passed);
+    if (vtxs)     {fBranches.Load("vtxs");     PlotPhotons::FillVertices();}
+    if (met)      {fBranches.Load("met");      PlotPhotons::FillMET();}
+    if (jets)     {fBranches.Load("jets");     PlotPhotons::FillJets();}
+    if (photons)  {fBranches.Load("photons");  PlotPhotons::FillRecoPhotons();}
+    if (ph1)      {fBranches.Load("ph1");      PlotPhotons::FillLeading();}
+    if (phdelay)  {fBranches.Load("phdelay");  PlotPhotons::FillMostDelayed();}
+    if (trigger)  {fBranches.Load("trigger");  PlotPhotons::FillTrigger();}
+    if (analysis) {fBranches.Load("analysis"); PlotPhotons::FillAnalysis(passed);}
   } // end loop over events
+
+  fBranches.Report();
 }
 
 Bool_t PlotPhotons::CountEvents()
@@ -448,8 +514,7 @@ void PlotPhotons::FillGMSB()
     const Float_t genN1decayvr = std::sqrt(rad2(genN1decayvx,genN1decayvy));
     if (genN1decayvr < ECAL::rEB && genN1decayvz < ECAL::zEE) 
     {
-      Float_t genphtime = PlotPhotons::GetGenPhotonArrivalTime(genN1decayvr,genN1decayvz,ineta(genph1eta));
-      genphtime = ((genphtime != -1.f) ? genphtime + genN1ctau * genN1gamma / sol : -1.f);
+      const Float_t genphtime = PlotPhotons::GetGenPhotonArrivalTime(genN1decayvx,genN1decayvy,genN1decayvz,genph1eta,genph1phi,genN1ctau*genN1gamma);
       fPlots["genphtime"]->Fill(genphtime);
       fPlots2D["genphtime_vs_genphpt"]->Fill(genph1pt,genphtime);
     }
@@ -498,8 +563,7 @@ void PlotPhotons::FillGMSB()
     const Float_t genN2decayvr = std::sqrt(rad2(genN2decayvx,genN2decayvy));
     if (genN2decayvr < ECAL::rEB && genN2decayvz < ECAL::zEE) 
     {
-      Float_t genphtime = PlotPhotons::GetGenPhotonArrivalTime(genN2decayvr,genN2decayvz,ineta(genph2eta));
-      genphtime = ((genphtime != -1.f) ? genphtime + genN2ctau * genN2gamma / sol : -1.f);
+      const Float_t genphtime = PlotPhotons::GetGenPhotonArrivalTime(genN2decayvx,genN2decayvy,genN2decayvz,genph2eta,genph2phi,genN2ctau*genN2gamma);
       fPlots["genphtime"]->Fill(genphtime);
       fPlots2D["genphtime_vs_genphpt"]->Fill(genph2pt,genphtime);
     }
@@ -567,19 +631,14 @@ void PlotPhotons::FillHVDS()
     const Float_t genvPiondecayvr = std::sqrt(rad2((*genvPiondecayvx)[ipion],(*genvPiondecayvy)[ipion]));
     if (genvPiondecayvr < ECAL::rEB && std::abs((*genvPiondecayvz)[ipion]) < ECAL::zEE) 
     {
-      std::cout << std::endl;
-      std::cout << "decayr: "<< genvPiondecayvr << " decayz: " << (*genvPiondecayvz)[ipion] << " ineta: " << ineta((*genHVph1eta)[ipion]) << std::endl;
-
-      Float_t genph1time = PlotPhotons::GetGenPhotonArrivalTime(genvPiondecayvr,(*genvPiondecayvz)[ipion],ineta((*genHVph1eta)[ipion]));
-      genph1time = ((genph1time != -1.f) ? genph1time + genvPionctau * genvPiongamma / sol : -1.f);
-      
-      std::cout << " w/ vpiontime: " << genph1time << std::endl; 
+      const Float_t genph1time = PlotPhotons::GetGenPhotonArrivalTime((*genvPiondecayvx)[ipion],(*genvPiondecayvy)[ipion],(*genvPiondecayvz)[ipion],
+								      (*genHVph1eta)[ipion],(*genHVph1phi)[ipion],genvPionctau*genvPiongamma);
 
       fPlots["genHVph1time"]->Fill(genph1time);
       fPlots2D["genHVph1time_vs_genHVph1pt"]->Fill((*genHVph1pt)[ipion],genph1time);
 
-//       Float_t genph2time = PlotPhotons::GetGenPhotonArrivalTime(genvPiondecayvr,(*genvPiondecayvz)[ipion],ineta((*genHVph2eta)[ipion]));
-//       genph2time = ((genph2time != -1.f) ? genph2time + genvPionctau * genvPiongamma / sol : -1.f);
+//       const Float_t genph2time = PlotPhotons::GetGenPhotonArrivalTime((*genvPiondecayvx)[ipion],(*genvPiondecayvy)[ipion],(*genvPiondecayvz)[ipion],
+// 								      (*genHVph2eta)[ipion],(*genHVph2phi)[ipion],genvPionctau*genvPiongamma);
 //       fPlots["genHVph2time"]->Fill(genph2time);
 //       fPlots2D["genHVph2time_vs_genHVph2pt"]->Fill((*genHVph2pt)[ipion],genph2time);
     }
@@ -593,37 +652,15 @@ void PlotPhotons::FillHVDS()
   }
 }
 
-Float_t PlotPhotons::GetGenPhotonArrivalTime(const Float_t r0, const Float_t z0, const Float_t slope)
+Float_t PlotPhotons::GetGenPhotonArrivalTime(const Float_t vx, const Float_t vy, const Float_t vz, 
+					     const Float_t eta, const Float_t phi, const Float_t ctaugamma)
 {
-  Float_t time = -1.f;
+  // batch kernel on a single photon: use ArrivalTime::Compute on Inputs directly for many photons at once
+  Int_t   det  = ArrivalTime::Missed;
+  Float_t path = 0.f;
+  const Float_t time = ArrivalTime::Compute(vx,vy,vz,eta,phi,ctaugamma/ArrivalTime::sol,det,path);
   
-  const Float_t z = z0 + ( (ECAL::rEB - r0) / slope );
-  if (std::abs(z) < ECAL::zEB) 
-  {
-    time  = std::sqrt(rad2(ECAL::rEB-r0,z-z0)) / sol;
-    
-    std::cout << "EB: " << time << " (z" << z << ")" ;
-
-    time -= std::sqrt(rad2(ECAL::rEB,z)) / sol; // TOF correction;
-
-    std::cout << " w TOF: " << time;
-  }
-  else 
-  {
-    const Float_t r = r0 + ( slope * (ECAL::zEE - z0) );
-    if (std::abs(r) > ECAL::rEEmin && std::abs(r) < ECAL::rEEmax)
-    {
-      time  = std::sqrt(rad2(r-r0,ECAL::zEE-z0)) / sol;
-
-      std::cout << "EE: " << time << " (z" << r << ")" ;
-
-      time -= std::sqrt(rad2(r0,ECAL::zEE)) / sol; // TOF correction;
-
-      std::cout << " w TOF: " << time;
-    }
-  }
-
-  return time;
+  return ((det != ArrivalTime::Missed) ? time : -1.f); // [ns]
 }
 
 void PlotPhotons::FillVertices()
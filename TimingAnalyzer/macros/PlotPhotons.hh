@@ -10,6 +10,7 @@
 #include "TLorentzVector.h"
 #include "TVector3.h"
 #include "common/common.h"
+#include "../plugins/BranchGroups.hh"
 
 #include <fstream>
 #include <vector>
@@ -52,6 +53,7 @@ public :
   TH2F * MakeTH2F(TString hname, TString htitle, Int_t nbinsx, Float_t xlow, Float_t xhigh, TString xtitle, Int_t nbinsy, Float_t ylow, Float_t yhigh, TString ytitle, TString subdir);
   std::pair<TH2F*,TH2F*> MakeTrigTH2Fs(TString hname, TString htitle, Int_t nbinsx, Float_t xlow, Float_t xhigh, TString xtitle, Int_t nbinsy, Float_t ylow, Float_t yhigh, TString ytitle, TString path, TString subdir);
   void MakeEffPlot2D(TH2F *& eff, TString hname, TH2F *& denom, TH2F *& numer);
+  void SetupBranchGroups(Bool_t geninfo, Bool_t vtxs, Bool_t met, Bool_t jets, Bool_t photons, Bool_t ph1, Bool_t phdelay, Bool_t trigger, Bool_t analysis);
   void EventLoop(Bool_t geninfo, Bool_t vtxs, Bool_t met, Bool_t jets, Bool_t photons, Bool_t ph1, Bool_t phdelay, Bool_t trigger, Bool_t analysis);
   Bool_t CountEvents();
   Int_t GetLeadingPhoton();
@@ -63,7 +65,8 @@ public :
   void FillGMSB();
   void FillGenJets();
   void FillHVDS();
-  Float_t GetGenPhotonArrivalTime(const Float_t r0, const Float_t z0, const Float_t slope);
+  Float_t GetGenPhotonArrivalTime(const Float_t vx, const Float_t vy, const Float_t vz, 
+				  const Float_t eta, const Float_t phi, const Float_t ctaugamma);
   void FillVertices();
   void FillMET();
   void FillJets();
@@ -85,6 +88,7 @@ private :
   // Input vars
   TFile * fInFile; //!pointer to file
   TTree * fInTree; //!pointer to the analyzed TTree
+  BranchGroups fBranches; //!branches read per plot group
   const Bool_t fIsGMSB;
   const Bool_t fIsHVDS;
   const Bool_t fIsBkg;
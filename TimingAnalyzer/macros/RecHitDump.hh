@@ -0,0 +1,253 @@
+#ifndef _rechitdump_
+#define _rechitdump_
+
+#include "TString.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// POSIX: for the memory-mapped reader
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////
+//                                                                //
+// Binary rec hit dump: a small header followed by fixed-width    //
+// records, one per rec hit. Same fields, same order as the text  //
+// dump: "event iph irh detid OOT E time".                        //
+//                                                                //
+////////////////////////////////////////////////////////////////////
+
+namespace RecHitDump
+{
+  const UInt_t Magic   = 0x52484450; // "RHDP"
+  const UInt_t Version = 1;
+
+  // 32 bytes, naturally aligned: no padding, so it can be read in place
+  struct Record
+  {
+    ULong64_t event;
+    Int_t     iph;
+    Int_t     irh;
+    Int_t     detid;
+    Int_t     oot;
+    Float_t   E;
+    Float_t   time;
+  };
+  static_assert(sizeof(Record) == 32, "RecHitDump::Record must be packed to 32 bytes");
+
+  struct Header
+  {
+    UInt_t magic;
+    UInt_t version;
+    UInt_t recsize;
+    UInt_t reserved;
+  };
+
+  // existing text format: one line per rec hit
+  inline void WriteText(std::ostream & out, const Record & rec)
+  {
+    out << rec.event << " " << rec.iph << " " << rec.irh << " " << rec.detid << " " << rec.oot << " " << rec.E << " " << rec.time << "\n";
+  }
+
+  // buffered writer: binary records, or the text format through a large stream buffer (no flush per line)
+  class Writer
+  {
+  public:
+    Writer() : fBinary(false), fFile(NULL) {}
+    ~Writer() {Writer::Close();}
+
+    Bool_t Open(const TString & filename, const Bool_t binary, const UInt_t bufsize = 1<<16)
+    {
+      Writer::Close();
+      fBinary = binary;
+      fFileName = filename;
+      if (fBinary)
+      {
+	fFile = std::fopen(filename.Data(),"wb");
+	if (fFile == NULL) return false;
+	const Header header = {Magic,Version,UInt_t(sizeof(Record)),0};
+	Writer::WriteBinary(&header,sizeof(Header),1);
+	fBuffer.reserve(bufsize);
+      }
+      else
+      {
+	fTextBuffer.resize(bufsize*sizeof(Record));
+	fText.rdbuf()->pubsetbuf(&fTextBuffer[0],fTextBuffer.size()); // must precede open
+	fText.open(filename.Data(),std::ios_base::trunc);
+	if (!fText.is_open()) return false;
+      }
+      return true;
+    }
+
+    Bool_t IsOpen() const {return (fBinary ? fFile != NULL : fText.is_open());}
+
+    inline void Write(const Record & rec)
+    {
+      if (fBinary)
+      {
+	fBuffer.emplace_back(rec);
+	if (fBuffer.size() == fBuffer.capacity()) Writer::Flush();
+      }
+      else WriteText(fText,rec);
+    }
+
+    void Flush()
+    {
+      if (fBinary)
+      {
+	if (fFile != NULL && !fBuffer.empty()) Writer::WriteBinary(fBuffer.data(),sizeof(Record),fBuffer.size());
+	fBuffer.clear();
+      }
+      else if (fText.is_open())
+      {
+	fText.flush();
+	if (fText.fail()) Writer::Fail();
+      }
+    }
+
+    void Close()
+    {
+      Writer::Flush();
+      if (fFile != NULL)
+      {
+	const auto status = std::fclose(fFile); // flushes stdio's own buffer: can fail too
+	fFile = NULL;
+	if (status != 0) Writer::Fail();
+      }
+      if (fText.is_open())
+      {
+	fText.close();
+	if (fText.fail()) Writer::Fail();
+      }
+    }
+
+  private:
+    // a short write (e.g. full disk) must not leave a truncated dump behind silently
+    void WriteBinary(const void * data, const std::size_t size, const std::size_t count)
+    {
+      if (std::fwrite(data,size,count,fFile) != count) Writer::Fail();
+    }
+
+    void Fail() const
+    {
+      std::cerr << "Failed writing rec hit dump: " << fFileName.Data() << " (" << std::strerror(errno) << ") ...exiting..." << std::endl;
+      exit(1);
+    }
+
+    Bool_t fBinary;
+    TString fFileName;
+
+    std::FILE * fFile;
+    std::vector<Record> fBuffer;
+
+    std::ofstream fText;
+    std::vector<char> fTextBuffer;
+  };
+
+  // zero-copy reader: records are used straight from the mapped file
+  class Reader
+  {
+  public:
+    Reader() : fData(NULL), fSize(0), fRecords(NULL), fNRecords(0) {}
+    ~Reader() {Reader::Close();}
+
+    Bool_t Open(const TString & filename)
+    {
+      Reader::Close();
+
+      const Int_t fd = ::open(filename.Data(),O_RDONLY);
+      if (fd < 0)
+      {
+	std::cerr << "Cannot open rec hit dump: " << filename.Data() << std::endl;
+	return false;
+      }
+
+      struct stat st;
+      if (::fstat(fd,&st) != 0 || st.st_size < Long64_t(sizeof(Header)))
+      {
+	std::cerr << "Rec hit dump too short: " << filename.Data() << std::endl;
+	::close(fd);
+	return false;
+      }
+
+      fSize = st.st_size;
+      void * data = ::mmap(NULL,fSize,PROT_READ,MAP_PRIVATE,fd,0);
+      ::close(fd);
+      if (data == MAP_FAILED)
+      {
+	std::cerr << "Cannot map rec hit dump: " << filename.Data() << std::endl;
+	fSize = 0;
+	return false;
+      }
+      fData = static_cast<const char*>(data);
+      ::madvise(data,fSize,MADV_SEQUENTIAL);
+
+      Header header;
+      std::memcpy(&header,fData,sizeof(Header));
+      if (header.magic != Magic || header.version != Version || header.recsize != sizeof(Record) ||
+	  (fSize-sizeof(Header)) % sizeof(Record) != 0)
+      {
+	std::cerr << "Not a (compatible) binary rec hit dump: " << filename.Data() << std::endl;
+	Reader::Close();
+	return false;
+      }
+
+      fRecords  = reinterpret_cast<const Record*>(fData+sizeof(Header));
+      fNRecords = (fSize-sizeof(Header)) / sizeof(Record);
+      return true;
+    }
+
+    void Close()
+    {
+      if (fData != NULL) ::munmap(const_cast<char*>(fData),fSize);
+      fData = NULL; fSize = 0; fRecords = NULL; fNRecords = 0;
+    }
+
+    std::size_t size() const {return fNRecords;}
+    const Record & operator[](const std::size_t i) const {return fRecords[i];}
+    const Record * begin() const {return fRecords;}
+    const Record * end  () const {return fRecords+fNRecords;}
+
+  private:
+    const char * fData;
+    std::size_t fSize;
+    const Record * fRecords;
+    std::size_t fNRecords;
+  };
+
+  // binary --> existing text format
+  inline Bool_t ConvertToText(const TString & binname, const TString & txtname)
+  {
+    Reader reader;
+    if (!reader.Open(binname)) return false;
+
+    Writer writer;
+    if (!writer.Open(txtname,false))
+    {
+      std::cerr << "Cannot open text output: " << txtname.Data() << std::endl;
+      return false;
+    }
+    for (const auto & rec : reader) writer.Write(rec);
+    return true;
+  }
+
+  // crystal indices straight from the raw DetId (same bit layout as EBDetId/EEDetId)
+  inline Bool_t IsEB(const Int_t detid) {return ((detid>>25)&0x7) == 1;}
+  inline Bool_t IsEE(const Int_t detid) {return ((detid>>25)&0x7) == 2;}
+
+  inline Int_t EBieta(const Int_t detid) {return ((detid>>9)&0x7F) * ((detid&0x10000) ? 1 : -1);}
+  inline Int_t EBiphi(const Int_t detid) {return detid&0x1FF;}
+  inline Int_t EEix  (const Int_t detid) {return (detid>>7)&0x7F;}
+  inline Int_t EEiy  (const Int_t detid) {return detid&0x7F;}
+  inline Int_t EEzside(const Int_t detid) {return ((detid&0x4000) ? 1 : -1);}
+};
+
+#endif
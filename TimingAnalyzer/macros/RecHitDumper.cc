@@ -5,8 +5,8 @@
 #include <iostream>
 
 RecHitDumper::RecHitDumper(TString filename, TString outdir,
-			   TString ph1config, TString phanyconfig, TString photonconfig) :
-  fOutDir(outdir)
+			   TString ph1config, TString phanyconfig, TString photonconfig, const Bool_t binary) :
+  fOutDir(outdir), fBinary(binary)
 {
   // input
   fInFile = TFile::Open(filename.Data());
@@ -45,37 +45,66 @@ void RecHitDumper::DoDump(const Bool_t allph, const Bool_t leading, const Bool_t
 
 void RecHitDumper::SetupFiles(const Bool_t allph, const Bool_t leading, const Bool_t mostdelayed)
 {
+  const TString ext = (fBinary ? "bin" : "txt");
   if (allph) 
   {
-    fSeedDumpAll.open(Form("%s/seeddump-allphotons.txt",fOutDir.Data()),std::ios_base::trunc);
-    fRHDumpAll  .open(Form("%s/rhdump-allphotons.txt"  ,fOutDir.Data()),std::ios_base::trunc);
+    fSeedDumpAll.Open(Form("%s/seeddump-allphotons.%s",fOutDir.Data(),ext.Data()),fBinary);
+    fRHDumpAll  .Open(Form("%s/rhdump-allphotons.%s"  ,fOutDir.Data(),ext.Data()),fBinary);
   }
   if (leading) 
   {
-    fSeedDumpLeading.open(Form("%s/seeddump-leadingphoton.txt",fOutDir.Data()),std::ios_base::trunc);
-    fRHDumpLeading  .open(Form("%s/rhdump-leadingphoton.txt"  ,fOutDir.Data()),std::ios_base::trunc);
+    fSeedDumpLeading.Open(Form("%s/seeddump-leadingphoton.%s",fOutDir.Data(),ext.Data()),fBinary);
+    fRHDumpLeading  .Open(Form("%s/rhdump-leadingphoton.%s"  ,fOutDir.Data(),ext.Data()),fBinary);
   }
   if (mostdelayed) 
   {
-    fSeedDumpMostDelayed.open(Form("%s/seeddump-mostdelayedphoton.txt",fOutDir.Data()),std::ios_base::trunc);
-    fRHDumpMostDelayed  .open(Form("%s/rhdump-mostdelayedphoton.txt"  ,fOutDir.Data()),std::ios_base::trunc);
+    fSeedDumpMostDelayed.Open(Form("%s/seeddump-mostdelayedphoton.%s",fOutDir.Data(),ext.Data()),fBinary);
+    fRHDumpMostDelayed  .Open(Form("%s/rhdump-mostdelayedphoton.%s"  ,fOutDir.Data(),ext.Data()),fBinary);
   }
 }
 
+void RecHitDumper::SetupBranchGroups(const Bool_t allph, const Bool_t leading, const Bool_t mostdelayed)
+{
+  fBranches.SetTree(fInTree);
+
+  // photon selection: read for every entry
+  std::vector<TString> selection = {"event","nphotons","phsceta"};
+  if (leading || mostdelayed)
+  {
+    for (const auto & name : {"phpt","phVID","phr9","phsmaj","phsmin","phseedpos"}) selection.emplace_back(name);
+    if (Config::ApplyrhECut) selection.emplace_back("phrhE");
+  }
+  fBranches.Declare("selection",selection);
+  fBranches.Enable("selection");
+
+  // seed times for the most delayed photon, and the (nested) rec hit vectors only once a photon is dumped
+  fBranches.Declare("mostdelayed",{"phrhtime"},true);
+  fBranches.Declare("rechits",{"phnrh","phseedpos","phrhID","phrhOOT","phrhE","phrhtime"},true);
+  fBranches.Enable("mostdelayed",mostdelayed);
+  fBranches.Enable("rechits",allph || leading || mostdelayed);
+
+  fBranches.Activate();
+}
+
 void RecHitDumper::EventLoop(const Bool_t allph, const Bool_t leading, const Bool_t mostdelayed)
 {
-  for (UInt_t entry = 0; entry < fInTree->GetEntries(); entry++)
+  RecHitDumper::SetupBranchGroups(allph,leading,mostdelayed);
+
+  const Long64_t nEntries = fInTree->GetEntries();
+  for (Long64_t entry = 0; entry < nEntries; entry++)
   {
-    fInTree->GetEntry(entry);
+    fBranches.GetEntry(entry);
     
     // standard printout
-    if (entry%1000 == 0 || entry == 0) std::cout << "Entry " << entry << " out of " << fInTree->GetEntries() << std::endl;
+    if (entry%1000 == 0 || entry == 0) std::cout << "Entry " << entry << " out of " << nEntries << std::endl;
 
     if (allph)       RecHitDumper::FillAllPhotons();
     if (leading)     RecHitDumper::FillLeadingPhoton();
-    if (mostdelayed) RecHitDumper::FillMostDelayedPhoton();
+    if (mostdelayed) {fBranches.Load("mostdelayed"); RecHitDumper::FillMostDelayedPhoton();}
 
   } // end loop over events
+
+  fBranches.Report();
 }
 
 void RecHitDumper::FillAllPhotons()
@@ -87,14 +116,7 @@ void RecHitDumper::FillAllPhotons()
     if (Config::ApplyECALAcceptCut && (((eta > 1.4442) && (eta < 1.566)) || (eta > 2.5))) continue;
 
     // no cuts on energy of recHits or on seed existing -- so be careful! 
-    for (Int_t irh = 0; irh < (*phnrh)[iph]; irh++)
-    {
-      fRHDumpAll << event << " " << iph << " " << irh << " " << (*phrhID)[iph][irh] << " " << (*phrhOOT)[iph][irh] << " " << (*phrhE)[iph][irh] << " " << (*phrhtime)[iph][irh] << std::endl;
-      if (irh == (*phseedpos)[iph])
-      {
-	fSeedDumpAll << event << " " << iph << " " << irh << " " << (*phrhID)[iph][irh] << " " << (*phrhOOT)[iph][irh] << " " << (*phrhE)[iph][irh] << " " << (*phrhtime)[iph][irh] << std::endl;
-      }
-    }
+    RecHitDumper::FillPhoton(iph,false,fRHDumpAll,fSeedDumpAll);
   }
 }
 
@@ -102,35 +124,40 @@ void RecHitDumper::FillLeadingPhoton()
 {
   Int_t ph1 = RecHitDumper::GetLeadingPhoton();
 
-  if (ph1 != -1)
-  {
-    for (Int_t irh = 0; irh < (*phnrh)[ph1]; irh++)
-    {
-      if (Config::ApplyrhECut && (*phrhE)[ph1][irh] < Config::rhECut) continue;
-      fRHDumpLeading << event << " " << ph1 << " " << irh << " " << (*phrhID)[ph1][irh] << " " << (*phrhOOT)[ph1][irh] << " " << (*phrhE)[ph1][irh] << " " << (*phrhtime)[ph1][irh] << std::endl;
-      if (irh == (*phseedpos)[ph1])
-      {
-	fSeedDumpLeading << event << " " << ph1 << " " << irh << " " << (*phrhID)[ph1][irh] << " " << (*phrhOOT)[ph1][irh] << " " << (*phrhE)[ph1][irh] << " " << (*phrhtime)[ph1][irh] << std::endl;
-      }
-    }
-  }
+  if (ph1 != -1) RecHitDumper::FillPhoton(ph1,Config::ApplyrhECut,fRHDumpLeading,fSeedDumpLeading);
 }
 
 void RecHitDumper::FillMostDelayedPhoton()
 {
   Int_t phdelay = RecHitDumper::GetMostDelayedPhoton();
 
-  if (phdelay != -1)
+  if (phdelay != -1) RecHitDumper::FillPhoton(phdelay,Config::ApplyrhECut,fRHDumpMostDelayed,fSeedDumpMostDelayed);
+}
+
+void RecHitDumper::FillPhoton(const Int_t iph, const Bool_t applyrhECut, RecHitDump::Writer & rhdump, RecHitDump::Writer & seeddump)
+{
+  fBranches.Load("rechits"); // no-op if already read for this entry
+
+  const auto & rhIDs   = (*phrhID)  [iph];
+  const auto & rhOOTs  = (*phrhOOT) [iph];
+  const auto & rhEs    = (*phrhE)   [iph];
+  const auto & rhtimes = (*phrhtime)[iph];
+
+  RecHitDump::Record rec;
+  rec.event = event;
+  rec.iph   = iph;
+  for (Int_t irh = 0; irh < (*phnrh)[iph]; irh++)
   {
-    for (Int_t irh = 0; irh < (*phnrh)[phdelay]; irh++)
-    {
-      if (Config::ApplyrhECut && (*phrhE)[phdelay][irh] < Config::rhECut) continue;
-      fRHDumpMostDelayed << event << " " << phdelay << " " << irh << " " << (*phrhID)[phdelay][irh] << " " << (*phrhOOT)[phdelay][irh] << " " << (*phrhE)[phdelay][irh] << " " << (*phrhtime)[phdelay][irh] << std::endl;
-      if (irh == (*phseedpos)[phdelay])
-      {
-	fSeedDumpMostDelayed << event << " " << phdelay << " " << irh << " " << (*phrhID)[phdelay][irh] << " " << (*phrhOOT)[phdelay][irh] << " " << (*phrhE)[phdelay][irh] << " " << (*phrhtime)[phdelay][irh] << std::endl;
-      }
-    }
+    if (applyrhECut && rhEs[irh] < Config::rhECut) continue;
+
+    rec.irh   = irh;
+    rec.detid = rhIDs  [irh];
+    rec.oot   = rhOOTs [irh];
+    rec.E     = rhEs   [irh];
+    rec.time  = rhtimes[irh];
+
+    rhdump.Write(rec);
+    if (irh == (*phseedpos)[iph]) seeddump.Write(rec);
   }
 }
 
@@ -138,18 +165,18 @@ void RecHitDumper::SaveFiles(const Bool_t allph, const Bool_t leading, const Boo
 {
   if (allph) 
   {
-    fSeedDumpAll.close();
-    fRHDumpAll  .close();
+    fSeedDumpAll.Close();
+    fRHDumpAll  .Close();
   }
   if (leading) 
   {
-    fSeedDumpLeading.close();
-    fRHDumpLeading  .close();
+    fSeedDumpLeading.Close();
+    fRHDumpLeading  .Close();
   }
   if (mostdelayed) 
   {
-    fSeedDumpMostDelayed.close();
-    fRHDumpMostDelayed  .close();
+    fSeedDumpMostDelayed.Close();
+    fRHDumpMostDelayed  .Close();
   }
 }
 
@@ -6,6 +6,9 @@
 #include "TTree.h"
 #include "TString.h"
 
+#include "RecHitDump.hh"
+#include "../plugins/BranchGroups.hh"
+
 #include <fstream>
 #include <vector>
 #include <map>
@@ -18,7 +21,8 @@ class RecHitDumper
 {
 public :
   RecHitDumper(TString filename, TString outdir = "output",
-	       TString ph1config = "config/plotter-ph1.txt", TString phanyconfig = "config/plotter-phany.txt", TString photonconfig = "config/plotter-photon.txt");
+	       TString ph1config = "config/plotter-ph1.txt", TString phanyconfig = "config/plotter-phany.txt", TString photonconfig = "config/plotter-photon.txt",
+	       const Bool_t binary = false);
   ~RecHitDumper();
   void InitTree();
   void InitPh1Config(TString config);
@@ -26,11 +30,13 @@ public :
   void InitPhotonConfig(TString config);
   void DoDump(const Bool_t allph = false, const Bool_t leading = false, const Bool_t mostdelayed = false);
   void SetupFiles(const Bool_t allph, const Bool_t leading, const Bool_t mostdelayed);
+  void SetupBranchGroups(const Bool_t allph, const Bool_t leading, const Bool_t mostdelayed);
   void EventLoop(const Bool_t allph, const Bool_t leading, const Bool_t mostdelayed);
   void FillAllPhotons();
   void FillLeadingPhoton();
   void FillMostDelayedPhoton();
-  void SaveFiles(const Bool_t allph, const Bool_t leading, const Bool_t mostdelayed)
+  void FillPhoton(const Int_t iph, const Bool_t applyrhECut, RecHitDump::Writer & rhdump, RecHitDump::Writer & seeddump);
+  void SaveFiles(const Bool_t allph, const Bool_t leading, const Bool_t mostdelayed);
   Int_t GetLeadingPhoton();
   Int_t GetGoodPhotons(std::vector<Int_t> & goodphotons);
   Int_t GetMostDelayedPhoton();
@@ -39,18 +45,20 @@ private :
   // Input vars
   TFile * fInFile; //!pointer to file
   TTree * fInTree; //!pointer to the analyzed TTree
+  BranchGroups fBranches; //!selection read per entry, rec hits only per dumped photon
 
   // In routine vars
   TStrIntMap fPhVIDMap;
 
   // Output vars
   TString fOutDir;
-  std::fstream fSeedDumpAll;
-  std::fstream fRHDumpAll;
-  std::fstream fSeedDumpLeading;
-  std::fstream fRHDumpLeading;
-  std::fstream fSeedDumpMostDelayed;
-  std::fstream fRHDumpMostDelayed;
+  const Bool_t fBinary; // fixed-width records (.bin) instead of text (.txt)
+  RecHitDump::Writer fSeedDumpAll;
+  RecHitDump::Writer fRHDumpAll;
+  RecHitDump::Writer fSeedDumpLeading;
+  RecHitDump::Writer fRHDumpLeading;
+  RecHitDump::Writer fSeedDumpMostDelayed;
+  RecHitDump::Writer fRHDumpMostDelayed;
 
   // Declaration of leaf types
   ULong64_t event;
@@ -300,7 +300,54 @@ void rhEmap::DoAllPlotNatural(const Float_t rhEcut)
   }
 }
 
+void rhEmap::DoPlotFromDump(const TString & dumpname, const TString & outname, const Bool_t applyrhEcut, const Float_t rhEcut)
+{
+  // binary dump from RecHitDumper: records are read in place, no parsing
+  RecHitDump::Reader reader;
+  if (!reader.Open(dumpname)) return;
+
+  TFile * outfile = TFile::Open(outname.Data(),"RECREATE");
+
+  // EB: ieta vs iphi, EE: ix vs iy per endcap; mostly empty for any selection, so kept sparse until written
+  SparseHist2D h_EB_occ ("h_EB_occ" ,"EB RecHit Occupancy;i_{#eta};i_{#phi}"         ,171,-85.5,85.5,360,0.5,360.5);
+  SparseHist2D h_EB_E   ("h_EB_E"   ,"EB RecHit Energy (GeV);i_{#eta};i_{#phi}"      ,171,-85.5,85.5,360,0.5,360.5);
+  SparseHist2D h_EEm_occ("h_EEm_occ","EE- RecHit Occupancy;i_{x};i_{y}"              ,100,0.5,100.5,100,0.5,100.5);
+  SparseHist2D h_EEm_E  ("h_EEm_E"  ,"EE- RecHit Energy (GeV);i_{x};i_{y}"           ,100,0.5,100.5,100,0.5,100.5);
+  SparseHist2D h_EEp_occ("h_EEp_occ","EE+ RecHit Occupancy;i_{x};i_{y}"              ,100,0.5,100.5,100,0.5,100.5);
+  SparseHist2D h_EEp_E  ("h_EEp_E"  ,"EE+ RecHit Energy (GeV);i_{x};i_{y}"           ,100,0.5,100.5,100,0.5,100.5);
 
+  for (const auto & rec : reader)
+  {
+    if (applyrhEcut && (rec.E < rhEcut)) continue;
 
+    const Int_t detid = rec.detid;
+    if (RecHitDump::IsEB(detid))
+    {
+      const Int_t ieta = RecHitDump::EBieta(detid);
+      const Int_t iphi = RecHitDump::EBiphi(detid);
+      h_EB_occ.Fill(ieta,iphi);
+      h_EB_E  .Fill(ieta,iphi,rec.E);
+    }
+    else if (RecHitDump::IsEE(detid))
+    {
+      const Int_t ix = RecHitDump::EEix(detid);
+      const Int_t iy = RecHitDump::EEiy(detid);
+      SparseHist2D & h_occ = (RecHitDump::EEzside(detid) > 0 ? h_EEp_occ : h_EEm_occ);
+      SparseHist2D & h_E   = (RecHitDump::EEzside(detid) > 0 ? h_EEp_E   : h_EEm_E);
+      h_occ.Fill(ix,iy);
+      h_E  .Fill(ix,iy,rec.E);
+    }
+  }
+  std::cout << "Filled maps from " << reader.size() << " rechits in " << dumpname.Data() << std::endl;
 
+  // dense only for writing
+  outfile->cd();
+  for (const SparseHist2D * sparse : {&h_EB_occ,&h_EB_E,&h_EEm_occ,&h_EEm_E,&h_EEp_occ,&h_EEp_E})
+  {
+    TH2F * hist = sparse->ToTH2F();
+    hist->Write(hist->GetName(),TObject::kWriteDelete);
+    delete hist;
+  }
 
+  delete outfile;
+}
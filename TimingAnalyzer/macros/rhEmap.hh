@@ -6,6 +6,9 @@
 #include "TBranch.h"
 #include "TString.h"
 
+#include "RecHitDump.hh"
+#include "../dispho_work/macros/SparseHist2D.hh"
+
 #include <vector>
 #include <map>
 
@@ -44,6 +47,7 @@ public:
   void DoPlotIndices();
   void DoPlotNatural(const Int_t ientry = -1, const Int_t iph = -1, const Bool_t applyrhEcut = false, const Float_t rhEcut = 0.f);
   void DoAllPlotNatural(const Float_t rhEcut = 0.f);
+  void DoPlotFromDump(const TString & dumpname, const TString & outname, const Bool_t applyrhEcut = false, const Float_t rhEcut = 0.f);
 
 private:
   TFile * fInFile;
@@ -0,0 +1,161 @@
+#ifndef __ArrivalTime__
+#define __ArrivalTime__
+
+// basic C++ types: no ROOT or CMSSW dependencies, so the dispho_work macros and macros can use it too
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////
+//                                                              //
+// Batch arrival time of (gen) photons at the ECAL front face,  //
+// from displaced decay vertices: straight-line intercept with  //
+// the EB cylinder or the EE disks, in structure-of-arrays form //
+// so the kernel vectorizes over photons. Units: cm and ns.     //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+namespace ArrivalTime
+{
+  constexpr float sol = 29.9792458f; // cm/ns
+
+  // ECAL front face
+  constexpr float rEB = 129.f; // 1.29 m
+  constexpr float zEE = 314.f; // 3.14 m
+  constexpr float etaEB    = 1.4442;
+  constexpr float etaEEmin = 1.566;
+  constexpr float etaEEmax = 2.5;
+
+  // r/z of a line through the origin at pseudorapidity eta
+  inline float RoverZ(const float eta) {return 1.f/std::sinh(eta);}
+
+  const float zEB    = rEB / RoverZ(etaEB);
+  const float rEEmin = zEE * RoverZ(etaEEmax);
+  const float rEEmax = zEE * RoverZ(etaEEmin);
+
+  enum Detector {EB = 0, EE = 1, Missed = 2};
+
+  // lab-frame flight time of the parent [ns], from its production and decay vertices [cm] and momentum
+  inline float DecayTime(const float prodvx, const float prodvy, const float prodvz,
+			 const float decayvx, const float decayvy, const float decayvz,
+			 const float p, const float E)
+  {
+    const auto dx = decayvx-prodvx, dy = decayvy-prodvy, dz = decayvz-prodvz;
+    return std::sqrt(dx*dx + dy*dy + dz*dz) * E / (p * sol); // d / (beta*c)
+  }
+
+  // one entry per photon
+  struct Inputs
+  {
+    void clear()
+    {
+      vx.clear(); vy.clear(); vz.clear();
+      dx.clear(); dy.clear(); dz.clear();
+      t0.clear();
+    }
+
+    void reserve(const std::size_t n)
+    {
+      vx.reserve(n); vy.reserve(n); vz.reserve(n);
+      dx.reserve(n); dy.reserve(n); dz.reserve(n);
+      t0.reserve(n);
+    }
+
+    // decay vertex [cm], photon direction, and time of the decay [ns]: direction converted to a unit vector here, outside the kernel
+    void emplace_back(const float vx_, const float vy_, const float vz_, const float eta, const float phi, const float t0_)
+    {
+      const auto sintheta = 1.f/std::cosh(eta);
+      vx.emplace_back(vx_);
+      vy.emplace_back(vy_);
+      vz.emplace_back(vz_);
+      dx.emplace_back(sintheta*std::cos(phi));
+      dy.emplace_back(sintheta*std::sin(phi));
+      dz.emplace_back(std::tanh(eta));
+      t0.emplace_back(t0_);
+    }
+
+    std::size_t size() const {return vx.size();}
+
+    std::vector<float> vx, vy, vz;
+    std::vector<float> dx, dy, dz;
+    std::vector<float> t0;
+  };
+
+  struct Outputs
+  {
+    void resize(const std::size_t n) {det.resize(n); path.resize(n); time.resize(n);}
+
+    std::vector<int> det; // Detector: int, same width as the float lanes
+    std::vector<float> path; // decay vertex to ECAL [cm]
+    std::vector<float> time; // t0 + path/c - (TOF of a prompt photon to the same point) [ns]; -9999 if missed
+  };
+
+  // no I/O, no branches: both intercepts computed for every photon, then blended, so the loop vectorizes
+  // (std::sqrt needs -fno-math-errno, as in the CMSSW build, for gcc to use the vector instruction)
+  inline void Compute(const std::size_t n,
+		      const float * __restrict__ vx, const float * __restrict__ vy, const float * __restrict__ vz,
+		      const float * __restrict__ dx, const float * __restrict__ dy, const float * __restrict__ dz,
+		      const float * __restrict__ t0,
+		      int * __restrict__ det, float * __restrict__ path, float * __restrict__ time)
+  {
+    const auto rEB2    = rEB*rEB;
+    const auto rEEmin2 = rEEmin*rEEmin;
+    const auto rEEmax2 = rEEmax*rEEmax;
+    const auto tiny    = 1e-12f;
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+      // EB: |v_T + s*d_T| = rEB, outgoing root (always real for a decay inside the cylinder)
+      const auto a = std::max(dx[i]*dx[i] + dy[i]*dy[i],tiny);
+      const auto b = vx[i]*dx[i] + vy[i]*dy[i];
+      const auto c = vx[i]*vx[i] + vy[i]*vy[i] - rEB2;
+      const auto sEB = (std::sqrt(std::max(b*b - a*c,0.f)) - b) / a;
+      const auto zEBhit = vz[i] + sEB*dz[i];
+
+      // EE: disk on the side the photon heads to (dz == 0 never reaches it)
+      const auto zdisk = std::copysign(zEE,dz[i]);
+      const auto sEE   = (zdisk - vz[i]) / std::copysign(std::max(std::abs(dz[i]),tiny),dz[i]);
+      const auto xEE   = vx[i] + sEE*dx[i];
+      const auto yEE   = vy[i] + sEE*dy[i];
+      const auto rEE2  = xEE*xEE + yEE*yEE;
+
+      // decay must be inside the ECAL volume: masks as 0/1 and blends instead of selects,
+      // so there is neither a branch nor a conditional store for the vectorizer to trip on
+      const int inside = (c < 0.f) & (std::abs(vz[i]) < zEE);
+      const int isEB   = inside & (std::abs(zEBhit) < zEB);
+      const int isEE   = inside & (1-isEB) & (rEE2 > rEEmin2) & (rEE2 < rEEmax2);
+      const float fEB  = isEB;
+      const float fEE  = isEE;
+
+      // hit point and its distance from the origin
+      const auto s     = fEB*sEB    + (1.f-fEB)*sEE;
+      const auto rhit2 = fEB*rEB2   + (1.f-fEB)*rEE2;
+      const auto zhit  = fEB*zEBhit + (1.f-fEB)*zdisk;
+      const auto tof   = std::sqrt(rhit2 + zhit*zhit) / sol;
+
+      det [i] = Detector::Missed - (Detector::Missed-Detector::EB)*isEB - (Detector::Missed-Detector::EE)*isEE;
+      path[i] = (fEB+fEE) * s;
+      time[i] = (fEB+fEE) * (t0[i] + s/sol - tof) + (1.f-fEB-fEE) * -9999.f;
+    }
+  }
+
+  inline void Compute(const Inputs & in, Outputs & out)
+  {
+    const auto n = in.size();
+    out.resize(n);
+    Compute(n,in.vx.data(),in.vy.data(),in.vz.data(),in.dx.data(),in.dy.data(),in.dz.data(),in.t0.data(),
+	    out.det.data(),out.path.data(),out.time.data());
+  }
+
+  // single photon, for one-off use outside of batch loops
+  inline float Compute(const float vx, const float vy, const float vz, const float eta, const float phi, const float t0,
+		       int & det, float & path)
+  {
+    Inputs in; in.emplace_back(vx,vy,vz,eta,phi,t0);
+    float time;
+    Compute(1,in.vx.data(),in.vy.data(),in.vz.data(),in.dx.data(),in.dy.data(),in.dz.data(),in.t0.data(),&det,&path,&time);
+    return time;
+  }
+};
+
+#endif
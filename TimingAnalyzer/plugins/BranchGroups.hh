@@ -0,0 +1,171 @@
+#ifndef __BranchGroups__
+#define __BranchGroups__
+
+// ROOT includes: no CMSSW dependencies, so the macros and the standalone analyses can use it too
+#include "TTree.h"
+#include "TBranch.h"
+#include "TObjArray.h"
+#include "TRegexp.h"
+#include "TString.h"
+
+// basic C++ types
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <map>
+
+//////////////////////////////////////////////////////////////////
+//                                                              //
+// Branch dependencies of the plot groups: each group declares  //
+// the branches (or wildcards) it reads, only the branches of   //
+// enabled groups are switched on, and entries are read branch  //
+// by branch instead of with TTree::GetEntry. Eager groups are  //
+// read for every entry, lazy ones only when Load()-ed.         //
+// Bytes read are accounted per group for the end-of-run report //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+class BranchGroups
+{
+public:
+  BranchGroups() : fTree(NULL), fEntry(-1) {}
+
+  void SetTree(TTree * tree) {fTree = tree;}
+
+  // names may use the same wildcards as TTree::SetBranchStatus; returns the handle for Load()
+  UInt_t Declare(const TString & group, const std::vector<TString> & branches, const Bool_t lazy = false)
+  {
+    const auto igroup = BranchGroups::Index(group);
+    auto & grp = fGroups[igroup];
+    grp.names.insert(grp.names.end(),branches.begin(),branches.end());
+    grp.lazy = lazy;
+    return igroup;
+  }
+
+  void Enable(const TString & group, const Bool_t enable = true) {fGroups[BranchGroups::Index(group)].enabled = enable;}
+
+  // everything off, then only what the enabled groups declared: missing branches are skipped (with a warning)
+  void Activate()
+  {
+    fTree->SetBranchStatus("*",0);
+
+    const auto branches = fTree->GetListOfBranches();
+    for (auto & grp : fGroups)
+    {
+      grp.branches.clear();
+      if (!grp.enabled) continue;
+
+      for (const auto & name : grp.names)
+      {
+	const Bool_t wildcard = (name.First('*') != kNPOS || name.First('?') != kNPOS);
+	if (!wildcard)
+	{
+	  auto branch = fTree->GetBranch(name.Data());
+	  if (branch) grp.branches.emplace_back(branch);
+	  else std::cout << "BranchGroups: no branch " << name.Data() << " for group " << grp.name.Data() << ", skipping" << std::endl;
+	  continue;
+	}
+
+	const TRegexp regexp(name,kTRUE);
+	for (auto ibranch = 0; ibranch < branches->GetEntriesFast(); ibranch++)
+	{
+	  auto branch = static_cast<TBranch*>(branches->UncheckedAt(ibranch));
+	  if (TString(branch->GetName()).Index(regexp) == 0) grp.branches.emplace_back(branch);
+	}
+      }
+
+      for (auto branch : grp.branches) fTree->SetBranchStatus(branch->GetName(),1);
+    }
+    fEntry = -1;
+  }
+
+  // eager groups; a branch shared by several groups is read once per entry, and charged to the first one reading it
+  Int_t GetEntry(const Long64_t entry)
+  {
+    fEntry = fTree->LoadTree(entry);
+
+    Int_t nbytes = 0;
+    for (auto & grp : fGroups)
+    {
+      if (grp.enabled && !grp.lazy) nbytes += BranchGroups::Read(grp);
+    }
+    return nbytes;
+  }
+
+  // lazy group, for the entry of the last GetEntry()
+  Int_t Load(const UInt_t igroup) {return BranchGroups::Read(fGroups[igroup]);}
+  Int_t Load(const TString & group)
+  {
+    const auto iter = fIndices.find(group);
+    return (iter != fIndices.end() ? BranchGroups::Read(fGroups[iter->second]) : 0);
+  }
+
+  void Report(std::ostream & out = std::cout) const
+  {
+    Long64_t total = 0;
+    for (const auto & grp : fGroups) total += grp.bytes;
+
+    out << "Bytes read per branch group:" << std::endl;
+    for (const auto & grp : fGroups)
+    {
+      if (!grp.enabled) continue;
+      out << "  " << std::setw(12) << std::left << grp.name.Data() << std::right
+	  << " branches: " << std::setw(4) << grp.branches.size()
+	  << " entries: "  << std::setw(9) << grp.nentries
+	  << " MB: "       << std::setw(10) << std::fixed << std::setprecision(2) << grp.bytes/1048576.0
+	  << " ("          << std::setw(5) << (total > 0 ? 100.0*grp.bytes/total : 0.0) << "%)"
+	  << (grp.lazy ? " [lazy]" : "") << std::endl;
+    }
+    out << "  total MB: " << std::fixed << std::setprecision(2) << total/1048576.0 << std::endl;
+    out.unsetf(std::ios_base::floatfield);
+  }
+
+private:
+  struct Group
+  {
+    Group(const TString & name) : name(name), lazy(false), enabled(false), bytes(0), nentries(0) {}
+
+    TString name;
+    std::vector<TString> names;
+    Bool_t lazy;
+    Bool_t enabled;
+
+    std::vector<TBranch*> branches;
+    Long64_t bytes;
+    Long64_t nentries;
+  };
+
+  UInt_t Index(const TString & group)
+  {
+    const auto iter = fIndices.find(group);
+    if (iter != fIndices.end()) return iter->second;
+
+    fGroups.emplace_back(group);
+    return (fIndices[group] = fGroups.size()-1);
+  }
+
+  Int_t Read(Group & grp)
+  {
+    if (fEntry < 0) return 0;
+
+    Int_t nbytes = 0;
+    Bool_t read = false;
+    for (auto branch : grp.branches)
+    {
+      if (branch->GetReadEntry() == fEntry) continue;
+      nbytes += branch->GetEntry(fEntry);
+      read = true;
+    }
+    grp.bytes += nbytes;
+    if (read) grp.nentries++;
+    return nbytes;
+  }
+
+  TTree * fTree;
+  Long64_t fEntry;
+
+  std::vector<Group> fGroups;
+  std::map<TString,UInt_t> fIndices;
+};
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef __ColumnStats__
+#define __ColumnStats__
+
+// ROOT includes: no CMSSW dependencies, so the standalone analyses can use it
+#include "TH2F.h"
+#include "TAxis.h"
+
+// basic C++ types
+#include <vector>
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////
+//                                                              //
+// Per-column (x bin) statistics of y, straight from the bin    //
+// content array of a 2D histogram: no projected TH1 per x bin. //
+// Rows of the array are contiguous in x, so all columns are    //
+// accumulated together, row by row. Mean and its error follow  //
+// TH1::GetMean()/GetMeanError() of the projection (in-range    //
+// bins), the quantile and its up/down errors the cumulative    //
+// "efficiency" crossing used by the dispho_work plots.         //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+namespace ColumnStats
+{
+  struct Column
+  {
+    Column() : filled(false), sumw(0.0), sumwy(0.0), sumwy2(0.0), sumw2(0.0),
+	       mean(0.0), emean(0.0), stddev(0.0), quant(0.f), equant_dn(0.f), equant_up(0.f) {}
+
+    Bool_t   filled; // anything > 0 in the column, under/overflow included: empty columns are skipped by the callers
+
+    // in-range sums over y
+    Double_t sumw, sumwy, sumwy2, sumw2;
+
+    Double_t mean, emean, stddev;
+    Float_t  quant, equant_dn, equant_up;
+  };
+
+  // first crossing of eff +/- err above qprob, with linear interpolation to the previous bin (x stays 0 if that fails)
+  struct Crossing
+  {
+    Crossing() : found(false), x(0.f), prev_eff(0.f), prev_center(0.f), ibin(0) {}
+
+    void Update(const Float_t eff, const Float_t center, const Float_t qprob)
+    {
+      ibin++;
+      if (found) return;
+      if (eff > qprob)
+      {
+	found = true;
+	if (ibin > 1 && eff > 0.f && prev_eff > 0.f && (center-prev_center) > 0.f)
+	{
+	  const Float_t slope = (eff-prev_eff)/(center-prev_center);
+	  if (slope > 0.f) x = (qprob - (eff-slope*center))/slope;
+	}
+	return;
+      }
+      prev_eff    = eff;
+      prev_center = center;
+    }
+
+    Bool_t  found;
+    Float_t x;
+    Float_t prev_eff;
+    Float_t prev_center;
+    Int_t   ibin;
+  };
+
+  // columns indexed by x bin (0 and nx+1 stay empty)
+  inline std::vector<Column> Compute(const TH2F * hist2d, const Float_t qprob)
+  {
+    const Int_t nx = hist2d->GetNbinsX();
+    const Int_t ny = hist2d->GetNbinsY();
+    const Int_t stride = nx+2;
+    const Float_t  * content = hist2d->GetArray();
+    const Double_t * sumw2   = (hist2d->GetSumw2N() > 0 ? hist2d->GetSumw2()->GetArray() : NULL);
+    const TAxis    * yaxis   = hist2d->GetYaxis();
+
+    std::vector<Column> columns(stride);
+
+    // pass 1: sums, row by row
+    for (Int_t iy = 0; iy <= ny+1; iy++)
+    {
+      const Float_t * row = content + iy*stride;
+      const Bool_t inrange = (iy >= 1 && iy <= ny);
+      const Double_t y = yaxis->GetBinCenter(iy);
+
+      for (Int_t ix = 1; ix <= nx; ix++)
+      {
+	const Double_t w = row[ix];
+	auto & column = columns[ix];
+	if (w > 0.0) column.filled = true;
+	if (!inrange) continue;
+
+	column.sumw   += w;
+	column.sumwy  += w*y;
+	column.sumwy2 += w*y*y;
+	column.sumw2  += (sumw2 ? sumw2[ix+iy*stride] : w*w);
+      }
+    }
+
+    for (Int_t ix = 1; ix <= nx; ix++)
+    {
+      auto & column = columns[ix];
+      if (column.sumw == 0.0) continue;
+      column.mean   = column.sumwy/column.sumw;
+      column.stddev = std::sqrt(std::abs(column.sumwy2/column.sumw - column.mean*column.mean));
+      const Double_t neff = (column.sumw2 != 0.0 ? column.sumw*column.sumw/column.sumw2 : std::abs(column.sumw));
+      column.emean  = (neff > 0.0 ? column.stddev/std::sqrt(neff) : 0.0);
+    }
+
+    // pass 2: cumulative fraction of each column, and its binomial error
+    std::vector<Float_t> cumsum(stride,0.f);
+    std::vector<Bool_t> found(stride,false);
+    std::vector<Crossing> up(stride), dn(stride);
+    for (Int_t iy = 1; iy <= ny; iy++)
+    {
+      const Float_t * row = content + iy*stride;
+      const Float_t center = yaxis->GetBinCenter(iy);
+
+      for (Int_t ix = 1; ix <= nx; ix++)
+      {
+	const Float_t integral = columns[ix].sumw;
+	cumsum[ix] += row[ix];
+
+	Float_t eff = 0.f, eff_err = 0.f;
+	if (cumsum[ix] != 0.f && integral != 0.f)
+	{
+	  eff     = cumsum[ix]/integral;
+	  eff_err = std::sqrt(eff*(1.f-eff)/integral);
+	}
+
+	// nominal: the center of the crossing bin itself
+	if (!found[ix] && eff > qprob) {columns[ix].quant = center; found[ix] = true;}
+	up[ix].Update(eff+eff_err,center,qprob);
+	dn[ix].Update(eff-eff_err,center,qprob);
+      }
+    }
+
+    for (Int_t ix = 1; ix <= nx; ix++)
+    {
+      auto & column = columns[ix];
+      column.equant_dn = (dn[ix].found ? std::abs(column.quant-dn[ix].x) : 0.f);
+      column.equant_up = (up[ix].found ? std::abs(column.quant-up[ix].x) : 0.f);
+    }
+
+    return columns;
+  }
+};
+
+#endif
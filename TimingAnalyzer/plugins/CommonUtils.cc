@@ -3,6 +3,61 @@
 
 namespace oot
 {
+  ///////////////////
+  //               //
+  // Trigger Cache //
+  //               //
+  ///////////////////
+
+  int TriggerCache::addPath(const std::string & path)
+  {
+    pathNames_.emplace_back(path);
+    bits_.emplace_back(false);
+    menuID_ = edm::ParameterSetID(); // force re-resolving the menu
+    return pathNames_.size()-1;
+  }
+
+  int TriggerCache::addFilter(const std::string & filter)
+  {
+    const int ifilter = filterNames_.size();
+    filterNames_.emplace_back(filter);
+    if (filter.find('*') != std::string::npos) wildcardFilters_.emplace_back(ifilter);
+    else                                       filterIndexMap_[filter].emplace_back(ifilter);
+    isL1T_.emplace_back(filter == Config::L1Trigger);
+    objects_.emplace_back();
+    return ifilter;
+  }
+
+  int TriggerCache::getPathIndex(const std::string & path) const
+  {
+    const auto iter = std::find(pathNames_.begin(),pathNames_.end(),path);
+    return (iter != pathNames_.end() ? iter-pathNames_.begin() : -1);
+  }
+
+  int TriggerCache::getFilterIndex(const std::string & filter) const
+  {
+    const auto iter = std::find(filterNames_.begin(),filterNames_.end(),filter);
+    return (iter != filterNames_.end() ? iter-filterNames_.begin() : -1);
+  }
+
+  void TriggerCache::updateMenu(const edm::TriggerNames & triggerNames)
+  {
+    if (menuID_.isValid() && triggerNames.parameterSetID() == menuID_) return;
+
+    // user path names are substrings of menu names (i.e. without version numbers): last match wins
+    menuIndices_.assign(pathNames_.size(),-1);
+    for (std::size_t itrig = 0; itrig < triggerNames.size(); itrig++)
+    {
+      const std::string & triggerName = triggerNames.triggerName(itrig);
+      for (std::size_t ipath = 0; ipath < pathNames_.size(); ipath++)
+      {
+	if (triggerName.find(pathNames_[ipath]) != std::string::npos) menuIndices_[ipath] = itrig;
+      } // end loop over user path names
+    } // end loop over trigger names
+
+    menuID_ = triggerNames.parameterSetID();
+  }
+
   /////////////////
   //             //
   // Object Prep //
@@ -10,7 +65,7 @@ namespace oot
   /////////////////
 
   void ReadInTriggerNames(const std::string & inputPaths, std::vector<std::string> & pathNames, 
-			  strBitMap & triggerBitMap)
+			  TriggerCache & triggerCache)
   {
     if (Config::file_exists(inputPaths))
     {
@@ -22,7 +77,7 @@ namespace oot
 	if (path != "") 
 	{
 	  pathNames.emplace_back(path);
-	  triggerBitMap[path] = false;
+	  triggerCache.addPath(path);
 	}
       }
       pathStream.close();
@@ -30,7 +85,7 @@ namespace oot
   }
 
   void ReadInFilterNames(const std::string & inputFilters, std::vector<std::string> & filterNames, 
-			 trigObjVecMap & triggerObjectsByFilterMap)
+			 TriggerCache & triggerCache)
   {
     if (Config::file_exists(inputFilters))
     {
@@ -42,7 +97,7 @@ namespace oot
 	if (label != "") 
 	{
 	  filterNames.emplace_back(label);
-	  triggerObjectsByFilterMap[label].clear();
+	  triggerCache.addFilter(label);
 	}
       }
       filterStream.close();
@@ -109,55 +164,64 @@ namespace oot
   }
 
   void PrepTriggerBits(edm::Handle<edm::TriggerResults> & triggerResultsH, 
-		       const edm::Event & iEvent, strBitMap & triggerBitMap)
+		       const edm::Event & iEvent, TriggerCache & triggerCache)
   {
-    for (auto & triggerBitPair : triggerBitMap) 
-    {
-      triggerBitPair.second = false;
-    }
+    auto & bits = triggerCache.bits_;
+    std::fill(bits.begin(),bits.end(),false);
     
     if (triggerResultsH.isValid())
     {
-      const edm::TriggerNames &triggerNames = iEvent.triggerNames(*triggerResultsH);
-      for (std::size_t itrig = 0; itrig < triggerNames.size(); itrig++)
+      // only does string matching when the menu changes
+      triggerCache.updateMenu(iEvent.triggerNames(*triggerResultsH));
+
+      const auto & menuIndices = triggerCache.menuIndices_;
+      for (std::size_t ipath = 0; ipath < menuIndices.size(); ipath++)
       {
-	std::string triggerName = triggerNames.triggerName(itrig);
-      
-	for (auto & triggerBitPair : triggerBitMap) 
-	{
-	  if (triggerName.find(triggerBitPair.first) != std::string::npos) triggerBitPair.second = triggerResultsH->accept(itrig);
-	} // end loop over user path names
-      } // end loop over trigger names
+	if (menuIndices[ipath] >= 0) bits[ipath] = triggerResultsH->accept(menuIndices[ipath]);
+      } // end loop over user path names
     } // end check over valid TriggerResults
   }
   
   void PrepTriggerObjects(const edm::Handle<edm::TriggerResults> & triggerResultsH,
 			  const edm::Handle<std::vector<pat::TriggerObjectStandAlone> > & triggerObjectsH,
-			  const edm::Event & iEvent, trigObjVecMap & triggerObjectsByFilterMap)
+			  const edm::Event & iEvent, TriggerCache & triggerCache)
   {
     // clear first
-    for (auto& triggerObjectsByFilterPair : triggerObjectsByFilterMap)
+    auto & objects = triggerCache.objects_;
+    for (auto & filterObjects : objects)
     {
-      triggerObjectsByFilterPair.second.clear();
+      filterObjects.clear();
     }
+    if (objects.empty()) return;
     
     // store all the trigger objects needed to be checked later
     if (triggerObjectsH.isValid() && triggerResultsH.isValid())
     {
-      const edm::TriggerNames &triggerNames = iEvent.triggerNames(*triggerResultsH);
-      for (pat::TriggerObjectStandAlone triggerObject : *triggerObjectsH) 
+      const auto & filterIndexMap = triggerCache.filterIndexMap_;
+      for (const auto & packedObject : *triggerObjectsH) 
       {
-	triggerObject.unpackPathNames(triggerNames);
+	// copy needed to unpack: path names are never used, so only unpack filter labels
+	pat::TriggerObjectStandAlone triggerObject(packedObject);
 	triggerObject.unpackFilterLabels(iEvent, *triggerResultsH);
-	for (auto& triggerObjectsByFilterPair : triggerObjectsByFilterMap)
-	{	
-	  if (triggerObject.hasFilterLabel(triggerObjectsByFilterPair.first)) triggerObjectsByFilterPair.second.emplace_back(triggerObject);
-	} // end loop over user filter names
+
+	// one hash lookup per label of this object, rather than a scan of its labels per user filter
+	for (const auto & filterLabel : triggerObject.filterLabels())
+	{
+	  const auto iter = filterIndexMap.find(filterLabel);
+	  if (iter == filterIndexMap.end()) continue;
+	  for (const auto ifilter : iter->second) objects[ifilter].emplace_back(triggerObject);
+	} // end loop over object filter labels
+
+	// wildcards as before: hasFilterLabel() matches them against every label
+	for (const auto ifilter : triggerCache.wildcardFilters_)
+	{
+	  if (triggerObject.hasFilterLabel(triggerCache.filterNames_[ifilter])) objects[ifilter].emplace_back(triggerObject);
+	} // end loop over user wildcard filters
       } // end loop over trigger objects
 
-      for (auto& triggerObjectsByFilterPair : triggerObjectsByFilterMap)
+      for (auto & filterObjects : objects)
       {
-	std::sort(triggerObjectsByFilterPair.second.begin(),triggerObjectsByFilterPair.second.end(),oot::sortByPt);
+	std::sort(filterObjects.begin(),filterObjects.end(),oot::sortByPt);
       }
     }
   }
@@ -142,11 +142,57 @@ typedef std::vector<reco::GenParticle> genPartVec;
 // Trigger Object Typedefs //
 //                         //
 /////////////////////////////
-typedef std::map<std::string,bool> strBitMap;
-typedef std::map<std::string,std::vector<pat::TriggerObjectStandAlone> > trigObjVecMap;
+typedef std::vector<pat::TriggerObjectStandAlone> trigObjVec;
 
 namespace oot
 {
+  // user paths and filters resolved to integer indices: paths are matched to the trigger menu once per menu 
+  // (i.e. when the TriggerNames parameter set ID changes), so no string work is left in the per-event path
+  class TriggerCache
+  {
+  public:
+    TriggerCache() {}
+    ~TriggerCache() {}
+
+    // setup: index is order of addition, one slot per call even for a name added before,
+    // so indices follow the callers' own pathNames/filterNames; lookups return the first slot
+    int addPath(const std::string & path);
+    int addFilter(const std::string & filter);
+    int getPathIndex(const std::string & path) const;
+    int getFilterIndex(const std::string & filter) const;
+
+    std::size_t nPaths() const {return pathNames_.size();}
+    std::size_t nFilters() const {return filterNames_.size();}
+
+    // per event: fixed bitset of user paths, and trigger objects per user filter (sorted by pt)
+    bool accept(const int ipath) const {return (ipath >= 0 && std::size_t(ipath) < bits_.size() && bits_[ipath]);}
+    bool anyAccept() const {return std::find(bits_.begin(),bits_.end(),true) != bits_.end();}
+    const trigObjVec & objects(const int ifilter) const {return objects_[ifilter];}
+    bool isL1T(const int ifilter) const {return isL1T_[ifilter];}
+
+    friend void PrepTriggerBits(edm::Handle<edm::TriggerResults> & triggerResultsH, 
+				const edm::Event & iEvent, TriggerCache & triggerCache);
+    friend void PrepTriggerObjects(const edm::Handle<edm::TriggerResults> & triggerResultsH,
+				   const edm::Handle<std::vector<pat::TriggerObjectStandAlone> > & triggerObjectsH,
+				   const edm::Event & iEvent, TriggerCache & triggerCache);
+
+  private:
+    void updateMenu(const edm::TriggerNames & triggerNames);
+
+    // paths
+    std::vector<std::string> pathNames_;
+    std::vector<int> menuIndices_; // index in trigger menu per user path, -1 if not in menu
+    edm::ParameterSetID menuID_;
+    std::vector<bool> bits_;
+
+    // filters
+    std::vector<std::string> filterNames_;
+    std::unordered_map<std::string,std::vector<int> > filterIndexMap_; // exact labels
+    std::vector<int> wildcardFilters_; // labels with '*': matched by pat::TriggerObjectStandAlone::hasFilterLabel()
+    std::vector<bool> isL1T_;
+    std::vector<trigObjVec> objects_;
+  };
+
   // special ootPhoton class
   class Photon
   {
@@ -170,24 +216,18 @@ namespace oot
   // sort by pt template
   const auto sortByPt = [](const auto& obj1, const auto& obj2) {return obj1.pt() > obj2.pt();};
 
-  // sort by closest to z-mass
-  inline bool minimizeByZmass(const triple& pair1, const triple& pair2)
-  {
-    return std::get<2>(pair1)<std::get<2>(pair2);
-  }
-
   void ReadInTriggerNames(const std::string & inputPaths, std::vector<std::string> & pathNames, 
-			  strBitMap & triggerBits);
+			  TriggerCache & triggerCache);
   void ReadInFilterNames(const std::string & inputFilters, std::vector<std::string> & filterNames, 
-			 trigObjVecMap & triggerObjectsByFilter);
+			 TriggerCache & triggerCache);
   void PrepNeutralinos(const edm::Handle<std::vector<reco::GenParticle> >& genparticlesH, genPartVec& neutralinos);
   void PrepVPions(const edm::Handle<std::vector<reco::GenParticle> > & genparticlesH, genPartVec& vPions);
   void PrepToys(const edm::Handle<std::vector<reco::GenParticle> >& genparticlesH, genPartVec& toys);
   void PrepTriggerBits(edm::Handle<edm::TriggerResults> & triggerResultsH, 
-		       const edm::Event & iEvent, strBitMap & triggerBitMap);
+		       const edm::Event & iEvent, TriggerCache & triggerCache);
   void PrepTriggerObjects(const edm::Handle<edm::TriggerResults> & triggerResultsH,
 			  const edm::Handle<std::vector<pat::TriggerObjectStandAlone> > & triggerObjectsH,
-			  const edm::Event & iEvent, trigObjVecMap & triggerObjectsByFilterMap);
+			  const edm::Event & iEvent, TriggerCache & triggerCache);
   void PrepJets(const edm::Handle<std::vector<pat::Jet> > & jetsH, 
 		std::vector<pat::Jet> & jets, const float jetpTmin = 0.f, 
 		const float jetEtamax = 100.f, const int jetID = -1);
@@ -240,15 +280,15 @@ namespace oot
 
   // templates MUST be in header if included elsewhere
   template <typename Obj>
-  void HLTToObjectMatching(const trigObjVecMap & triggerObjectsByFilterMap, strBitMap & isHLTMatched, 
+  void HLTToObjectMatching(const TriggerCache & triggerCache, std::vector<bool> & isHLTMatched, 
 			   const Obj& obj, const float pTres = 1.f, const float dRmin = 100.f)
   {
-    for (const auto & triggerObjectsByFilterPair : triggerObjectsByFilterMap)
+    isHLTMatched.assign(triggerCache.nFilters(),false);
+    for (std::size_t ifilter = 0; ifilter < triggerCache.nFilters(); ifilter++)
     {
-      const auto & filterName = triggerObjectsByFilterPair.first;
-      const bool isL1T = (filterName == Config::L1Trigger.c_str());
+      const bool isL1T = triggerCache.isL1T(ifilter);
 
-      for (const auto & triggerObject : triggerObjectsByFilterPair.second)
+      for (const auto & triggerObject : triggerCache.objects(ifilter))
       {
 	if (!isL1T)
 	{
@@ -257,7 +297,7 @@ namespace oot
 	}
 	if (reco::deltaR(obj,triggerObject) < dRmin)
 	{
-	  isHLTMatched[filterName] = true; 
+	  isHLTMatched[ifilter] = true; 
 	  break;
 	} // end check deltaR
       } // end loop over trigger objects 
@@ -0,0 +1,261 @@
+#ifndef __CutFlow__
+#define __CutFlow__
+
+// ROOT includes: no CMSSW dependencies, so the dispho_work macros can use it too
+#include "TH1F.h"
+#include "TString.h"
+
+// basic C++ types
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <chrono>
+#include <mutex>
+
+//////////////////////////////////////////////////////////////////
+//                                                              //
+// Cut flow accounting: cuts registered once to integer slots,  //
+// so filling is an array increment instead of a label lookup.  //
+// Slot i always maps to bin i+1 of the exported histograms.    //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+// per-thread counters: each worker owns one, merged into the CutFlow at the end
+class CutFlowCounters
+{
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  CutFlowCounters() : fFirst(0), fPending(-1), fTiming(true) {}
+  CutFlowCounters(const Int_t ncuts, const Int_t first) : fTiming(true) {Resize(ncuts,first);}
+
+  void Resize(const Int_t ncuts, const Int_t first)
+  {
+    nRaw   .assign(ncuts,0);
+    sumWgt .assign(ncuts,0.0);
+    sumWgt2.assign(ncuts,0.0);
+    sumScl .assign(ncuts,0.0);
+    sumScl2.assign(ncuts,0.0);
+    time   .assign(ncuts,0.0);
+    fFirst   = first;
+    fPending = -1;
+  }
+
+  void SetTiming(const Bool_t timing) {fTiming = timing;}
+
+  // time between marks is charged to the cut being evaluated, i.e. the slot after the last one passed:
+  // events failing a cut pay for it at the start of the next event, time after the last cut is not charged
+  inline void StartEvent()
+  {
+    if (!fTiming) return;
+    const auto now = Clock::now();
+    if (fPending >= 0 && fPending < Int_t(time.size())) time[fPending] += std::chrono::duration<Double_t>(now-fMark).count();
+    fPending = fFirst;
+    fMark    = now;
+  }
+
+  inline void Fill(const Int_t slot, const Double_t wgt = 1.0, const Double_t scl = 1.0)
+  {
+    nRaw   [slot] += 1;
+    sumWgt [slot] += wgt;
+    sumWgt2[slot] += wgt*wgt;
+    sumScl [slot] += scl;
+    sumScl2[slot] += scl*scl;
+  }
+
+  // event survived cut in slot: count it, and charge the elapsed time to it
+  inline void Pass(const Int_t slot, const Double_t wgt = 1.0, const Double_t scl = 1.0)
+  {
+    Fill(slot,wgt,scl);
+    if (!fTiming) return;
+    const auto now = Clock::now();
+    time[slot] += std::chrono::duration<Double_t>(now-fMark).count();
+    fPending = slot+1;
+    fMark    = now;
+  }
+
+  // for cuts evaluated in bulk (e.g. TTree::Draw), rather than event by event
+  inline void AddTime(const Int_t slot, const Double_t seconds) {time[slot] += seconds;}
+
+  // raw counts, and sums (of squares) of weights per slot
+  std::vector<Long64_t> nRaw;
+  std::vector<Double_t> sumWgt;
+  std::vector<Double_t> sumWgt2;
+  std::vector<Double_t> sumScl;
+  std::vector<Double_t> sumScl2;
+  std::vector<Double_t> time; // seconds
+
+private:
+  Int_t fFirst;
+  Int_t fPending;
+  Bool_t fTiming;
+  Clock::time_point fMark;
+};
+
+class CutFlow
+{
+public:
+  CutFlow() : fNInherited(0) {}
+
+  // slots for the labels of an upstream cut flow: kept as is, never filled here
+  void Inherit(const TH1F * inhist)
+  {
+    const auto nbinsX = inhist->GetNbinsX();
+    for (auto ibin = 1; ibin <= nbinsX; ibin++) CutFlow::Register(inhist->GetXaxis()->GetBinLabel(ibin));
+    fNInherited = fLabels.size();
+  }
+
+  // setup time only: returns the slot to fill with (the same one for a label registered twice)
+  Int_t Register(const std::string & label)
+  {
+    const auto iter = fSlots.find(label);
+    if (iter != fSlots.end())
+    {
+      // an inherited slot is never exported: its counts would be lost
+      if (iter->second < fNInherited)
+      {
+	std::cerr << "Cut flow label is already one of the inherited cuts: " << label.c_str() << " ...exiting..." << std::endl;
+	exit(1);
+      }
+      return iter->second;
+    }
+
+    const Int_t slot = fLabels.size();
+    fLabels.emplace_back(label);
+    fSlots[label] = slot;
+    fCounters.Resize(fLabels.size(),fNInherited);
+    fMerged  .Resize(fLabels.size(),fNInherited);
+    return slot;
+  }
+
+  Int_t GetSlot(const std::string & label) const
+  {
+    const auto iter = fSlots.find(label);
+    return (iter != fSlots.end() ? iter->second : -1);
+  }
+
+  Int_t GetNCuts() const {return fLabels.size();}
+  Int_t GetNInherited() const {return fNInherited;}
+  const std::string & GetLabel(const Int_t slot) const {return fLabels[slot];}
+
+  // counters for a worker thread, sized to the registered cuts: register everything first!
+  CutFlowCounters MakeCounters() const {return CutFlowCounters(fLabels.size(),fNInherited);}
+  void Merge(const CutFlowCounters & counters)
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    for (auto slot = 0U; slot < fLabels.size(); slot++)
+    {
+      fMerged.nRaw   [slot] += counters.nRaw   [slot];
+      fMerged.sumWgt [slot] += counters.sumWgt [slot];
+      fMerged.sumWgt2[slot] += counters.sumWgt2[slot];
+      fMerged.sumScl [slot] += counters.sumScl [slot];
+      fMerged.sumScl2[slot] += counters.sumScl2[slot];
+      fMerged.time   [slot] += counters.time   [slot];
+    }
+  }
+
+  // single-threaded use: fill the built-in counters directly
+  inline void StartEvent() {fCounters.StartEvent();}
+  inline void Pass(const Int_t slot, const Double_t wgt = 1.0, const Double_t scl = 1.0) {fCounters.Pass(slot,wgt,scl);}
+  inline void Fill(const Int_t slot, const Double_t wgt = 1.0, const Double_t scl = 1.0) {fCounters.Fill(slot,wgt,scl);}
+  inline void AddTime(const Int_t slot, const Double_t seconds) {fCounters.AddTime(slot,seconds);}
+  void SetTiming(const Bool_t timing) {fCounters.SetTiming(timing);}
+
+  // new histogram with one bin per slot, inherited bins copied from the upstream cut flow
+  TH1F * MakeHist(const TString & name, const TString & title, const TH1F * inhist = NULL) const
+  {
+    auto hist = new TH1F(name.Data(),title.Data(),fLabels.size(),0,fLabels.size());
+    hist->Sumw2();
+    CutFlow::SetLabels(hist);
+
+    if (inhist != NULL)
+    {
+      for (auto slot = 0; slot < fNInherited; slot++)
+      {
+	hist->SetBinContent(slot+1,inhist->GetBinContent(slot+1));
+	hist->SetBinError  (slot+1,inhist->GetBinError  (slot+1));
+      }
+      hist->GetYaxis()->SetTitle(inhist->GetYaxis()->GetTitle());
+    }
+    return hist;
+  }
+
+  void SetLabels(TH1F * hist) const
+  {
+    for (auto slot = 0U; slot < fLabels.size(); slot++) hist->GetXaxis()->SetBinLabel(slot+1,fLabels[slot].c_str());
+  }
+
+  // add built-in plus merged counters to existing cut flows: any of them may be NULL
+  void Export(TH1F * h_raw, TH1F * h_wgt, TH1F * h_scl) const
+  {
+    for (auto slot = fNInherited; slot < Int_t(fLabels.size()); slot++)
+    {
+      const auto nRaw = Double_t(fCounters.nRaw[slot]+fMerged.nRaw[slot]);
+      if (h_raw != NULL) CutFlow::AddToBin(h_raw,slot+1,nRaw,nRaw);
+      if (h_wgt != NULL) CutFlow::AddToBin(h_wgt,slot+1,fCounters.sumWgt[slot]+fMerged.sumWgt[slot],fCounters.sumWgt2[slot]+fMerged.sumWgt2[slot]);
+      if (h_scl != NULL) CutFlow::AddToBin(h_scl,slot+1,fCounters.sumScl[slot]+fMerged.sumScl[slot],fCounters.sumScl2[slot]+fMerged.sumScl2[slot]);
+    }
+  }
+
+  // cost of each selection step, in seconds summed over all events (and workers)
+  TH1F * MakeTimeHist(const TString & name) const
+  {
+    auto hist = new TH1F(name.Data(),"Cut Flow Time",fLabels.size(),0,fLabels.size());
+    CutFlow::SetLabels(hist);
+    CutFlow::ExportTime(hist);
+    hist->GetYaxis()->SetTitle("Time [s]");
+    return hist;
+  }
+
+  void ExportTime(TH1F * hist) const
+  {
+    for (auto slot = fNInherited; slot < Int_t(fLabels.size()); slot++)
+    {
+      hist->AddBinContent(slot+1,fCounters.time[slot]+fMerged.time[slot]);
+    }
+  }
+
+  // efficiency and cost per selection step
+  void Dump(std::ostream & out = std::cout) const
+  {
+    out << std::setw(16) << "Cut" << std::setw(12) << "nEntries" << std::setw(14) << "Weighted"
+	<< std::setw(10) << "Eff" << std::setw(12) << "Time [s]" << std::setw(14) << "us/entry" << std::endl;
+
+    const auto precision = out.precision();
+    Double_t nprev = -1.0;
+    for (auto slot = fNInherited; slot < Int_t(fLabels.size()); slot++)
+    {
+      const auto nRaw = Double_t(fCounters.nRaw[slot]+fMerged.nRaw[slot]);
+      const auto time = fCounters.time[slot]+fMerged.time[slot];
+      const auto nin  = (nprev < 0 ? nRaw : nprev); // entries evaluated by this cut
+
+      out << std::setw(16) << fLabels[slot] << std::setw(12) << Long64_t(nRaw) << std::setw(14) << (fCounters.sumWgt[slot]+fMerged.sumWgt[slot])
+	  << std::setw(10) << std::setprecision(4) << (nin > 0 ? nRaw/nin : 0.0)
+	  << std::setw(12) << time << std::setw(14) << (nin > 0 ? 1e6*time/nin : 0.0) << std::endl;
+      nprev = nRaw;
+    }
+    out.precision(precision);
+  }
+
+private:
+  static void AddToBin(TH1F * hist, const Int_t ibin, const Double_t sumw, const Double_t sumw2)
+  {
+    const auto err = hist->GetBinError(ibin);
+    hist->AddBinContent(ibin,sumw);
+    hist->SetBinError(ibin,std::sqrt(err*err+sumw2));
+  }
+
+  std::vector<std::string> fLabels;
+  std::map<std::string,Int_t> fSlots;
+  Int_t fNInherited;
+
+  CutFlowCounters fCounters; // built-in, for single-threaded use
+  CutFlowCounters fMerged;   // sum over workers
+  std::mutex fMutex;
+};
+
+#endif
@@ -97,29 +97,54 @@ DisPho::DisPho(const edm::ParameterSet& iConfig):
   usesResource();
   usesResource("TFileService");
 
-  // labels for cut flow histogram
-  std::vector<std::string> cutflowLabelVec = {"All","nEvBlinding","METBlinding","Trigger","H_{T}","Good Photon"};
-  int ibin = 0;
-  for (const auto & cutflowLabel : cutflowLabelVec)
-  {
-    cutflowLabelMap[cutflowLabel] = ibin++;
-  }
+  // slots for cut flow histogram, in the order the cuts are applied
+  cutAll      = cutflow.Register("All");
+  cutEvBlind  = cutflow.Register("nEvBlinding");
+  cutMETBlind = cutflow.Register("METBlinding");
+  cutTrigger  = cutflow.Register("Trigger");
+  cutHT       = cutflow.Register("H_{T}");
+  cutPhGood   = cutflow.Register("Good Photon");
 
   // triggers
   triggerResultsToken = consumes<edm::TriggerResults> (triggerResultsTag);
   triggerObjectsToken = consumes<std::vector<pat::TriggerObjectStandAlone> > (triggerObjectsTag);
 
   // read in from a stream the trigger paths for saving
-  oot::ReadInTriggerNames(inputPaths,pathNames,triggerBitMap);
+  oot::ReadInTriggerNames(inputPaths,pathNames,triggerCache);
 
   // read in from a stream the hlt objects/labels to match to
-  oot::ReadInFilterNames(inputFilters,filterNames,triggerObjectsByFilterMap);
+  oot::ReadInFilterNames(inputFilters,filterNames,triggerCache);
 
   // MET flags
   triggerFlagsToken = consumes<edm::TriggerResults> (triggerFlagsTag);
 
   // read in from a stream the trigger paths for saving
-  oot::ReadInTriggerNames(inputFlags,flagNames,triggerFlagMap);
+  oot::ReadInTriggerNames(inputFlags,flagNames,flagCache);
+
+  // resolve the paths, filters, and flags for the branches once: -1 (i.e. false) if not read in
+  triggerBranchBits = {{&hltSignal       ,triggerCache.getPathIndex(Config::SignalPath)},
+		       {&hltRefPhoID     ,triggerCache.getPathIndex(Config::RefPhoIDPath)},
+		       {&hltRefDispID    ,triggerCache.getPathIndex(Config::RefDispIDPath)},
+		       {&hltRefHT        ,triggerCache.getPathIndex(Config::RefHTPath)},
+		       {&hltPho50        ,triggerCache.getPathIndex(Config::Pho50Path)},
+		       {&hltPho200       ,triggerCache.getPathIndex(Config::Pho200Path)},
+		       {&hltDiPho70      ,triggerCache.getPathIndex(Config::DiPho70Path)},
+		       {&hltDiPho3022M90 ,triggerCache.getPathIndex(Config::DiPho3022M90Path)},
+		       {&hltDiPho30PV18PV,triggerCache.getPathIndex(Config::DiPho30PV18PVPath)},
+		       {&hltEle32WPT     ,triggerCache.getPathIndex(Config::Ele32WPTPath)},
+		       {&hltDiEle33MW    ,triggerCache.getPathIndex(Config::DiEle33MWPath)},
+		       {&hltJet500       ,triggerCache.getPathIndex(Config::Jet500Path)}};
+  iDispIDFilter = triggerCache.getFilterIndex(Config::DispIDFilter);
+
+  flagBranchBits = {{&metPV          ,flagCache.getPathIndex(Config::PVFlag)},
+		    {&metBeamHalo    ,flagCache.getPathIndex(Config::BeamHaloFlag)},
+		    {&metHBHENoise   ,flagCache.getPathIndex(Config::HBHENoiseFlag)},
+		    {&metHBHEisoNoise,flagCache.getPathIndex(Config::HBHEisoNoiseFlag)},
+		    {&metECALTP      ,flagCache.getPathIndex(Config::ECALTPFlag)},
+		    {&metPFMuon      ,flagCache.getPathIndex(Config::PFMuonFlag)},
+		    {&metPFChgHad    ,flagCache.getPathIndex(Config::PFChgHadFlag)},
+		    {&metEESC        ,flagCache.getPathIndex(Config::EESCFlag)},
+		    {&metECALCalib   ,flagCache.getPathIndex(Config::ECALCalibFlag)}};
 
   // tracks 
   tracksToken = consumes<std::vector<reco::Track> > (tracksTag);
@@ -165,6 +190,9 @@ DisPho::~DisPho() {}
 
 void DisPho::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup) 
 {
+  // start the clock for the cut flow
+  cutflow.StartEvent();
+
   ////////////////////////
   //                    //
   // Get Object Handles //
@@ -324,8 +352,7 @@ void DisPho::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   const Float_t wgt = (isMC ? genwgt : 1.f);
 
   // Fill total cutflow regardless of cuts
-  h_cutflow    ->Fill((cutflowLabelMap["All"]*1.f));
-  h_cutflow_wgt->Fill((cutflowLabelMap["All"]*1.f),wgt);
+  cutflow.Pass(cutAll,wgt);
 
   // Fill PU hists regardless of cuts
   if (isMC)
@@ -342,15 +369,13 @@ void DisPho::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   //          //
   //////////////
   if (event%blindSF!=0 && applyBlindSF) return;
-  h_cutflow    ->Fill((cutflowLabelMap["nEvBlinding"]*1.f));
-  h_cutflow_wgt->Fill((cutflowLabelMap["nEvBlinding"]*1.f),wgt);
+  cutflow.Pass(cutEvBlind,wgt);
 
   if (metsH.isValid())
   {
     if ((*metsH).front().pt() > blindMET && applyBlindMET) return;
   }  
-  h_cutflow    ->Fill((cutflowLabelMap["METBlinding"]*1.f));
-  h_cutflow_wgt->Fill((cutflowLabelMap["METBlinding"]*1.f),wgt);
+  cutflow.Pass(cutMETBlind,wgt);
 
   /////////
   //     //
@@ -371,9 +396,9 @@ void DisPho::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   if (isGMSB) oot::PrepNeutralinos(genparticlesH,neutralinos);
   if (isHVDS) oot::PrepVPions(genparticlesH,vPions);
   if (isToy)  oot::PrepToys(genparticlesH,toys);
-  oot::PrepTriggerBits(triggerResultsH,iEvent,triggerBitMap);
-  oot::PrepTriggerBits(triggerFlagsH,iEvent,triggerFlagMap);
-  oot::PrepTriggerObjects(triggerResultsH,triggerObjectsH,iEvent,triggerObjectsByFilterMap);
+  oot::PrepTriggerBits(triggerResultsH,iEvent,triggerCache);
+  oot::PrepTriggerBits(triggerFlagsH,iEvent,flagCache);
+  oot::PrepTriggerObjects(triggerResultsH,triggerObjectsH,iEvent,triggerCache);
   oot::PrepJets(jetsH,jets,jetpTmin,jetEtamax,jetIDmin);
   oot::PrepRecHits(recHitsEB,recHitsEE,recHitMap,rhEmin);
   oot::PrepPhotons(photonsH,ootPhotonsH,photons,rho,phpTmin,phIDmin);
@@ -410,21 +435,15 @@ void DisPho::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   //                     //
   /////////////////////////
   // trigger pre-selection
-  bool triggered = false;
-  for (const auto & triggerBitPair : triggerBitMap)
-  {
-    if (triggerBitPair.second) {triggered = true; break;}
-  }
+  const bool triggered = triggerCache.anyAccept();
   if (!triggered && applyTrigger) return;
-  h_cutflow    ->Fill((cutflowLabelMap["Trigger"]*1.f));
-  h_cutflow_wgt->Fill((cutflowLabelMap["Trigger"]*1.f),wgt);
+  cutflow.Pass(cutTrigger,wgt);
 
   // HT pre-selection
   auto jetHT = 0.f;
   for (auto ijet = 0; ijet < nJets; ijet++) jetHT += jets[ijet].pt();
   if (jetHT < minHT && applyHT) return;
-  h_cutflow    ->Fill((cutflowLabelMap["H_{T}"]*1.f));
-  h_cutflow_wgt->Fill((cutflowLabelMap["H_{T}"]*1.f),wgt);
+  cutflow.Pass(cutHT,wgt);
 
   // photon pre-selection: at least one good photon in event
   bool isphgood = false;
@@ -452,8 +471,7 @@ void DisPho::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
     } 
   } // end check
   if (!isphgood && applyPhGood) return;
-  h_cutflow    ->Fill((cutflowLabelMap["Good Photon"]*1.f));
-  h_cutflow_wgt->Fill((cutflowLabelMap["Good Photon"]*1.f),wgt);
+  cutflow.Pass(cutPhGood,wgt);
 
   /////////////
   //         //
@@ -926,31 +944,12 @@ void DisPho::SetRecordInfo(const edm::Event & iEvent)
 
 void DisPho::SetTriggerBranches()
 {
-  hltSignal = (triggerBitMap.count(Config::SignalPath.c_str()) ? triggerBitMap[Config::SignalPath.c_str()] : false);
-  hltRefPhoID = (triggerBitMap.count(Config::RefPhoIDPath.c_str()) ? triggerBitMap[Config::RefPhoIDPath.c_str()] : false);
-  hltRefDispID = (triggerBitMap.count(Config::RefDispIDPath.c_str()) ? triggerBitMap[Config::RefDispIDPath.c_str()] : false);
-  hltRefHT = (triggerBitMap.count(Config::RefHTPath.c_str()) ? triggerBitMap[Config::RefHTPath.c_str()] : false);
-  hltPho50 = (triggerBitMap.count(Config::Pho50Path.c_str()) ? triggerBitMap[Config::Pho50Path.c_str()] : false);
-  hltPho200 = (triggerBitMap.count(Config::Pho200Path.c_str()) ? triggerBitMap[Config::Pho200Path.c_str()] : false);
-  hltDiPho70 = (triggerBitMap.count(Config::DiPho70Path.c_str()) ? triggerBitMap[Config::DiPho70Path.c_str()] : false);
-  hltDiPho3022M90 = (triggerBitMap.count(Config::DiPho3022M90Path.c_str()) ? triggerBitMap[Config::DiPho3022M90Path.c_str()] : false);
-  hltDiPho30PV18PV = (triggerBitMap.count(Config::DiPho30PV18PVPath.c_str()) ? triggerBitMap[Config::DiPho30PV18PVPath.c_str()] : false);
-  hltEle32WPT = (triggerBitMap.count(Config::Ele32WPTPath.c_str()) ? triggerBitMap[Config::Ele32WPTPath.c_str()] : false);
-  hltDiEle33MW = (triggerBitMap.count(Config::DiEle33MWPath.c_str()) ? triggerBitMap[Config::DiEle33MWPath.c_str()] : false);
-  hltJet500 = (triggerBitMap.count(Config::Jet500Path.c_str()) ? triggerBitMap[Config::Jet500Path.c_str()] : false);
+  for (const auto & triggerBranchBit : triggerBranchBits) *triggerBranchBit.first = triggerCache.accept(triggerBranchBit.second);
 }
 
 void DisPho::SetMETFilterBranches()
 {
-  metPV = (triggerFlagMap.count(Config::PVFlag.c_str()) ? triggerFlagMap[Config::PVFlag.c_str()] : false);
-  metBeamHalo = (triggerFlagMap.count(Config::BeamHaloFlag.c_str()) ? triggerFlagMap[Config::BeamHaloFlag.c_str()] : false);
-  metHBHENoise = (triggerFlagMap.count(Config::HBHENoiseFlag.c_str()) ? triggerFlagMap[Config::HBHENoiseFlag.c_str()] : false);
-  metHBHEisoNoise = (triggerFlagMap.count(Config::HBHEisoNoiseFlag.c_str()) ? triggerFlagMap[Config::HBHEisoNoiseFlag.c_str()] : false);
-  metECALTP = (triggerFlagMap.count(Config::ECALTPFlag.c_str()) ? triggerFlagMap[Config::ECALTPFlag.c_str()] : false);
-  metPFMuon = (triggerFlagMap.count(Config::PFMuonFlag.c_str()) ? triggerFlagMap[Config::PFMuonFlag.c_str()] : false);
-  metPFChgHad = (triggerFlagMap.count(Config::PFChgHadFlag.c_str()) ? triggerFlagMap[Config::PFChgHadFlag.c_str()] : false);
-  metEESC = (triggerFlagMap.count(Config::EESCFlag.c_str()) ? triggerFlagMap[Config::EESCFlag.c_str()] : false);
-  metECALCalib = (triggerFlagMap.count(Config::ECALCalibFlag.c_str()) ? triggerFlagMap[Config::ECALCalibFlag.c_str()] : false);
+  for (const auto & flagBranchBit : flagBranchBits) *flagBranchBit.first = flagCache.accept(flagBranchBit.second);
 }
 
 void DisPho::InitializePVBranches()
@@ -1567,11 +1566,9 @@ void DisPho::SetPhoBranches(const std::vector<oot::Photon> photons, const int nP
     phoBranch.isEB_  = isEB;
 
     // HLT Matching!
-    strBitMap isHLTMatched;
-    for (const auto & filter : filterNames) isHLTMatched[filter] = false;
-    oot::HLTToObjectMatching(triggerObjectsByFilterMap,isHLTMatched,photon,pTres,dRmin);
-    const std::string filter = Config::DispIDFilter.c_str();
-    phoBranch.isHLT_ = (isHLTMatched.count(filter.c_str()) ? isHLTMatched[filter.c_str()] : false);
+    std::vector<bool> isHLTMatched;
+    oot::HLTToObjectMatching(triggerCache,isHLTMatched,photon,pTres,dRmin);
+    phoBranch.isHLT_ = (iDispIDFilter >= 0 ? isHLTMatched[iDispIDFilter] : false);
 
     // check for simple track veto
     phoBranch.isTrk_ = oot::TrackToObjectMatching(tracksH,photon,trackpTmin,trackdRmin);
@@ -1680,8 +1677,9 @@ void DisPho::beginJob()
   edm::Service<TFileService> fs;
   
   // histograms needed
-  h_cutflow     = fs->make<TH1F>("h_cutflow"    , "Cut Flow"           , cutflowLabelMap.size(), 0, cutflowLabelMap.size());
-  h_cutflow_wgt = fs->make<TH1F>("h_cutflow_wgt", "Cut Flow (Weighted)", cutflowLabelMap.size(), 0, cutflowLabelMap.size());
+  h_cutflow      = fs->make<TH1F>("h_cutflow"     , "Cut Flow"           , cutflow.GetNCuts(), 0, cutflow.GetNCuts());
+  h_cutflow_wgt  = fs->make<TH1F>("h_cutflow_wgt" , "Cut Flow (Weighted)", cutflow.GetNCuts(), 0, cutflow.GetNCuts());
+  h_cutflow_time = fs->make<TH1F>("h_cutflow_time", "Cut Flow Time"      , cutflow.GetNCuts(), 0, cutflow.GetNCuts());
   
   if (isMC)
   {
@@ -1704,13 +1702,12 @@ void DisPho::beginJob()
 void DisPho::MakeHists()
 {
   // cut flow settings
-  for (const auto & cutflowLabelPair : cutflowLabelMap)
-  {
-    h_cutflow    ->GetXaxis()->SetBinLabel(cutflowLabelPair.second+1,cutflowLabelPair.first.c_str()); // +1 to account for bins in ROOT from [1,nBins]
-    h_cutflow_wgt->GetXaxis()->SetBinLabel(cutflowLabelPair.second+1,cutflowLabelPair.first.c_str()); // +1 to account for bins in ROOT from [1,nBins]
-  }
-  h_cutflow    ->GetYaxis()->SetTitle("nEntries");
-  h_cutflow_wgt->GetYaxis()->SetTitle("nEntries with gen weights");
+  cutflow.SetLabels(h_cutflow);
+  cutflow.SetLabels(h_cutflow_wgt);
+  cutflow.SetLabels(h_cutflow_time);
+  h_cutflow     ->GetYaxis()->SetTitle("nEntries");
+  h_cutflow_wgt ->GetYaxis()->SetTitle("nEntries with gen weights");
+  h_cutflow_time->GetYaxis()->SetTitle("Time [s]");
 
   if (isMC)
   {
@@ -2154,7 +2151,13 @@ void DisPho::MakeEventTree()
   } // end loop over nPhotons
 }
 
-void DisPho::endJob() {}
+void DisPho::endJob() 
+{
+  // counters are filled per event, hists only once: TFileService writes them out after this
+  cutflow.Export(h_cutflow,h_cutflow_wgt,NULL);
+  cutflow.ExportTime(h_cutflow_time);
+  cutflow.Dump();
+}
 
 void DisPho::beginRun(edm::Run const& iRun, edm::EventSetup const& iSetup) {}
 
@@ -96,6 +96,9 @@
 // Unique structs
 #include "Timing/TimingAnalyzer/plugins/DisPhoTypes.hh"
 
+// Cut flow accounting
+#include "Timing/TimingAnalyzer/plugins/CutFlow.hh"
+
 // Unique typedef
 typedef ROOT::Math::PositionVector3D<ROOT::Math::Cartesian3D<float>,ROOT::Math::DefaultCoordinateSystemTag> Point3D;
 
@@ -231,19 +234,21 @@ class DisPho : public edm::one::EDAnalyzer<edm::one::SharedResources,edm::one::W
   // triggers
   const std::string inputPaths;
   std::vector<std::string> pathNames;
-  strBitMap triggerBitMap;
+  oot::TriggerCache triggerCache; // user paths and filters, resolved once per menu
   const std::string inputFilters;
   std::vector<std::string> filterNames;
   const edm::InputTag triggerResultsTag;
   edm::EDGetTokenT<edm::TriggerResults> triggerResultsToken;
   const edm::InputTag triggerObjectsTag;
   edm::EDGetTokenT<std::vector<pat::TriggerObjectStandAlone> > triggerObjectsToken;
-  trigObjVecMap triggerObjectsByFilterMap; // first index is filter label, second is trigger objects
+  std::vector<std::pair<bool*,int> > triggerBranchBits; // branch to fill, index of path in cache
+  int iDispIDFilter;
 
   // met filters
   const std::string inputFlags;
   std::vector<std::string> flagNames;
-  strBitMap triggerFlagMap;
+  oot::TriggerCache flagCache;
+  std::vector<std::pair<bool*,int> > flagBranchBits;
   const edm::InputTag triggerFlagsTag;
   edm::EDGetTokenT<edm::TriggerResults> triggerFlagsToken;
 
@@ -301,7 +306,9 @@ class DisPho : public edm::one::EDAnalyzer<edm::one::SharedResources,edm::one::W
   // output histograms
   TH1F * h_cutflow;
   TH1F * h_cutflow_wgt;
-  std::map<std::string,int> cutflowLabelMap;
+  TH1F * h_cutflow_time;
+  CutFlow cutflow;
+  int cutAll, cutEvBlind, cutMETBlind, cutTrigger, cutHT, cutPhGood;
   TH1F * h_genpuobs;
   TH1F * h_genpuobs_wgt;
   TH1F * h_genputrue;
@@ -49,11 +49,14 @@ HLTDump::HLTDump(const edm::ParameterSet& iConfig):
   triggerObjectsToken = consumes<std::vector<pat::TriggerObjectStandAlone> > (triggerObjectsTag);
 
   // read in from a stream the trigger paths for saving
-  oot::ReadInTriggerNames(inputPaths,pathNames,triggerBitMap);
+  oot::ReadInTriggerNames(inputPaths,pathNames,triggerCache);
   triggerBits.resize(pathNames.size());
 
   // read in from a stream the hlt objects/labels to match to
-  oot::ReadInFilterNames(inputFilters,filterNames,triggerObjectsByFilterMap);
+  oot::ReadInFilterNames(inputFilters,filterNames,triggerCache);
+
+  // pre-selection path: not necessarily saved
+  iPSPath = triggerCache.addPath("HLT_IsoMu27_v");
 
   //vertex
   verticesToken = consumes<std::vector<reco::Vertex> > (verticesTag);
@@ -141,17 +144,17 @@ void HLTDump::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   const CaloSubdetectorGeometry * endcapGeometry = calogeoH->getSubdetectorGeometry(DetId::Ecal, EcalEndcap);
 
   // do some prepping of objects
-  oot::PrepTriggerBits(triggerResultsH,iEvent,triggerBitMap);
+  oot::PrepTriggerBits(triggerResultsH,iEvent,triggerCache);
 
   ///////////////////
   //               //
   // Pre-selection //
   //               //
   ///////////////////
-  if (!triggerBitMap["HLT_IsoMu27_v"]) return;
+  if (!triggerCache.accept(iPSPath)) return;
 
   // prep everything else after pre-selection
-  oot::PrepTriggerObjects(triggerResultsH,triggerObjectsH,iEvent,triggerObjectsByFilterMap);
+  oot::PrepTriggerObjects(triggerResultsH,triggerObjectsH,iEvent,triggerCache);
   oot::PrepJets(jetsH,jets,jetpTmin);
   oot::PrepPhotons(photonsH,ootPhotonsH,photons,rho,phpTmin);
 
@@ -189,7 +192,7 @@ void HLTDump::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   {
     for (std::size_t ipath = 0; ipath < pathNames.size(); ipath++)
     {
-      triggerBits[ipath] = triggerBitMap[pathNames[ipath]];
+      triggerBits[ipath] = triggerCache.accept(ipath);
     }
   } // end check over valid TriggerResults
 
@@ -203,9 +206,10 @@ void HLTDump::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
     HLTDump::ClearTriggerObjectBranches();
     for (std::size_t ifilter = 0; ifilter < filterNames.size(); ifilter++)
     {
-      for (std::size_t iobject = 0; iobject < triggerObjectsByFilterMap[filterNames[ifilter]].size(); iobject++)
+      const auto & triggerObjects = triggerCache.objects(ifilter);
+      for (std::size_t iobject = 0; iobject < triggerObjects.size(); iobject++)
       {
-	const auto & triggerObject = triggerObjectsByFilterMap[filterNames[ifilter]][iobject];
+	const auto & triggerObject = triggerObjects[iobject];
 	trigobjE  [ifilter][iobject] = triggerObject.energy();
 	trigobjeta[ifilter][iobject] = triggerObject.eta();
 	trigobjphi[ifilter][iobject] = triggerObject.phi();
@@ -296,12 +300,11 @@ void HLTDump::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
       pheta[iph] = photon.eta();
 
       // check for HLT filter matches!
-      strBitMap isHLTMatched;
-      for (const auto & filter : filterNames) isHLTMatched[filter] = false;
-      oot::HLTToObjectMatching(triggerObjectsByFilterMap,isHLTMatched,*phiter,pTres,dRmin);
+      std::vector<bool> isHLTMatched;
+      oot::HLTToObjectMatching(triggerCache,isHLTMatched,*phiter,pTres,dRmin);
       for (std::size_t ifilter = 0; ifilter < filterNames.size(); ifilter++)
       {
-	phIsHLTMatched[iph][ifilter] = isHLTMatched[filterNames[ifilter]];
+	phIsHLTMatched[iph][ifilter] = isHLTMatched[ifilter];
       }
 
       // check for simple track veto
@@ -415,18 +418,19 @@ void HLTDump::ClearTriggerObjectBranches()
   trigobjphi.clear();
   trigobjpt.clear();
 
-  trigobjE.resize(triggerObjectsByFilterMap.size());
-  trigobjeta.resize(triggerObjectsByFilterMap.size());
-  trigobjphi.resize(triggerObjectsByFilterMap.size());
-  trigobjpt.resize(triggerObjectsByFilterMap.size());
+  trigobjE.resize(triggerCache.nFilters());
+  trigobjeta.resize(triggerCache.nFilters());
+  trigobjphi.resize(triggerCache.nFilters());
+  trigobjpt.resize(triggerCache.nFilters());
 
   for (std::size_t ifilter = 0; ifilter < filterNames.size(); ifilter++)
   {
-    trigobjE  [ifilter].resize(triggerObjectsByFilterMap[filterNames[ifilter]].size());
-    trigobjeta[ifilter].resize(triggerObjectsByFilterMap[filterNames[ifilter]].size());
-    trigobjphi[ifilter].resize(triggerObjectsByFilterMap[filterNames[ifilter]].size());
-    trigobjpt [ifilter].resize(triggerObjectsByFilterMap[filterNames[ifilter]].size());
-    for (std::size_t iobject = 0; iobject < triggerObjectsByFilterMap[filterNames[ifilter]].size(); iobject++)
+    const auto nobjects = triggerCache.objects(ifilter).size();
+    trigobjE  [ifilter].resize(nobjects);
+    trigobjeta[ifilter].resize(nobjects);
+    trigobjphi[ifilter].resize(nobjects);
+    trigobjpt [ifilter].resize(nobjects);
+    for (std::size_t iobject = 0; iobject < nobjects; iobject++)
     {
       trigobjE  [ifilter][iobject] = -9999.f;
       trigobjeta[ifilter][iobject] = -9999.f;
@@ -114,14 +114,14 @@ class HLTDump : public edm::one::EDAnalyzer<edm::one::SharedResources,edm::one::
   // triggers
   const std::string inputPaths;
   std::vector<std::string> pathNames;
-  strBitMap triggerBitMap;
+  oot::TriggerCache triggerCache; // user paths and filters, resolved once per menu
+  int iPSPath;
   const std::string inputFilters;
   std::vector<std::string> filterNames;
   const edm::InputTag triggerResultsTag;
   edm::EDGetTokenT<edm::TriggerResults> triggerResultsToken;
   const edm::InputTag triggerObjectsTag;
   edm::EDGetTokenT<std::vector<pat::TriggerObjectStandAlone> > triggerObjectsToken;
-  trigObjVecMap triggerObjectsByFilterMap; // first index is filter label, second is trigger objects
 
   // vertices
   const edm::InputTag verticesTag;
@@ -49,15 +49,15 @@ HLTPlots::HLTPlots(const edm::ParameterSet& iConfig):
   triggerResultsToken = consumes<edm::TriggerResults> (triggerResultsTag);
   triggerObjectsToken = consumes<std::vector<pat::TriggerObjectStandAlone> > (triggerObjectsTag);
     
-  // store pre-selection path if it exists
-  if (applyTriggerPS && psPath != "") triggerBitMap[psPath] = false;
-  
   // read in from a stream the trigger paths for saving
-  oot::ReadInTriggerNames(inputPaths,pathNames,triggerBitMap);
+  oot::ReadInTriggerNames(inputPaths,pathNames,triggerCache);
+
+  // store pre-selection path if it exists
+  iPSPath = ((applyTriggerPS && psPath != "") ? triggerCache.addPath(psPath) : -1);
   triggerBits.resize(pathNames.size());
   
   // read in from a stream the hlt objects/labels to match to
-  oot::ReadInFilterNames(inputFilters,filterNames,triggerObjectsByFilterMap);
+  oot::ReadInFilterNames(inputFilters,filterNames,triggerCache);
   
   // set test options
   const TestResults initResults = {false,-1};
@@ -77,6 +77,7 @@ HLTPlots::HLTPlots(const edm::ParameterSet& iConfig):
       if (filterName == options.denomName) options.idenom = ifilter;
       if (filterName == options.numerName) options.inumer = ifilter;
     }
+    options.inumerPath = triggerCache.getPathIndex(options.numerName);
   }
 
   // rhos
@@ -151,20 +152,20 @@ void HLTPlots::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   const CaloSubdetectorGeometry * endcapGeometry = calogeoH->getSubdetectorGeometry(DetId::Ecal, EcalEndcap);
 
   // do some prepping of objects
-  oot::PrepTriggerBits(triggerResultsH,iEvent,triggerBitMap);
+  oot::PrepTriggerBits(triggerResultsH,iEvent,triggerCache);
 
   ///////////////////
   //               //
   // Pre-selection //
   //               //
   ///////////////////
-  if (applyTriggerPS && triggerBitMap.count(psPath))
+  if (applyTriggerPS && iPSPath >= 0)
   {
-    if (!triggerBitMap[psPath]) return;
+    if (!triggerCache.accept(iPSPath)) return;
   }
 
   // prep everything else after pre-selection
-  oot::PrepTriggerObjects(triggerResultsH,triggerObjectsH,iEvent,triggerObjectsByFilterMap);
+  oot::PrepTriggerObjects(triggerResultsH,triggerObjectsH,iEvent,triggerCache);
   oot::PrepJets(jetsH,jets,jetpTmin,jetEtamax,jetIDmin);
   oot::PrepPhotons(photonsH,ootPhotonsH,photons,rho,phpTmin);
 
@@ -178,7 +179,7 @@ void HLTPlots::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   {
     for (std::size_t ipath = 0; ipath < pathNames.size(); ipath++)
     {
-      triggerBits[ipath] = triggerBitMap[pathNames[ipath]];
+      triggerBits[ipath] = triggerCache.accept(ipath);
     }
   } // end check over valid TriggerResults
 
@@ -233,12 +234,11 @@ void HLTPlots::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
       pheta[iph] = pho.eta();
 
       // check for HLT filter matches!
-      strBitMap isHLTMatched;
-      for (const auto & filter : filterNames) isHLTMatched[filter] = false;
-      oot::HLTToObjectMatching(triggerObjectsByFilterMap,isHLTMatched,photon,pTres,dRmin);
+      std::vector<bool> isHLTMatched;
+      oot::HLTToObjectMatching(triggerCache,isHLTMatched,photon,pTres,dRmin);
       for (std::size_t ifilter = 0; ifilter < filterNames.size(); ifilter++)
       {
-	phIsHLTMatched[iph][ifilter] = isHLTMatched[filterNames[ifilter]];
+	phIsHLTMatched[iph][ifilter] = isHLTMatched[ifilter];
       }
 
       // check for simple track veto
@@ -522,9 +522,9 @@ void HLTPlots::GetLastLegResult(const std::vector<int> & goodphs, const std::str
   if (denomphs.size() == 0) return;
   
   // get numer
-  if (triggerBitMap.count(options.numerName))
+  if (options.inumerPath >= 0)
   {
-    if (triggerBitMap[options.numerName])
+    if (triggerCache.accept(options.inumerPath))
     {
       results.passed = true;
     }
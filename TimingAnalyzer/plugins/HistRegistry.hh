@@ -0,0 +1,76 @@
+#ifndef __HistRegistry__
+#define __HistRegistry__
+
+// ROOT includes: no CMSSW dependencies, so the standalone analyses can use it
+#include "TString.h"
+
+// basic C++ types
+#include <vector>
+#include <map>
+
+//////////////////////////////////////////////////////////////////
+//                                                              //
+// Integer handles for histograms filled in event loops: names  //
+// are resolved once at setup, and the fill loop only indexes a //
+// contiguous vector. The name-keyed maps the plots are made in //
+// keep the ownership and the output layout (SaveTH1s, SaveTH2s //
+// DumpTH1Names, ...): the registry only points into them.      //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+template <typename H>
+class HistRegistry
+{
+public:
+  typedef std::map<TString,H*> HistMap;
+
+  // setup: one handle per name, repeated names share it; unknown names stay empty until Bind()
+  UInt_t Declare(const TString & name)
+  {
+    const auto iter = fHandles.find(name);
+    if (iter != fHandles.end()) return iter->second;
+
+    fNames.emplace_back(name);
+    fHists.emplace_back((H*)NULL);
+    return (fHandles[name] = fHists.size()-1);
+  }
+
+  // point the declared handles at the histograms of the same name: may be called once per map
+  void Bind(const HistMap & map)
+  {
+    for (auto ihist = 0U; ihist < fNames.size(); ihist++)
+    {
+      const auto iter = map.find(fNames[ihist]);
+      if (iter != map.end()) fHists[ihist] = iter->second;
+    }
+  }
+
+  // handle of a declared name, size() (never bound) otherwise
+  UInt_t Find(const TString & name) const
+  {
+    const auto iter = fHandles.find(name);
+    return (iter != fHandles.end() ? iter->second : fHists.size());
+  }
+
+  // fill loop: no strings, no tree walk; a handle no map provided is NULL, and Fill() skips it
+  H * operator[](const UInt_t handle) const {return (handle < fHists.size() ? fHists[handle] : (H*)NULL);}
+
+  template <typename... Args>
+  void Fill(const UInt_t handle, Args... args) const
+  {
+    auto hist = (*this)[handle];
+    if (hist) hist->Fill(args...);
+  }
+
+  // the maps delete the histograms: drop the pointers with them
+  void Clear() {fNames.clear(); fHists.clear(); fHandles.clear();}
+
+  UInt_t size() const {return fHists.size();}
+
+private:
+  std::vector<TString> fNames;
+  std::vector<H*> fHists;
+  std::map<TString,UInt_t> fHandles;
+};
+
+#endif
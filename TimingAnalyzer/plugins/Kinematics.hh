@@ -0,0 +1,187 @@
+#ifndef __Kinematics__
+#define __Kinematics__
+
+// basic C++ types: no ROOT or CMSSW dependencies, so the dispho_work macros and zee_work can use it too
+#include <vector>
+#include <cmath>
+#include <limits>
+
+//////////////////////////////////////////////////////////////////
+//                                                              //
+// Lightweight four-vector kinematics in structure-of-arrays    //
+// form: one contiguous array per component, so that the pair   //
+// kernels below vectorize over the partner index.              //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+namespace Kinematics
+{
+  constexpr float PI    = 3.14159265358979323846;
+  constexpr float TWOPI = 2.0*PI;
+
+  // wrap to [-pi,pi)
+  inline float DeltaPhi(const float phi1, const float phi2)
+  {
+    auto dphi = phi1-phi2;
+    if      (dphi >=  PI) dphi -= TWOPI;
+    else if (dphi <  -PI) dphi += TWOPI;
+    return dphi;
+  }
+
+  inline float DeltaR2(const float eta1, const float phi1, const float eta2, const float phi2)
+  {
+    const auto deta = eta1-eta2;
+    const auto dphi = DeltaPhi(phi1,phi2);
+    return deta*deta + dphi*dphi;
+  }
+
+  inline float DeltaR(const float eta1, const float phi1, const float eta2, const float phi2)
+  {
+    return std::sqrt(DeltaR2(eta1,phi1,eta2,phi2));
+  }
+
+  // same convention as TLorentzVector::M(): negative for space-like m^2
+  inline float MassFromM2(const float m2) {return (m2 < 0.f ? -std::sqrt(-m2) : std::sqrt(m2));}
+
+  // sum of two four-vectors given as (pt,eta,phi,E), with the usual derived quantities
+  struct PairSum
+  {
+    PairSum(const float pt1, const float eta1, const float phi1, const float E1,
+	    const float pt2, const float eta2, const float phi2, const float E2)
+    {
+      px = pt1*std::cos(phi1) + pt2*std::cos(phi2);
+      py = pt1*std::sin(phi1) + pt2*std::sin(phi2);
+      pz = pt1*std::sinh(eta1) + pt2*std::sinh(eta2);
+      E  = E1 + E2;
+    }
+
+    float Pt  () const {return std::sqrt(px*px + py*py);}
+    float P   () const {return std::sqrt(px*px + py*py + pz*pz);}
+    float Eta () const // as TLorentzVector::Eta() along the beam: 0 at rest, else +/-10e10
+    {
+      const auto pt = Pt();
+      if (pt == 0.f) return (pz == 0.f ? 0.f : (pz > 0.f ? 10e10f : -10e10f));
+      return std::asinh(pz/pt);
+    }
+    float Phi () const {return (px == 0.f && py == 0.f ? 0.f : std::atan2(py,px));}
+    float M   () const {return MassFromM2(E*E - px*px - py*py - pz*pz);}
+
+    float px, py, pz, E;
+  };
+
+  inline float PairMass(const float pt1, const float eta1, const float phi1, const float E1,
+			const float pt2, const float eta2, const float phi2, const float E2)
+  {
+    return PairSum(pt1,eta1,phi1,E1,pt2,eta2,phi2,E2).M();
+  }
+
+  // all objects of one event
+  struct FourVecs
+  {
+    void clear()
+    {
+      px.clear(); py.clear(); pz.clear(); E.clear();
+      eta.clear(); phi.clear();
+    }
+
+    void reserve(const std::size_t n)
+    {
+      px.reserve(n); py.reserve(n); pz.reserve(n); E.reserve(n);
+      eta.reserve(n); phi.reserve(n);
+    }
+
+    void emplace_back(const float pt, const float eta_, const float phi_, const float E_)
+    {
+      px .emplace_back(pt*std::cos(phi_));
+      py .emplace_back(pt*std::sin(phi_));
+      pz .emplace_back(pt*std::sinh(eta_));
+      E  .emplace_back(E_);
+      eta.emplace_back(eta_);
+      phi.emplace_back(phi_);
+    }
+
+    std::size_t size() const {return E.size();}
+
+    std::vector<float> px, py, pz, E;
+    std::vector<float> eta, phi; // kept for the angular kernels
+  };
+
+  // kernels over all partners j > i of object i: out[j] is filled, out[0..i] left untouched
+  inline void PairMasses(const FourVecs & vecs, const std::size_t i, std::vector<float> & out)
+  {
+    const auto n = vecs.size();
+    out.resize(n);
+
+    const auto pxi = vecs.px[i]; const auto pyi = vecs.py[i];
+    const auto pzi = vecs.pz[i]; const auto Ei  = vecs.E [i];
+    const auto * px = vecs.px.data(); const auto * py = vecs.py.data();
+    const auto * pz = vecs.pz.data(); const auto * E  = vecs.E .data();
+    auto * m = out.data();
+
+    for (auto j = i+1; j < n; j++)
+    {
+      const auto sE  = Ei +E [j];
+      const auto spx = pxi+px[j];
+      const auto spy = pyi+py[j];
+      const auto spz = pzi+pz[j];
+      m[j] = sE*sE - spx*spx - spy*spy - spz*spz;
+    }
+    for (auto j = i+1; j < n; j++) m[j] = MassFromM2(m[j]);
+  }
+
+  inline void PairDeltaPhis(const FourVecs & vecs, const std::size_t i, std::vector<float> & out)
+  {
+    const auto n = vecs.size();
+    out.resize(n);
+    for (auto j = i+1; j < n; j++) out[j] = DeltaPhi(vecs.phi[i],vecs.phi[j]);
+  }
+
+  inline void PairDeltaRs(const FourVecs & vecs, const std::size_t i, std::vector<float> & out)
+  {
+    const auto n = vecs.size();
+    out.resize(n);
+    for (auto j = i+1; j < n; j++) out[j] = DeltaR(vecs.eta[i],vecs.phi[i],vecs.eta[j],vecs.phi[j]);
+  }
+
+  // running minimum of |mass - target| over pairs
+  struct BestPair
+  {
+    BestPair() : i(-1), j(-1), mass(0.f), diff(std::numeric_limits<float>::max()) {}
+
+    bool IsValid() const {return i >= 0;}
+
+    inline void Update(const int i_, const int j_, const float mass_, const float target)
+    {
+      const auto diff_ = std::abs(mass_-target);
+      if (diff_ < diff) {i = i_; j = j_; mass = mass_; diff = diff_;}
+    }
+
+    int i, j; // indices into the FourVecs (or whatever the caller paired up)
+    float mass;
+    float diff;
+  };
+
+  // single reduction pass over all pairs i < j, for pairs passing accept(i,j): first pair wins ties
+  template <typename Accept>
+  inline BestPair FindBestPair(const FourVecs & vecs, const float target, Accept accept)
+  {
+    BestPair best;
+    std::vector<float> masses;
+    for (auto i = 0U; i < vecs.size(); i++)
+    {
+      Kinematics::PairMasses(vecs,i,masses);
+      for (auto j = i+1; j < vecs.size(); j++)
+      {
+	if (accept(i,j)) best.Update(i,j,masses[j],target);
+      }
+    }
+    return best;
+  }
+
+  inline BestPair FindBestPair(const FourVecs & vecs, const float target)
+  {
+    return FindBestPair(vecs,target,[](const std::size_t, const std::size_t){return true;});
+  }
+};
+
+#endif
@@ -49,10 +49,10 @@ PhotonDump::PhotonDump(const edm::ParameterSet& iConfig):
   triggerObjectsToken = consumes<std::vector<pat::TriggerObjectStandAlone> > (triggerObjectsTag);
 
   // read in from a stream the trigger paths for saving
-  oot::ReadInTriggerNames(inputPaths,pathNames,triggerBitMap);
+  oot::ReadInTriggerNames(inputPaths,pathNames,triggerCache);
 
   // read in from a stream the hlt objects/labels to match to
-  oot::ReadInFilterNames(inputFilters,filterNames,triggerObjectsByFilterMap);
+  oot::ReadInFilterNames(inputFilters,filterNames,triggerCache);
 
   //vertex
   verticesToken = consumes<std::vector<reco::Vertex> > (verticesTag);
@@ -172,8 +172,8 @@ void PhotonDump::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
   const float rho = rhosH.isValid() ? *(rhosH.product()) : 0.f;
 
   // do some prepping of objects
-  oot::PrepTriggerBits(triggerResultsH,iEvent,triggerBitMap);
-  oot::PrepTriggerObjects(triggerResultsH,triggerObjectsH,iEvent,triggerObjectsByFilterMap);
+  oot::PrepTriggerBits(triggerResultsH,iEvent,triggerCache);
+  oot::PrepTriggerObjects(triggerResultsH,triggerObjectsH,iEvent,triggerCache);
   oot::PrepJets(jetsH,jets);
   oot::PrepPhotons(photonsH,ootPhotonsH,photons,rho);
   if (isGMSB) oot::PrepNeutralinos(genparticlesH,neutralinos);
@@ -198,7 +198,7 @@ void PhotonDump::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
   {
     for (std::size_t ipath = 0; ipath < pathNames.size(); ipath++)
     {
-      triggerBits[ipath] = triggerBitMap[pathNames[ipath]];
+      triggerBits[ipath] = triggerCache.accept(ipath);
     }
   } // end check over valid TriggerResults
 
@@ -611,12 +611,11 @@ void PhotonDump::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
       pheta[iph] = photon.eta();
 
       // check for HLT filter matches!
-      strBitMap isHLTMatched; 
-      for (const auto & filter : filterNames) isHLTMatched[filter] = false;
-      oot::HLTToObjectMatching(triggerObjectsByFilterMap,isHLTMatched,*phiter,pTres,dRmin);
+      std::vector<bool> isHLTMatched;
+      oot::HLTToObjectMatching(triggerCache,isHLTMatched,*phiter,pTres,dRmin);
       for (std::size_t ifilter = 0; ifilter < filterNames.size(); ifilter++)
       {
-	phIsHLTMatched[iph][ifilter] = isHLTMatched[filterNames[ifilter]];
+	phIsHLTMatched[iph][ifilter] = isHLTMatched[ifilter];
       }
 
       // Check for gen level match
@@ -128,14 +128,13 @@ class PhotonDump : public edm::one::EDAnalyzer<edm::one::SharedResources,edm::on
   // triggers
   const std::string inputPaths;
   std::vector<std::string> pathNames;
-  strBitMap triggerBitMap;
+  oot::TriggerCache triggerCache; // user paths and filters, resolved once per menu
   const std::string inputFilters;
   std::vector<std::string> filterNames;
   const edm::InputTag triggerResultsTag;
   edm::EDGetTokenT<edm::TriggerResults> triggerResultsToken;
   const edm::InputTag triggerObjectsTag;
   edm::EDGetTokenT<std::vector<pat::TriggerObjectStandAlone> > triggerObjectsToken;
-  trigObjVecMap triggerObjectsByFilterMap; // first index is filter label, second is trigger objects
 
   // vertices
   const edm::InputTag verticesTag;
@@ -0,0 +1,321 @@
+#ifndef __Profiler__
+#define __Profiler__
+
+// ROOT includes: no CMSSW dependencies, so the dispho_work macros can use it too
+#include "TFile.h"
+#include "TString.h"
+
+// basic C++ types
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////
+//                                                              //
+// Scoped hot-path instrumentation: timers, counters and byte   //
+// meters accumulated into a call tree per thread, merged by    //
+// scope path when dumped. Names must be string literals.       //
+//                                                              //
+// Disabled (DISPHO_PROFILE=0) a scope is one relaxed load.     //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+namespace Profiler
+{
+  typedef std::chrono::steady_clock Clock;
+
+  // a scope in the call tree of one thread
+  struct Node
+  {
+    Node(const char * name, const Int_t parent) : name(name), parent(parent), calls(0), seconds(0.0) {}
+
+    const char * name;
+    Int_t parent;
+    std::vector<Int_t> children;
+    ULong64_t calls;
+    Double_t  seconds;
+    std::vector<std::pair<const char*,Long64_t> > counters;
+    std::vector<std::pair<const char*,Long64_t> > bytes;
+  };
+
+  // call tree of one thread: node 0 is the root
+  class ThreadTree
+  {
+  public:
+    ThreadTree() : fCurrent(0) {fNodes.emplace_back("",-1);}
+
+    inline Int_t Enter(const char * name)
+    {
+      auto & children = fNodes[fCurrent].children;
+      for (const auto child : children)
+      {
+	const auto childname = fNodes[child].name;
+	if (childname == name || std::strcmp(childname,name) == 0) return (fCurrent = child);
+      }
+
+      const Int_t child = fNodes.size();
+      fNodes.emplace_back(name,fCurrent);
+      fNodes[fCurrent].children.emplace_back(child);
+      return (fCurrent = child);
+    }
+
+    inline void Exit(const Int_t node, const Double_t seconds)
+    {
+      auto & current = fNodes[node];
+      current.calls++;
+      current.seconds += seconds;
+      fCurrent = current.parent;
+    }
+
+    inline void Add(std::vector<std::pair<const char*,Long64_t> > & values, const char * name, const Long64_t value)
+    {
+      for (auto & pair : values)
+      {
+	if (pair.first == name || std::strcmp(pair.first,name) == 0) {pair.second += value; return;}
+      }
+      values.emplace_back(name,value);
+    }
+
+    inline void Count(const char * name, const Long64_t n) {Add(fNodes[fCurrent].counters,name,n);}
+    inline void Bytes(const char * name, const Long64_t n) {Add(fNodes[fCurrent].bytes,name,n);}
+
+    const std::vector<Node> & GetNodes() const {return fNodes;}
+
+  private:
+    std::vector<Node> fNodes;
+    Int_t fCurrent;
+  };
+
+  // all thread trees of the process; they outlive their threads so the dump sees them
+  class Registry
+  {
+  public:
+    Registry()
+    {
+      const auto env = std::getenv("DISPHO_PROFILE");
+      fEnabled = !(env != NULL && std::strcmp(env,"0") == 0);
+    }
+
+    ThreadTree * Add()
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fTrees.emplace_back(new ThreadTree());
+      return fTrees.back().get();
+    }
+
+    template <typename F>
+    void ForEach(F func)
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      for (const auto & tree : fTrees) func(*tree);
+    }
+
+    std::atomic<Bool_t> fEnabled;
+
+  private:
+    std::mutex fMutex;
+    std::vector<std::unique_ptr<ThreadTree> > fTrees;
+  };
+
+  inline Registry & GetRegistry() {static Registry registry; return registry;}
+  inline ThreadTree & Local() {thread_local ThreadTree * tree = GetRegistry().Add(); return *tree;}
+
+  inline Bool_t IsEnabled() {return GetRegistry().fEnabled.load(std::memory_order_relaxed);}
+  inline void SetEnabled(const Bool_t enabled) {GetRegistry().fEnabled = enabled;}
+
+  // counters and byte meters attach to the innermost open scope of the calling thread
+  inline void Count(const char * name, const Long64_t n = 1) {if (IsEnabled()) Local().Count(name,n);}
+  inline void Bytes(const char * name, const Long64_t n) {if (IsEnabled()) Local().Bytes(name,n);}
+
+  // times the enclosing block
+  class Scope
+  {
+  public:
+    explicit Scope(const char * name) : fTree(IsEnabled() ? &Local() : NULL)
+    {
+      if (fTree == NULL) return;
+      fNode  = fTree->Enter(name);
+      fStart = Clock::now();
+    }
+
+    ~Scope()
+    {
+      if (fTree == NULL) return;
+      fTree->Exit(fNode,std::chrono::duration<Double_t>(Clock::now()-fStart).count());
+    }
+
+    Scope(const Scope &) = delete;
+    Scope & operator=(const Scope &) = delete;
+
+  private:
+    ThreadTree * fTree;
+    Int_t fNode;
+    Clock::time_point fStart;
+  };
+
+  // times the enclosing block and meters the bytes ROOT read from files meanwhile (all threads)
+  class ReadScope
+  {
+  public:
+    explicit ReadScope(const char * name) : fScope(name), fStart(IsEnabled() ? TFile::GetFileBytesRead() : -1) {}
+    ~ReadScope() {if (fStart >= 0) Local().Bytes("read",TFile::GetFileBytesRead()-fStart);}
+
+  private:
+    Scope fScope;
+    const Long64_t fStart;
+  };
+
+  ////////////////////////////////////
+  // Merged profile: dump at the end //
+  ////////////////////////////////////
+
+  struct Entry
+  {
+    Entry() : calls(0), seconds(0.0) {}
+
+    ULong64_t calls;
+    Double_t  seconds;
+    std::map<std::string,Long64_t> counters;
+    std::map<std::string,Long64_t> bytes;
+    std::vector<std::string> order; // children, in order of first appearance
+    std::map<std::string,Entry> children;
+  };
+
+  inline void MergeNode(const std::vector<Node> & nodes, const Int_t inode, Entry & entry)
+  {
+    const auto & node = nodes[inode];
+    entry.calls   += node.calls;
+    entry.seconds += node.seconds;
+    for (const auto & pair : node.counters) entry.counters[pair.first] += pair.second;
+    for (const auto & pair : node.bytes)    entry.bytes   [pair.first] += pair.second;
+
+    for (const auto child : node.children)
+    {
+      const std::string name = nodes[child].name;
+      if (!entry.children.count(name)) entry.order.emplace_back(name);
+      MergeNode(nodes,child,entry.children[name]);
+    }
+  }
+
+  // scopes opened in worker threads show up at the top level, summed over threads
+  inline Entry Merge()
+  {
+    Entry root;
+    GetRegistry().ForEach([&](const ThreadTree & tree){MergeNode(tree.GetNodes(),0,root);});
+    for (const auto & name : root.order) root.seconds += root.children[name].seconds;
+    return root;
+  }
+
+  inline Double_t ChildSeconds(const Entry & entry)
+  {
+    Double_t seconds = 0.0;
+    for (const auto & child : entry.children) seconds += child.second.seconds;
+    return seconds;
+  }
+
+  inline std::string Escape(const std::string & str)
+  {
+    std::string out;
+    for (const auto c : str)
+    {
+      if (c == '"' || c == '\\') out += '\\';
+      out += c;
+    }
+    return out;
+  }
+
+  inline void WriteJSON(std::ostream & out, const std::string & name, const Entry & entry, const Int_t depth)
+  {
+    const std::string indent(2*depth,' ');
+    out << indent << "{\"name\": \"" << Escape(name) << "\", \"calls\": " << entry.calls
+	<< ", \"seconds\": " << entry.seconds << ", \"self_seconds\": " << std::max(entry.seconds-ChildSeconds(entry),0.0);
+
+    for (const auto & values : {std::make_pair("counters",&entry.counters),std::make_pair("bytes",&entry.bytes)})
+    {
+      out << ", \"" << values.first << "\": {";
+      Bool_t first = true;
+      for (const auto & pair : *values.second)
+      {
+	out << (first ? "" : ", ") << "\"" << Escape(pair.first) << "\": " << pair.second;
+	first = false;
+      }
+      out << "}";
+    }
+
+    out << ", \"children\": [";
+    if (!entry.order.empty())
+    {
+      out << std::endl;
+      for (auto ichild = 0U; ichild < entry.order.size(); ichild++)
+      {
+	const auto & child = entry.order[ichild];
+	WriteJSON(out,child,entry.children.at(child),depth+1);
+	out << (ichild+1 < entry.order.size() ? "," : "") << std::endl;
+      }
+      out << indent;
+    }
+    out << "]}";
+  }
+
+  inline void WriteTable(std::ostream & out, const std::string & name, const Entry & entry, const Int_t depth, const Double_t total)
+  {
+    const auto self = std::max(entry.seconds-ChildSeconds(entry),0.0);
+
+    Long64_t nbytes = 0;
+    for (const auto & pair : entry.bytes) nbytes += pair.second;
+
+    std::string extra;
+    for (const auto & pair : entry.counters) extra += " "+pair.first+"="+std::to_string(pair.second);
+
+    out << std::left << std::setw(44) << (std::string(2*depth,' ')+name) << std::right
+	<< std::setw(12) << entry.calls
+	<< std::setw(12) << std::setprecision(3) << entry.seconds
+	<< std::setw(12) << self
+	<< std::setw(8)  << std::setprecision(1) << (total > 0 ? 100.0*entry.seconds/total : 0.0)
+	<< std::setw(12) << std::setprecision(2) << (entry.calls > 0 ? 1e6*entry.seconds/entry.calls : 0.0)
+	<< std::setw(10) << std::setprecision(1) << nbytes/(1024.0*1024.0)
+	<< extra << std::endl;
+
+    for (const auto & child : entry.order) WriteTable(out,child,entry.children.at(child),depth+1,total);
+  }
+
+  // <outtext>_profile.json plus a summary table on out
+  inline void Dump(const TString & outtext, std::ostream & out = std::cout)
+  {
+    if (!IsEnabled()) return;
+
+    const auto root = Merge();
+
+    const TString jsonname = outtext+"_profile.json";
+    std::ofstream json(jsonname.Data(),std::ios::trunc);
+    WriteJSON(json,"total",root,0);
+    json << std::endl;
+
+    const auto precision = out.precision();
+    const auto flags = out.flags();
+    out << std::fixed << std::left << std::setw(44) << "Scope" << std::right << std::setw(12) << "Calls" << std::setw(12) << "Total [s]"
+	<< std::setw(12) << "Self [s]" << std::setw(8) << "%" << std::setw(12) << "us/call" << std::setw(10) << "MB" << "  Counters" << std::endl;
+    for (const auto & child : root.order) WriteTable(out,child,root.children.at(child),0,root.seconds);
+    out.precision(precision);
+    out.flags(flags);
+
+    out << "Profile written to: " << jsonname.Data() << std::endl;
+  }
+};
+
+#define PROFILER_CONCAT_(a,b) a##b
+#define PROFILER_CONCAT(a,b) PROFILER_CONCAT_(a,b)
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILER_CONCAT(profiler_scope_,__LINE__)(name)
+#define PROFILE_READ_SCOPE(name) Profiler::ReadScope PROFILER_CONCAT(profiler_scope_,__LINE__)(name)
+
+#endif
@@ -0,0 +1,447 @@
+#ifndef __ResolutionEngine__
+#define __ResolutionEngine__
+
+// only ROOT's basic types: no ROOT objects or CMSSW dependencies, so the slices can be fit in threads
+#include "Rtypes.h"
+
+// basic C++ types
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////
+//                                                              //
+// Time resolution vs x, streamed: each x slice of a 2D plot    //
+// keeps the in-range moments of y over all fills, plus a       //
+// weighted reservoir sample of y (A-Res: the k largest keys    //
+// log(u)/w, so the sample follows the weighted distribution    //
+// and two reservoirs merge exactly). At the end of the loop,   //
+// the slices are fit unbinned on their samples, in threads:    //
+// a truncated gaussian for the core (gaus1, gaus1core), EM for //
+// the mixtures (gaus2, gaus2fm, gaus3fm), with the starting    //
+// values and the mean/sigma combination of the binned fits.    //
+// Statistical errors scale with the slice's effective entries, //
+// not with the reservoir size.                                 //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+class ResolutionEngine
+{
+public:
+  enum Form {kGaus1, kGaus1core, kGaus2, kGaus2fm, kGaus3fm, kNoForm};
+
+  struct Component
+  {
+    Double_t frac, mean, sigma;
+  };
+
+  struct Sample
+  {
+    Float_t key, y;
+  };
+
+  struct Slice
+  {
+    Slice() : first(0), last(0), bin(0), sumw(0.0), sumwy(0.0), sumwy2(0.0), sumw2(0.0),
+	      status(-1), lo(0.0), hi(0.0), mean(0.0), emean(0.0), sigma(0.0), esigma(0.0) {}
+
+    // x bins (1-based, as in the 2D plot) merged into this slice, and the bin of the output plots
+    Int_t first, last, bin;
+
+    // in-range moments of y, all fills
+    Double_t sumw, sumwy, sumwy2, sumw2;
+
+    // min-heap on the key
+    std::vector<Sample> reservoir;
+
+    // fit: status 0 converged, 1 not converged, -1 not fit (too few samples); lo/hi is the range fit
+    Int_t    status;
+    Double_t lo, hi;
+    Double_t mean, emean, sigma, esigma;
+    std::vector<Component> comps;
+  };
+
+  ResolutionEngine(const UInt_t nreservoir = 20000, const UInt_t seed = 12345) : fNReservoir(nreservoir), fRng(seed), fUniform(0.0,1.0) {}
+
+  void SetReservoirSize(const UInt_t nreservoir) {fNReservoir = nreservoir;}
+
+  // one plot per handle (e.g. the handle of the same 2D plot in its HistRegistry); minsumw > 0 merges
+  // low-stat slices into the next one passing it, as the binned runs and nvtx plots do
+  void Book(const UInt_t handle, const std::vector<Double_t> & xedges, const Double_t ylow, const Double_t yhigh, const Double_t minsumw = 0.0)
+  {
+    if (handle >= fPlots.size()) fPlots.resize(handle+1);
+    auto & plot = fPlots[handle];
+    plot.booked  = true;
+    plot.xedges  = xedges;
+    plot.ylow    = ylow;
+    plot.yhigh   = yhigh;
+    plot.minsumw = minsumw;
+    plot.bins.assign(xedges.size()-1,Slice());
+    plot.slices.clear();
+  }
+
+  // same binning as TH1::FindBin: low edge inclusive, under/overflow in x and y dropped
+  void Fill(const UInt_t handle, const Double_t x, const Double_t y, const Double_t w)
+  {
+    if (handle >= fPlots.size()) return;
+    auto & plot = fPlots[handle];
+    if (!plot.booked || y < plot.ylow || y >= plot.yhigh) return;
+
+    const auto iedge = std::upper_bound(plot.xedges.begin(),plot.xedges.end(),x);
+    if (iedge == plot.xedges.begin() || iedge == plot.xedges.end()) return;
+    auto & slice = plot.bins[iedge-plot.xedges.begin()-1];
+
+    slice.sumw   += w;
+    slice.sumwy  += w*y;
+    slice.sumwy2 += w*y*y;
+    slice.sumw2  += w*w;
+
+    if (w <= 0.0) return;
+    const Sample sample = {Float_t(std::log(1.0-fUniform(fRng))/w),Float_t(y)};
+    auto & reservoir = slice.reservoir;
+    if (reservoir.size() < fNReservoir)
+    {
+      reservoir.emplace_back(sample);
+      std::push_heap(reservoir.begin(),reservoir.end(),ResolutionEngine::MinHeap);
+    }
+    else if (sample.key > reservoir.front().key)
+    {
+      std::pop_heap(reservoir.begin(),reservoir.end(),ResolutionEngine::MinHeap);
+      reservoir.back() = sample;
+      std::push_heap(reservoir.begin(),reservoir.end(),ResolutionEngine::MinHeap);
+    }
+  }
+
+  // merge the low-stat slices, then fit all slices of all plots: nthreads <= 0 uses every core
+  void Solve(const Form form, const Double_t fitrange, const Double_t ncore, Int_t nthreads = 0)
+  {
+    std::vector<Slice*> slices;
+    for (auto & plot : fPlots)
+    {
+      if (!plot.booked) continue;
+      ResolutionEngine::Merge(plot);
+      for (auto & slice : plot.slices) slices.emplace_back(&slice);
+    }
+
+    if (nthreads <= 0) nthreads = std::max(1U,std::thread::hardware_concurrency());
+    nthreads = std::min<Int_t>(nthreads,slices.size());
+
+    std::atomic<UInt_t> next(0);
+    auto work = [&]()
+    {
+      for (UInt_t islice = next++; islice < slices.size(); islice = next++)
+      {
+	ResolutionEngine::Fit(*slices[islice],form,fitrange,ncore);
+      }
+    };
+
+    if (nthreads <= 1) {work(); return;}
+    std::vector<std::thread> threads;
+    for (Int_t ithread = 0; ithread < nthreads; ithread++) threads.emplace_back(work);
+    for (auto & thread : threads) thread.join();
+  }
+
+  // fit slices of a plot, in x order: empty if not booked (or not solved yet)
+  const std::vector<Slice> & Slices(const UInt_t handle) const
+  {
+    static const std::vector<Slice> none;
+    return (handle < fPlots.size() ? fPlots[handle].slices : none);
+  }
+
+  static Form GetForm(const std::string & formname)
+  {
+    if      (formname == "gaus1")     return kGaus1;
+    else if (formname == "gaus1core") return kGaus1core;
+    else if (formname == "gaus2")     return kGaus2;
+    else if (formname == "gaus2fm")   return kGaus2fm;
+    else if (formname == "gaus3fm")   return kGaus3fm;
+    else                              return kNoForm;
+  }
+
+  // free parameters of the binned fit with the same form
+  static Int_t NPars(const Form form)
+  {
+    switch (form)
+    {
+      case kGaus1: case kGaus1core: return 3;
+      case kGaus2:   return 6;
+      case kGaus2fm: return 5;
+      case kGaus3fm: return 7;
+      default:       return 0;
+    }
+  }
+
+  static constexpr Double_t sqrt2pi = 2.50662827463100050242;
+
+  static Double_t Gaus(const Double_t y, const Double_t mean, const Double_t sigma)
+  {
+    const Double_t z = (y-mean)/sigma;
+    return std::exp(-0.5*z*z)/(sqrt2pi*sigma);
+  }
+
+  static Double_t Pdf(const std::vector<Component> & comps, const Double_t y)
+  {
+    Double_t pdf = 0.0;
+    for (const auto & comp : comps) pdf += comp.frac*ResolutionEngine::Gaus(y,comp.mean,comp.sigma);
+    return pdf;
+  }
+
+private:
+  struct Plot
+  {
+    Plot() : booked(false), ylow(0.0), yhigh(0.0), minsumw(0.0) {}
+
+    Bool_t booked;
+    std::vector<Double_t> xedges;
+    Double_t ylow, yhigh, minsumw;
+    std::vector<Slice> bins;   // filled: one per x bin
+    std::vector<Slice> slices; // solved: filled bins, merged
+  };
+
+  struct Bounds
+  {
+    Double_t lo, hi;
+  };
+
+  static bool MinHeap(const Sample & a, const Sample & b) {return a.key > b.key;}
+
+  static Double_t Phi(const Double_t z) {return 0.5*std::erfc(-z/std::sqrt(2.0));}
+
+  static void Add(Slice & slice, Slice & other)
+  {
+    slice.sumw   += other.sumw;
+    slice.sumwy  += other.sumwy;
+    slice.sumwy2 += other.sumwy2;
+    slice.sumw2  += other.sumw2;
+    slice.reservoir.insert(slice.reservoir.end(),other.reservoir.begin(),other.reservoir.end());
+    std::vector<Sample>().swap(other.reservoir);
+  }
+
+  // filled bins become slices; with a minimum, bins below it are carried over to the next one passing it,
+  // which is then placed at the weighted average bin, and whatever is left below it at the end is dropped
+  void Merge(Plot & plot)
+  {
+    plot.slices.clear();
+    std::vector<Int_t> pending;
+    Double_t pendingsumw = 0.0;
+
+    for (auto ibin = 0U; ibin < plot.bins.size(); ibin++)
+    {
+      auto & bin = plot.bins[ibin];
+      if (bin.sumw <= 0.0) continue;
+      bin.first = bin.last = bin.bin = ibin+1;
+
+      if (plot.minsumw > 0.0)
+      {
+	if (bin.sumw + pendingsumw < plot.minsumw)
+	{
+	  pending.emplace_back(ibin);
+	  pendingsumw += bin.sumw;
+	  continue;
+	}
+
+	if (!pending.empty())
+	{
+	  Int_t numer = bin.bin*bin.sumw;
+	  const Int_t denom = pendingsumw + bin.sumw;
+	  for (const auto ipending : pending)
+	  {
+	    numer += (ipending+1)*plot.bins[ipending].sumw;
+	    ResolutionEngine::Add(bin,plot.bins[ipending]);
+	  }
+	  bin.first = pending.front()+1;
+	  bin.bin   = numer/denom;
+	  pending.clear();
+	  pendingsumw = 0.0;
+	}
+      }
+
+      // the merged reservoir keeps the largest keys, as if filled in one go
+      if (bin.reservoir.size() > fNReservoir)
+      {
+	std::nth_element(bin.reservoir.begin(),bin.reservoir.begin()+fNReservoir,bin.reservoir.end(),ResolutionEngine::MinHeap);
+	bin.reservoir.resize(fNReservoir);
+      }
+      plot.slices.emplace_back(std::move(bin));
+    }
+    std::vector<Slice>().swap(plot.bins);
+  }
+
+  // moments of a gaussian truncated to [lo,hi] matched to those of the samples in it
+  static Int_t FitTruncGaus(const std::vector<Double_t> & ys, const Double_t lo, const Double_t hi, Double_t & mean, Double_t & sigma)
+  {
+    Double_t m = 0.0, v = 0.0;
+    for (const auto y : ys) m += y;
+    m /= ys.size();
+    for (const auto y : ys) v += (y-m)*(y-m);
+    v /= ys.size();
+
+    mean = m; sigma = std::sqrt(v);
+    if (sigma <= 0.0) return 1;
+
+    for (Int_t iter = 0; iter < 100; iter++)
+    {
+      const Double_t a = (lo-mean)/sigma, b = (hi-mean)/sigma;
+      const Double_t Z = ResolutionEngine::Phi(b)-ResolutionEngine::Phi(a);
+      if (Z < 1e-6) return 1;
+
+      const Double_t pa = std::exp(-0.5*a*a)/sqrt2pi, pb = std::exp(-0.5*b*b)/sqrt2pi;
+      const Double_t d    = (pa-pb)/Z;
+      const Double_t vfac = 1.0 + (a*pa-b*pb)/Z - d*d;
+      if (vfac <= 0.0) return 1;
+
+      const Double_t newsigma = std::sqrt(v/vfac);
+      const Double_t newmean  = m - newsigma*d;
+      const Bool_t   done     = (std::abs(newmean-mean) < 1e-6*sigma && std::abs(newsigma-sigma) < 1e-6*sigma);
+      mean = newmean; sigma = newsigma;
+      if (done) return 0;
+    }
+    return 1;
+  }
+
+  // EM for a mixture of gaussians, sigmas kept within their bounds; with a shared mean, it is updated
+  // from the responsibilities weighted by 1/sigma^2 (ECM)
+  static Int_t FitMixture(const std::vector<Double_t> & ys, std::vector<Component> & comps, const std::vector<Bounds> & bounds, const Bool_t sharedmean)
+  {
+    const UInt_t ncomps = comps.size();
+    std::vector<Double_t> r(ncomps), sw(ncomps), swy(ncomps), swy2(ncomps);
+    Double_t lastlogl = -1e300;
+
+    for (Int_t iter = 0; iter < 500; iter++)
+    {
+      std::fill(sw.begin(),sw.end(),0.0); std::fill(swy.begin(),swy.end(),0.0); std::fill(swy2.begin(),swy2.end(),0.0);
+      Double_t logl = 0.0;
+      for (const auto y : ys)
+      {
+	Double_t sum = 0.0;
+	for (auto icomp = 0U; icomp < ncomps; icomp++)
+	{
+	  const auto & comp = comps[icomp];
+	  r[icomp] = comp.frac*ResolutionEngine::Gaus(y,comp.mean,comp.sigma);
+	  sum += r[icomp];
+	}
+	if (sum <= 0.0) continue;
+	logl += std::log(sum);
+	for (auto icomp = 0U; icomp < ncomps; icomp++)
+	{
+	  const Double_t ri = r[icomp]/sum;
+	  sw[icomp] += ri; swy[icomp] += ri*y; swy2[icomp] += ri*y*y;
+	}
+      }
+
+      Double_t sharedm = 0.0;
+      if (sharedmean)
+      {
+	Double_t numer = 0.0, denom = 0.0;
+	for (auto icomp = 0U; icomp < ncomps; icomp++)
+	{
+	  const Double_t ivar = 1.0/(comps[icomp].sigma*comps[icomp].sigma);
+	  numer += swy[icomp]*ivar;
+	  denom += sw[icomp]*ivar;
+	}
+	sharedm = (denom > 0.0 ? numer/denom : comps.front().mean);
+      }
+
+      for (auto icomp = 0U; icomp < ncomps; icomp++)
+      {
+	auto & comp = comps[icomp];
+	comp.frac = sw[icomp]/ys.size();
+	if (sw[icomp] < 1e-9) continue;
+
+	comp.mean = (sharedmean ? sharedm : swy[icomp]/sw[icomp]);
+	const Double_t var = (swy2[icomp] - 2.0*comp.mean*swy[icomp] + comp.mean*comp.mean*sw[icomp])/sw[icomp];
+	comp.sigma = std::min(std::max(std::sqrt(std::max(var,0.0)),bounds[icomp].lo),bounds[icomp].hi);
+      }
+
+      if (std::abs(logl-lastlogl) < 1e-7*ys.size()) return 0;
+      lastlogl = logl;
+    }
+    return 1;
+  }
+
+  static void Fit(Slice & slice, const Form form, const Double_t fitrange, const Double_t ncore)
+  {
+    // range: as the binned fits, where gaus1core is around the core of the (all fills) distribution
+    const Double_t hmean   = slice.sumwy/slice.sumw;
+    const Double_t hstddev = std::sqrt(std::abs(slice.sumwy2/slice.sumw - hmean*hmean));
+    slice.lo = (form == kGaus1core ? hmean-ncore*hstddev : -fitrange);
+    slice.hi = (form == kGaus1core ? hmean+ncore*hstddev :  fitrange);
+
+    std::vector<Double_t> ys;
+    ys.reserve(slice.reservoir.size());
+    for (const auto & sample : slice.reservoir)
+    {
+      if (sample.y >= slice.lo && sample.y <= slice.hi) ys.emplace_back(sample.y);
+    }
+    if (ys.size() < 10 || form == kNoForm) {slice.status = -1; return;}
+
+    // effective entries in range, from the moments of all fills
+    const Double_t neff = (slice.sumw2 > 0.0 ? slice.sumw*slice.sumw/slice.sumw2 : slice.sumw) * ys.size()/slice.reservoir.size();
+
+    // core first: the prefit of the binned fits
+    Double_t mean0 = 0.0, sigma0 = 0.0;
+    slice.status = ResolutionEngine::FitTruncGaus(ys,slice.lo,slice.hi,mean0,sigma0);
+    sigma0 = std::min(std::max(sigma0,1e-4),10.0);
+
+    // starting heights h and sigmas as in the binned fits: fractions go as h*sigma
+    auto & comps = slice.comps;
+    std::vector<Bounds> bounds;
+    const Bounds any = {1e-4,10.0};
+    switch (form)
+    {
+      case kGaus1: case kGaus1core:
+	comps  = {{1.0,mean0,sigma0}};
+	break;
+      case kGaus2:
+	comps  = {{1.0,mean0,sigma0},{0.1*4.0,0.0,4.0*sigma0}};
+	bounds = {any,any};
+	break;
+      case kGaus2fm:
+	comps  = {{1.0,mean0,sigma0},{0.1*4.0,mean0,4.0*sigma0}};
+	bounds = {any,any};
+	break;
+      case kGaus3fm:
+	comps  = {{0.8*0.7,mean0,0.7*sigma0},{0.3*1.4,mean0,1.4*sigma0},{0.01*2.5,mean0,2.5*sigma0}};
+	bounds = {{0.5*sigma0,sigma0},{sigma0,1.5*sigma0},{1.5*sigma0,5.0*sigma0}};
+	break;
+      default:
+	break;
+    }
+    Double_t norm = 0.0;
+    for (const auto & comp : comps) norm += comp.frac;
+    for (auto & comp : comps) comp.frac /= norm;
+
+    if (comps.size() > 1) slice.status = ResolutionEngine::FitMixture(ys,comps,bounds,(form != kGaus2));
+
+    // combination as Analysis::GetMeanSigma: weighted by the heights, frac/sigma
+    Double_t denom = 0.0, mean = 0.0, sigma = 0.0, emean2 = 0.0, esigma2 = 0.0, ivarsum = 0.0;
+    for (const auto & comp : comps)
+    {
+      const Double_t height = comp.frac/comp.sigma;
+      const Double_t n      = std::max(comp.frac*neff,1.0);
+      denom   += height;
+      mean    += height*comp.mean;
+      sigma   += height*comp.sigma;
+      emean2  += height*height*comp.sigma*comp.sigma/n;
+      esigma2 += height*height*comp.sigma*comp.sigma/(2.0*n);
+      ivarsum += n/(comp.sigma*comp.sigma);
+    }
+    slice.mean   = mean/denom;
+    slice.sigma  = sigma/denom;
+    slice.emean  = (form == kGaus2 ? std::sqrt(emean2)/denom : 1.0/std::sqrt(ivarsum));
+    slice.esigma = std::sqrt(esigma2)/denom;
+
+    std::vector<Sample>().swap(slice.reservoir);
+  }
+
+  UInt_t fNReservoir;
+  std::mt19937 fRng;
+  std::uniform_real_distribution<Double_t> fUniform;
+  std::vector<Plot> fPlots;
+};
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef __SamplePool__
+#define __SamplePool__
+
+// ROOT includes: no CMSSW dependencies, so the standalone analyses can use it
+#include "TString.h"
+
+// basic C++ types
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <vector>
+#include <map>
+#include <functional>
+#include <chrono>
+#include <exception>
+
+// POSIX: one process per sample
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+//////////////////////////////////////////////////////////////////
+//                                                              //
+// Bounded pool of worker processes for independent samples:    //
+// each job runs in its own fork, so ROOT globals, gDirectory   //
+// and output files are never shared between samples. Wall time //
+// and peak memory (max RSS) are logged per sample.             //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+namespace SamplePool
+{
+  struct Job
+  {
+    TString name;
+    std::function<void()> run;
+  };
+
+  struct Result
+  {
+    TString  name;
+    Int_t    status; // 0 == success
+    Double_t seconds;
+    Long64_t maxrss; // kB
+  };
+
+  typedef std::chrono::steady_clock Clock;
+
+  inline Double_t Seconds(const Clock::time_point & start) {return std::chrono::duration<Double_t>(Clock::now()-start).count();}
+
+  inline void Print(const Result & result, std::ostream & out)
+  {
+    out << "Sample: " << result.name.Data() << (result.status == 0 ? " done" : " FAILED")
+	<< " wall time [s]: " << std::fixed << std::setprecision(1) << result.seconds
+	<< " max RSS [MB]: " << std::setprecision(1) << result.maxrss/1024.0 << std::endl;
+    out.unsetf(std::ios_base::floatfield);
+  }
+
+  // sample names may contain subdirectories (e.g. qcd/Pt-15to20)
+  inline TString LogName(const TString & logdir, const TString & name)
+  {
+    TString logname = name;
+    logname.ReplaceAll("/","_");
+    return Form("%s/%s.log",logdir.Data(),logname.Data());
+  }
+
+  // in the child: never returns, and skips the parent's atexit handlers and static destructors
+  inline void RunChild(const Job & job, const TString & logdir)
+  {
+    if (logdir != "")
+    {
+      const TString logname = SamplePool::LogName(logdir,job.name);
+      if (std::freopen(logname.Data(),"w",stdout) == NULL) ::_exit(2);
+      ::dup2(::fileno(stdout),::fileno(stderr));
+    }
+
+    Int_t status = 0;
+    try {job.run();}
+    catch (const std::exception & e) {std::cerr << "Exception in " << job.name.Data() << ": " << e.what() << std::endl; status = 1;}
+
+    std::cout.flush(); std::cerr.flush(); std::fflush(NULL);
+    ::_exit(status);
+  }
+
+  // njobs <= 1: run in this process, one after another (max RSS is then the process high-water mark so far);
+  // otherwise at most njobs forks at a time, output of each to <logdir>/<sample>.log (if logdir is set).
+  // Returns once every job is done: true if all succeeded
+  inline Bool_t Run(const std::vector<Job> & jobs, const Int_t njobs, const TString & logdir = "", std::ostream & out = std::cout)
+  {
+    std::vector<Result> results(jobs.size());
+    for (auto ijob = 0U; ijob < jobs.size(); ijob++) results[ijob] = {jobs[ijob].name,-1,0.0,0};
+
+    if (njobs <= 1)
+    {
+      for (auto ijob = 0U; ijob < jobs.size(); ijob++)
+      {
+	auto & result = results[ijob];
+	const auto start = Clock::now();
+	jobs[ijob].run();
+	result.status  = 0;
+	result.seconds = SamplePool::Seconds(start);
+
+	struct rusage usage;
+	::getrusage(RUSAGE_SELF,&usage);
+	result.maxrss = usage.ru_maxrss;
+	SamplePool::Print(result,out);
+      }
+      return true;
+    }
+
+    // nothing buffered may be inherited by the children, or it is printed twice
+    out.flush(); std::cout.flush(); std::cerr.flush(); std::fflush(NULL);
+
+    std::map<pid_t,std::pair<UInt_t,Clock::time_point> > running;
+    UInt_t next = 0;
+    while (next < jobs.size() || !running.empty())
+    {
+      // top up the pool
+      while (next < jobs.size() && Int_t(running.size()) < njobs)
+      {
+	const auto start = Clock::now();
+	const pid_t pid = ::fork();
+	if (pid == 0) SamplePool::RunChild(jobs[next],logdir);
+	if (pid < 0)
+	{
+	  std::cerr << "Cannot fork for sample: " << jobs[next].name.Data() << std::endl;
+	  next++;
+	  continue;
+	}
+	out << "Started sample: " << jobs[next].name.Data() << " (pid " << pid << ")" << std::endl;
+	running[pid] = std::make_pair(next++,start);
+      }
+      if (running.empty()) break;
+
+      // reap whichever finishes first: wait4 gives the child's own peak memory
+      Int_t wstatus = 0;
+      struct rusage usage;
+      const pid_t pid = ::wait4(-1,&wstatus,0,&usage);
+      if (pid < 0) break;
+
+      const auto iter = running.find(pid);
+      if (iter == running.end()) continue;
+
+      auto & result = results[iter->second.first];
+      result.status  = (WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : 128+WTERMSIG(wstatus));
+      result.seconds = SamplePool::Seconds(iter->second.second);
+      result.maxrss  = usage.ru_maxrss;
+      SamplePool::Print(result,out);
+      running.erase(iter);
+    }
+
+    Bool_t ok = true;
+    for (const auto & result : results)
+    {
+      if (result.status != 0)
+      {
+	std::cerr << "Sample: " << result.name.Data() << " failed (status " << result.status << ")"
+		  << (logdir != "" ? ", see "+SamplePool::LogName(logdir,result.name) : TString("")).Data() << std::endl;
+	ok = false;
+      }
+    }
+    return ok;
+  }
+};
+
+#endif
@@ -188,8 +188,8 @@ void ZeeTnPTree::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
     if (saveElectron) tagelectrons.emplace_back(i); // save index of tag electron
   } // end loop over all electrons
 
-  // Now build the tnppairs
-  triplevec tnpelectrons;
+  // Now build the tnppairs: keep only the best one as we go
+  Kinematics::BestPair best;
   for (std::size_t i = 0; i < tagelectrons.size(); i++)
   {
     // get the electron
@@ -235,22 +235,18 @@ void ZeeTnPTree::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
       // need the seed to exist to be a good probe!
       if (!seedOK) continue;
       
-      TLorentzVector el1vec; el1vec.SetPtEtaPhiE(tagelectron.pt(), tagelectron.eta(), tagelectron.phi(), tagelectron.energy());
-      TLorentzVector el2vec; el2vec.SetPtEtaPhiE(   electron.pt(),    electron.eta(),    electron.phi(),    electron.energy());
-      el1vec += el2vec;
+      const float mass = Kinematics::PairMass(tagelectron.pt(), tagelectron.eta(), tagelectron.phi(), tagelectron.energy(),
+					         electron.pt(),    electron.eta(),    electron.phi(),    electron.energy());
       
-      tnpelectrons.emplace_back(std::make_tuple(tagelectrons[i],j,std::abs(el1vec.M()-91.1876))); // save diff from Z mass
+      best.Update(tagelectrons[i],j,mass,91.1876); // keep the closest to the Z mass
     } // end loop over potential probes
   } // end loop over tags
 
   // check to make sure at least one TnP pair exists
-  if (tnpelectrons.size()>0)
+  if (best.IsValid())
   {
-    // For now, get the best pair
-    auto best = std::min_element(tnpelectrons.begin(),tnpelectrons.end(),oot::minimizeByZmass); // keep the lowest! --> returns pointer to lowest element
-
     // Tag is el1
-    pat::Electron el1 = electrons[std::get<0>(*best)];
+    pat::Electron el1 = electrons[best.i];
   
     // set the individual electron variables
     el1pid = el1.pdgId(); 
@@ -294,7 +290,7 @@ void ZeeTnPTree::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
     el1seedgain6 = el1recHit->checkFlag(EcalRecHit::kHasSwitchToGain6);
 
     // Probe is el2
-    pat::Electron el2 = electrons[std::get<1>(*best)];
+    pat::Electron el2 = electrons[best.j];
   
     // set the individual electron variables
     el2pid = el2.pdgId(); 
@@ -338,17 +334,13 @@ void ZeeTnPTree::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
     el2seedgain6 = el2recHit->checkFlag(EcalRecHit::kHasSwitchToGain6);
 
     // store Z information
-    TLorentzVector el1vec; el1vec.SetPtEtaPhiE(el1pt, el1eta, el1phi, el1E);
-    TLorentzVector el2vec; el2vec.SetPtEtaPhiE(el2pt, el2eta, el2phi, el2E);
-      
-    TLorentzVector zvec(el1vec);
-    zvec += el2vec;
+    const Kinematics::PairSum zvec(el1pt, el1eta, el1phi, el1E, el2pt, el2eta, el2phi, el2E);
       
     zpt   = zvec.Pt();
     zeta  = zvec.Eta();
     zphi  = zvec.Phi();
     zmass = zvec.M();
-    zE    = zvec.Energy();
+    zE    = zvec.E;
     zp    = zvec.P();
   } // end section over tnp pair
 
@@ -51,10 +51,10 @@
 
 // ROOT
 #include "TTree.h"
-#include "TLorentzVector.h"
 #include "TPRegexp.h"
 
 #include "Timing/TimingAnalyzer/plugins/CommonUtils.hh"
+#include "Timing/TimingAnalyzer/plugins/Kinematics.hh"
 
 class ZeeTnPTree : public edm::one::EDAnalyzer<edm::one::SharedResources,edm::one::WatchRuns> 
 {
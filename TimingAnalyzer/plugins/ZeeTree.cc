@@ -29,6 +29,13 @@ ZeeTree::ZeeTree(const edm::ParameterSet& iConfig):
   usesResource();
   usesResource("TFileService");
 
+  // triggers for the Analysis: matched to the menu only when it changes
+  triggerCache.addPath("HLT_Ele23_Ele12_CaloIdL_TrackIdL_IsoVL_DZ_L1JetTauSeeded_v");
+  triggerCache.addPath("HLT_Ele23_Ele12_CaloIdL_TrackIdL_IsoVL_DZ_v");
+  triggerCache.addPath("HLT_DoubleEle33_CaloIdL_GsfTrkIdVL_v");
+  triggerCache.addPath("HLT_DoubleEle33_CaloIdL_MW_v");
+  triggerCache.addPath("HLT_DoubleEle37_Ele27_CaloIdL_GsfTrkIdVL");
+
   // trigger tokens
   triggerResultsToken = consumes<edm::TriggerResults> (triggerResultsTag);
   
@@ -113,18 +120,10 @@ void ZeeTree::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   hltdoubleel37_27 = false;
 
   // Which triggers fired
-  if (triggerResultsH.isValid())
-  {
-    for (std::size_t i = 0; i < triggerPathsVector.size(); i++) 
-    {
-      if (triggerPathsMap[triggerPathsVector[i]] == -1) continue;	
-      if (i == 0 && triggerResultsH->accept(triggerPathsMap[triggerPathsVector[i]])) hltdoubleel23_12 = true; // Double electron trigger (23-12)
-      if (i == 1 && triggerResultsH->accept(triggerPathsMap[triggerPathsVector[i]])) hltdoubleel23_12 = true; // Double electron trigger (23-12)
-      if (i == 2 && triggerResultsH->accept(triggerPathsMap[triggerPathsVector[i]])) hltdoubleel33_33 = true; // Double electron trigger (33-33)
-      if (i == 3 && triggerResultsH->accept(triggerPathsMap[triggerPathsVector[i]])) hltdoubleel33_33 = true; // Double electron trigger (33-33)
-      if (i == 4 && triggerResultsH->accept(triggerPathsMap[triggerPathsVector[i]])) hltdoubleel37_27 = true; // Double electron trigger (37-27)
-    }
-  }
+  oot::PrepTriggerBits(triggerResultsH,iEvent,triggerCache);
+  if (triggerCache.accept(0) || triggerCache.accept(1)) hltdoubleel23_12 = true; // Double electron trigger (23-12)
+  if (triggerCache.accept(2) || triggerCache.accept(3)) hltdoubleel33_33 = true; // Double electron trigger (33-33)
+  if (triggerCache.accept(4))                           hltdoubleel37_27 = true; // Double electron trigger (37-27)
 
   // skim on events that pass triggers
   bool triggered = false;
@@ -199,39 +198,30 @@ void ZeeTree::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   }
 
   // Z matching + filling of variables
-  triplevec invmasspairs; // store i-j good el index + invariant mass
+  Kinematics::BestPair best; // i-j good el index + invariant mass
   if (goodelectrons.size()>1)  // need at least two electrons that pass id and pt cuts! 
   {
-    // only want pair of good electrons that yield closest zmass diff   
-    for (std::size_t i = 0; i < goodelectrons.size(); i++) 
-    {
-      const pat::Electron& el1_tmp = goodelectrons[i];
-      for (std::size_t j = i+1; j < goodelectrons.size(); j++) 
-      {
-	const pat::Electron& el2_tmp = goodelectrons[j];
-	int el1pdgId = el1_tmp.pdgId();
-	int el2pdgId = el2_tmp.pdgId();
-	if (el1pdgId == -el2pdgId)
-        {
-	  TLorentzVector el1vec; el1vec.SetPtEtaPhiE(el1_tmp.pt(), el1_tmp.eta(), el1_tmp.phi(), el1_tmp.energy());
-	  TLorentzVector el2vec; el2vec.SetPtEtaPhiE(el2_tmp.pt(), el2_tmp.eta(), el2_tmp.phi(), el2_tmp.energy());
-	  el1vec += el2vec;
-	  invmasspairs.emplace_back(std::make_tuple(i,j,std::abs(el1vec.M()-91.1876))); 
-	}
-      }
-    }
+    // only want pair of good electrons that yield closest zmass diff: opposite charge only
+    Kinematics::FourVecs elvecs;
+    elvecs.reserve(goodelectrons.size());
+    for (const auto & el : goodelectrons) elvecs.emplace_back(el.pt(), el.eta(), el.phi(), el.energy());
+
+    best = Kinematics::FindBestPair(elvecs,91.1876,
+				    [&](const std::size_t i, const std::size_t j)
+				    {
+				      return (goodelectrons[i].pdgId() == -goodelectrons[j].pdgId());
+				    });
   }
   else
   {
     if (applyKinematicsFilter) return;
   }
 
-  if (invmasspairs.size()>0)
+  if (best.IsValid())
   {
     // Get the best pair (if it exists)
-    auto best = std::min_element(invmasspairs.begin(),invmasspairs.end(),oot::minimizeByZmass); // keep the lowest! --> returns pointer to lowest element
-    pat::Electron el1 = goodelectrons[std::get<0>(*best)];
-    pat::Electron el2 = goodelectrons[std::get<1>(*best)];
+    pat::Electron el1 = goodelectrons[best.i];
+    pat::Electron el2 = goodelectrons[best.j];
   
     // set the individual electron variables
     el1pid = el1.pdgId();  el2pid = el2.pdgId();
@@ -364,13 +354,9 @@ void ZeeTree::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
     } // end check over electron2 supercluster
 
     // store Z information
-    TLorentzVector el1vec; el1vec.SetPtEtaPhiE(el1pt, el1eta, el1phi, el1E);
-    TLorentzVector el2vec; el2vec.SetPtEtaPhiE(el2pt, el2eta, el2phi, el2E);
-      
-    TLorentzVector zvec(el1vec);
-    zvec += el2vec;
+    const Kinematics::PairSum zvec(el1pt, el1eta, el1phi, el1E, el2pt, el2eta, el2phi, el2E);
       
-    zE    = zvec.Energy();
+    zE    = zvec.E;
     zp    = zvec.P();
     zpt   = zvec.Pt();
     zeta  = zvec.Eta();
@@ -480,14 +466,10 @@ void ZeeTree::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
 	} // end loop over gen particles
   	if (genel1pid == 11 && genel2pid == -11) 
         {
-  	  TLorentzVector el1vec; el1vec.SetPtEtaPhiE(genel1pt, genel1eta, genel1phi, genel1E);
-  	  TLorentzVector el2vec; el2vec.SetPtEtaPhiE(genel2pt, genel2eta, genel2phi, genel2E);
-
-  	  TLorentzVector zvec(el1vec);
-  	  zvec    += el2vec;
+  	  const Kinematics::PairSum zvec(genel1pt, genel1eta, genel1phi, genel1E, genel2pt, genel2eta, genel2phi, genel2E);
 
 	  genzpid  = 23;
-  	  genzE    = zvec.Energy();
+  	  genzE    = zvec.E;
   	  genzp    = zvec.P();
   	  genzpt   = zvec.Pt();
   	  genzeta  = zvec.Eta();
@@ -622,37 +604,7 @@ void ZeeTree::beginJob()
 
 void ZeeTree::endJob() {}
 
-void ZeeTree::beginRun(edm::Run const& iRun, edm::EventSetup const& iSetup) 
-{
-  // triggers for the Analysis
-  triggerPathsVector.emplace_back("HLT_Ele23_Ele12_CaloIdL_TrackIdL_IsoVL_DZ_L1JetTauSeeded_v");
-  triggerPathsVector.emplace_back("HLT_Ele23_Ele12_CaloIdL_TrackIdL_IsoVL_DZ_v");
-  triggerPathsVector.emplace_back("HLT_DoubleEle33_CaloIdL_GsfTrkIdVL_v");
-  triggerPathsVector.emplace_back("HLT_DoubleEle33_CaloIdL_MW_v");
-  triggerPathsVector.emplace_back("HLT_DoubleEle37_Ele27_CaloIdL_GsfTrkIdVL");
-
-  HLTConfigProvider hltConfig;
-  bool changedConfig = false;
-  hltConfig.init(iRun, iSetup, triggerResultsTag.process(), changedConfig);
-  
-  for (size_t i = 0; i < triggerPathsVector.size(); i++) 
-  {
-    triggerPathsMap[triggerPathsVector[i]] = -1;
-  }
-  
-  for(size_t i = 0; i < triggerPathsVector.size(); i++)
-  {
-    TPRegexp pattern(triggerPathsVector[i]);
-    for(size_t j = 0; j < hltConfig.triggerNames().size(); j++)
-    {
-      std::string pathName = hltConfig.triggerNames()[j];
-      if(TString(pathName).Contains(pattern))
-      {
-	triggerPathsMap[triggerPathsVector[i]] = j;
-      }
-    }
-  }
-}
+void ZeeTree::beginRun(edm::Run const&, edm::EventSetup const&) {}
 
 void ZeeTree::endRun(edm::Run const&, edm::EventSetup const&) {}
 
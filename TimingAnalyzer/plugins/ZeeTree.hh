@@ -23,9 +23,6 @@
 #include "FWCore/Common/interface/TriggerNames.h"
 #include "CommonTools/UtilAlgos/interface/TFileService.h" 
 
-// HLT info
-#include "HLTrigger/HLTcore/interface/HLTConfigProvider.h"
-
 // Gen Info
 #include "SimDataFormats/PileupSummaryInfo/interface/PileupSummaryInfo.h"
 #include "SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h"
@@ -51,10 +48,9 @@
 
 // ROOT
 #include "TTree.h"
-#include "TLorentzVector.h"
-#include "TPRegexp.h"
 
 #include "Timing/TimingAnalyzer/plugins/CommonUtils.hh"
+#include "Timing/TimingAnalyzer/plugins/Kinematics.hh"
 
 class ZeeTree : public edm::one::EDAnalyzer<edm::one::SharedResources,edm::one::WatchRuns> 
 {
@@ -75,8 +71,7 @@ private:
   // Trigger
   const edm::InputTag triggerResultsTag;
   edm::EDGetTokenT<edm::TriggerResults> triggerResultsToken;
-  std::vector<std::string>   triggerPathsVector;
-  std::map<std::string, int> triggerPathsMap;
+  oot::TriggerCache triggerCache;
   const bool applyHLTFilter;
 
   // Vertex
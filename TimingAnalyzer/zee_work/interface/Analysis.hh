@@ -4,9 +4,14 @@
 #include "CommonTypes.hh"
 #include "Config.hh"
 #include "Common.hh"
+#include "../../plugins/Kinematics.hh"
+#include "../../plugins/BranchGroups.hh"
+#include "../../plugins/HistRegistry.hh"
+#include "../../plugins/ResolutionEngine.hh"
 
 #include "TH2F.h"
 #include "TF1.h"
+#include "TMath.h"
 
 #include <array>
 
@@ -48,6 +53,40 @@ typedef TH1Map::iterator        TH1MapIter;
 typedef std::map<TString,TH2F*> TH2Map;
 typedef TH2Map::iterator        TH2MapIter;
 
+// partitions in the plot names: single electrons, and electron pairs
+enum ElPart   {kElIncl, kElEB, kElEE, kElEP, kElEM, nElParts};
+enum PairPart {kPairIncl, kPairEBEB, kPairEEEE, kPairEPEP, kPairEMEM, kPairEPEM, kPairEBEE, nPairParts};
+
+typedef std::array<UInt_t,nElParts>   ElPartHandles;
+typedef std::array<UInt_t,nPairParts> PairPartHandles;
+
+struct Parts // partitions an electron (pair) is in: inclusive first, then the finer ones
+{
+  Parts() : n(0) {}
+  void Add(const UInt_t part) {ids[n++] = part;}
+  const UInt_t * begin() const {return ids.data();}
+  const UInt_t * end() const {return ids.data()+n;}
+  UInt_t n;
+  std::array<UInt_t,3> ids;
+};
+
+// fill handles into the TH1 and TH2 registries
+struct EvHandles
+{
+  UInt_t nvtx, vtxZ, zpt, zeta, abszeta, zphi, deta, dseedeta;
+  UInt_t td_vtxZ; // TH2
+  PairPartHandles zmass, effseedE, td;
+  PairPartHandles td_effseedE, td_nvtx, td_dseedeta, td_runs; // TH2
+};
+
+struct ElHandles
+{
+  UInt_t phi, eta, seedeta, pt, p, scE;
+  UInt_t td_seedeta, time_seedeta, time_vtxZ; // TH2
+  ElPartHandles E, seedE, rhEs, time, rhtimes;
+  PairPartHandles td_seedE, time_seedE; // TH2
+};
+
 class Analysis {
 public:
   // functions
@@ -57,6 +96,7 @@ public:
   void GetPedestalNoise();
   void GetADC2GeVConvs();
   void InitTree();
+  void SetupBranchGroups();
   void EventLoop();
   void SetupStandardPlots();
   void SetupSingleEPlots();
@@ -66,6 +106,11 @@ public:
   void SetupVtxZPlots();
   void SetupRunPlots();
   void SetupTrigEffPlots();
+  void SetupFillHandles();
+  void SetupResolutionEngine();
+  Parts GetElParts(const Bool_t eb, const Bool_t ee, const Bool_t ep, const Bool_t em);
+  Parts GetPairParts(const Bool_t el1eb, const Bool_t el1ee, const Bool_t el1ep, const Bool_t el1em,
+		     const Bool_t el2eb, const Bool_t el2ee, const Bool_t el2ep, const Bool_t el2em);
   void FillStandardPlots(const Float_t weight, const Float_t effseedE, const Float_t el1seedE, const Float_t el2seedE, const Float_t timediff, 
 			 const Float_t el1time, const Float_t el1seedeta, Bool_t el1eb, Bool_t el1ee, Bool_t el1ep, Bool_t el1em, const FltArr3Vec & el1rhetps,
 			 const Float_t el2time, const Float_t el2seedeta, Bool_t el2eb, Bool_t el2ee, Bool_t el2ep, Bool_t el2em, const FltArr3Vec & el2rhetps);
@@ -80,6 +125,7 @@ public:
   void FillVtxZPlots(const Float_t weight, const Float_t timediff, const Float_t el1time, const Float_t el2time);
   void FillRunPlots(const Float_t weight, const Float_t timediff, Bool_t el1eb, Bool_t el1ee, Bool_t el2eb, Bool_t el2ee);
   void FillTrigEffPlots(const Float_t weight);
+  void Fill2D(const UInt_t handle, const Float_t x, const Float_t y, const Float_t weight);
   void OutputStandardPlots();
   void OutputSingleEPlots();
   void OutputEffEPlots();
@@ -91,14 +137,20 @@ public:
   void Make1DTimingPlots(TH2F *& hist2D, const TString subdir2D, const DblVec& bins2D, TString name);
   void Project2Dto1D(TH2F *& hist2d, TString subdir2d, TH1Map & th1map, TStrMap & subdir1dmap, TStrIntMap & th1binmap);
   void ProduceMeanSigma(TH1Map & th1map, TStrIntMap & th1binmap, TString name, TString xtitle, const DblVec vxbins, TString subdir);
+  TH1F * MakeFitResultHist(const TString & name, const TString & var, const TString & label, const TString & xtitle, const DblVec & vxbins);
+  void OutputFitResultHists(const TString & name, const TString & subdir, TH1F * outhist_mean, TH1F * outhist_sigma, TH1F * outhist_chi2ndf, TH1F * outhist_chi2prob);
+  void ProduceStreamMeanSigma(TH2F *& hist2d, TString name, const DblVec vxbins, TString subdir);
+  void GetStreamGoF(TH2F *& hist2d, const ResolutionEngine::Slice & slice, Double_t & norm, Float_t & chi2ndf, Float_t & chi2prob);
+  TH1F * MakeSliceHist(TH2F *& hist2d, const ResolutionEngine::Slice & slice);
+  TF1 * MakeStreamFit(const ResolutionEngine::Slice & slice, const Double_t norm);
   void PrepFit(TF1 *& fit, TH1F *& hist);
   void GetMeanSigma(TF1 *& fit, Float_t & mean, Float_t & emean, Float_t & sigma, Float_t & esigma); 
   void DrawSubComp(TF1 *& fit, TCanvas *& canv, TF1 *& sub1, TF1 *& sub2, TF1 *& sub3);
   TH1F * MakeTH1Plot(TString hname, TString htitle, Int_t nbins, Double_t xlow, Double_t xhigh, TString xtitle, TString ytitle, TStrMap& subdirmap, TString subdir);
   TH2F * MakeTH2Plot(TString hname, TString htitle, const DblVec& vxbins, Int_t nbinsy, Double_t ylow, Double_t yhigh, 
 		     TString xtitle, TString ytitle, TStrMap& subdirmap, TString subdir);
-  void FillHistFromArr3Vec0(TH1F *& hist, const FltArr3Vec & arr3vec);
-  void FillHistFromArr3Vec1(TH1F *& hist, const FltArr3Vec & arr3vec);
+  void FillHistFromArr3Vec0(TH1F * hist, const FltArr3Vec & arr3vec);
+  void FillHistFromArr3Vec1(TH1F * hist, const FltArr3Vec & arr3vec);
   void SaveTH1s(TH1Map & th1map, TStrMap & subdirmap);
   void SaveTH1andFit(TH1F *& hist, TString subdir, TF1 *& fit);
   void SaveTH2s(TH2Map & th2map, TStrMap & subdirmap);
@@ -111,6 +163,7 @@ private:
   // Input
   TFile * fInFile;
   TTree * fInTree;
+  BranchGroups fBranches;
   TString fSample;
   Bool_t  fIsMC;
 
@@ -131,6 +184,8 @@ private:
   TString fOutDir;
   TFile*  fOutFile;
   std::ofstream fTH1Dump; 
+  TString fTH1DumpName;
+  TString fTmpExt;
   
   // Output colors
   Color_t fColor;
@@ -174,6 +229,17 @@ private:
   TH1F * n_hltdoubleel_el1pt; TH1F * d_hltdoubleel_el1pt;
   TH1F * n_hltdoubleel_el2pt; TH1F * d_hltdoubleel_el2pt;
 
+  ///////////////////////////////////////////////////
+  // fill handles: resolved once, after the setup //
+  ///////////////////////////////////////////////////
+  HistRegistry<TH1F> fTH1s;
+  HistRegistry<TH2F> fTH2s;
+  EvHandles fEvHandles;
+  std::array<ElHandles,2> fElHandles;
+
+  // streamed time resolution: on the TH2 handles
+  ResolutionEngine fResEngine;
+
 public:
   // Declaration of leaf types
   UInt_t    run;
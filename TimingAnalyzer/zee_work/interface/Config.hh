@@ -110,6 +110,7 @@ namespace Config{
   extern Bool_t      doAnalysis;
   extern Bool_t      doStacks;
   extern Bool_t      doDemo;
+  extern Int_t       nJobs;
   extern Bool_t      useDEG;
   extern Bool_t      useSEL;
   extern Bool_t      useDYll;
@@ -128,6 +129,9 @@ namespace Config{
   extern Bool_t      wgtedTime;
   extern Bool_t      useSigma_n;
   extern Bool_t      saveFits;
+  extern Bool_t      streamRes;
+  extern Int_t       fitThreads;
+  extern Int_t       nReservoir;
   extern Bool_t      dumpStatus;
   extern TString     year;
   extern TString     formname; // fitting function to be used
@@ -1,5 +1,6 @@
 #include "../interface/Analysis.hh"
 #include "TROOT.h"
+#include "TSystem.h"
 
 inline Float_t rad2  (const Float_t x, const Float_t y){return x*x + y*y;}
 inline Float_t theta (const Float_t r, const Float_t z){return std::atan2(r,z);}
@@ -12,16 +13,6 @@ inline Float_t rad2  (const Float_t x, const Float_t y, const Float_t z)
   return x*x + y*y + z*z;
 }
 inline Float_t phi   (const Float_t x, const Float_t y){return std::atan2(y,x);}
-inline Float_t mphi  (Float_t phi)
-{    
-  while (phi >= Config::PI) phi -= Config::TWOPI;
-  while (phi < -Config::PI) phi += Config::TWOPI;
-  return phi;
-}
-inline Float_t deltaR(const Float_t eta1, const Float_t phi1, const Float_t eta2, const Float_t phi2)
-{
-  return std::sqrt(rad2(eta2-eta1,mphi(phi1-phi2)));
-}
 inline Float_t TOF   (const Float_t x,  const Float_t y,  const Float_t z, 
 		      const Float_t vx, const Float_t vy, const Float_t vz, const Float_t time)
 {
@@ -96,7 +87,10 @@ Analysis::Analysis(TString sample, Bool_t isMC) : fSample(sample), fIsMC(isMC)
   }  
   else 
   {
-    fTH1Dump.open(Form("%s/%s",Config::outdir.Data(),Config::plotdumpname.Data()),std::ios_base::trunc); // do this once, and just do it for data
+    // do this once, and just do it for data: per-process name, moved in place when closed, in case data samples run concurrently
+    fTH1DumpName = Form("%s/%s",Config::outdir.Data(),Config::plotdumpname.Data());
+    fTmpExt      = Form(".%i",gSystem->GetPid());
+    fTH1Dump.open((fTH1DumpName+fTmpExt).Data(),std::ios_base::trunc);
   }
 }
 
@@ -105,7 +99,11 @@ Analysis::~Analysis()
   delete fInTree;
   delete fInFile;
   delete fOutFile;
-  if (!fIsMC) fTH1Dump.close();
+  if (!fIsMC) 
+  {
+    fTH1Dump.close();
+    gSystem->Rename((fTH1DumpName+fTmpExt).Data(),fTH1DumpName.Data());
+  }
 }
 
 void Analysis::EventLoop()
@@ -119,23 +117,34 @@ void Analysis::EventLoop()
   if (Config::doVtxZ)     Analysis::SetupVtxZPlots();
   if (Config::doRuns)     Analysis::SetupRunPlots();
   if (Config::doTrigEff)  Analysis::SetupTrigEffPlots();
+  Analysis::SetupFillHandles();
 
   // do loop over events, filling histos --> store current run
   Int_t currentRun  = -1;
   Int_t PedNoiseIOV = (fIsMC)?0:-1;
   Int_t ADC2GeVIOV  = (fIsMC)?0:-1;
-  for (UInt_t entry = 0; entry < (!Config::doDemo?fInTree->GetEntries():Config::demoNum); entry++)
+  Analysis::SetupBranchGroups();
+  const UInt_t nEntries = (!Config::doDemo?fInTree->GetEntries():Config::demoNum);
+  for (UInt_t entry = 0; entry < nEntries; entry++)
   {
-    fInTree->GetEntry(entry);
+    fBranches.GetEntry(entry);
 
     if (Config::dumpStatus) 
     {
-      if (entry%Config::nEvCheck == 0 || entry == 0) std::cout << "Processing Entry: " << entry << " out of " << fInTree->GetEntries() << std::endl;
+      if (entry%Config::nEvCheck == 0 || entry == 0) std::cout << "Processing Entry: " << entry << " out of " << nEntries << std::endl;
     } 
 
     const Bool_t triggered = (fIsMC)?true:(hltdoubleel33_33||hltdoubleel37_27);
     if ( (zmass < 76.f || zmass > 106.f) || (!triggered) || (el1seedpos < 0) || (el2seedpos < 0) ) continue;
 
+    // rest of the event only for Z candidates
+    fBranches.Load("electrons");
+    if (Config::doStandard) fBranches.Load("standard");
+    if (Config::doNvtx)     fBranches.Load("nvtx");
+    if (Config::doVtxZ)     fBranches.Load("vtxZ");
+    if (Config::doRuns)     fBranches.Load("runs");
+    if (Config::doTrigEff)  fBranches.Load("trigeff");
+
     ///////////////
     //           //
     // Seed Info //
@@ -251,7 +260,7 @@ void Analysis::EventLoop()
 	
 	const Float_t rhX = (*el1rhXs)[rh]; const Float_t rhY = (*el1rhYs)[rh]; const Float_t rhZ = (*el1rhZs)[rh];  
 	const Float_t rhphi = phi(rhX,rhY); const Float_t rheta = eta(rhX, rhY, rhZ);
-	if (deltaR(el1eta,rheta,el1phi,rhphi) > Config::dRcut) continue; 
+	if (Kinematics::DeltaR(el1eta,el1phi,rheta,rhphi) > Config::dRcut) continue; 
 	
 	Float_t rhSigma_n = 0.0;
 	if      (el1eb) rhSigma_n = fPedNoises[PedNoiseIOV][rhid] * fADC2GeVs[ADC2GeVIOV].EB_;
@@ -268,7 +277,7 @@ void Analysis::EventLoop()
 	
 	const Float_t rhX = (*el2rhXs)[rh]; const Float_t rhY = (*el2rhYs)[rh]; const Float_t rhZ = (*el2rhZs)[rh];  
 	const Float_t rhphi = phi(rhX,rhY); const Float_t rheta = eta(rhX, rhY, rhZ);
-	if (deltaR(el2eta,rheta,el2phi,rhphi) > Config::dRcut) continue; 
+	if (Kinematics::DeltaR(el2eta,el2phi,rheta,rhphi) > Config::dRcut) continue; 
 	
 	Float_t rhSigma_n = 0.0;
 	if      (el2eb) rhSigma_n = fPedNoises[PedNoiseIOV][rhid] * fADC2GeVs[ADC2GeVIOV].EB_;
@@ -313,6 +322,10 @@ void Analysis::EventLoop()
     if (Config::doRuns)     Analysis::FillRunPlots(weight,timediff,el1eb,el1ee,el2eb,el2ee);
     if (Config::doTrigEff)  Analysis::FillTrigEffPlots(weight);
   } // end loop over events
+  fBranches.Report();
+
+  // streamed time resolution: every slice of every plot fit at once, in threads
+  if (Config::streamRes) fResEngine.Solve(ResolutionEngine::GetForm(Config::formname.Data()),Config::fitrange,Config::ncore,Config::fitThreads);
 
    // output hists
   if (Config::doStandard) Analysis::OutputStandardPlots();
@@ -325,6 +338,47 @@ void Analysis::EventLoop()
   if (Config::doTrigEff)  Analysis::OutputTrigEffPlots();
 }
 
+void Analysis::SetupBranchGroups()
+{
+  fBranches.SetTree(fInTree);
+
+  // Z selection: read for every entry
+  fBranches.Declare("selection",{"zmass","hltdoubleel33_33","hltdoubleel37_27","el1seedpos","el2seedpos"});
+  fBranches.Enable("selection");
+
+  // seed and rec hit info for the electron times, after the Z selection
+  std::vector<TString> electrons = {"vtxX","vtxY","vtxZ","el1rhids","el1rhXs","el1rhYs","el1rhZs","el1rhEs","el1rhtimes",
+				    "el2rhids","el2rhXs","el2rhYs","el2rhZs","el2rhEs","el2rhtimes"};
+  if (Config::doStandard || Config::wgtedTime)
+  {
+    for (const auto & name : {"el1nrh","el1eta","el1phi","el2nrh","el2eta","el2phi"}) electrons.emplace_back(name);
+  }
+  if (!fIsMC && Config::useSigma_n) electrons.emplace_back("run");
+  if (fIsMC)
+  {
+    electrons.emplace_back("wgt");
+    electrons.emplace_back("putrue");
+  }
+  fBranches.Declare("electrons",electrons,true);
+  fBranches.Enable("electrons");
+
+  // plot groups
+  fBranches.Declare("standard",{"nvtx","vtxZ","zpt","zeta","zphi","el1E","el1p","el1pt","el1eta","el1phi","el1scE",
+				"el2E","el2p","el2pt","el2eta","el2phi","el2scE"},true);
+  fBranches.Declare("nvtx",{"nvtx"},true);
+  fBranches.Declare("vtxZ",{"vtxZ"},true);
+  fBranches.Declare("runs",{"run"},true);
+  fBranches.Declare("trigeff",{"el1pt","el2pt"},true);
+
+  fBranches.Enable("standard",Config::doStandard);
+  fBranches.Enable("nvtx"    ,Config::doNvtx);
+  fBranches.Enable("vtxZ"    ,Config::doVtxZ);
+  fBranches.Enable("runs"    ,Config::doRuns);
+  fBranches.Enable("trigeff" ,Config::doTrigEff);
+
+  fBranches.Activate();
+}
+
 void Analysis::SetupStandardPlots()
 {
   // event based variables
@@ -588,242 +642,271 @@ void Analysis::SetupTrigEffPlots()
   trTH1Map["hltdoubleel_el2pt"] = Analysis::MakeTH1Plot("hltdoubleel_el2pt","Double Electron Trigger Efficiency vs. p_{T}",nBinsDEEpt,xLowDEEpt,xHighDEEpt,"Subleading Electron p_{T} [GeV/c]","Efficiency",trTH1SubMap,"trigger_zoomest");
 }
 
-void Analysis::FillStandardPlots(const Float_t weight, const Float_t effseedE, const Float_t el1seedE, const Float_t el2seedE, const Float_t timediff,
-				 const Float_t el1time, const Float_t el1seedeta, Bool_t el1eb, Bool_t el1ee, Bool_t el1ep, Bool_t el1em, const FltArr3Vec & el1rhetps,
-				 const Float_t el2time, const Float_t el2seedeta, Bool_t el2eb, Bool_t el2ee, Bool_t el2ep, Bool_t el2em, const FltArr3Vec & el2rhetps)
+void Analysis::SetupFillHandles()
 {
-  // standard "validation" and Z mass plots
-  standardTH1Map["nvtx"]->Fill(nvtx,weight);
-  standardTH1Map["vtxZ"]->Fill(vtxZ,weight);
-
-  standardTH1Map["zpt"]->Fill(zpt,weight);
-  standardTH1Map["zeta"]->Fill(zeta,weight);
-  standardTH1Map["abszeta"]->Fill(std::abs(zeta),weight);
-  standardTH1Map["zphi"]->Fill(zphi,weight);
-
-  standardTH1Map["el1phi"]->Fill(el1phi,weight);
-  standardTH1Map["el1eta"]->Fill(el1eta,weight);
-  standardTH1Map["el1seedeta"]->Fill(el1seedeta,weight);
-  standardTH1Map["el1pt"]->Fill(el1pt,weight);
-  standardTH1Map["el1p"]->Fill(el1p,weight);
-  standardTH1Map["el1scE"]->Fill(el1scE,weight);
-
-  standardTH1Map["el2phi"]->Fill(el2phi,weight); 
-  standardTH1Map["el2eta"]->Fill(el2eta,weight);
-  standardTH1Map["el2seedeta"]->Fill(el2seedeta,weight);
-  standardTH1Map["el2pt"]->Fill(el2pt,weight);
-  standardTH1Map["el2p"]->Fill(el2p,weight);
-  standardTH1Map["el2scE"]->Fill(el2scE,weight);
-
-  standardTH1Map["deta"]->Fill(std::abs(el1eta-el2eta),weight);
-  standardTH1Map["dseedeta"]->Fill(std::abs(el1seedeta-el2seedeta),weight);
-
-  // inclusive single electron timing and energy
-  // el1
-  standardTH1Map["el1E_inclusive"]->Fill(el1E,weight);
-  standardTH1Map["el1seedE_inclusive"]->Fill(el1seedE,weight);
-  timingMap["el1time_inclusive"]->Fill(el1time,weight);
-  Analysis::FillHistFromArr3Vec0(timingMap["el1rhtimes_inclusive"],el1rhetps);
-  if        (el1eb) 
-  {
-    standardTH1Map["el1E_EB"]->Fill(el1E,weight);
-    standardTH1Map["el1seedE_EB"]->Fill(el1seedE,weight);
-    timingMap["el1time_EB"]->Fill(el1time,weight);
-    Analysis::FillHistFromArr3Vec0(timingMap["el1rhtimes_EB"],el1rhetps);
-    Analysis::FillHistFromArr3Vec1(standardTH1Map["el1rhEs_EB"],el1rhetps);
-  }
-  else if   (el1ee) 
-  {
-    standardTH1Map["el1E_EE"]->Fill(el1E,weight);
-    standardTH1Map["el1seedE_EE"]->Fill(el1seedE,weight);
-    timingMap["el1time_EE"]->Fill(el1time,weight);
-    Analysis::FillHistFromArr3Vec0(timingMap["el1rhtimes_EE"],el1rhetps);
-    Analysis::FillHistFromArr3Vec1(standardTH1Map["el1rhEs_EE"],el1rhetps);
-    if      (el1ep) 
-    {
-      standardTH1Map["el1E_EP"]->Fill(el1E,weight);
-      standardTH1Map["el1seedE_EP"]->Fill(el1seedE,weight);
-      timingMap["el1time_EP"]->Fill(el1time,weight);
-      Analysis::FillHistFromArr3Vec0(timingMap["el1rhtimes_EP"],el1rhetps);
-      Analysis::FillHistFromArr3Vec1(standardTH1Map["el1rhEs_EP"],el1rhetps);
-    }
-    else if (el1em) 
-    {
-      standardTH1Map["el1E_EM"]->Fill(el1E,weight);
-      standardTH1Map["el1seedE_EM"]->Fill(el1seedE,weight);
-      timingMap["el1time_EM"]->Fill(el1time,weight);
-      Analysis::FillHistFromArr3Vec0(timingMap["el1rhtimes_EM"],el1rhetps);
-      Analysis::FillHistFromArr3Vec1(standardTH1Map["el1rhEs_EM"],el1rhetps);
-    }
+  // names resolved here once: the fill functions only index the registries
+  static const TStrVec elparts   = {"inclusive","EB","EE","EP","EM"};
+  static const TStrVec pairparts = {"inclusive","EBEB","EEEE","EPEP","EMEM","EPEM","EBEE"};
+
+  auto & ev = fEvHandles;
+  ev.nvtx     = fTH1s.Declare("nvtx");
+  ev.vtxZ     = fTH1s.Declare("vtxZ");
+  ev.zpt      = fTH1s.Declare("zpt");
+  ev.zeta     = fTH1s.Declare("zeta");
+  ev.abszeta  = fTH1s.Declare("abszeta");
+  ev.zphi     = fTH1s.Declare("zphi");
+  ev.deta     = fTH1s.Declare("deta");
+  ev.dseedeta = fTH1s.Declare("dseedeta");
+  ev.td_vtxZ  = fTH2s.Declare("td_vtxZ");
+  for (Int_t ipart = 0; ipart < nPairParts; ipart++)
+  {
+    const auto & part = pairparts[ipart];
+    ev.zmass      [ipart] = fTH1s.Declare(Form("zmass_%s",part.Data()));
+    ev.effseedE   [ipart] = fTH1s.Declare(Form("effseedE_%s",part.Data()));
+    ev.td         [ipart] = fTH1s.Declare(Form("td_%s",part.Data()));
+    ev.td_effseedE[ipart] = fTH2s.Declare(Form("td_effseedE_%s",part.Data()));
+    ev.td_nvtx    [ipart] = fTH2s.Declare(Form("td_nvtx_%s",part.Data()));
+    ev.td_dseedeta[ipart] = fTH2s.Declare(Form("td_dseedeta_%s",part.Data()));
+    ev.td_runs    [ipart] = fTH2s.Declare(Form("td_runs_%s",part.Data()));
   }
 
-  // el2
-  standardTH1Map["el2E_inclusive"]->Fill(el2E,weight);
-  standardTH1Map["el2seedE_inclusive"]->Fill(el2seedE,weight);
-  timingMap["el2time_inclusive"]->Fill(el2time,weight);
-  Analysis::FillHistFromArr3Vec0(timingMap["el2rhtimes_inclusive"],el2rhetps);
-  if        (el2eb) 
-  {
-    standardTH1Map["el2E_EB"]->Fill(el2E,weight);
-    standardTH1Map["el2seedE_EB"]->Fill(el2seedE,weight);
-    timingMap["el2time_EB"]->Fill(el2time,weight);
-    Analysis::FillHistFromArr3Vec0(timingMap["el2rhtimes_EB"],el2rhetps);
-    Analysis::FillHistFromArr3Vec1(standardTH1Map["el2rhEs_EB"],el2rhetps);
-  }
-  else if   (el2ee) 
-  {
-    standardTH1Map["el2E_EE"]->Fill(el2E,weight);
-    standardTH1Map["el2seedE_EE"]->Fill(el2seedE,weight);
-    timingMap["el2time_EE"]->Fill(el2time,weight);
-    Analysis::FillHistFromArr3Vec0(timingMap["el2rhtimes_EE"],el2rhetps);
-    Analysis::FillHistFromArr3Vec1(standardTH1Map["el2rhEs_EE"],el2rhetps);
-    if      (el2ep) 
+  for (Int_t iel = 0; iel < 2; iel++)
+  {
+    auto & el = fElHandles[iel];
+    const TString name = Form("el%i",iel+1);
+    el.phi          = fTH1s.Declare(name+"phi");
+    el.eta          = fTH1s.Declare(name+"eta");
+    el.seedeta      = fTH1s.Declare(name+"seedeta");
+    el.pt           = fTH1s.Declare(name+"pt");
+    el.p            = fTH1s.Declare(name+"p");
+    el.scE          = fTH1s.Declare(name+"scE");
+    el.td_seedeta   = fTH2s.Declare("td_"+name+"seedeta");
+    el.time_seedeta = fTH2s.Declare(name+"time_"+name+"seedeta");
+    el.time_vtxZ    = fTH2s.Declare(name+"time_vtxZ");
+    for (Int_t ipart = 0; ipart < nElParts; ipart++)
     {
-      standardTH1Map["el2E_EP"]->Fill(el2E,weight);
-      standardTH1Map["el2seedE_EP"]->Fill(el2seedE,weight);
-      timingMap["el2time_EP"]->Fill(el2time,weight);
-      Analysis::FillHistFromArr3Vec0(timingMap["el2rhtimes_EP"],el2rhetps);
-      Analysis::FillHistFromArr3Vec1(standardTH1Map["el2rhEs_EP"],el2rhetps);
+      const auto & part = elparts[ipart];
+      el.E      [ipart] = fTH1s.Declare(name+"E_"+part);
+      el.seedE  [ipart] = fTH1s.Declare(name+"seedE_"+part);
+      el.rhEs   [ipart] = fTH1s.Declare(name+"rhEs_"+part);
+      el.time   [ipart] = fTH1s.Declare(name+"time_"+part);
+      el.rhtimes[ipart] = fTH1s.Declare(name+"rhtimes_"+part);
     }
-    else if (el2em) 
+    for (Int_t ipart = 0; ipart < nPairParts; ipart++)
     {
-      standardTH1Map["el2E_EM"]->Fill(el2E,weight);
-      standardTH1Map["el2seedE_EM"]->Fill(el2seedE,weight);
-      timingMap["el2time_EM"]->Fill(el2time,weight);
-      Analysis::FillHistFromArr3Vec0(timingMap["el2rhtimes_EM"],el2rhetps);
-      Analysis::FillHistFromArr3Vec1(standardTH1Map["el2rhEs_EM"],el2rhetps);
+      const auto & part = pairparts[ipart];
+      el.td_seedE  [ipart] = fTH2s.Declare("td_"+name+"seedE_"+part);
+      el.time_seedE[ipart] = fTH2s.Declare(name+"time_"+name+"seedE_"+part);
     }
   }
 
-  // plots subdivided into 2partition events
-  standardTH1Map["effseedE_inclusive"]->Fill(effseedE,weight);
-  standardTH1Map["zmass_inclusive"]->Fill(zmass,weight);
-  timingMap["td_inclusive"]->Fill(timediff,weight);
-  if        (el1eb && el2eb) //EBEB
+  // plots not set up (or not made for a partition) stay NULL, and are skipped when filled
+  fTH1s.Bind(standardTH1Map);
+  fTH1s.Bind(timingMap);
+  for (const auto & th2map : {&effseedE2DMap,&el1seedE2DMap,&el2seedE2DMap,&nvtx2DMap,&deta2DMap,&eleta2DMap,&vtxZ2DMap,&runs2DMap})
   {
-    standardTH1Map["zmass_EBEB"]->Fill(zmass,weight); 
-    standardTH1Map["effseedE_EBEB"]->Fill(effseedE,weight);
-    timingMap["td_EBEB"]->Fill(timediff,weight); 
+    fTH2s.Bind(*th2map);
   }
-  else if   (el1ee && el2ee) //EEEE
+
+  if (Config::streamRes) Analysis::SetupResolutionEngine();
+}
+
+void Analysis::SetupResolutionEngine()
+{
+  if (ResolutionEngine::GetForm(Config::formname.Data()) == ResolutionEngine::kNoForm)
   {
-    standardTH1Map["zmass_EEEE"]->Fill(zmass,weight); 
-    standardTH1Map["effseedE_EEEE"]->Fill(effseedE,weight);
-    timingMap["td_EEEE"]->Fill(timediff,weight); 
-    if      (el1ep && el2ep) //EE+EE+
-    {
-      standardTH1Map["zmass_EPEP"]->Fill(zmass,weight); 
-      standardTH1Map["effseedE_EPEP"]->Fill(effseedE,weight);
-      timingMap["td_EPEP"]->Fill(timediff,weight); 
-    }
-    else if (el1em && el2em) //EE-EE-
-    {
-      standardTH1Map["zmass_EMEM"]->Fill(zmass,weight); 
-      standardTH1Map["effseedE_EMEM"]->Fill(effseedE,weight);
-      timingMap["td_EMEM"]->Fill(timediff,weight); 
-    }
+    std::cerr << "Yikes, you picked a function that we made that does not even exist ...exiting... " << std::endl;
+    exit(1);
+  }
+
+  // one engine plot per 2D plot, on the same handle: the runs and nvtx plots merge low-stat slices, as in ProduceMeanSigma
+  fResEngine.SetReservoirSize(Config::nReservoir);
+  for (UInt_t handle = 0; handle < fTH2s.size(); handle++)
+  {
+    const TH2F * hist2d = fTH2s[handle];
+    if (!hist2d) continue;
+
+    const TString name  = hist2d->GetName();
+    const TAxis * xaxis = hist2d->GetXaxis();
+    DblVec xedges;
+    for (Int_t i = 1; i <= xaxis->GetNbins() + 1; i++) xedges.push_back(xaxis->GetBinLowEdge(i));
+
+    const Bool_t merge = (name.Contains("runs",TString::kExact) || name.Contains("nvtx",TString::kExact));
+    fResEngine.Book(handle,xedges,hist2d->GetYaxis()->GetXmin(),hist2d->GetYaxis()->GetXmax(),(merge ? Config::nEventsCut : 0));
+  }
+}
+
+void Analysis::Fill2D(const UInt_t handle, const Float_t x, const Float_t y, const Float_t weight)
+{
+  fTH2s.Fill(handle,x,y,weight);
+  fResEngine.Fill(handle,x,y,weight); // nothing booked unless streaming
+}
+
+Parts Analysis::GetElParts(const Bool_t eb, const Bool_t ee, const Bool_t ep, const Bool_t em)
+{
+  Parts parts;
+  parts.Add(kElIncl);
+  if      (eb) parts.Add(kElEB);
+  else if (ee) 
+  {
+    parts.Add(kElEE);
+    if      (ep) parts.Add(kElEP);
+    else if (em) parts.Add(kElEM);
   }
-  else if   ((el1eb && el2ee) || (el1ee && el2eb)) //EBEE
+  return parts;
+}
+
+Parts Analysis::GetPairParts(const Bool_t el1eb, const Bool_t el1ee, const Bool_t el1ep, const Bool_t el1em,
+			     const Bool_t el2eb, const Bool_t el2ee, const Bool_t el2ep, const Bool_t el2em)
+{
+  Parts parts;
+  parts.Add(kPairIncl);
+  if      (el1eb && el2eb) parts.Add(kPairEBEB);
+  else if (el1ee && el2ee) 
+  {
+    parts.Add(kPairEEEE);
+    if      (el1ep && el2ep) parts.Add(kPairEPEP);
+    else if (el1em && el2em) parts.Add(kPairEMEM);
+    else if ((el1ep && el2em) || (el1em && el2ep)) parts.Add(kPairEPEM);
+  }
+  else if ((el1eb && el2ee) || (el1ee && el2eb)) parts.Add(kPairEBEE);
+  return parts;
+}
+
+void Analysis::FillStandardPlots(const Float_t weight, const Float_t effseedE, const Float_t el1seedE, const Float_t el2seedE, const Float_t timediff,
+				 const Float_t el1time, const Float_t el1seedeta, Bool_t el1eb, Bool_t el1ee, Bool_t el1ep, Bool_t el1em, const FltArr3Vec & el1rhetps,
+				 const Float_t el2time, const Float_t el2seedeta, Bool_t el2eb, Bool_t el2ee, Bool_t el2ep, Bool_t el2em, const FltArr3Vec & el2rhetps)
+{
+  const auto & ev  = fEvHandles;
+  const auto & el1 = fElHandles[0];
+  const auto & el2 = fElHandles[1];
+
+  // standard "validation" and Z mass plots
+  fTH1s.Fill(ev.nvtx,nvtx,weight);
+  fTH1s.Fill(ev.vtxZ,vtxZ,weight);
+
+  fTH1s.Fill(ev.zpt,zpt,weight);
+  fTH1s.Fill(ev.zeta,zeta,weight);
+  fTH1s.Fill(ev.abszeta,std::abs(zeta),weight);
+  fTH1s.Fill(ev.zphi,zphi,weight);
+
+  fTH1s.Fill(el1.phi,el1phi,weight);
+  fTH1s.Fill(el1.eta,el1eta,weight);
+  fTH1s.Fill(el1.seedeta,el1seedeta,weight);
+  fTH1s.Fill(el1.pt,el1pt,weight);
+  fTH1s.Fill(el1.p,el1p,weight);
+  fTH1s.Fill(el1.scE,el1scE,weight);
+
+  fTH1s.Fill(el2.phi,el2phi,weight); 
+  fTH1s.Fill(el2.eta,el2eta,weight);
+  fTH1s.Fill(el2.seedeta,el2seedeta,weight);
+  fTH1s.Fill(el2.pt,el2pt,weight);
+  fTH1s.Fill(el2.p,el2p,weight);
+  fTH1s.Fill(el2.scE,el2scE,weight);
+
+  fTH1s.Fill(ev.deta,std::abs(el1eta-el2eta),weight);
+  fTH1s.Fill(ev.dseedeta,std::abs(el1seedeta-el2seedeta),weight);
+
+  // inclusive single electron timing and energy, then per partition (no inclusive rhEs)
+  // el1
+  for (const auto part : Analysis::GetElParts(el1eb,el1ee,el1ep,el1em))
   {
-    standardTH1Map["zmass_EBEE"]->Fill(zmass,weight); 
-    standardTH1Map["effseedE_EBEE"]->Fill(effseedE,weight);
-    timingMap["td_EBEE"]->Fill(timediff,weight); 
+    fTH1s.Fill(el1.E[part],el1E,weight);
+    fTH1s.Fill(el1.seedE[part],el1seedE,weight);
+    fTH1s.Fill(el1.time[part],el1time,weight);
+    Analysis::FillHistFromArr3Vec0(fTH1s[el1.rhtimes[part]],el1rhetps);
+    Analysis::FillHistFromArr3Vec1(fTH1s[el1.rhEs[part]],el1rhetps);
+  }
+
+  // el2
+  for (const auto part : Analysis::GetElParts(el2eb,el2ee,el2ep,el2em))
+  {
+    fTH1s.Fill(el2.E[part],el2E,weight);
+    fTH1s.Fill(el2.seedE[part],el2seedE,weight);
+    fTH1s.Fill(el2.time[part],el2time,weight);
+    Analysis::FillHistFromArr3Vec0(fTH1s[el2.rhtimes[part]],el2rhetps);
+    Analysis::FillHistFromArr3Vec1(fTH1s[el2.rhEs[part]],el2rhetps);
+  }
+
+  // plots subdivided into 2partition events (no EE+EE- plots)
+  for (const auto part : Analysis::GetPairParts(el1eb,el1ee,el1ep,el1em,el2eb,el2ee,el2ep,el2em))
+  {
+    fTH1s.Fill(ev.zmass[part],zmass,weight); 
+    fTH1s.Fill(ev.effseedE[part],effseedE,weight);
+    fTH1s.Fill(ev.td[part],timediff,weight); 
   }
 }
 
 void Analysis::FillSingleEPlots(const Float_t weight, const Float_t el1seedE, const Float_t el2seedE, const Float_t timediff, const Float_t el1time, const Float_t el2time,
 				Bool_t el1eb, Bool_t el1ee, Bool_t el2eb, Bool_t el2ee)
 {
-  if (el1eb && el2eb) //EBEB
-  { 
-    el1seedE2DMap["td_el1seedE_EBEB"]->Fill(el1seedE,timediff,weight);
-    el2seedE2DMap["td_el2seedE_EBEB"]->Fill(el2seedE,timediff,weight);
-    el1seedE2DMap["el1time_el1seedE_EBEB"]->Fill(el1seedE,el1time,weight);
-    el2seedE2DMap["el2time_el2seedE_EBEB"]->Fill(el2seedE,el2time,weight);
-  }
-  else if (el1ee && el2ee) //EEEE
+  const auto & el1 = fElHandles[0];
+  const auto & el2 = fElHandles[1];
+
+  // only EBEB and EEEE are made
+  for (const auto part : Analysis::GetPairParts(el1eb,el1ee,false,false,el2eb,el2ee,false,false))
   { 
-    el1seedE2DMap["td_el1seedE_EEEE"]->Fill(el1seedE,timediff,weight);
-    el2seedE2DMap["td_el2seedE_EEEE"]->Fill(el2seedE,timediff,weight);
-    el1seedE2DMap["el1time_el1seedE_EEEE"]->Fill(el1seedE,el1time,weight);
-    el2seedE2DMap["el2time_el2seedE_EEEE"]->Fill(el2seedE,el2time,weight);
+    Analysis::Fill2D(el1.td_seedE[part],el1seedE,timediff,weight);
+    Analysis::Fill2D(el2.td_seedE[part],el2seedE,timediff,weight);
+    Analysis::Fill2D(el1.time_seedE[part],el1seedE,el1time,weight);
+    Analysis::Fill2D(el2.time_seedE[part],el2seedE,el2time,weight);
   }
 }
+
 void Analysis::FillEffEPlots(const Float_t weight, const Float_t effseedE, const Float_t timediff,
 			     Bool_t el1eb, Bool_t el1ee, Bool_t el1ep, Bool_t el1em, Bool_t el2eb, Bool_t el2ee, Bool_t el2ep, Bool_t el2em)
 {
-  // inclusive
-  effseedE2DMap["td_effseedE_inclusive"]->Fill(effseedE,timediff,weight);
-  if (el1eb && el2eb) //EBEB
-  { 
-    effseedE2DMap["td_effseedE_EBEB"]->Fill(effseedE,timediff,weight);
-  }
-  else if (el1ee && el2ee) //EEEE
-  { 
-    effseedE2DMap["td_effseedE_EEEE"]->Fill(effseedE,timediff,weight);
-    if      (el1ep && el2ep) // EE+EE+
-    {
-      effseedE2DMap["td_effseedE_EPEP"]->Fill(effseedE,timediff,weight);
-    }
-    else if (el1em && el2em) // EE-EE-
-    {
-      effseedE2DMap["td_effseedE_EMEM"]->Fill(effseedE,timediff,weight);
-    }
-  }
-  else if   ((el1eb && el2ee) || (el1ee && el2eb)) //EBEE
+  for (const auto part : Analysis::GetPairParts(el1eb,el1ee,el1ep,el1em,el2eb,el2ee,el2ep,el2em))
   {
-    effseedE2DMap["td_effseedE_EBEE"]->Fill(effseedE,timediff,weight);
+    Analysis::Fill2D(fEvHandles.td_effseedE[part],effseedE,timediff,weight);
   }
 }
 
 void Analysis::FillNvtxPlots(const Float_t weight, const Float_t timediff, const Float_t el1time, const Float_t el2time,
 			     Bool_t el1eb, Bool_t el1ee, Bool_t el1ep, Bool_t el1em, Bool_t el2eb, Bool_t el2ee, Bool_t el2ep, Bool_t el2em)
 {
-  nvtx2DMap["td_nvtx_inclusive"]->Fill(nvtx,timediff,weight);
-  if        (el1eb && el2eb) {nvtx2DMap["td_nvtx_EBEB"]->Fill(nvtx,timediff,weight);}
-  else if   (el1ee && el2ee) {nvtx2DMap["td_nvtx_EEEE"]->Fill(nvtx,timediff,weight);
-    if      (el1ep && el2ep) {nvtx2DMap["td_nvtx_EPEP"]->Fill(nvtx,timediff,weight);}
-    else if (el1em && el2em) {nvtx2DMap["td_nvtx_EMEM"]->Fill(nvtx,timediff,weight);}
+  // no EBEE plots
+  for (const auto part : Analysis::GetPairParts(el1eb,el1ee,el1ep,el1em,el2eb,el2ee,el2ep,el2em))
+  {
+    Analysis::Fill2D(fEvHandles.td_nvtx[part],nvtx,timediff,weight);
   }
 }
 
 void Analysis::FillEtaPlots(const Float_t weight, const Float_t timediff, const Float_t el1time, const Float_t el2time, const Float_t el1seedeta, const Float_t el2seedeta,
 			    Bool_t el1eb, Bool_t el1ee, Bool_t el1ep, Bool_t el1em, Bool_t el2eb, Bool_t el2ee, Bool_t el2ep, Bool_t el2em)
 {
-  deta2DMap["td_dseedeta_inclusive"]->Fill(std::abs(el1seedeta-el2seedeta),timediff,weight);
+  const auto & el1 = fElHandles[0];
+  const auto & el2 = fElHandles[1];
 
-  if        (el1eb && el2eb) {deta2DMap["td_dseedeta_EBEB"]->Fill(std::abs(el1seedeta-el2seedeta),timediff,weight);}
-  else if   (el1ee && el2ee) {deta2DMap["td_dseedeta_EEEE"]->Fill(std::abs(el1seedeta-el2seedeta),timediff,weight);
-    if      (el1ep && el2ep) {deta2DMap["td_dseedeta_EPEP"]->Fill(std::abs(el1seedeta-el2seedeta),timediff,weight);}
-    else if (el1em && el2em) {deta2DMap["td_dseedeta_EMEM"]->Fill(std::abs(el1seedeta-el2seedeta),timediff,weight);}
-    else if ((el1ep && el2em) || (el1em && el2ep)) {deta2DMap["td_dseedeta_EPEM"]->Fill(std::abs(el1seedeta-el2seedeta),timediff,weight);}
-  }
-  else if ((el1eb && el2ee) || (el1ee && el2eb)) {
-    deta2DMap["td_dseedeta_EBEE"]->Fill(std::abs(el1seedeta-el2seedeta),timediff,weight);
+  for (const auto part : Analysis::GetPairParts(el1eb,el1ee,el1ep,el1em,el2eb,el2ee,el2ep,el2em))
+  {
+    Analysis::Fill2D(fEvHandles.td_dseedeta[part],std::abs(el1seedeta-el2seedeta),timediff,weight);
   }
 
   if ((el1eb && el2eb) || (el1ee && el2ee)) // restrict this to only events with ebeb and eeee
   {
-    eleta2DMap["td_el1seedeta"]->Fill(el1seedeta,timediff,weight);
-    eleta2DMap["td_el2seedeta"]->Fill(el2seedeta,timediff,weight);
+    Analysis::Fill2D(el1.td_seedeta,el1seedeta,timediff,weight);
+    Analysis::Fill2D(el2.td_seedeta,el2seedeta,timediff,weight);
   }
 
-  eleta2DMap["el1time_el1seedeta"]->Fill(el1seedeta,el1time,weight);
-  eleta2DMap["el2time_el2seedeta"]->Fill(el2seedeta,el2time,weight);
+  Analysis::Fill2D(el1.time_seedeta,el1seedeta,el1time,weight);
+  Analysis::Fill2D(el2.time_seedeta,el2seedeta,el2time,weight);
 }
 
 void Analysis::FillVtxZPlots(const Float_t weight, const Float_t timediff, const Float_t el1time, const Float_t el2time)
 {
-  vtxZ2DMap["td_vtxZ"] ->Fill(vtxZ,timediff,weight);
-  vtxZ2DMap["el1time_vtxZ"]->Fill(vtxZ,el1time,weight);
-  vtxZ2DMap["el2time_vtxZ"]->Fill(vtxZ,el2time,weight);
+  Analysis::Fill2D(fEvHandles.td_vtxZ,vtxZ,timediff,weight);
+  Analysis::Fill2D(fElHandles[0].time_vtxZ,vtxZ,el1time,weight);
+  Analysis::Fill2D(fElHandles[1].time_vtxZ,vtxZ,el2time,weight);
 }
 
 void Analysis::FillRunPlots(const Float_t weight, const Float_t timediff, Bool_t el1eb, Bool_t el1ee, Bool_t el2eb, Bool_t el2ee)
 {
-  runs2DMap["td_runs_inclusive"]->Fill(run,timediff,weight);
-  if      (el1eb && el2eb) { runs2DMap["td_runs_EBEB"]->Fill(run,timediff,weight); }
-  else if (el1ee && el2ee) { runs2DMap["td_runs_EEEE"]->Fill(run,timediff,weight); }
+  // only inclusive, EBEB, and EEEE are made
+  for (const auto part : Analysis::GetPairParts(el1eb,el1ee,false,false,el2eb,el2ee,false,false))
+  {
+    Analysis::Fill2D(fEvHandles.td_runs[part],run,timediff,weight);
+  }
 }
 
 void Analysis::FillTrigEffPlots(const Float_t weight)
@@ -961,6 +1044,12 @@ void Analysis::OutputTrigEffPlots()
 
 void Analysis::Make1DTimingPlots(TH2F *& hist2D, const TString subdir2D, const DblVec& bins2D, TString name)
 {
+   if (Config::streamRes) 
+   {
+     Analysis::ProduceStreamMeanSigma(hist2D,name,bins2D,subdir2D);
+     return;
+   }
+
    TH1Map th1Dmap; TStrMap th1Dsubmap; TStrIntMap th1Dbinmap;
    Analysis::Project2Dto1D(hist2D,subdir2D,th1Dmap,th1Dsubmap,th1Dbinmap);
    Analysis::ProduceMeanSigma(th1Dmap,th1Dbinmap,name,hist2D->GetXaxis()->GetTitle(),bins2D,subdir2D);
@@ -1051,85 +1140,11 @@ void Analysis::Project2Dto1D(TH2F *& hist2d, TString subdir2d, TH1Map & th1map,
 
 void Analysis::ProduceMeanSigma(TH1Map & th1map, TStrIntMap & th1binmap, TString name, TString xtitle, const DblVec vxbins, TString subdir)
 {
-  // need to convert bins into array
-  const Double_t * axbins = &vxbins[0]; // https://stackoverflow.com/questions/2923272/how-to-convert-vector-to-array-c
-
   // initialize new mean/sigma histograms
-  TH1F * outhist_mean  = new TH1F(Form("%s_mean_%s",name.Data(),Config::formname.Data()),"",vxbins.size()-1,axbins);
-  outhist_mean->GetXaxis()->SetTitle(xtitle.Data());
-  if (name.Contains("td_",TString::kExact)) 
-  {
-    outhist_mean->GetYaxis()->SetTitle("Dielectron Seed Time Difference Fit #mu [ns]");
-  }
-  else if (name.Contains("el1",TString::kExact)) 
-  {
-    outhist_mean->GetYaxis()->SetTitle("Leading Electron Seed Time Fit #mu [ns]");
-  }
-  else if (name.Contains("el2",TString::kExact)) 
-  {
-    outhist_mean->GetYaxis()->SetTitle("Subleading Electron Seed Time Fit #mu [ns]");
-  }
-  outhist_mean->SetLineColor(fColor);
-  outhist_mean->SetMarkerColor(fColor);
-  outhist_mean->GetYaxis()->SetTitleOffset(outhist_mean->GetYaxis()->GetTitleOffset() * Config::TitleFF);
-  outhist_mean->Sumw2();
-
-  TH1F * outhist_sigma  = new TH1F(Form("%s_sigma_%s",name.Data(),Config::formname.Data()),"",vxbins.size()-1,axbins);
-  outhist_sigma->GetXaxis()->SetTitle(xtitle.Data());
-  if (name.Contains("td_",TString::kExact)) 
-  {
-    outhist_sigma->GetYaxis()->SetTitle("Dielectron Seed Time Difference Fit #sigma [ns]");
-  }
-  else if (name.Contains("el1",TString::kExact)) 
-  {
-    outhist_sigma->GetYaxis()->SetTitle("Leading Electron Seed Time Fit #sigma [ns]");
-  }
-  else if (name.Contains("el2",TString::kExact)) 
-  {
-    outhist_sigma->GetYaxis()->SetTitle("Subleading Electron Seed Time Fit #sigma [ns]");
-  }
-  outhist_sigma->SetLineColor(fColor);
-  outhist_sigma->SetMarkerColor(fColor);
-  outhist_sigma->GetYaxis()->SetTitleOffset(outhist_sigma->GetYaxis()->GetTitleOffset() * Config::TitleFF);
-  outhist_sigma->Sumw2();
-
-  TH1F * outhist_chi2ndf = new TH1F(Form("%s_chi2ndf_%s",name.Data(),Config::formname.Data()),"",vxbins.size()-1,axbins);
-  outhist_chi2ndf->GetXaxis()->SetTitle(xtitle.Data());
-  if (name.Contains("td_",TString::kExact)) 
-  {
-    outhist_chi2ndf->GetYaxis()->SetTitle("Dielectron Seed Time Difference Fit #chi^{2} / NDF");
-  }
-  else if (name.Contains("el1",TString::kExact)) 
-  {
-    outhist_chi2ndf->GetYaxis()->SetTitle("Leading Electron Seed Time Fit #chi^{2} / NDF");
-  }
-  else if (name.Contains("el2",TString::kExact)) 
-  {
-    outhist_chi2ndf->GetYaxis()->SetTitle("Subleading Electron Seed Time Fit #chi^{2} / NDF");
-  }
-  outhist_chi2ndf->SetLineColor(fColor);
-  outhist_chi2ndf->SetMarkerColor(fColor);
-  outhist_chi2ndf->GetYaxis()->SetTitleOffset(outhist_chi2ndf->GetYaxis()->GetTitleOffset() * Config::TitleFF);
-  outhist_chi2ndf->Sumw2();
-
-  TH1F * outhist_chi2prob = new TH1F(Form("%s_chi2prob_%s",name.Data(),Config::formname.Data()),"",vxbins.size()-1,axbins);
-  outhist_chi2prob->GetXaxis()->SetTitle(xtitle.Data());
-  if (name.Contains("td_",TString::kExact)) 
-  {
-    outhist_chi2prob->GetYaxis()->SetTitle("Dielectron Seed Time Difference Fit #chi^{2} probability");
-  }
-  else if (name.Contains("el1",TString::kExact)) 
-  {
-    outhist_chi2prob->GetYaxis()->SetTitle("Leading Electron Seed Time Fit #chi^{2} probability");
-  }
-  else if (name.Contains("el2",TString::kExact))  
-  {
-    outhist_chi2prob->GetYaxis()->SetTitle("Subleading Electron Seed Time Fit #chi^{2} probability");
-  }
-  outhist_chi2prob->SetLineColor(fColor);
-  outhist_chi2prob->SetMarkerColor(fColor);
-  outhist_chi2prob->GetYaxis()->SetTitleOffset(outhist_chi2prob->GetYaxis()->GetTitleOffset() * Config::TitleFF);
-  outhist_chi2prob->Sumw2();
+  TH1F * outhist_mean     = Analysis::MakeFitResultHist(name,"mean","Fit #mu [ns]",xtitle,vxbins);
+  TH1F * outhist_sigma    = Analysis::MakeFitResultHist(name,"sigma","Fit #sigma [ns]",xtitle,vxbins);
+  TH1F * outhist_chi2ndf  = Analysis::MakeFitResultHist(name,"chi2ndf","Fit #chi^{2} / NDF",xtitle,vxbins);
+  TH1F * outhist_chi2prob = Analysis::MakeFitResultHist(name,"chi2prob","Fit #chi^{2} probability",xtitle,vxbins);
 
   // use this to store runs that by themselves produce bad fits
   TH1Map tempmap; // a bit hacky I admit...
@@ -1203,10 +1218,42 @@ void Analysis::ProduceMeanSigma(TH1Map & th1map, TStrIntMap & th1binmap, TString
     const Float_t chi2prob = fit->GetProb();
     outhist_chi2prob->SetBinContent(bin,chi2prob);
 
-    // save a copy of the fitted histogram with the fit
-    Analysis::SaveTH1andFit(mapiter->second,subdir,fit);
+    // save a copy of the fitted histogram with the fit, only if asked for
+    if (Config::saveFits) Analysis::SaveTH1andFit(mapiter->second,subdir,fit);
+    else                  delete fit;
   } // end loop over th1s
 
+  Analysis::OutputFitResultHists(name,subdir,outhist_mean,outhist_sigma,outhist_chi2ndf,outhist_chi2prob);
+}
+
+TH1F * Analysis::MakeFitResultHist(const TString & name, const TString & var, const TString & label, const TString & xtitle, const DblVec & vxbins)
+{
+  // need to convert bins into array
+  const Double_t * axbins = &vxbins[0]; // https://stackoverflow.com/questions/2923272/how-to-convert-vector-to-array-c
+
+  TH1F * outhist = new TH1F(Form("%s_%s_%s",name.Data(),var.Data(),Config::formname.Data()),"",vxbins.size()-1,axbins);
+  outhist->GetXaxis()->SetTitle(xtitle.Data());
+  if (name.Contains("td_",TString::kExact)) 
+  {
+    outhist->GetYaxis()->SetTitle(Form("Dielectron Seed Time Difference %s",label.Data()));
+  }
+  else if (name.Contains("el1",TString::kExact)) 
+  {
+    outhist->GetYaxis()->SetTitle(Form("Leading Electron Seed Time %s",label.Data()));
+  }
+  else if (name.Contains("el2",TString::kExact)) 
+  {
+    outhist->GetYaxis()->SetTitle(Form("Subleading Electron Seed Time %s",label.Data()));
+  }
+  outhist->SetLineColor(fColor);
+  outhist->SetMarkerColor(fColor);
+  outhist->GetYaxis()->SetTitleOffset(outhist->GetYaxis()->GetTitleOffset() * Config::TitleFF);
+  outhist->Sumw2();
+  return outhist;
+}
+
+void Analysis::OutputFitResultHists(const TString & name, const TString & subdir, TH1F * outhist_mean, TH1F * outhist_sigma, TH1F * outhist_chi2ndf, TH1F * outhist_chi2prob)
+{
   // write output mean/sigma hists to file
   fOutFile->cd();
   outhist_mean->Write(outhist_mean->GetName(),TObject::kWriteDelete);
@@ -1252,6 +1299,136 @@ void Analysis::ProduceMeanSigma(TH1Map & th1map, TStrIntMap & th1binmap, TString
   delete outhist_mean;
 }
 
+void Analysis::ProduceStreamMeanSigma(TH2F *& hist2d, TString name, const DblVec vxbins, TString subdir)
+{
+  // slices were fit at the end of the event loop, low-stat runs/nvtx slices merged as in ProduceMeanSigma
+  const TString xtitle = hist2d->GetXaxis()->GetTitle();
+  TH1F * outhist_mean     = Analysis::MakeFitResultHist(name,"mean","Fit #mu [ns]",xtitle,vxbins);
+  TH1F * outhist_sigma    = Analysis::MakeFitResultHist(name,"sigma","Fit #sigma [ns]",xtitle,vxbins);
+  TH1F * outhist_chi2ndf  = Analysis::MakeFitResultHist(name,"chi2ndf","Fit #chi^{2} / NDF",xtitle,vxbins);
+  TH1F * outhist_chi2prob = Analysis::MakeFitResultHist(name,"chi2prob","Fit #chi^{2} probability",xtitle,vxbins);
+
+  for (const auto & slice : fResEngine.Slices(fTH2s.Find(name)))
+  {
+    if (slice.status != 0) {std::cout << "BAD FIT " << name.Data() << " " << slice.bin << " " << subdir.Data() << " " << Config::formname.Data() << std::endl;}
+    if (slice.status < 0) continue;
+
+    outhist_mean->SetBinContent(slice.bin,slice.mean);
+    outhist_mean->SetBinError(slice.bin,slice.emean);
+
+    outhist_sigma->SetBinContent(slice.bin,slice.sigma);
+    outhist_sigma->SetBinError(slice.bin,slice.esigma);
+
+    Double_t norm; Float_t chi2ndf, chi2prob;
+    Analysis::GetStreamGoF(hist2d,slice,norm,chi2ndf,chi2prob);
+    outhist_chi2ndf->SetBinContent(slice.bin,chi2ndf);
+    outhist_chi2prob->SetBinContent(slice.bin,chi2prob);
+
+    // only now is the slice projected: to draw it with the fit, if asked for
+    if (Config::saveFits)
+    {
+      TH1F * hist = Analysis::MakeSliceHist(hist2d,slice);
+      TF1  * fit  = Analysis::MakeStreamFit(slice,norm);
+      Analysis::SaveTH1andFit(hist,subdir,fit);
+      delete hist;
+    }
+  }
+
+  Analysis::OutputFitResultHists(name,subdir,outhist_mean,outhist_sigma,outhist_chi2ndf,outhist_chi2prob);
+}
+
+void Analysis::GetStreamGoF(TH2F *& hist2d, const ResolutionEngine::Slice & slice, Double_t & norm, Float_t & chi2ndf, Float_t & chi2prob)
+{
+  // the unbinned result against the x bins of the slice in the 2D plot: as the binned fits, evaluated at the bin 
+  // centers in the range fit, and empty bins skipped; the events in range fix the normalization
+  const TAxis * yaxis = hist2d->GetYaxis();
+  DblVec contents, errors2, models;
+  Double_t sumdata = 0.0, summodel = 0.0;
+  for (Int_t j = 1; j <= hist2d->GetNbinsY(); j++)
+  {
+    const Double_t center = yaxis->GetBinCenter(j);
+    if (center < slice.lo || center > slice.hi) continue;
+
+    Double_t content = 0.0, error2 = 0.0;
+    for (Int_t i = slice.first; i <= slice.last; i++)
+    {
+      content += hist2d->GetBinContent(i,j);
+      error2  += hist2d->GetBinError(i,j)*hist2d->GetBinError(i,j);
+    }
+    const Double_t model = ResolutionEngine::Pdf(slice.comps,center)*yaxis->GetBinWidth(j);
+
+    contents.push_back(content); errors2.push_back(error2); models.push_back(model);
+    sumdata += content; summodel += model;
+  }
+  const Double_t scale = (summodel > 0.0 ? sumdata/summodel : 0.0);
+  norm = scale*yaxis->GetBinWidth(1); // y bins same width
+
+  Double_t chi2 = 0.0;
+  Int_t    ndf  = -ResolutionEngine::NPars(ResolutionEngine::GetForm(Config::formname.Data()));
+  for (UInt_t k = 0; k < contents.size(); k++)
+  {
+    if (errors2[k] <= 0.0) continue;
+    chi2 += (contents[k]-scale*models[k])*(contents[k]-scale*models[k])/errors2[k];
+    ndf++;
+  }
+  chi2ndf  = (ndf > 0 ? chi2/ndf : 0.f);
+  chi2prob = (ndf > 0 ? TMath::Prob(chi2,ndf) : 0.f);
+}
+
+TH1F * Analysis::MakeSliceHist(TH2F *& hist2d, const ResolutionEngine::Slice & slice)
+{
+  TStrMap subdirmap; // not saved on its own
+  const TString histname = Form("%s_bin%i",hist2d->GetName(),slice.bin);
+  TH1F * hist = Analysis::MakeTH1Plot(histname,"",hist2d->GetNbinsY(),hist2d->GetYaxis()->GetXmin(),hist2d->GetYaxis()->GetXmax(),
+				      Form("%s in %s bins: %i to %i",hist2d->GetYaxis()->GetTitle(),hist2d->GetXaxis()->GetTitle(),slice.first,slice.last),"Events",subdirmap,"");
+  for (Int_t j = 0; j <= hist2d->GetNbinsY() + 1; j++) 
+  {
+    Double_t content = 0.0, error2 = 0.0;
+    for (Int_t i = slice.first; i <= slice.last; i++)
+    {
+      content += hist2d->GetBinContent(i,j);
+      error2  += hist2d->GetBinError(i,j)*hist2d->GetBinError(i,j);
+    }
+    hist->SetBinContent(j,content);
+    hist->SetBinError(j,std::sqrt(error2));
+  }
+  return hist;
+}
+
+TF1 * Analysis::MakeStreamFit(const ResolutionEngine::Slice & slice, const Double_t norm)
+{
+  // the unbinned result in the parameters of PrepFit: heights are events per bin
+  const auto & comps = slice.comps;
+  DblVec heights;
+  for (const auto & comp : comps) heights.push_back(norm*comp.frac/(ResolutionEngine::sqrt2pi*comp.sigma));
+
+  TF1 * fit;
+  const TString fitname = Form("%s_fit",Config::formname.Data());
+  if (Config::formname.EqualTo("gaus2",TString::kExact)) 
+  {
+    fit = new TF1(fitname.Data(),"[0]*exp(-0.5*((x-[1])/[2])**2)+[3]*exp(-0.5*((x-[4])/[5])**2)",slice.lo,slice.hi);
+    fit->SetParameters(heights[0],comps[0].mean,comps[0].sigma,heights[1],comps[1].mean,comps[1].sigma);
+  }
+  else if (Config::formname.EqualTo("gaus2fm",TString::kExact)) 
+  {
+    fit = new TF1(fitname.Data(),"[0]*exp(-0.5*((x-[1])/[2])**2)+[3]*exp(-0.5*((x-[1])/[4])**2)",slice.lo,slice.hi);
+    fit->SetParameters(heights[0],comps[0].mean,comps[0].sigma,heights[1],comps[1].sigma);
+  }
+  else if (Config::formname.EqualTo("gaus3fm",TString::kExact)) 
+  {
+    fit = new TF1(fitname.Data(),"[0]*exp(-0.5*((x-[1])/[2])**2)+[3]*exp(-0.5*((x-[1])/[4])**2)+[5]*exp(-0.5*((x-[1])/[6])**2)",slice.lo,slice.hi);
+    fit->SetParameters(heights[0],comps[0].mean,comps[0].sigma,heights[1],comps[1].sigma,heights[2],comps[2].sigma);
+  }
+  else // gaus1, gaus1core
+  {
+    fit = new TF1(fitname.Data(),"[0]*exp(-0.5*((x-[1])/[2])**2)",slice.lo,slice.hi);
+    fit->SetParameters(heights[0],comps[0].mean,comps[0].sigma);
+  }
+
+  fit->SetLineColor(kMagenta-3); //kViolet-6
+  return fit;
+}
+
 void Analysis::PrepFit(TF1 *& fit, TH1F *& hist) 
 {
   TF1 * tempfit = new TF1("temp","gaus(0)",-Config::fitrange,Config::fitrange);
@@ -1430,16 +1607,18 @@ void Analysis::DrawSubComp(TF1 *& fit, TCanvas *& canv, TF1 *& sub1, TF1 *& sub2
   sub2->Draw("same");
 }
 
-void Analysis::FillHistFromArr3Vec0(TH1F *& hist, const FltArr3Vec & arr3vec)
+void Analysis::FillHistFromArr3Vec0(TH1F * hist, const FltArr3Vec & arr3vec)
 {
+  if (!hist) return;
   for (auto&& arr3 : arr3vec)
   {
     hist->Fill(arr3[0]);
   }
 }
 
-void Analysis::FillHistFromArr3Vec1(TH1F *& hist, const FltArr3Vec & arr3vec)
+void Analysis::FillHistFromArr3Vec1(TH1F * hist, const FltArr3Vec & arr3vec)
 {
+  if (!hist) return;
   for (auto&& arr3 : arr3vec)
   {
     hist->Fill(arr3[1]);
@@ -1589,18 +1768,15 @@ void Analysis::SaveTH1andFit(TH1F *& hist, TString subdir, TF1 *& fit)
 
   fOutFile->cd();
 
-  // write out the canvas, but only print canvases if specfied
+  // write out the canvas, and print it (only called if the fits are to be saved)
   canv->SetLogy(0);
   CMSLumi(canv);
   canv->Write(canv->GetName(),TObject::kWriteDelete);
-  if (Config::saveFits) 
-  {
-    canv->SaveAs(Form("%s/%s/lin/%s_%s.%s",fOutDir.Data(),subdir.Data(),hist->GetName(),fit->GetName(),Config::outtype.Data()));
+  canv->SaveAs(Form("%s/%s/lin/%s_%s.%s",fOutDir.Data(),subdir.Data(),hist->GetName(),fit->GetName(),Config::outtype.Data()));
     
-    canv->SetLogy(1);
-    CMSLumi(canv);
-    canv->SaveAs(Form("%s/%s/log/%s_%s.%s",fOutDir.Data(),subdir.Data(),hist->GetName(),fit->GetName(),Config::outtype.Data()));
-  }
+  canv->SetLogy(1);
+  CMSLumi(canv);
+  canv->SaveAs(Form("%s/%s/log/%s_%s.%s",fOutDir.Data(),subdir.Data(),hist->GetName(),fit->GetName(),Config::outtype.Data()));
   delete canv;
 
   Analysis::DeleteFit(fit,sub1,sub2,sub3); // now that the fitting is done being used, delete it (as well as sub component gaussians)
@@ -9,6 +9,7 @@ namespace Config {
   Bool_t  doAnalysis = false;
   Bool_t  doStacks   = false;
   Bool_t  doDemo     = false;
+  Int_t   nJobs      = 1; // samples analyzed concurrently
   Bool_t  useDEG     = false; 
   Bool_t  useSEL     = false; 
   Bool_t  useDYll    = false; 
@@ -27,6 +28,9 @@ namespace Config {
   Bool_t  wgtedTime  = false;
   Bool_t  useSigma_n = false;
   Bool_t  saveFits   = false;
+  Bool_t  streamRes  = false;
+  Int_t   fitThreads = 0;     // 0: all cores
+  Int_t   nReservoir = 20000; // samples kept per slice
   Bool_t  dumpStatus = false;
   TString year       = "2016";
   TString formname   = "gaus2fm"; // gaus1, gaus1core, gaus2, gaus2fm, gaus3fm
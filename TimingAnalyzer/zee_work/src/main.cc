@@ -4,6 +4,7 @@
 #include "../interface/PUReweight.hh"
 #include "../interface/Analysis.hh"
 #include "../interface/StackPlots.hh"
+#include "../../plugins/SamplePool.hh"
 
 #include "TROOT.h"
 #include "TVirtualFitter.h"
@@ -171,6 +172,7 @@ int main(int argc, const char* argv[])
 	"  --do-analysis   <bool>        make analysis plots (def: %s)\n"
 	"  --do-stacks     <bool>        stack data/MC plots (def: %s)\n"
 	"  --do-demo       <bool>        demo analysis (def: %s)\n"
+	"  --n-jobs        <int>         number of samples to analyze concurrently, one process each (def: %i)\n"
 	"  --use-DEG       <bool>        use doubleEG for data (def: %s)\n"
 	"  --use-SEL       <bool>        use singleEl for data (def: %s)\n"
 	"  --use-DYll      <bool>        use Drell-Yan (LL+Jets) with MC (def: %s)\n"
@@ -188,7 +190,10 @@ int main(int argc, const char* argv[])
 	"  --apply-TOF     <bool>        apply TOF correction to times (def: %s)\n"
 	"  --wgt-time      <bool>        use full SC weighted time (def: %s)\n"
 	"  --use-sigman    <bool>        divide by sigma_n in E/pT plots (def: %s)\n"
-	"  --save-fits     <bool>        save local copies of fits as images (def: %s)\n"
+	"  --save-fits     <bool>        draw the fit of each slice: canvases in the ROOT file, and images (def: %s)\n"
+	"  --stream-res    <bool>        fit time resolution slices unbinned, from moments and reservoir samples filled in the event loop (def: %s)\n"
+	"  --fit-threads   <int>         threads fitting the streamed slices, 0 for all cores (def: %i)\n"
+	"  --n-reservoir   <int>         samples kept per streamed slice (def: %i)\n"
 	"  --dump-status   <bool>        print out every N events in analysis loop (def: %s)\n"
 	"  --in-year       <string>      which year to process (def: %s)\n"
 	"  --fit-form      <string>      name of formula used for fitting time plots (def: %s)\n"
@@ -201,6 +206,7 @@ int main(int argc, const char* argv[])
 	(Config::doAnalysis ? "true" : "false"),
 	(Config::doStacks   ? "true" : "false"),
 	(Config::doDemo     ? "true" : "false"),
+	Config::nJobs,
 	(Config::useDEG     ? "true" : "false"),
 	(Config::useSEL     ? "true" : "false"),
 	(Config::useDYll    ? "true" : "false"),
@@ -219,6 +225,9 @@ int main(int argc, const char* argv[])
 	(Config::wgtedTime  ? "true" : "false"),
 	(Config::useSigma_n ? "true" : "false"),
 	(Config::saveFits   ? "true" : "false"),
+	(Config::streamRes  ? "true" : "false"),
+	Config::fitThreads,
+	Config::nReservoir,
 	(Config::dumpStatus ? "true" : "false"),
 	Config::year.Data(),
         Config::formname.Data(),
@@ -232,6 +241,7 @@ int main(int argc, const char* argv[])
     else if (*i == "--do-analysis") { Config::doAnalysis = true; }
     else if (*i == "--do-stacks")   { Config::doStacks   = true; }
     else if (*i == "--do-demo")     { Config::doDemo     = true; Config::doAnalysis = true; Config::doStandard = true; Config::doTimeRes = true; }
+    else if (*i == "--n-jobs")      { next_arg_or_die(mArgs, i); Config::nJobs = std::atoi(i->c_str()); }
     else if (*i == "--use-DEG")     { Config::useDEG     = true; }
     else if (*i == "--use-SEL")     { Config::useSEL     = true; }
     else if (*i == "--use-DYll")    { Config::useDYll    = true; }
@@ -250,6 +260,9 @@ int main(int argc, const char* argv[])
     else if (*i == "--wgt-time")    { Config::doAnalysis = true; Config::wgtedTime  = true; Config::useSigma_n = true; }
     else if (*i == "--use-sigman")  { Config::doAnalysis = true; Config::useSigma_n = true; }
     else if (*i == "--save-fits")   { Config::doAnalysis = true; Config::saveFits   = true; }
+    else if (*i == "--stream-res")  { Config::doAnalysis = true; Config::streamRes  = true; }
+    else if (*i == "--fit-threads") { next_arg_or_die(mArgs, i); Config::fitThreads = std::atoi(i->c_str()); }
+    else if (*i == "--n-reservoir") { next_arg_or_die(mArgs, i); Config::nReservoir = std::atoi(i->c_str()); }
     else if (*i == "--dump-status") { Config::doAnalysis = true; Config::dumpStatus = true; }
     else if (*i == "--in-year")     { next_arg_or_die(mArgs, i); Config::year     = i->c_str(); }
     else if (*i == "--fit-form")    { next_arg_or_die(mArgs, i); Config::formname = i->c_str(); }
@@ -289,12 +302,27 @@ int main(int argc, const char* argv[])
   if (Config::doAnalysis) 
   {
     std::cout << "Starting analyis section" << std::endl;
+    std::vector<SamplePool::Job> jobs;
     for (TStrBoolMapIter mapiter = Config::SampleMap.begin(); mapiter != Config::SampleMap.end(); ++mapiter) 
     {
-      Analysis analysis((*mapiter).first,(*mapiter).second);
-      std::cout << "Analyzing: " << ((*mapiter).second?"MC":"DATA") << " sample: " << (*mapiter).first << std::endl;
-      analysis.EventLoop();
-      std::cout << "Done analyzing: " << ((*mapiter).second?"MC":"DATA") << " sample: " << (*mapiter).first << std::endl;
+      const TString sample = (*mapiter).first;
+      const Bool_t  isMC   = (*mapiter).second;
+      jobs.push_back({sample,[sample,isMC]()
+      {
+	Analysis analysis(sample,isMC);
+	std::cout << "Analyzing: " << (isMC?"MC":"DATA") << " sample: " << sample << std::endl;
+	analysis.EventLoop();
+	std::cout << "Done analyzing: " << (isMC?"MC":"DATA") << " sample: " << sample << std::endl;
+      }});
+    }
+
+    // samples are independent until stacking: with --n-jobs > 1, one process per sample, logs in outdir/logs
+    const TString logdir = Form("%s/logs", Config::outdir.Data());
+    if (Config::nJobs > 1) MakeOutDir(logdir);
+    if (!SamplePool::Run(jobs,Config::nJobs,(Config::nJobs > 1 ? logdir : TString(""))))
+    {
+      std::cerr << "Analysis failed for at least one sample! Exiting..." << std::endl;
+      exit(1);
     }
     std::cout << "Finished analysis section" << std::endl;
   }